@@ -11,10 +11,14 @@
 */
 // note: u64 in Cascade is a bitvec<64>, not a built-in integer. 
 // It isn’t a literal type, so you can’t use it in constexpr
+// Storage is a flat table of lazily allocated pages: nothing is committed until a
+// page is first written, and untouched pages read as zero.
 
 #pragma once
 #include <cascade/Cascade.hpp>
 #include "smem/MemTypes.hpp"
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace smem {
@@ -28,23 +32,41 @@ public:
   FifoOutput(MemResp, s_resp); // s_resp output port
   void set_latency(int v); // Set DRAM latency in cycles. Applies to next accepted req (in-flight unaffected).
 
+  // Capacity/paging (default 256MB window of 4KiB pages; can be multi-GB)
+  static constexpr uint64_t kDefaultCapacity  = 256ull * 1024 * 1024;
+  static constexpr uint64_t kDefaultPageBytes = 4096;
+  void set_capacity(uint64_t bytes, uint64_t page_bytes = kDefaultPageBytes); // drops current contents
+
   // HAL/test helpers
   uint64_t get_base() const { return base_addr_; }
-  uint64_t get_size() const { return mem_.size(); }
+  uint64_t get_size() const { return capacity_; }
+  uint64_t get_page_bytes()  const { return page_bytes_; }
+  uint64_t page_count()      const { return pages_.size(); }   // page-table entries
+  uint64_t resident_pages()  const { return resident_pages_; } // pages actually allocated
+  uint64_t resident_bytes()  const { return resident_pages_ * page_bytes_; }
   // methods for HAL to call
   void* alloc(uint64_t bytes);
   void  write(uint64_t addr, const void* src, uint64_t bytes);
   void  read(uint64_t addr, void* dst, uint64_t bytes);
 
 private:
-  std::vector<char> mem_;  // storage for simulated DRAM, C++ vector of characters (bytes)
-  static constexpr uint64_t base_addr_ = 0x80000000ull; // base address mapped to mem_[0]
+  std::vector<std::unique_ptr<uint8_t[]>> pages_; // page table for simulated DRAM (null = never written, reads 0)
+  uint64_t capacity_       = 0;
+  uint64_t page_bytes_     = kDefaultPageBytes;
+  uint32_t page_shift_     = 12;
+  uint64_t resident_pages_ = 0;
+  static constexpr uint64_t base_addr_ = 0x80000000ull; // base address mapped to offset 0
   u64 next_addr_ = 0;      // counter to keep track of next available memory address
   int latency_ = 0;
 
   void update();
   void reset();
 
+  // offset-based page helpers (caller checks bounds)
+  bool in_window(uint64_t addr, uint64_t bytes) const;          // [addr, addr+bytes) inside DRAM?
+  void copy_in(uint64_t off, const void* src, uint64_t bytes);  // allocates pages on demand
+  void copy_out(uint64_t off, void* dst, uint64_t bytes) const; // non-resident pages read as 0
+
   // request/response pipeline state for smoke test
   int    cnt_ = -1;
   MemReq cur_{};
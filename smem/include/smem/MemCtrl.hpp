@@ -5,11 +5,22 @@
 /*
   --> in_core_req   -> update_issue()  ->  s_req -->
   <-- out_core_resp <- update_retire() <- s_resp <--
+Two timing models:
+  flat   (banks=0, default): every access waits latency_ cycles, issued in order.
+  banked (banks>0): N banks with an open row each; requests are scheduled
+         FR-FCFS (oldest row hit first, else oldest) and cost
+         latency_ + t_cl (row hit), + t_rcd + t_cl (closed bank), or
+         + t_rp + t_rcd + t_cl (row conflict).
+Requests may be bursts of up to kMaxBurstBytes (see MemTypes.hpp); each is one
+transaction. In the banked model a burst also holds its bank for one extra cycle
+per additional beat_bytes of data.
 */
 
 #pragma once
 #include <cascade/Cascade.hpp>
+#include <cstdint>
 #include <deque>
+#include <vector>
 #include "smem/MemTypes.hpp"
 
 namespace smem {
@@ -38,12 +49,55 @@ public:
 
   void set_latency(int v) { if (v < 0) v = 0; latency_ = v; trace("mem: latency=%d", latency_); }
 
+  // Banked DRAM timing (cycles). banks=0 selects the flat model.
+  struct DramTiming {
+    int banks       = 0;    // number of banks (0 = flat fixed-latency pipe)
+    int row_bytes   = 2048; // bytes per row (power of two); addr -> row:bank:column
+    int t_cl        = 2;    // column access (row hit)
+    int t_rcd       = 3;    // activate (bank closed)
+    int t_rp        = 3;    // precharge (other row open)
+    int queue_depth = 16;   // requests the scheduler can see/reorder
+    int beat_bytes  = 8;    // data bus width; a burst costs ceil(size/beat_bytes) beats
+  };
+  struct BankStats {
+    uint64_t row_hits      = 0;
+    uint64_t row_misses    = 0; // bank was closed (first touch)
+    uint64_t row_conflicts = 0; // another row was open
+    uint64_t reads         = 0;
+    uint64_t writes        = 0;
+    uint64_t busy_cycles   = 0;
+  };
+  void set_timing(const DramTiming& t);
+  const DramTiming& timing() const { return timing_; }
+  const std::vector<BankStats>& bank_stats() const { return bank_stats_; }
+  uint64_t row_hits() const;
+  uint64_t row_accesses() const;
+  double   row_hit_rate() const { const uint64_t n = row_accesses(); return n ? double(row_hits()) / double(n) : 0.0; }
+  uint64_t reordered() const { return reordered_; }       // requests scheduled ahead of an older one
+  uint64_t queue_full_stalls() const { return queue_full_stalls_; }
+  uint64_t bursts() const { return bursts_; }             // accepted requests larger than 8 bytes
+  uint64_t burst_bytes() const { return burst_bytes_; }
+
 private:
-  struct Q { MemReq r; int cnt; };
-  std::deque<Q> pipe_; // pipeline stages to model latency
+  struct Q { MemReq r; int cnt; int bank = -1; uint64_t row = 0; bool sched = true; };
+  std::deque<Q> pipe_; // pipeline stages to model latency (banked: scheduler queue, oldest first)
   int latency_ = 0;
+  // banked model state
+  struct Bank { bool open = false; uint64_t row = 0; int busy = 0; };
+  DramTiming timing_{};
+  std::vector<Bank> banks_;
+  std::vector<BankStats> bank_stats_;
+  uint64_t reordered_ = 0;
+  uint64_t queue_full_stalls_ = 0;
+  uint64_t bursts_ = 0;
+  uint64_t burst_bytes_ = 0;
+  void map_addr(u64 addr, int &bank, uint64_t &row) const;
+  Q    make_entry(const MemReq &r) const; // flat: cnt=latency_; banked: unscheduled
+  void issue_banked();    // step 2 for the banked model: issue matured, then FR-FCFS schedule
+  bool issue_entry(size_t i); // push pipe_[i] to DRAM (and ACK non-posted stores); false if blocked
   // helpers
-  bool find_pending_store(u64 addr, u16 size, u64 &val) const;
+  const Q *find_pending_store(u64 addr, u16 size) const; // newest queued STORE overlapping the range
+  void forward_store(const Q &st, const MemReq &r);      // answer LOAD r from queued STORE st
   bool posted_writes_ = true; // if false, ack store when it drains to DRAM
 };
 
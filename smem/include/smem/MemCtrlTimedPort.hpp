@@ -34,6 +34,10 @@ public:
   uint32_t resp_data() const override;
   void resp_consume() override;
 
+  // Every write (immediate or timed) lands in the backing port, so observers live there.
+  void add_write_observer(MemoryWriteObserver* obs) override;
+  void remove_write_observer(MemoryWriteObserver* obs) override;
+
 private:
   MemoryPort* backing_ = nullptr;
   int latency_ = 0;
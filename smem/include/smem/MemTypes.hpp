@@ -4,25 +4,73 @@
 // Sebastian Claudiusz Magierowski Aug 16 2025
 /*
 Minimal memory request/response packet types (FIFO-friendly).  MemReq is a mem request ("read/write this addr"), and MemResp is mem response ("here's the read data or here's the store ack").  They travel through Cascade FIFO ports.
+
+Bursts: size may be up to kMaxBurstBytes.  A 1..8 byte op uses wdata/rdata alone.  A larger op
+carries all size bytes (little-endian, byte 0 at addr) in wburst/rburst and is served as one
+transaction; wdata/rdata still mirror the low 8 bytes.  Use the put/get helpers below rather
+than filling the fields by hand.
 */
 
 #pragma once
 #include <cascade/Cascade.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 
 namespace smem {
 
+static constexpr std::size_t kMaxBurstBytes = 64;        // largest single MemReq (one 64B line / DMA row)
+using MemBurst = std::array<std::uint8_t, kMaxBurstBytes>;
+
 struct MemReq {
   u64  addr  = 0;     // byte address
-  u64  wdata = 0;     // write data (single beat for now)
-  u16  size  = 8;     // bytes covered by memory op
+  u64  wdata = 0;     // write data (low 8 bytes of a burst)
+  u16  size  = 8;     // bytes covered by memory op (1..kMaxBurstBytes)
   bit  write = false; // write=1 store, write=0 load
   u16  id    = 0;     // transaction id (requester can label so response can be matched to req)
+  MemBurst wburst{};  // write data when size > 8
 };
 
 struct MemResp {
-  u64  rdata = 0;   // read data (single beat for now)
+  u64  rdata = 0;   // read data (low 8 bytes of a burst)
   u16  id    = 0;   // transaction id
   u8   err   = 0;   // 0=OK, nonzero=error code
+  MemBurst rburst{}; // read data when the request size was > 8
 };
 
+inline bool is_burst(std::size_t bytes) { return bytes > sizeof(std::uint64_t); }
+
+// fill a store's payload from bytes [src, src+bytes); bytes <= kMaxBurstBytes
+inline void put_wdata(MemReq& r, const void* src, std::size_t bytes) {
+  std::uint64_t low = 0;
+  std::memcpy(&low, src, bytes < sizeof(low) ? bytes : sizeof(low));
+  r.wdata = low;
+  r.size  = static_cast<std::uint16_t>(bytes);
+  if (is_burst(bytes)) std::memcpy(r.wburst.data(), src, bytes);
+}
+
+// copy a store's payload (size bytes) out to dst
+inline void get_wdata(const MemReq& r, void* dst) {
+  const std::size_t bytes = static_cast<std::uint16_t>(r.size);
+  if (is_burst(bytes)) { std::memcpy(dst, r.wburst.data(), bytes); return; }
+  const auto low = static_cast<std::uint64_t>(r.wdata);
+  std::memcpy(dst, &low, bytes);
+}
+
+// fill a load response's payload (bytes = the request's size)
+inline void put_rdata(MemResp& r, const void* src, std::size_t bytes) {
+  std::uint64_t low = 0;
+  std::memcpy(&low, src, bytes < sizeof(low) ? bytes : sizeof(low));
+  r.rdata = low;
+  if (is_burst(bytes)) std::memcpy(r.rburst.data(), src, bytes);
+}
+
+// copy a load response's payload out to dst (bytes = the request's size)
+inline void get_rdata(const MemResp& r, void* dst, std::size_t bytes) {
+  if (is_burst(bytes)) { std::memcpy(dst, r.rburst.data(), bytes); return; }
+  const auto low = static_cast<std::uint64_t>(r.rdata);
+  std::memcpy(dst, &low, bytes);
+}
+
 } // namespace smem
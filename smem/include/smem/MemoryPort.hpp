@@ -5,13 +5,29 @@
 /*
 Lightweight software memory-port protocol used by Tile1, memory adapters,
 debug tools, and accelerators. This is not a Cascade component by itself.
+Ports that commit writes tell any attached MemoryWriteObserver (e.g. Tile1's
+decoded-instruction cache) which word was touched. Writers that know the
+whole span (e.g. smicro's shared L2) report it with on_write.
 */
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <vector>
 
 namespace smem {
 
+// Gets a callback for every 32b word a MemoryPort commits via write32
+class MemoryWriteObserver {
+public:
+  virtual      ~MemoryWriteObserver()    = default;
+  virtual void on_write32(uint32_t addr) = 0;
+  // bytes written at addr; by default one on_write32 per word touched
+  virtual void on_write(uint64_t addr, uint64_t bytes) {
+    for (uint64_t w = addr & ~3ull; w < addr + bytes; w += 4) on_write32(static_cast<uint32_t>(w));
+  }
+};
+
 class MemoryPort {
 public:
   virtual          ~MemoryPort()                          = default;
@@ -24,6 +40,24 @@ public:
   virtual bool     resp_valid() const                     = 0;
   virtual uint32_t resp_data() const                      = 0;
   virtual void     resp_consume()                         = 0;
+
+  // Write observers (wrappers forward these to the port that actually commits writes)
+  virtual void add_write_observer(MemoryWriteObserver* obs) {
+    if (obs && std::find(write_observers_.begin(), write_observers_.end(), obs) == write_observers_.end()) {
+      write_observers_.push_back(obs);
+    }
+  }
+  virtual void remove_write_observer(MemoryWriteObserver* obs) {
+    write_observers_.erase(std::remove(write_observers_.begin(), write_observers_.end(), obs), write_observers_.end());
+  }
+
+protected:
+  void notify_write32(uint32_t addr) { // call after a write32 lands in backing storage
+    for (MemoryWriteObserver* obs : write_observers_) obs->on_write32(addr);
+  }
+
+private:
+  std::vector<MemoryWriteObserver*> write_observers_;
 };
 
 } // namespace smem
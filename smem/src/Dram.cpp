@@ -10,6 +10,7 @@
    +------------
 */
 #include "smem/Dram.hpp"
+#include <algorithm>
 #include <cstring>
 
 namespace smem {
@@ -17,7 +18,57 @@ namespace smem {
 Dram::Dram(std::string /*name*/, int latency, IMPL_CTOR) : latency_(latency) // DRAM constructor
 {
   UPDATE(update).reads(s_req).writes(s_resp); // hint let's Cascade order producer->consumer correctly
-  mem_.resize(256 * 1024 * 1024);             // upon construction resizes (allocates) mem_ to 256MB of DRAM
+  set_capacity(kDefaultCapacity);             // 256MB window, but only a page table is allocated up front
+}
+
+// Resize the DRAM window; page_bytes must be a power of two. Existing contents are dropped.
+void Dram::set_capacity(uint64_t bytes, uint64_t page_bytes) {
+  assert_always(page_bytes != 0 && (page_bytes & (page_bytes - 1)) == 0, "Dram page size must be a power of two");
+  page_bytes_ = page_bytes;
+  page_shift_ = 0;
+  while ((1ull << page_shift_) < page_bytes_) ++page_shift_;
+  const uint64_t npages = (bytes + page_bytes_ - 1) >> page_shift_;
+  capacity_ = npages << page_shift_;
+  pages_.clear();
+  pages_.resize(static_cast<size_t>(npages));
+  resident_pages_ = 0;
+  trace("dram: capacity=0x%llx page=%llu pages=%llu\n",
+        (unsigned long long)capacity_, (unsigned long long)page_bytes_, (unsigned long long)npages);
+}
+
+bool Dram::in_window(uint64_t addr, uint64_t bytes) const {
+  if (addr < base_addr_) return false;
+  const uint64_t off = addr - base_addr_;
+  return off <= capacity_ && bytes <= capacity_ - off; // overflow-safe
+}
+
+void Dram::copy_in(uint64_t off, const void* src, uint64_t bytes) {
+  const uint8_t* s = static_cast<const uint8_t*>(src);
+  while (bytes) {
+    const uint64_t pg  = off >> page_shift_;
+    const uint64_t in  = off & (page_bytes_ - 1);
+    const uint64_t n   = std::min(bytes, page_bytes_ - in);
+    auto& page = pages_[static_cast<size_t>(pg)];
+    if (!page) { // first touch: allocate a zeroed page
+      page.reset(new uint8_t[static_cast<size_t>(page_bytes_)]());
+      ++resident_pages_;
+    }
+    std::memcpy(page.get() + in, s, static_cast<size_t>(n));
+    off += n; s += n; bytes -= n;
+  }
+}
+
+void Dram::copy_out(uint64_t off, void* dst, uint64_t bytes) const {
+  uint8_t* d = static_cast<uint8_t*>(dst);
+  while (bytes) {
+    const uint64_t pg  = off >> page_shift_;
+    const uint64_t in  = off & (page_bytes_ - 1);
+    const uint64_t n   = std::min(bytes, page_bytes_ - in);
+    const auto& page = pages_[static_cast<size_t>(pg)];
+    if (page) std::memcpy(d, page.get() + in, static_cast<size_t>(n));
+    else      std::memset(d, 0, static_cast<size_t>(n));
+    off += n; d += n; bytes -= n;
+  }
 }
 
 // Set latency in cycles (applies to the next accepted request; in-flight unaffected)
@@ -36,7 +87,7 @@ void* Dram::alloc(uint64_t bytes) {
   return addr;                    // returns starting addr
 }
 
-// method: write to DRAM, use memcpy fn. to copy data between host program's memory and simulated DRAM (mem_ vector)
+// method: write to DRAM, copy data from host program's memory into simulated DRAM pages
 void Dram::write(uint64_t addr, const void* src, uint64_t bytes) {
   // Trace HAL-side writes for visibility in -test=multi/bounds
   if (bytes >= 8) {
@@ -50,30 +101,19 @@ void Dram::write(uint64_t addr, const void* src, uint64_t bytes) {
           (unsigned long long)addr,
           (unsigned long long)bytes);
   }
-  if (addr < base_addr_) return;
-  uint64_t off = addr - base_addr_;
-  if (off + bytes > mem_.size()) return;
-  memcpy(&mem_[off], src, bytes);
+  if (!in_window(addr, bytes)) return;
+  copy_in(addr - base_addr_, src, bytes);
 }
 // method: read from DRAM for HAL
 void Dram::read(uint64_t addr, void* dst, uint64_t bytes) {
-  // OOB below base → zero-fill and return
-  if (addr < base_addr_) {
-    std::memset(dst, 0, (size_t)bytes);
-    return;
-  }
-  // Compute offset once (safe after the check above)
-  uint64_t off_u64 = addr - base_addr_;
-  size_t   sz      = mem_.size();
-  size_t   off     = (size_t)off_u64;
-  size_t   n       = (size_t)bytes;
-  // OOB past end (overflow-safe): if n > sz - off, range doesn’t fit
-  if (off > sz || n > (sz - off)) {
+  size_t n = (size_t)bytes;
+  // OOB below base or past end → zero-fill and return
+  if (!in_window(addr, bytes)) {
     std::memset(dst, 0, n);
     return;
   }
-  // In-bounds copy
-  std::memcpy(dst, mem_.data() + off, n);
+  // In-bounds copy (untouched pages read as zero)
+  copy_out(addr - base_addr_, dst, bytes);
   // Trace a preview of the first 8 bytes (same as before)
   if (n >= 8) {
     uint64_t tmp = 0;
@@ -91,13 +131,16 @@ void Dram::read(uint64_t addr, void* dst, uint64_t bytes) {
 
 void Dram::update() {
   // Zero-latency storage with 1-entry read hold; writes produce no responses.
+  // A burst (size > 8, up to kMaxBurstBytes) is moved whole in one transaction.
   if (!hold_valid_ && !s_req.empty()) {          // accept one req (if not already holding a LOAD req)
     auto rq = s_req.pop();
+    const uint64_t bytes = static_cast<uint16_t>(rq.size);
+    assert_always(bytes <= kMaxBurstBytes, "Dram: request larger than kMaxBurstBytes");
     if (rq.write) {                                // if req=STORE copy wdata into to byte array; no sig on s_resp
-      if (rq.addr >= base_addr_) {
-        uint64_t off = rq.addr - base_addr_;
-        if (off + rq.size <= mem_.size())
-          std::memcpy(&mem_[off], &rq.wdata, rq.size);
+      if (in_window(rq.addr, bytes)) {
+        uint8_t buf[kMaxBurstBytes];
+        get_wdata(rq, buf);
+        copy_in(rq.addr - base_addr_, buf, bytes);
       }
     } else {                                       // if req=LOAD put req in hold_ (1-entry latch)
       hold_ = rq;
@@ -107,12 +150,11 @@ void Dram::update() {
 
   if (hold_valid_ && !s_resp.full()) {           // if holding a LOAD req and resp FIFO has space, respond now
     MemResp resp{};                                // build zero-initialized resp
-    if (hold_.addr >= base_addr_) {                // if addr inside DRAM window
-      uint64_t off = hold_.addr - base_addr_;
-      if (off + hold_.size <= mem_.size())          // bounds check (if requested bytes fit)
-        std::memcpy(&resp.rdata, &mem_[off], hold_.size);
-      else
-        resp.rdata = 0;
+    const uint64_t bytes = static_cast<uint16_t>(hold_.size);
+    if (in_window(hold_.addr, bytes)) {            // if requested bytes fit inside DRAM window
+      uint8_t buf[kMaxBurstBytes] = {};
+      copy_out(hold_.addr - base_addr_, buf, bytes);
+      put_rdata(resp, buf, bytes);                   // rdata (and rburst for a burst)
     } else {
       resp.rdata = 0;
     }
@@ -126,8 +168,9 @@ void Dram::reset() {
   next_addr_ = 0;
   cnt_ = -1;
   // Preload memory location with the expected test pattern
+  // (skipped when set_capacity() left no window to hold it)
   uint64_t v = 0x1122334455667788ull;
-  std::memcpy(&mem_[0], &v, 8);
+  if (in_window(base_addr_, sizeof(v))) copy_in(0, &v, sizeof(v));
 }
 
 } // namespace smem
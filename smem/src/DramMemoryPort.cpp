@@ -19,6 +19,7 @@ uint32_t DramMemoryPort::read32(uint32_t addr) {
 void DramMemoryPort::write32(uint32_t addr, uint32_t value) {
   const uint64_t phys = dram_.get_base() + static_cast<uint64_t>(addr);
   dram_.write(phys, &value, sizeof(value));
+  notify_write32(addr);
 }
 
 void DramMemoryPort::cycle() {}
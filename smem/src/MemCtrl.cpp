@@ -15,7 +15,12 @@ Some details:
   - posted STORE means MemCtrl give core ACK as soon as it queues it up to send to DRAM
   - non-posted STORE means core gets ACK only afer DRAM gets store
 • LOADs can fetch from STORE queue
-  - if a LOAD matches a STORE in the queue, return that value to core right away (and still send that STORE to DRAM)
+  - if a STORE in the queue covers a LOAD, return that value to core right away (and still send that STORE to DRAM)
+With set_timing(banks>0) steps 1-2 become a banked DRAM model (see issue_banked()):
+requests wait in the queue until FR-FCFS picks them for an idle bank, then pay
+row hit / miss / conflict latency on top of latency_.
+Bursts (size 9..kMaxBurstBytes) travel as one request. A LOAD is forwarded from a queued
+STORE that fully covers it; a LOAD that only partly overlaps a queued STORE waits behind it.
 */
 
 #include "smem/MemCtrl.hpp"
@@ -29,42 +34,45 @@ MemCtrl::MemCtrl(std::string /*name*/, IMPL_CTOR) {  // constructor registers tw
 
 // ----- first update: accepts from core, ages/queues, issues to DRAM -----
 void MemCtrl::update_issue() {
-  // 1) Age existing entries (do not age the one we may enqueue this tick)
-  for (auto &q : pipe_) if (q.cnt > 0) --q.cnt; // pipe_ holdes queued memory ops
-  // 2) Sending signals to DRAM
-  if (!pipe_.empty() && pipe_.front().cnt == 0) {  // if head of queue is matured
-    const MemReq &hq = pipe_.front().r;
-    if (hq.write && !posted_writes_) {               // if non-posted STORE @ head (i.e., ACK not sent to core yet)
-      if (!out_core_resp.full() && !s_req.full()) {    // if MemCtrl & DRAM FIFOs can take data
-        MemResp ack{}; ack.rdata = 0; ack.id = hq.id; ack.err = 0; // build a STORE ACK
-        out_core_resp.push(ack);                                   // send ACK to core now
-        s_req.push(hq);                                            // issue STORE to DRAM
-        pipe_.pop_front();                                         // remove from queue
-      }
-    } else if (!s_req.full()) {                      // if LOAD or posted STORE @ head (STORE ACK already sent to core)
-      s_req.push(hq);                                  // issue to DRAM
-      pipe_.pop_front();                               // remove from queue
+  if (timing_.banks > 0) {
+    issue_banked();                                 // 1+2) banked model: age, issue matured, FR-FCFS schedule
+  } else {
+    // 1) Age existing entries (do not age the one we may enqueue this tick)
+    for (auto &q : pipe_) if (q.cnt > 0) --q.cnt;   // pipe_ holdes queued memory ops
+    // 2) Sending signals to DRAM
+    if (!pipe_.empty() && pipe_.front().cnt == 0) { // if head of queue is matured
+      issue_entry(0);
     }
   }
   // 3) Take at most one new request from core; posted write-ack + RAW handling
   if (!in_core_req.empty()) {       // if core has REQ ready 
     if (out_core_resp.full()) return; // avoid pop if we might need to ACK a store but cannot (being convervative)
+    if (timing_.banks > 0 && (int)pipe_.size() >= timing_.queue_depth) { // scheduler queue full: backpressure
+      queue_full_stalls_++;
+      return;
+    }
     auto r = in_core_req.pop();       // take REQ from core
+    const size_t bytes = static_cast<uint16_t>(r.size);
+    assert_always(bytes <= kMaxBurstBytes, "MemCtrl: request larger than kMaxBurstBytes");
+    if (is_burst(bytes)) { bursts_++; burst_bytes_ += bytes; }
     if (r.write) {                    // *** if core's REQ is STORE ***
       if (posted_writes_) {                                       // if posted STORE
-        assert_always(((u64)r.size == 8) && (((u64)r.addr & 7ull) == 0ull), "MemCtrl posted write: only 8-byte aligned ops supported for now"); // Guard
         MemResp ack{}; ack.rdata = 0; ack.id = r.id; ack.err = 0;   // build ACK
         out_core_resp.push(ack);                                    // send ACK to core now
       }
-      pipe_.push_back(Q{r, latency_});                            // put STORE in latency queue
+      pipe_.push_back(make_entry(r));                             // put STORE in latency queue
     } else {                          // *** if core's REQ is LOAD ***
-      u64 fwd = 0;
-      if (find_pending_store((u64)r.addr, (u16)r.size, fwd)) {   // check if a queued STORE=LOAD (store hazard); if so forward full word; partial size handling can be added later
-        assert_always(((u64)r.size == 8) && (((u64)r.addr & 7ull) == 0ull), "MemCtrl RAW forward: only 8-byte aligned ops supported for now"); // Guard
-        MemResp rr{}; rr.rdata = fwd; rr.id = r.id; rr.err = 0;    // build synthetic LOAD response with STORE's data
-        out_core_resp.push(rr);                                    // return data to core now (no DRAM access)
+      const Q *st = find_pending_store((u64)r.addr, (u16)r.size);
+      if (st) {                                                  // a queued STORE overlaps this LOAD (store hazard)
+        const u64 a0 = r.addr, b0 = st->r.addr;
+        const bool covered = a0 >= b0 && (u64)(a0 + bytes) <= (u64)(b0 + (u64)st->r.size);
+        if (covered) {
+          forward_store(*st, r);                                   // STORE holds every byte: answer from its data
+        } else {
+          pipe_.push_back(make_entry(r));                          // partial overlap: read after the STORE drains
+        }
       } else {                                                   // normal path through latency pipe
-        pipe_.push_back(Q{r, latency_});                           // no hazard: queue the read for timed issue to DRAM
+        pipe_.push_back(make_entry(r));                            // no hazard: queue the read for timed issue to DRAM
       }
     }
   }
@@ -74,7 +82,7 @@ void MemCtrl::update_issue() {
 void MemCtrl::update_retire() {
   if (!s_resp.empty() && !out_core_resp.full()) { // if DRAM returns LOAD & core can take it
     auto rr = s_resp.pop();                         // get DRAM's resp
-    MemResp o{}; o.rdata = rr.rdata; o.id = rr.id; o.err = 0; // build o/p resposne to core
+    MemResp o = rr; o.err = 0;                      // build o/p resposne to core (burst payload rides along)
     out_core_resp.push(o);                          // send resp to core 
   }
 }
@@ -82,12 +90,118 @@ void MemCtrl::update_retire() {
 // clear state
 void MemCtrl::reset() {
   pipe_.clear(); // forget all queued resuests
+  for (auto &b : banks_) b = Bank{};
+  for (auto &st : bank_stats_) st = BankStats{};
+  reordered_ = 0;
+  queue_full_stalls_ = 0;
+  bursts_ = 0;
+  burst_bytes_ = 0;
+}
+
+// ----- banked DRAM timing model -----
+void MemCtrl::set_timing(const DramTiming& t) {
+  assert_always(t.banks >= 0, "MemCtrl: banks must be >= 0");
+  assert_always(t.row_bytes > 0 && (t.row_bytes & (t.row_bytes - 1)) == 0, "MemCtrl: row_bytes must be a power of two");
+  assert_always(t.t_cl >= 0 && t.t_rcd >= 0 && t.t_rp >= 0, "MemCtrl: DRAM timings must be >= 0");
+  assert_always(t.beat_bytes > 0, "MemCtrl: beat_bytes must be > 0");
+  assert_always(pipe_.empty(), "MemCtrl: change timing model only while idle");
+  timing_ = t;
+  if (timing_.queue_depth < 1) timing_.queue_depth = 1;
+  banks_.assign((size_t)timing_.banks, Bank{});
+  bank_stats_.assign((size_t)timing_.banks, BankStats{});
+  reordered_ = 0;
+  queue_full_stalls_ = 0;
+  trace("mem: banks=%d row_bytes=%d tCL=%d tRCD=%d tRP=%d\n", timing_.banks, timing_.row_bytes, timing_.t_cl, timing_.t_rcd, timing_.t_rp);
+}
+
+// row:bank:column interleave, so sequential streams walk a row then move to the next bank
+void MemCtrl::map_addr(u64 addr, int &bank, uint64_t &row) const {
+  const uint64_t line = (uint64_t)addr / (uint64_t)timing_.row_bytes;
+  bank = (int)(line % (uint64_t)timing_.banks);
+  row  = line / (uint64_t)timing_.banks;
+}
+
+MemCtrl::Q MemCtrl::make_entry(const MemReq &r) const {
+  Q q{r, latency_};
+  if (timing_.banks > 0) {        // banked: wait unscheduled until FR-FCFS picks it
+    map_addr(r.addr, q.bank, q.row);
+    q.sched = false;
+    q.cnt = -1;
+  }
+  return q;
+}
+
+// Push pipe_[i] to DRAM; non-posted STOREs are ACKed here. Returns false if a FIFO is full.
+bool MemCtrl::issue_entry(size_t i) {
+  const MemReq &hq = pipe_[i].r;
+  if (hq.write && !posted_writes_) {               // if non-posted STORE (i.e., ACK not sent to core yet)
+    if (out_core_resp.full() || s_req.full()) return false;
+    MemResp ack{}; ack.rdata = 0; ack.id = hq.id; ack.err = 0; // build a STORE ACK
+    out_core_resp.push(ack);                                   // send ACK to core now
+    s_req.push(hq);                                            // issue STORE to DRAM
+  } else {                                         // if LOAD or posted STORE (STORE ACK already sent to core)
+    if (s_req.full()) return false;
+    s_req.push(hq);                                            // issue to DRAM
+  }
+  pipe_.erase(pipe_.begin() + (std::ptrdiff_t)i);            // remove from queue
+  return true;
+}
+
+void MemCtrl::issue_banked() {
+  // 1) Age scheduled entries and bank occupancy
+  for (size_t b = 0; b < banks_.size(); ++b) {
+    if (banks_[b].busy > 0) { --banks_[b].busy; bank_stats_[b].busy_cycles++; }
+  }
+  for (auto &q : pipe_) if (q.sched && q.cnt > 0) --q.cnt;
+  // 2) Issue the oldest matured access to DRAM (one per cycle)
+  for (size_t i = 0; i < pipe_.size(); ++i) {
+    if (pipe_[i].sched && pipe_[i].cnt == 0) { issue_entry(i); break; }
+  }
+  // 3) FR-FCFS: oldest row hit on an idle bank, else oldest request on an idle bank
+  int pick = -1;
+  for (size_t i = 0; i < pipe_.size(); ++i) {
+    const Q &q = pipe_[i];
+    if (q.sched || banks_[(size_t)q.bank].busy > 0) continue;
+    const Bank &bk = banks_[(size_t)q.bank];
+    if (bk.open && bk.row == q.row) { pick = (int)i; break; } // first ready (row hit)
+    if (pick < 0) pick = (int)i;                               // first come
+  }
+  if (pick < 0) return;
+  Q &q = pipe_[(size_t)pick];
+  Bank &bk = banks_[(size_t)q.bank];
+  BankStats &st = bank_stats_[(size_t)q.bank];
+  int access = timing_.t_cl;
+  if (bk.open && bk.row == q.row) { st.row_hits++; }
+  else if (!bk.open)              { st.row_misses++;    access += timing_.t_rcd; }
+  else                            { st.row_conflicts++; access += timing_.t_rp + timing_.t_rcd; }
+  const int beats = ((int)static_cast<uint16_t>(q.r.size) + timing_.beat_bytes - 1) / timing_.beat_bytes;
+  if (beats > 1) access += beats - 1;                          // burst: extra data beats on the bus
+  if (q.r.write) st.writes++; else st.reads++;
+  for (int i = 0; i < pick; ++i) if (!pipe_[(size_t)i].sched) { reordered_++; break; } // jumped an older request
+  bk.open = true;
+  bk.row  = q.row;
+  bk.busy = access;
+  q.cnt   = latency_ + access;
+  q.sched = true;
+  trace("mem: sched id=%u bank=%d row=%llu lat=%d\n", (unsigned)(u16)q.r.id, q.bank, (unsigned long long)q.row, q.cnt);
+}
+
+uint64_t MemCtrl::row_hits() const {
+  uint64_t n = 0;
+  for (const auto &st : bank_stats_) n += st.row_hits;
+  return n;
+}
+
+uint64_t MemCtrl::row_accesses() const {
+  uint64_t n = 0;
+  for (const auto &st : bank_stats_) n += st.row_hits + st.row_misses + st.row_conflicts;
+  return n;
 }
 
 // small helpers
 // deal with LOAD = queued STORE (store hazard); scan most-recent-first for a pending write that overlaps [addr, addr+size)
-bool MemCtrl::find_pending_store(u64 addr, u16 size, u64 &val) const {
-  if (size == 0) return false;                           // empty LOAD size is a miss
+const MemCtrl::Q *MemCtrl::find_pending_store(u64 addr, u16 size) const {
+  if (size == 0) return nullptr;                         // empty LOAD size is a miss
   u64 a0 = addr;                                         // read range start
   u64 a1 = addr + (u64)size;                             // read range end (exclusive)
   for (int i = (int)pipe_.size() - 1; i >= 0; --i) {     // search newset --> oldest
@@ -96,9 +210,21 @@ bool MemCtrl::find_pending_store(u64 addr, u16 size, u64 &val) const {
     u64 b0 = (u64)q.r.addr;                                // STORE range start
     u64 b1 = b0 + (u64)q.r.size;                           // STORE range end (exlucsive)
     bool overlap = !(a1 <= b0 || b1 <= a0);                // overlap test
-    if (overlap) { val = (u64)q.r.wdata; return true; }    // on hit: return STORE data
+    if (overlap) return &q;                                // on hit: return STORE entry
   }
-  return false;                                         // no pending STORE covers this LOAD
+  return nullptr;                                       // no pending STORE covers this LOAD
+}
+
+// LOAD r lies inside queued STORE st: answer with the covered slice of its data
+void MemCtrl::forward_store(const Q &st, const MemReq &r) {
+  uint8_t sbuf[kMaxBurstBytes], lbuf[kMaxBurstBytes];
+  get_wdata(st.r, sbuf);
+  const size_t off = (size_t)((u64)r.addr - (u64)st.r.addr);
+  const size_t bytes = static_cast<uint16_t>(r.size);
+  for (size_t i = 0; i < bytes; ++i) lbuf[i] = sbuf[off + i];
+  MemResp rr{}; rr.id = r.id; rr.err = 0;
+  put_rdata(rr, lbuf, bytes);
+  out_core_resp.push(rr);                                // return data to core now (no DRAM access)
 }
 
 // true when no STOREs remain in the latency queue (used for fences)
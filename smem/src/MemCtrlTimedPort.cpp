@@ -78,4 +78,12 @@ void MemCtrlTimedPort::resp_consume() {
   resp_valid_ = false;
 }
 
+void MemCtrlTimedPort::add_write_observer(MemoryWriteObserver* obs) {
+  backing_->add_write_observer(obs);
+}
+
+void MemCtrlTimedPort::remove_write_observer(MemoryWriteObserver* obs) {
+  backing_->remove_write_observer(obs);
+}
+
 } // namespace smem
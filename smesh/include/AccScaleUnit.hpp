@@ -3,7 +3,21 @@
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 13 2026
 /*
-Accumulator scale-stage skeleton.
+Accumulator scale stage.
+
+Two inputs share one pipeline: store data arriving through the normalizer
+(req_*, wins the stage) and execute operand reads straight from the
+accumulator banks (ex_req_*, lowest bank first). A row entering the stage goes
+through the CONFIG_ST activation (Activation.hpp) on the whole accumulator row
+and is then requantized to Elem with its acc_scale and per-channel scales
+(Requantize.hpp); full_data keeps the activated full-width row. Execute reads
+carry act=None and the identity scale, so they are only saturated.
+
+The row then moves through latency() stages, one per cycle, and leaves from the
+last one: out_val only advertises store data to StIssueCtrl; out_val_exresp
+advertises execute data to AccumExResp. A stage is freed when the row ahead of
+it moves, and the row leaving the last stage frees it in the same cycle, so the
+unit takes a row every cycle at any depth while its consumer is ready.
 */
 
 #pragma once
@@ -12,6 +26,9 @@ Accumulator scale-stage skeleton.
 
 #include "SmeshPorts.hpp"
 
+#include <array>
+#include <cstdint>
+
 namespace smesh {
 
 class AccScaleUnit : public Component {
@@ -25,19 +42,47 @@ class AccScaleUnit : public Component {
   Input(bit, req_val);
   Output(bit, req_rdy);
   Input(AccScaleReq, req_bits);
+  InputArray(bit, ex_req_val, kAccBanks);
+  InputArray(AccumReadResp, ex_req_bits, kAccBanks);
+  OutputArray(bit, ex_req_rdy, kAccBanks);
   Output(bit, out_val);
+  Output(bit, out_val_exresp);
   Output(AccScaleResp, out_bits);
   Input(bit, out_rdy_issue);
   Input(bit, out_rdy_exresp);
 
   void updateReady();
   void updateOutView();
-  void updateOutPop();
   void update();
+  void reset();
+
+  void setLatency(std::size_t n); // 1..kAccScaleMaxLatency; change only while empty
+  std::size_t latency()   const { return latency_; }
+  std::size_t occupancy() const { return count_; }
+
+  // counters
+  std::uint64_t cycles()          const { return cycles_; }
+  std::uint64_t rows()            const { return rows_; }
+  std::uint64_t fullStallCycles() const { return full_stall_cycles_; } // a row was offered to a full pipeline
+  std::uint64_t outStallCycles()  const { return out_stall_cycles_; }  // the last stage waited on its consumer
+  double averageOccupancy() const { return cycles_ ? double(occupancy_sum_) / double(cycles_) : 0.0; }
 
  private:
-  bool out_valid_ = false;
-  AccScaleResp out_entry_{};
+  struct Stage {
+    bool         valid = false;
+    AccScaleResp resp{};
+  };
+
+  bool accepting_ = false; // a stage was free when the ready ports were driven
+  std::array<Stage, kAccScaleMaxLatency> stages_{}; // stages_[latency_ - 1] drives the outputs
+  std::size_t latency_ = kAccScaleLatency;
+  std::size_t count_   = 0;
+
+  std::uint64_t cycles_            = 0;
+  std::uint64_t rows_              = 0;
+  std::uint64_t full_stall_cycles_ = 0;
+  std::uint64_t out_stall_cycles_  = 0;
+  std::uint64_t occupancy_sum_     = 0;
 };
 
 } // namespace smesh
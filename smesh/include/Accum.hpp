@@ -4,6 +4,7 @@
 // Sebastian Claudiusz Magierowski Jul 9 2026
 /*
 Standalone smesh accumulator memory. Initially provides one normal-width load-path write port.
+A write whose local address carries the accumulate bit adds into the row in place.
 */
 
 #pragma once
@@ -14,6 +15,7 @@ Standalone smesh accumulator memory. Initially provides one normal-width load-pa
 #include "SmeshTypes.hpp"
 
 #include <array>
+#include <cstdint>
 
 namespace smesh {
 
@@ -28,12 +30,13 @@ class Accum : public Component {
   Clock(clk);
 
   FifoOutput(DmaReadCompletion, dma_resp); // completion FIFO: let LdCtrl know last accum write is done
-  // Banked write ports. For now Accum accepts at most one write per cycle.
+  // Banked write ports; every bank can take one write per cycle.
   InputArray(bit, write_val_bnk, kAccBanks);
   OutputArray(bit, write_rdy_bnk, kAccBanks);
   InputArray(DmaReadResp, write_bits_bnk, kAccBanks);
 
-  // Banked read request ports. For now Accum accepts at most one read per cycle.
+  // Banked read request ports; every bank serves one read per cycle, so execute
+  // operand reads and store reads proceed in parallel on different banks.
   InputArray(bit, read_req_val_bnk, kAccBanks);
   OutputArray(bit, read_req_rdy_bnk, kAccBanks);
   InputArray(AccumReadReq, read_req_bits_bnk, kAccBanks);
@@ -51,13 +54,22 @@ class Accum : public Component {
   void reset();
 
   bool hasAcceptedWrite() const { return write_accepted_; }
+  std::uint64_t reads(std::size_t bank) const { return reads_[bank]; }
+  std::uint64_t writes(std::size_t bank) const { return writes_[bank]; }
+  std::uint64_t exReads() const { return ex_reads_; }
+  std::uint64_t accumulates() const { return accumulates_; }
   const Row& row(SmeshLocalAddr addr) const;
 
  private:
   std::array<std::array<Row, kAccBankRows>, kAccBanks> banks_{};
   bool write_accepted_  = false;
-  bool read_resp_valid_ = false;
-  AccumReadResp read_resp_entry_{}; // reg holds response while waiting for StNormCtrl to pop it
+  std::array<bool, kAccBanks> read_accepting_{};     // read_req_rdy as driven this cycle
+  std::array<bool, kAccBanks> read_resp_valid_{};    // per-bank reg holds response until its consumer pops it
+  std::array<AccumReadResp, kAccBanks> read_resp_entry_{};
+  std::array<std::uint64_t, kAccBanks> reads_{};
+  std::array<std::uint64_t, kAccBanks> writes_{};
+  std::uint64_t ex_reads_ = 0;
+  std::uint64_t accumulates_ = 0; // writes that added into the row instead of overwriting
 };
 
 } // namespace smesh
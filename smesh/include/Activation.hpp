@@ -0,0 +1,57 @@
+// **********************************************************************
+// smesh/include/Activation.hpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Aug 26 2026
+/*
+Integer-only activation kernels shared by the store path (AccScaleUnit) and
+the execute writeback (ExCtrlWriteback).
+
+Every kernel works on one whole accumulator row per call, all kDim lanes
+side by side, with 64-bit intermediates and a saturating return to Acc:
+  ReLU  : max(q, 0)
+  ReLU6 : clamp(q, 0, 6 << relu6_shift), i.e. 1.0 is 1 << relu6_shift
+  IGELU : I-BERT integer GELU, q * (sgn(q) * ((min(|q|, -qb) + qb)^2 + qc) + qc)
+  IEXP  : I-BERT integer exp for q <= 0 (softmax after max subtraction),
+          z = floor(-q / qln2), ((q + z * qln2 + qb)^2 + qc) >> z
+qb/qc are the polynomial constants floor(b / S) and floor(c / (a * S^2)) for
+the input scale S, so I-GELU and I-EXP share the igelu_qb/qc fields; qln2 is
+floor(ln2 / S) and qln2_inv its reciprocal with 16 fractional bits.
+LayerNorm and Softmax need whole-row statistics, so the Normalizer applies
+them on mvout; here they leave the row unchanged.
+*/
+#pragma once
+
+#include "SmeshTypes.hpp"
+
+#include <cstdint>
+
+namespace smesh {
+
+// activation selector carried by CONFIG_EX (2 bits) and CONFIG_ST/acc_act (3 bits)
+enum class Activation : std::uint8_t {
+  None  = 0,
+  Relu  = 1,
+  Relu6 = 2,
+  IGelu = 3,
+  IExp  = 4,
+  LayerNorm = 5, // CONFIG_ST only, applied by the Normalizer
+  Softmax   = 6, // CONFIG_ST only, applied by the Normalizer
+};
+
+constexpr std::uint8_t kActivationCount = 7;
+
+struct ActivationParams {
+  std::uint8_t  relu6_shift   = 0;
+  std::int32_t  igelu_qb      = 0;
+  std::int32_t  igelu_qc      = 0;
+  std::int32_t  iexp_qln2     = 0;
+  std::uint32_t iexp_qln2_inv = 0; // 16 fractional bits
+};
+
+// decode a raw selector; out-of-range values select None
+Activation decodeActivation(std::uint32_t raw);
+
+Acc activate(Acc q, Activation act, const ActivationParams& params);
+MeshAccumRow activateRow(const MeshAccumRow& row, Activation act, const ActivationParams& params);
+
+} // namespace smesh
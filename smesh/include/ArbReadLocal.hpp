@@ -3,7 +3,10 @@
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 15 2026
 /*
-Local-memory read arbiters.
+Local-memory read arbiters. One ArbReadSpad/ArbReadAccum sits in front of each
+bank; the execute read wins a bank over the store (DMA write) read, and a cycle
+in which both want the same bank counts as a conflict for that bank. Requests
+for different banks never interact.
 */
 
 #pragma once
@@ -12,6 +15,8 @@ Local-memory read arbiters.
 
 #include "SmeshPorts.hpp"
 
+#include <cstdint>
+
 namespace smesh {
 
 class ArbReadSpad : public Component {
@@ -35,6 +40,17 @@ class ArbReadSpad : public Component {
   Output(SpadReadReq, read_req_bits);
 
   void update();
+  void updateCount();
+  void reset();
+
+  std::uint64_t exReads() const { return ex_reads_; }
+  std::uint64_t dmaReads() const { return dma_reads_; }
+  std::uint64_t conflicts() const { return conflicts_; } // store read held off by an execute read
+
+ private:
+  std::uint64_t ex_reads_  = 0;
+  std::uint64_t dma_reads_ = 0;
+  std::uint64_t conflicts_ = 0;
 };
 
 class ArbReadAccum : public Component {
@@ -58,6 +74,17 @@ class ArbReadAccum : public Component {
   Output(AccumReadReq, read_req_bits);
 
   void update();
+  void updateCount();
+  void reset();
+
+  std::uint64_t exReads() const { return ex_reads_; }
+  std::uint64_t dmaReads() const { return dma_reads_; }
+  std::uint64_t conflicts() const { return conflicts_; } // store read held off by an execute read
+
+ private:
+  std::uint64_t ex_reads_  = 0;
+  std::uint64_t dma_reads_ = 0;
+  std::uint64_t conflicts_ = 0;
 };
 
 class ArbRespSpad : public Component {
@@ -78,6 +105,29 @@ class ArbRespSpad : public Component {
   void update();
 };
 
+// Splits a bank's accumulator read response between the store path (from_dma) and
+// the execute path, so StNormCtrl never sees an execute read.
+class ArbRespAccum : public Component {
+  DECLARE_COMPONENT(ArbRespAccum);
+
+ public:
+  ArbRespAccum(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+
+  Input(bit, read_resp_val);
+  Input(AccumReadResp, read_resp_bits);
+  Input(bit, dma_resp_rdy);
+  Input(bit, ex_resp_rdy);
+
+  Output(bit, read_resp_rdy);
+  Output(bit, dma_resp_val);
+  Output(bit, ex_resp_val);
+
+  void updateValid();
+  void updateReady();
+};
+
 class AccumExResp : public Component {
   DECLARE_COMPONENT(AccumExResp);
 
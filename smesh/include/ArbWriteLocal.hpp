@@ -34,6 +34,11 @@ class ArbWriteSpad : public Component {
   Input(DmaReadResp, zerowrite_bits);
   Output(bit, zerowrite_rdy);
 
+  // lowest priority: store-to-scratchpad rows from SpadWriter; fire says it won this cycle
+  Input(bit, spadwrite_val);
+  Input(DmaReadResp, spadwrite_bits);
+  Output(bit, spadwrite_fire);
+
   Output(bit, write_val);
   Input(bit, write_rdy);
   Output(DmaReadResp, write_bits);
@@ -0,0 +1,62 @@
+// **********************************************************************
+// smesh/include/DmaMemArb.hpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Jul 18 2026
+/*
+Shares the external smem port between the load-side DmaReader and the
+store-side DmaWriter.
+
+  DmaReader --> rd_req  -+                  +-> rd_resp --> DmaReader
+                         |-> mem_req  ...  -|
+  DmaWriter --> wr_req  -+     mem_resp ... +-> wr_ack  --> StCtrl
+
+- One request per cycle onto mem_req, round-robin when both sides are waiting.
+- Store IDs are tagged 0x8000 | cmd_id on the way out; responses with bit 15 set
+  are write acks and leave on wr_ack as a DmaWriteResp, the rest go to the reader.
+*/
+
+#pragma once
+
+#include <cascade/Cascade.hpp>
+
+#include "SmeshPorts.hpp"
+#include "smem/MemTypes.hpp"
+
+#include <cstdint>
+
+namespace smesh {
+
+class DmaMemArb : public Component {
+  DECLARE_COMPONENT(DmaMemArb);
+
+ public:
+  DmaMemArb(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+
+  FifoInput(smem::MemReq, rd_req);
+  FifoOutput(smem::MemResp, rd_resp);
+  FifoInput(smem::MemReq, wr_req);
+  FifoOutput(DmaWriteResp, wr_ack);
+  FifoOutput(smem::MemReq, mem_req);   // external memory boundary
+  FifoInput(smem::MemResp, mem_resp);
+
+  void updateRequest();
+  void updateResponse();
+  void reset();
+
+  std::uint64_t reads()     const { return reads_; }
+  std::uint64_t writes()    const { return writes_; }
+  std::uint64_t writeAcks() const { return write_acks_; }
+  bool writesIdle()         const { return writes_ == write_acks_; } // every store acked
+
+  static constexpr std::uint16_t kWriteIdBit = 0x8000;
+
+ private:
+  bool last_was_write_ = true; // round-robin: side granted last
+  std::uint64_t reads_      = 0;
+  std::uint64_t writes_     = 0;
+  std::uint64_t write_acks_ = 0;
+};
+
+} // namespace smesh
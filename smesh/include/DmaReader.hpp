@@ -3,7 +3,12 @@
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 6 2026
 /*
-Minimal DMA reader for converting one smesh row request into one memory read.
+DMA reader: turns each smesh row request into one memory read.
+
+Up to maxInflight() reads are outstanding at once. Each takes a slot in a
+circular in-flight table and uses the slot index as its memory transaction ID,
+so responses may come back in any order; the table doubles as a reorder buffer
+and resp_out still delivers rows in request order.
 */
 
 #pragma once
@@ -13,6 +18,9 @@ Minimal DMA reader for converting one smesh row request into one memory read.
 #include "SmeshPorts.hpp"
 #include "smem/MemTypes.hpp"
 
+#include <array>
+#include <cstdint>
+
 namespace smesh {
 
 class DmaReader : public Component {
@@ -32,11 +40,40 @@ class DmaReader : public Component {
   void updateResponse();
   void reset();
 
-  const DmaReadReq& activeRequest() const { return active_; }
+  void setMaxInflight(std::size_t n); // 1..kDmaMaxInflight; change only while idle
+  std::size_t maxInflight() const { return max_inflight_; }
+  std::size_t inflight()    const { return count_; }
+  bool idle()               const { return count_ == 0; }
+  const DmaReadReq& activeRequest() const { return last_req_; } // most recently issued row
+
+  // counters
+  std::uint64_t cycles()          const { return cycles_; }
+  std::uint64_t reads()           const { return reads_; }
+  std::uint64_t fullStallCycles() const { return full_stall_cycles_; } // a request waited on a full table
+  std::uint64_t reorderedResponses() const { return reordered_; }     // responses that arrived ahead of an older row
+  std::size_t   peakInflight()    const { return peak_inflight_; }
+  double averageOccupancy() const { return cycles_ ? double(occupancy_sum_) / double(cycles_) : 0.0; }
 
  private:
-  bool waiting_ = false;
-  DmaReadReq active_{};
+  struct Slot {
+    bool valid = false; // issued to memory
+    bool done  = false; // response received, waiting its turn on resp_out
+    DmaReadReq req{};
+    DmaReadResp resp{};
+  };
+
+  std::array<Slot, kDmaMaxInflight> slots_{};
+  std::size_t head_  = 0;  // oldest outstanding slot (next to retire)
+  std::size_t count_ = 0;  // slots in use
+  std::size_t max_inflight_ = kDmaMaxInflight;
+  DmaReadReq last_req_{};
+
+  std::uint64_t cycles_            = 0;
+  std::uint64_t occupancy_sum_     = 0;
+  std::uint64_t reads_             = 0;
+  std::uint64_t full_stall_cycles_ = 0;
+  std::uint64_t reordered_         = 0;
+  std::size_t   peak_inflight_     = 0;
 };
 
 } // namespace smesh
@@ -5,6 +5,22 @@
 /*
 Structural shell for the smesh execute controller.
 
+Read side: ExCtrlReadReqLogic issues the A/B/D operand-row reads on every
+Spad/Accum bank in parallel (one read per bank per beat, granted by
+ExCtrlReadPriority); each bank's response is popped as its row enters Mesher.
+
+Mesh side: the mesh-control queue head selects/pads the operand rows read back
+from Spad/Accum (ExCtrlMeshInSelPad) into Mesher, ExCtrlMeshCntlDeqCtrl pops
+the head as its rows are taken, and Mesher routes the transposed operand
+(a_transpose/bd_transpose per dataflow) through the Transposer.
+
+Overlap: with preload overlap enabled, a COMPUTE followed by a PRELOAD issues as
+one mul_pre operation, so the next weights fill the mesh's shadow buffer while
+the current ones multiply (see ExCtrlState).
+
+Write side: ExCtrlWriteback commits every Mesher response row to the Spad or
+Accum bank its tag (plus c_addr_stride) names, and reports the last row of a
+tagged matmul to ExCtrlCompletion.
 */
 #pragma once
 
@@ -13,7 +29,9 @@ Structural shell for the smesh execute controller.
 #include "ExCtrlCompletion.hpp"
 #include "ExCtrlDecoder.hpp"
 #include "ExCtrlFeedSignals.hpp"
+#include "ExCtrlMeshCntlDeqCtrl.hpp"
 #include "ExCtrlMeshCntlPack.hpp"
+#include "ExCtrlMeshInSelPad.hpp"
 #include "ExCtrlMeshTagSelect.hpp"
 #include "ExCtrlOperandPack.hpp"
 #include "ExCtrlQueues.hpp"
@@ -23,8 +41,11 @@ Structural shell for the smesh execute controller.
 #include "ExCtrlRowFeedState.hpp"
 #include "ExCtrlRowPad.hpp"
 #include "ExCtrlState.hpp"
+#include "ExCtrlWriteback.hpp"
+#include "Mesher.hpp"
 #include "SmeshPorts.hpp"
 #include "SmeshTypes.hpp"
+#include "Transposer.hpp"
 
 namespace smesh {
 
@@ -55,19 +76,25 @@ class ExCtrl : public Component {
   InputArray(ExCtrlAccumReadResp, accum_read_resp_bits, kAccBanks);
   OutputArray(bit, accum_read_resp_rdy, kAccBanks);
 
-  Output(bit, spad_write_val);
-  Input(bit, spad_write_rdy);
-  Output(DmaReadResp, spad_write_bits);
+  OutputArray(bit, spad_write_val, kSpBanks);
+  InputArray(bit, spad_write_rdy, kSpBanks);
+  OutputArray(DmaReadResp, spad_write_bits, kSpBanks);
 
-  Output(bit, accum_write_val);
-  Input(bit, accum_write_rdy);
-  Output(DmaReadResp, accum_write_bits);
+  OutputArray(bit, accum_write_val, kAccBanks);
+  InputArray(bit, accum_write_rdy, kAccBanks);
+  OutputArray(DmaReadResp, accum_write_bits, kAccBanks);
 
   void updateReadPorts();
-  void updateWritePorts();
   void updateDecoderInputs();
   void reset();
 
+  Mesher&           mesher() { return *mesher_; }
+  const Transposer& transposer() const { return *transposer_; }
+  const ExCtrlWriteback& writeback() const { return *writeback_; }
+
+  // allow COMPUTE+PRELOAD overlap (defaults to kDefaultConfig.ex_overlap_preload)
+  void setPreloadOverlap(bool en) { preload_overlap_ = en; }
+
  private:
   ExCtrlCmdQueue* cmd_queue_    = nullptr;
   ExCtrlCompletion* completion_ = nullptr;
@@ -83,17 +110,24 @@ class ExCtrl : public Component {
   ExCtrlFeedSignals* feed_signals_ = nullptr;
   ExCtrlMeshCntlPack* mesh_cntl_pack_ = nullptr;
   ExCtrlMeshCntlQueue* mesh_cntl_queue_ = nullptr;
+  ExCtrlMeshCntlDeqCtrl* mesh_cntl_deq_ = nullptr;
+  ExCtrlMeshInSelPad* mesh_in_sel_pad_ = nullptr;
+  Mesher* mesher_ = nullptr;
+  Transposer* transposer_ = nullptr;
+  ExCtrlWriteback* writeback_ = nullptr;
   Output(bit, decoder_ex_read_from_acc_);
   Output(bit, decoder_ex_write_to_spad_);
-  Output(bit, mesh_cntl_pack_perform_mul_pre_);
-  Output(bit, tag_select_performing_single_mul_);
+  Output(bit, state_mul_pre_en_);
   Output(bit, im2col_wire_);
   Output(bit, im2col_en_);
   Output(bit, im2colling_);
-  Output(bit, mesh_cntl_deq_rdy_);
+  Output(u64, im2col_data_);
   Output(bit, cntl_rdy_);
-  OutputArray(MesherTag, decoder_tags_in_progress_, kRsExecuteEntries);
   Output(u32, row_addr_block_size_);
+  Output(u32, writeback_aligned_to_);
+  Output(bit, writeback_ex_write_to_acc_);
+
+  bool preload_overlap_ = kDefaultConfig.ex_overlap_preload;
 };
 
 } // namespace smesh
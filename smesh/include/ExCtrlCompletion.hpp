@@ -4,6 +4,12 @@
 // Sebastian Claudiusz Magierowski Jul 27 2026
 /*
 Execute-controller completion bookkeeping.
+
+One completion leaves per cycle. A tagged matmul finishing in the writeback
+wins the port; a CONFIG completion that collides with it is parked in a pending
+register and drained on the next free cycle. Commands the FSM retires without
+a mesh result (every COMPUTE, garbage-C PRELOADs) are always parked first. The
+FSM holds off new CONFIGs while anything is pending.
 */
 
 #pragma once
@@ -25,17 +31,25 @@ class ExCtrlCompletion : public Component {
   Input(bit, config_val);               // FSM accepted a CONFIG command
   Input(bit, config_rs_tag_valid);      // FSM cmd rs_tag_valid for CONFIG command
   Input(SmeshRsTag, config_rs_tag);     // FSM cmd rs_tag for CONFIG command
+  Input(bit, mesh_completed_val);       // writeback retired the last row of a tagged matmul
+  Input(SmeshRsTag, mesh_completed_bits);
+  InputArray(bit, ex_pending_val, 2);   // FSM retired up to two commands without a mesh result
+  InputArray(SmeshRsTag, ex_pending_bits, 2);
   Output(bit, completed_val);           // selected execute completion valid
   Output(SmeshRsTag, completed_bits);   // selected execute completion tag
   Output(bit, pending_completed_valid); // any pending completion register is occupied
 
   void updatePendingView();
-  void updateConfigCompletion();
+  void updateCompletion();
   void reset();
 
+  static constexpr std::size_t kPending = 4; // one operation's two retirements plus one waiting behind the mesh
+
  private:
-  bool pending_completed_valid_[2] = {false, false};
-  SmeshRsTag pending_completed_bits_[2] = {0, 0};
+  bool pending_completed_valid_[kPending] = {};
+  SmeshRsTag pending_completed_bits_[kPending] = {};
+
+  void park(SmeshRsTag tag);
 
   // TODO
   // complete_bits_count
@@ -4,6 +4,9 @@
 // Sebastian Claudiusz Magierowski Jul 29 2026
 /*
 Skeleton mesh input selection and padding for ExecuteController A/B/D feeds.
+spad_read_rdy/accum_read_rdy pop a bank's read response once the operand that
+was read from it enters Mesher; zero, garbage, padded and im2col rows read
+nothing and pop nothing.
 */
 
 #pragma once
@@ -45,6 +48,8 @@ class ExCtrlMeshInSelPad : public Component {
   Output(bit, mesh_a_fire);
   Output(bit, mesh_b_fire);
   Output(bit, mesh_d_fire);
+  OutputArray(bit, spad_read_rdy, kSpBanks);
+  OutputArray(bit, accum_read_rdy, kAccBanks);
 
   void update();
 };
@@ -4,6 +4,11 @@
 // Sebastian Claudiusz Magierowski Jul 28 2026
 /*
 Row-feed progress state for ExecuteController operand feeding.
+
+Each A/B/D stream counts its accepted row-beats modulo total_rows. A stream is
+done once it has wrapped; about_to_fire_all_rows rises in the cycle the last
+stream finishes, which is when the FSM retires the operation and the counters
+and started flags rearm for the next one.
 */
 
 #pragma once
@@ -45,6 +50,8 @@ class ExCtrlRowFeedState : public Component {
   Output(bit, about_to_fire_all_rows);// final row-beat for the active operation is about to fire
 
   void updateView();
+  void updateAboutToFire();
+  void updateState();
   void reset();
 
  private:
@@ -60,7 +67,7 @@ class ExCtrlRowFeedState : public Component {
   bool mul_pre_counter_lock_ = false;
   std::uint32_t preload_zero_counter_ = 0;
 
-  // TODO: use fire signals, total_rows, and a_addr_stride to update row-feed progress state.
+  bool allRowsFired(); // every stream has fed total_rows row-beats, counting this cycle's fires
 };
 
 } // namespace smesh
@@ -4,6 +4,16 @@
 // Sebastian Claudiusz Magierowski Jul 26 2026
 /*
 Central execute-controller FSM state holder.
+
+From WaitingForCmd the FSM takes, in priority order: a CONFIG, a standalone
+PRELOAD, a COMPUTE overlapped with the PRELOAD behind it (mul_pre), or a
+standalone COMPUTE. In mul_pre the next weights stream into the mesh's shadow
+C buffer on D while the current activations multiply against the live one, so
+a chain of WS matmuls costs one block of row-beats each instead of two.
+
+update() drives the row feed for the current mode from registered state;
+updateProgress() sees about_to_fire_all_rows, pops the command window and hands
+compute (and garbage-C preload) completions to ExCtrlCompletion.
 */
 
 #pragma once
@@ -13,6 +23,7 @@ Central execute-controller FSM state holder.
 #include "ExCtrlQueues.hpp"
 #include "ExCtrlDecoder.hpp"
 #include "SmeshCommand.hpp"
+#include "SmeshLocalAddr.hpp"
 #include "SmeshPorts.hpp"
 
 #include <cstdint>
@@ -43,6 +54,10 @@ class ExCtrlState : public Component {
   Input(bit, pending_completed_valid);                 // completion block has pending completions
   Input(bit, raw_hazards_are_impossible);              // no RAW hazards possible for this hardware config
   Input(bit, raw_hazard_pre);                          // PRELOAD branch has a RAW hazard
+  Input(bit, raw_hazard_mulpre);                       // COMPUTE+PRELOAD branch has a RAW hazard
+  Input(SmeshLocalAddr, c_address_rs2);                // C address of the PRELOAD in the window
+  Input(bit, about_to_fire_all_rows);                  // last row-beat of the current operation fires this cycle
+  Input(bit, mul_pre_en);                              // allow COMPUTE to overlap the following PRELOAD
   Input(bit, a_should_be_fed_into_transposer);         // decoder says A should start through transposer path
   Input(bit, b_should_be_fed_into_transposer);         // decoder says B should start through transposer path
   Input(bit, d_should_be_fed_into_transposer);         // decoder says D should start through transposer path
@@ -55,28 +70,31 @@ class ExCtrlState : public Component {
   Output(u32, a_addr_stride);       // CONFIG_EX A local-address stride
   Output(u32, c_addr_stride);       // CONFIG_EX C local-address stride
   Output(u8,  shift);               // CONFIG_EX in_shift register for mesh-control packets
+  Output(u8,  activation);          // CONFIG_EX activation register, applied to spad-bound results
+  Output(u8,  relu6_shift);         // CONFIG_EX ReLU6 shift register
   Output(bit, config_val);          // FSM accepts/processes a CONFIG command this cycle
   Output(bit, config_rs_tag_valid); // valid bit for CONFIG completion tag
   Output(SmeshRsTag, config_rs_tag);// info to send back on completed port
   Output(bit, performing_single_preload); // immediately signal standalone PRELOAD active (while latching perform_single_preload)
+  Output(bit, performing_mul_pre);  // COMPUTE overlapped with the next PRELOAD is active
+  Output(bit, performing_single_mul); // standalone COMPUTE is active
   Output(bit, computing);           // any execute operation mode is currently feeding rows
   Output(bit, start_inputting_a);   // begin feeding A operand rows
   Output(bit, start_inputting_b);   // begin feeding B operand rows
   Output(bit, start_inputting_d);   // begin feeding D/preload operand rows
   Output(bit, prop);                // mesh-control propagate value
   Output(u8, cmd_pop_count);        // number of command-window entries consumed this cycle
+  Output(u8, control_state);        // control_state register (ExCtrlFsmState) before this cycle's transition
+  OutputArray(bit, ex_pending_val, 2);        // operation retired this cycle with a completion that bypasses the mesh
+  OutputArray(SmeshRsTag, ex_pending_bits, 2);
 
   // TODO: add the remaining Gemmini-aligned FSM inputs as we use them:
-  // Input(bit, raw_hazard_mulpre);
   // Input(bit, third_instruction_needed);
-  // Input(bit, about_to_fire_all_rows);
-  // Input(u8, current_dataflow);
   // Input(bit, mesh_req_fire);
   // Input(bit, mesh_req_rdy);
-  // Output(bit, performing_mul_pre);
-  // Output(bit, performing_single_mul);
 
   void update();
+  void updateProgress();
   void reset();
 
  private:
@@ -86,21 +104,21 @@ class ExCtrlState : public Component {
   bool a_transpose_            = false;
   bool bd_transpose_           = false;
   bool perform_single_preload_ = false; // denote standalone PRELOAD mode
+  bool perform_mul_pre_        = false; // denote COMPUTE+PRELOAD mode
+  bool perform_single_mul_     = false; // denote standalone COMPUTE mode
+  bool was_computing_          = false; // state_ was Compute when update() ran this cycle
+  bool config_taken_           = false; // update() consumed a CONFIG this cycle
   bool in_prop_flush_          = false;
   std::uint8_t current_dataflow_ = kExDataflowWS;
   std::uint8_t in_shift_        = 0;
+  std::uint8_t activation_      = 0;
+  std::uint8_t relu6_shift_     = 0;
   std::uint32_t a_addr_stride_ = 1;
   std::uint32_t c_addr_stride_ = 1;
 
   // TODO: add later:
 
-  // command mode registers:
-  // perform_single_preload (done)
-  // perform_single_mul
-  // perform_mul_pre
-
   // programmed execution settings:
-  // activation
   // acc_scale
   // a_transpose
   // bd_transpose
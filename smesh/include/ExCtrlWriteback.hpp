@@ -3,11 +3,22 @@
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 30 2026
 /*
-Execute-controller writeback shell.
-
-This block will route mesh responses either toward scratchpad/accumulator
-writes or toward execute completion bookkeeping. For now it only establishes
-the hardware boundary and owns the output_counter state.
+Execute-controller writeback.
+
+Every Mesher response row is committed to the local memory named by its tag:
+row output_counter of a matmul lands at tag.addr + row * c_addr_stride (WS), or
+in reverse row order for OS, since OS results drain bottom row first. Rows past
+tag.rows and lanes past tag.cols are masked off, and garbage tags write nothing.
+
+Accumulator rows go out full width with the tag's accumulate bit intact, so
+Accum performs the read-modify-write add in place; a partial sum must stay
+linear, so the activation is left to the store path. Scratchpad rows are final:
+they go through the CONFIG_EX activation (None, ReLU or ReLU6; the I-GELU/I-EXP
+constants only exist on the store path, so ExCtrlState rejects I-GELU on
+CONFIG_EX) and are then saturated to the input width. The mesh response has no ready, so writes are
+never back-pressured (ArbWriteSpad/ArbWriteAccum give them top priority).
+
+The last row of a tagged matmul raises completed_val for the RS.
 */
 
 #pragma once
@@ -34,7 +45,8 @@ class ExCtrlWriteback : public Component {
 
   Input(u8, current_dataflow);         // execute dataflow config register
   Input(u32, c_addr_stride);           // C local-address stride from CONFIG_EX
-  Input(u8, activation);               // activation config, TODO: decode/apply
+  Input(u8, activation);               // CONFIG_EX activation, applied to spad-bound rows
+  Input(u8, relu6_shift);              // CONFIG_EX ReLU6 shift
   Input(u32, aligned_to);              // alignment setting used by output layout
   Input(bit, ex_write_to_spad);        // hardware config permits ExC writes to spad
   Input(bit, ex_write_to_acc);         // hardware config permits ExC writes to accumulator
@@ -48,17 +60,21 @@ class ExCtrlWriteback : public Component {
   OutputArray(DmaReadResp, accum_write_bits, kAccBanks);
 
   Output(u32, output_counter);         // current mesh-output row counter
-  Output(bit, start_array_outputting); // mesh output stream has begun
+  Output(bit, start_array_outputting); // a mesh output row is written this cycle
   Output(bit, mesh_completed_rs_tag_fire); // mesh response produced a completion event
   Output(bit, completed_val);          // execute completion valid
   Output(SmeshRsTag, completed_bits);  // execute completion tag
 
-  void updateView();
-  void updateState();
+  void update();
   void reset();
 
+  std::uint64_t spadRowsWritten() const { return spad_rows_written_; }
+  std::uint64_t accRowsWritten() const { return acc_rows_written_; }
+
  private:
   std::uint32_t output_counter_ = 0;
+  std::uint64_t spad_rows_written_ = 0;
+  std::uint64_t acc_rows_written_ = 0;
 };
 
 } // namespace smesh
@@ -41,18 +41,21 @@ class LdCtrl : public Component {
   std::uint32_t expectedBytes()     const { return expected_bytes_; }
   std::uint32_t returnedBytes()     const { return returned_bytes_; }
   SmeshRsTag responseRsTag()        const { return response_rs_tag_; }
+  std::uint32_t rowsInFlight()      const { return rows_in_flight_; }
 
  private:
   struct LoadConfigState {
     std::uint32_t dram_row_stride = 0;
     std::uint32_t ld_block_stride = 0;
+    std::uint32_t scale           = 0; // float32 mvin scale, 0 = identity
+    std::uint8_t  pixel_repeats   = 1; // local rows each DRAM row is repeated into
   };
 
   bool active_valid_        = false;  // whether LdCtrl has active command from RS
   SmeshIssue active_{};               // active command and its rs_tag from RS
   bool command_done_        = false;
   bool dma_response_valid_  = false;  // has a DMA completion response returned
-  bool request_in_flight_   = false;  // one DMA row request is outstanding
+  std::uint32_t rows_in_flight_ = 0;  // DMA row requests outstanding (up to kDmaMaxInflight)
   std::uint64_t base_vaddr_ = 0;
   SmeshLocalAddr base_laddr_{};
   std::uint32_t rows_ = 0;
@@ -60,6 +63,9 @@ class LdCtrl : public Component {
   std::uint32_t next_row_        = 0; // next row to issue to DMA
   std::uint32_t dram_row_stride_ = 0; // stride in bytes between rows in DRAM
   std::uint32_t ld_block_stride_ = 0; // stride in local rows between blocks of rows in local memory
+  std::uint32_t scale_           = 0; // mvin scale of the active command's load state
+  std::uint8_t  pixel_repeats_   = 1; // pixel_repeats of the active command's load state
+  bool acc_bitwidth_             = false; // rows are 32-bit accumulator words (full-width acc mvin)
   std::uint32_t expected_bytes_  = 0; // total bytes expected for active command
   std::uint32_t returned_bytes_  = 0; // total bytes returned for active command (accumulated across multiple DMA responses)
   SmeshRsTag response_rs_tag_    = 0; // RS tag from most recent DMA completion response (should match active_.rs_tag)
@@ -7,6 +7,21 @@ Plain C++ core systolic-array state model.
 
 This is not a Cascade component. Mesher will own this helper and call step
 methods once per simulated cycle.
+
+step() advances the grids in place (bottom row first) and runs each PE row's
+MAC and propagate as lane-masked vector kernels (AVX2/NEON when the build
+targets them, a plain loop otherwise).
+
+Each PE follows the dataflow carried by its control:
+  WS: c1/c2 hold weights; psums flow down B (out = b + a*w); D preloads the
+      idle weight set.
+  OS: acc1/acc2 hold int32 outputs in the PE; A flows LR, B (weights) flows
+      TB unchanged, and the active set accumulates a*b. The idle set is a
+      shift chain on the C path: each valid beat passes its old value down
+      (rounded >> shift on the first beat after a prop flip) and latches the
+      value from above. The bottom row of the C path is outC(), so a finished
+      tile drains bottom row first while D preloads the next tile's bias.
+  prop picks the set in use (WS weights: c2 if prop; OS accumulator: acc2 if prop).
 */
 
 #pragma once
@@ -21,7 +36,9 @@ namespace smesh {
 
 // PE control fields entering the systolic core.
 struct MeshCoreControl {
-  bool prop = false;
+  bool         prop     = false;
+  std::uint8_t dataflow = kExDataflowWS; // kExDataflowWS or kExDataflowOS
+  std::uint8_t shift    = 0;             // OS: results are rounded >> shift as they start draining
 };
 
 // Metadata/valid fields that flow with the PE control path, but are not PE control.
@@ -67,10 +84,16 @@ class MeshCore {
   const InputGrid&    dPath() const { return d_path_; }
   const CtrlGrid&     controlPath() const { return control_path_; }
   const StatusGrid&   statusPath() const { return status_path_; }
+  const AccumGrid&    acc1() const { return acc1_; }
+  const AccumGrid&    acc2() const { return acc2_; }
+  const AccumGrid&    cPath() const { return c_path_; }
   const MeshAccumRow& outB() const { return out_b_; }
+  const MeshAccumRow& outC() const { return out_c_; }
   const CtrlRow&      outBControl() const { return out_b_control_; }
   const StatusRow&    outBStatus() const { return out_b_status_; }
 
+  static Acc roundingShift(Acc value, unsigned shift); // value >> shift, rounded half to even
+
  private:
   InputGrid    c1_{};            // WS stationary weight register set 1
   InputGrid    c2_{};            // WS stationary weight register set 2
@@ -82,6 +105,24 @@ class MeshCore {
   MeshAccumRow out_b_{};         // bottom row emerging from B/out_b path
   CtrlRow      out_b_control_{}; // control emerging with out_b_
   StatusRow    out_b_status_{};  // status emerging with out_b_
+  AccumGrid    acc1_{};          // OS accumulator set 1
+  AccumGrid    acc2_{};          // OS accumulator set 2
+  AccumGrid    c_path_{};        // OS C/out_c vals moving TB: bias in, finished outputs out
+  MeshAccumRow out_c_{};         // bottom row emerging from the C path
+  InputGrid    last_prop_{};     // -1 where the PE's last valid beat had prop=1 (OS flip detect)
+
+  // valid/prop as lane masks, derived once at the top edge and flowing TB with status/control
+  struct LaneMasks {
+    MeshAccumRow keep{};  // -1 where the PE is valid and WS (B path)
+    MeshInputRow valid{}; // -1 where the PE is valid and WS (D path)
+    MeshInputRow live{};  // -1 where the PE is valid (either dataflow)
+    MeshInputRow prop{};  // -1 where control.prop
+    bool         any_ws = false;
+    bool         any_os = false;
+  };
+  std::array<LaneMasks, kDim> masks_{};
+
+  void stepOsRow(std::size_t r, const MeshCoreIn& in);
 };
 
 } // namespace smesh
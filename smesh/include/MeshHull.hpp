@@ -8,6 +8,25 @@ Timing wrapper around MeshCore.
 This is not a Cascade component. A later Mesher component can own this helper
 and connect it to valid/ready ports. MeshHull is where input/output skew and
 mesh-boundary timing belongs.
+
+Transaction-level mode (setTransactionLevel) skips the skews and MeshCore.
+Every PE sees a given input beat (the a/b/d buffers plus control/status of one
+step) at a different cycle, but in the same order relative to other beats, so
+the core is exactly a sequence of beats:
+  WS valid beat, prop p:  out = b + a * W   (W = c2 if p, else c1)
+                          other register set shifts down one row, d enters row 0
+  OS valid beat, prop p:  acc (acc2 if p, else acc1) += a (outer) b
+                          other set shifts down one row (rounded >> shift if p
+                          flipped), d enters row 0, out = its old bottom row
+and the beat's result reaches out() 2*(kDim-1) steps after it entered. The
+mode keeps c1/c2 and acc1/acc2 as row-rotated grids and the results in a delay
+queue of that length, so resp_valid/last/id match the full model every cycle
+and resp_data matches whenever resp_valid is set (invalid beats show zeros).
+No fallback is needed when prop flips mid-stream. core() is not advanced in
+this mode.
+
+resp_data is the B path (WS) or the C path (OS) per the beat's dataflow. An OS
+tile drains bottom row first.
 */
 
 #pragma once
@@ -54,6 +73,8 @@ class MeshHull {
   void reset();
   void step(const MeshHullIn& in);
   void loadC2ForTest(const MeshCore::InputGrid& weights);
+  void setTransactionLevel(bool en); // also resets the hull; the setting survives reset()
+  bool transactionLevel() const { return tl_; }
 
   const MeshHullOut& out() const { return out_; }
   const MeshCore& core() const { return core_; }
@@ -104,6 +125,10 @@ class MeshHull {
   }
 
   MeshAccumRow widenInputRow(const MeshInputRow& row) const;
+  void stepCore(const MeshHullIn& in, const MeshInputRow& a, const MeshAccumRow& b, const MeshInputRow& d);
+  void stepTransaction(const MeshHullIn& in, const MeshInputRow& a, const MeshAccumRow& b, const MeshInputRow& d);
+  void stepTransactionOs(bool prop, bool flip, std::uint8_t shift,
+                         const MeshInputRow& a, const MeshAccumRow& b, const MeshInputRow& d, MeshAccumRow& out);
 
   MeshCore core_{};          // Hull, contains Core systolic array
 
@@ -116,10 +141,27 @@ class MeshHull {
   SkewState<MeshCoreControl> control_skew_{}; // propagate control skewed
   SkewState<MeshCoreStatus>  status_skew_{};  // id/last/valid metadata skewed
 
-  SkewState<Acc>            out_b_skew_{};
-  SkewState<MeshCoreStatus> out_status_skew_{};
+  SkewState<Acc>             out_b_skew_{};
+  SkewState<Acc>             out_c_skew_{};
+  SkewState<MeshCoreControl> out_control_skew_{};
+  SkewState<MeshCoreStatus>  out_status_skew_{};
   
   MeshHullOut out_{};
+
+  // transaction-level state
+  static constexpr std::size_t kTlLatency = 2 * (kDim - 1); // beat enters -> result at out()
+  struct TlResult {
+    MeshAccumRow   data{};
+    MeshCoreStatus status{};
+  };
+  bool tl_ = kMeshTransactionLevel;
+  std::array<MeshCore::InputGrid, 2> tl_regs_{}; // [0] = c1, [1] = c2; row r lives at (r + tl_row0_) % kDim
+  std::array<std::size_t, 2>         tl_row0_{};
+  std::array<MeshCore::AccumGrid, 2> tl_acc_{};      // [0] = acc1, [1] = acc2; rotated like tl_regs_
+  std::array<std::size_t, 2>         tl_acc_row0_{};
+  bool                               tl_last_prop_ = false; // prop of the last valid beat (OS flip)
+  std::array<TlResult, kTlLatency + 1> tl_queue_{}; // results in flight, written at tl_head_
+  std::size_t                        tl_head_ = 0;
 };
 
 } // namespace smesh
@@ -53,9 +53,15 @@ class Mesher : public Component {
 
   OutputArray(MesherTag, tags_in_progress, kRsExecuteEntries);
 
+  void updateReady(); // req/a/b/d ready and tags from registered state
   void update();
   void reset();
 
+  // switch the hull between full systolic stepping and the transaction-level model (resets the hull)
+  void setTransactionLevel(bool en) { hull_.setTransactionLevel(en); }
+
+  std::uint64_t rowBeats() const { return row_beats_; } // non-flush row-beats that entered the mesh
+
  private:
   static constexpr std::size_t kTagQueueEntries = kMaxSimultaneousMatmuls + 1;
 
@@ -69,6 +75,16 @@ class Mesher : public Component {
     std::uint8_t  id         = 0;
   };
 
+  struct Readiness {
+    bool input_next_row = false; // a row-beat enters the mesh this cycle
+    bool last_fire      = false; // ... and it is the request's last
+    bool req = false;
+    bool a   = false;
+    bool b   = false;
+    bool d   = false;
+  };
+  Readiness readiness() const;
+
   ExCtrlMeshReq req_state_{};             // holds current request being processed
   bool          req_state_valid_ = false; // true if req_state_ is valid and being processed
   std::uint8_t  matmul_id_       = 0;     // id attached to rows entering the mesh for the active request
@@ -78,6 +94,7 @@ class Mesher : public Component {
   bool          b_written_       = false; // true once B input for current row-beat has been accepted
   bool          d_written_       = false; // true once D input for current row-beat has been accepted
   std::uint32_t fire_counter_    = 0;     // row-beats advanced into the mesh for current request
+  std::uint64_t row_beats_       = 0;     // lifetime row-beat count, for utilization reports
 
   std::array<TagQEntry, kTagQueueEntries>       tagq_{};             // tags indexed by mesh-local output id
   std::uint8_t                                  tagq_head_  = 0;
@@ -4,6 +4,9 @@
 // Sebastian Claudiusz Magierowski Jul 9 2026
 /*
 Route load-path write data to scratchpad or accumulator by local-address type.
+The router holds one row on the matching val/bits port until WriteCtrl takes
+it; only then does it pop the next row, so a full scratchpad or accumulator
+backs up into data_in and on to MvinPixelRepeater.
 */
 
 #pragma once
@@ -23,8 +26,6 @@ class MvinLocalRouter : public Component {
   Clock(clk);
 
   FifoInput(DmaReadResp, data_in);
-  FifoOutput(DmaReadResp, dmaread_spad);
-  FifoOutput(DmaReadResp, dmaread_accum);
   Output(bit, dmaread_spad_val);
   Output(DmaReadResp, dmaread_spad_bits);
   Input(bit, dmaread_spad_rdy);
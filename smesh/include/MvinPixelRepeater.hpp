@@ -3,7 +3,19 @@
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 6 2026
 /*
-Load-path pixel repetition stage. Only pixel_repeats=1 is currently supported.
+Load-path pixel repetition stage (Gemmini's convolution input reuse).
+
+A DRAM row of len lanes (one pixel's channels) bound for local row laddr with
+pixel_repeats = r is written r times: copy k (k = r-1 down to 0) lands in row
+laddr - k with its lanes and mask shifted up by k * len. Local row j so ends up
+holding pixels j, j+1, ..., j+r-1 side by side, each fetched from DRAM once.
+Copies that would fall below row 0 or start past the last lane are dropped.
+Only the final copy (k = 0, the row itself) keeps last and bytes_read, so the
+load still completes once per DRAM row.
+
+One copy leaves per cycle and the input row is popped with its last copy, so a
+backed-up MvinLocalRouter (data_out full) holds the repeater on its current
+copy. pixel_repeats of 0 or 1 is a plain pass-through.
 */
 
 #pragma once
@@ -12,6 +24,8 @@ Load-path pixel repetition stage. Only pixel_repeats=1 is currently supported.
 
 #include "SmeshPorts.hpp"
 
+#include <cstdint>
+
 namespace smesh {
 
 class MvinPixelRepeater : public Component {
@@ -26,6 +40,18 @@ class MvinPixelRepeater : public Component {
   FifoOutput(DmaReadResp, data_out);
 
   void update();
+  void reset();
+
+  std::uint64_t copies()  const { return copies_; }  // rows pushed, repeats included
+  std::uint64_t dropped() const { return dropped_; } // copies skipped below row 0 or past the last lane
+
+ private:
+  bool entry_valid_ = false;
+  DmaReadResp entry_{};
+  std::uint32_t repeat_ = 0; // copy k to push next, counting down to 0
+
+  std::uint64_t copies_  = 0;
+  std::uint64_t dropped_ = 0;
 };
 
 } // namespace smesh
@@ -3,7 +3,11 @@
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 6 2026
 /*
-Load-path scaling stage. Scaling is currently an identity operation.
+Load-path scaling stage. MvinScaleSplit sends accumulator-width rows (mvin of
+32-bit bias/partial-sum tiles into Accum) to MvinScaleAcc and everything else
+to MvinScale. Both multiply every lane by the row's DmaReadResp::scale (float32,
+0 = identity) with round-to-nearest-even and saturation, see Requantize.hpp.
+MvinScaleAcc holds its row on data_val/data_bits until WriteCtrl takes it.
 */
 
 #pragma once
@@ -37,7 +41,6 @@ class MvinScaleAcc : public Component {
   Clock(clk);
 
   FifoInput(DmaReadResp, data_in);
-  FifoOutput(DmaReadResp, data_out);
   Output(bit, data_val);
   Output(DmaReadResp, data_bits);
   Input(bit, data_rdy);
@@ -3,7 +3,32 @@
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 12 2026
 /*
-Accumulator normalization skeleton.
+Accumulator normalization stage (LayerNorm and softmax on mvout).
+
+Every accumulator row on the store path arrives here from StNormCtrl with the
+norm_cmd of its local address and the stats id CONFIG_NORM selected (there is
+one entry per 8-bit id, and StCtrl rejects an id past kNormStats). A row
+enters a latency()-stage reduction pipeline (req_rdy drops only when it is full
+and its last row cannot leave this cycle) and is handled in the last stage:
+
+  RESET       output row: forwarded on resp_* to StScaleCtrl
+  SUM         add the row's len lanes into the entry's sum, sum of squares and count
+  MEAN        SUM, then finalize mean
+  VARIANCE    SUM, then finalize mean and variance
+  INV_STDDEV  SUM, then finalize mean and 1/stddev
+  MAX         running max only
+  SUM_EXP     add I-EXP(x - max) of each lane into the entry's sum of exponentials
+  INV_SUM_EXP SUM_EXP, then finalize 1/sum of exponentials
+
+so a logical row wider than one mvout is reduced with SUM (or SUM_EXP) on its
+leading tiles and the finalizing command on its last. The first collecting
+command after a finalize starts the entry over. A stats-only row writes
+nothing, so the Normalizer acknowledges it on stats_done once it is reduced.
+
+An output row whose CONFIG_ST activation is LayerNorm leaves as x - mean with
+its acc_scale multiplied by 1/stddev; Softmax leaves as I-EXP(x - max) with its
+acc_scale multiplied by 1/sum of exponentials. AccScaleUnit's requantization
+then produces the normalized Elem row. Other activations pass through.
 */
 
 #pragma once
@@ -12,8 +37,23 @@ Accumulator normalization skeleton.
 
 #include "SmeshPorts.hpp"
 
+#include <array>
+#include <cstdint>
+
 namespace smesh {
 
+// norm_cmd, local_addr[28:26] of an mvout from the accumulator
+enum class NormCmd : std::uint8_t {
+  Reset      = 0,
+  Sum        = 1,
+  Mean       = 2,
+  Variance   = 3,
+  InvStddev  = 4,
+  Max        = 5,
+  SumExp     = 6,
+  InvSumExp  = 7,
+};
+
 class Normalizer : public Component {
   DECLARE_COMPONENT(Normalizer);
 
@@ -28,15 +68,63 @@ class Normalizer : public Component {
   Output(bit, resp_val);
   Input(bit, resp_rdy);
   Output(AccNormReq, resp_bits);
+  FifoOutput(DmaWriteResp, stats_done); // a stats-only mvout has been reduced
 
   void updateReady();
   void updateRespView();
-  void updateRespPop();
   void update();
+  void reset();
+
+  void setLatency(std::size_t n); // 1..kNormMaxLatency; change only while empty
+  std::size_t latency()   const { return latency_; }
+  std::size_t occupancy() const { return count_; }
+
+  // one stats entry, for testbenches
+  struct Stats {
+    std::int64_t  sum           = 0;
+    __int128      sum_sq        = 0;
+    std::uint32_t count         = 0;
+    Acc           max           = 0;
+    bool          max_valid     = false;
+    std::int64_t  sum_exp       = 0;
+    bool          moments_final = false; // MEAN/VARIANCE/INV_STDDEV ran
+    bool          exp_final     = false; // INV_SUM_EXP ran
+    Acc           mean          = 0;
+    double        variance      = 0.0;
+    float         inv_stddev    = 1.0f;
+    float         inv_sum_exp   = 1.0f;
+  };
+  const Stats& stats(std::size_t id) const { return stats_.at(id); }
+
+  // counters
+  std::uint64_t cycles()          const { return cycles_; }
+  std::uint64_t rows()            const { return rows_; }       // output rows forwarded
+  std::uint64_t statsRows()       const { return stats_rows_; } // stats-only rows reduced
+  std::uint64_t fullStallCycles() const { return full_stall_cycles_; } // a row was offered to a full pipeline
+  std::uint64_t outStallCycles()  const { return out_stall_cycles_; }  // the last stage waited on its consumer
+  double averageOccupancy() const { return cycles_ ? double(occupancy_sum_) / double(cycles_) : 0.0; }
 
  private:
-  bool resp_valid_ = false;
-  AccNormReq resp_entry_{};
+  struct Stage {
+    bool       valid = false;
+    AccNormReq req{};
+  };
+
+  void reduce(const AccNormReq& req);
+  AccNormReq normalize(const AccNormReq& req) const;
+
+  bool accepting_ = false; // a stage was free when req_rdy was driven
+  std::array<Stage, kNormMaxLatency> stages_{}; // stages_[latency_ - 1] is handled
+  std::array<Stats, kNormStats> stats_{};
+  std::size_t latency_ = kNormLatency;
+  std::size_t count_   = 0;
+
+  std::uint64_t cycles_            = 0;
+  std::uint64_t rows_              = 0;
+  std::uint64_t stats_rows_        = 0;
+  std::uint64_t full_stall_cycles_ = 0;
+  std::uint64_t out_stall_cycles_  = 0;
+  std::uint64_t occupancy_sum_     = 0;
 };
 
 } // namespace smesh
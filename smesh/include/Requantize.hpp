@@ -0,0 +1,56 @@
+// **********************************************************************
+// smesh/include/Requantize.hpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Aug 27 2026
+/*
+Accumulator-to-input requantization used by AccScaleUnit on mvout, and the
+mvin scale applied by MvinScale/MvinScaleAcc on load.
+
+Every lane is multiplied by a scale, rounded to nearest (ties to even) and
+saturated to the Elem range. The scale word is CONFIG_ST's acc_scale, either an
+IEEE float32 bit pattern (Gemmini's acc_scale) or an unsigned Q16.16 fixed-point
+multiplier. A zero word is the unprogrammed scale and means identity, so an
+un-configured store just narrows with saturation. A row carries one scale per
+output channel (lane); a zero channel word falls back to the row scale.
+
+The mvin scale is CONFIG_LD's scale word, always float32 with the same zero =
+identity rule; an input-width row saturates back to Elem, an accumulator-width
+(bias/partial-sum) row to Acc.
+*/
+#pragma once
+
+#include "SmeshTypes.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace smesh {
+
+enum class AccScaleFormat : std::uint8_t {
+  Float32 = 0, // acc_scale is an IEEE float32 bit pattern
+  Fixed16 = 1, // acc_scale is an unsigned Q16.16 multiplier
+};
+
+constexpr std::uint32_t kAccScaleIdentity  = 0;  // unprogrammed scale word: x1
+constexpr std::uint32_t kAccScaleFixedBits = 16; // fractional bits of a Fixed16 scale
+
+// float scale to its acc_scale word
+inline std::uint32_t accScaleFromFloat(float scale) {
+  std::uint32_t word = 0;
+  std::memcpy(&word, &scale, sizeof(word));
+  return word;
+}
+// acc_scale word (either format, 0 = identity) to the factor it multiplies by
+float accScaleToFloat(std::uint32_t scale, AccScaleFormat format);
+
+Elem requantize(Acc acc, std::uint32_t scale, AccScaleFormat format);
+// one row, all lanes: lane scale = channel_scale[lane] if nonzero, else row_scale
+MeshInputRow requantizeRow(const MeshAccumRow& row,
+                           std::uint32_t row_scale,
+                           const AccScaleRow& channel_scale,
+                           AccScaleFormat format);
+// mvin scale, all lanes of an input-width or accumulator-width load row
+MeshInputRow scaleInputRow(const MeshInputRow& row, std::uint32_t scale);
+MeshAccumRow scaleAccumRow(const MeshAccumRow& row, std::uint32_t scale);
+
+} // namespace smesh
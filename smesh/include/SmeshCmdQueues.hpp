@@ -4,14 +4,48 @@
 // Sebastian Claudiusz Magierowski Jul 10 2026
 /*
 Command-path queue components.
+
+SmeshUnrolledCmdQueue passes host commands through in order and unrolls two
+Gemmini-style hardware loops. LOOP_WS_CONFIG_* / LOOP_CONV_WS_CONFIG_* commands
+fill the next loop's registers (they may arrive while a loop is still unrolling);
+LOOP_WS or LOOP_CONV_WS then emits one command per cycle:
+
+  CONFIG_LD A, B, [D] DRAM strides; CONFIG_EX (WS, activation); [CONFIG_ST C stride, activation]
+  for each C tile:
+    [MVIN3 D -> acc slot]                      bias; else a conv clears the slot with
+                                               a garbage PRELOAD + COMPUTE_FLIP
+    for each k-step:
+      MVIN A, MVIN2 B -> spad half             A rows, then B rows
+      PRELOAD B -> acc slot, COMPUTE_FLIP A    accumulates after the first step (or bias/clear)
+    [MVOUT C <- acc slot]
+
+LOOP_WS: C = A * B (+ D) over I x J C tiles and K k-steps; trailing tiles shrink
+by the configured padding.
+LOOP_CONV_WS: conv2d as a matmul without a host im2col pass. A C tile is up to
+kDim output pixels along one output row x up to kDim output channels; a k-step is
+one kernel position x up to kDim input channels. Its A rows are the input pixels
+under that kernel tap, which sit conv-stride pixels apart in NHWC DRAM, so one
+strided MVIN gathers the patch rows straight from the input image. Output pixels
+whose tap falls in the zero padding are left out of the k-step (fewer rows,
+offset in the spad and acc slot), and a tap that misses the image entirely is
+skipped.
+
+Double buffering: the spad half flips every k-step (across tiles and loops) so
+step s+1's mvins land while step s computes, and C tiles alternate between two
+accumulator slots so a tile's mvout overlaps the next tile's computes. The RS
+holds back reuse of a half or slot (WAR) exactly as for a host-issued stream.
+Host commands behind a loop wait until it is fully unrolled.
 */
 
 #pragma once
 
 #include <cascade/Cascade.hpp>
 
+#include "SmeshCommand.hpp"
 #include "SmeshPorts.hpp"
 
+#include <cstdint>
+
 namespace smesh {
 
 class SmeshCmdQueue : public Component {
@@ -43,6 +77,106 @@ class SmeshUnrolledCmdQueue : public Component {
   FifoOutput(SmeshCmd, cmd_out);
 
   void update();
+  void reset();
+
+  bool loopActive() const { return phase_ != LoopPhase::Idle; }
+  std::uint64_t loops() const { return loops_; }                   // LOOP_WS / LOOP_CONV_WS commands started
+  std::uint64_t convLoops() const { return conv_loops_; }          // of which LOOP_CONV_WS
+  std::uint64_t loopCmdsIn() const { return loop_cmds_in_; }       // loop commands absorbed
+  std::uint64_t loopCmdsOut() const { return loop_cmds_out_; }     // commands generated by the unroller
+  std::uint64_t skippedSteps() const { return skipped_steps_; }    // conv k-steps entirely in the padding
+  std::uint64_t passedThrough() const { return passed_through_; }  // host commands forwarded as-is
+  std::uint64_t outStallCycles() const { return out_stall_cycles_; } // unroller had a command but cmd_out was full
+
+ private:
+  enum class LoopKind : std::uint8_t { Ws, Conv };
+  enum class LoopPhase : std::uint8_t { Idle, Config, ClearPreload, ClearCompute, Bias, LoadA, LoadB, Preload, Compute, Store };
+
+  struct LoopWsRegs {
+    LoopWsBounds tiles{}; // I, J, K in kDim tiles
+    LoopWsBounds pad{};   // rows/cols missing from the last tile along I, J, K
+    std::uint64_t a_addr   = 0;
+    std::uint64_t b_addr   = 0;
+    std::uint64_t d_addr   = 0; // 0: no bias
+    std::uint64_t c_addr   = 0; // 0: leave C in the accumulator
+    std::uint64_t a_stride = 0; // DRAM row strides in bytes
+    std::uint64_t b_stride = 0;
+    std::uint64_t d_stride = 0;
+    std::uint64_t c_stride = 0;
+  };
+
+  struct LoopConvRegs {
+    LoopConvDims   dims{};
+    LoopConvKernel kernel{};
+    std::uint32_t  out_dim = 0;
+    std::uint64_t  weights = 0;
+    std::uint64_t  output  = 0; // 0: leave C in the accumulator
+    std::uint64_t  bias    = 0; // 0: no bias
+    std::uint64_t  input   = 0;
+  };
+
+  struct LoopTile { // C tile geometry
+    std::uint64_t d_addr = 0;
+    std::uint64_t c_addr = 0;
+    std::size_t   rows   = 0;
+    std::size_t   cols   = 0;
+  };
+
+  struct LoopConvPos { // C tile position in a conv loop
+    std::uint32_t batch = 0;
+    std::uint32_t orow  = 0;
+    std::uint32_t ocol0 = 0;
+    std::uint32_t och0  = 0;
+  };
+
+  struct LoopStep { // k-step geometry; rows [row_off, row_off + rows) of the tile take part
+    std::uint64_t a_addr  = 0;
+    std::uint64_t b_addr  = 0;
+    std::uint32_t row_off = 0;
+    std::size_t   rows    = 0;
+    std::size_t   k       = 0;
+  };
+
+  void configureLoop(const SmeshCmd& cmd);           // loop config commands -> next_ws_/next_conv_
+  void startLoop(LoopKind kind, const SmeshCmd& cmd); // latch the next loop's registers and begin unrolling
+  SmeshCmd loopCmd() const;                          // command for the current unroller state
+  void advanceLoop();                                // step past the command just emitted
+  void beginTile();
+  void nextStep();                                   // first non-empty k-step at or after step_idx_, else the tile's end
+  void endTile();
+  bool configStepUsed(std::uint32_t step) const;
+  bool hasBias() const;
+  bool hasStore() const;
+  LoopConvPos convPos() const;
+  LoopTile tileGeom() const;
+  bool stepGeom(LoopStep& step) const;               // false: the k-step has no rows
+
+  LoopWsRegs    next_ws_{};
+  LoopConvRegs  next_conv_{};
+  LoopWsRegs    ws_{};
+  LoopConvRegs  conv_{};
+  LoopKind      kind_        = LoopKind::Ws;
+  LoopPhase     phase_       = LoopPhase::Idle;
+  std::uint32_t activation_  = 0;
+  bool          full_c_      = true;
+  bool          low_d_       = false;
+  std::uint32_t config_step_ = 0;
+  std::uint64_t num_tiles_   = 0;
+  std::uint64_t num_steps_   = 0; // k-steps per C tile
+  std::uint64_t tile_idx_    = 0;
+  std::uint64_t step_idx_    = 0;
+  bool          tile_init_   = false; // acc slot holds bias/zeros or an earlier step's psum
+  LoopStep      step_{};
+  std::uint64_t steps_done_ = 0; // k-steps unrolled so far; selects the spad half
+  std::uint64_t tiles_done_ = 0; // C tiles unrolled so far; selects the accumulator slot
+
+  std::uint64_t loops_            = 0;
+  std::uint64_t conv_loops_       = 0;
+  std::uint64_t loop_cmds_in_     = 0;
+  std::uint64_t loop_cmds_out_    = 0;
+  std::uint64_t skipped_steps_    = 0;
+  std::uint64_t passed_through_   = 0;
+  std::uint64_t out_stall_cycles_ = 0;
 };
 
 } // namespace smesh
@@ -23,7 +23,18 @@ enum class SmeshFunct : std::uint32_t {
   ComputeStay =  5,
   Preload     =  6,
   Flush       =  7,
+  LoopWs                =  8,
+  LoopWsConfigBounds    =  9,
+  LoopWsConfigAddrsAB   = 10,
+  LoopWsConfigAddrsDC   = 11,
+  LoopWsConfigStridesAB = 12,
+  LoopWsConfigStridesDC = 13,
   Mvin3       = 14,
+  LoopConvWs              = 15,
+  LoopConvWsConfigDims    = 16,
+  LoopConvWsConfigKernel  = 17,
+  LoopConvWsConfigAddrsWO = 18,
+  LoopConvWsConfigAddrsBI = 19,
   StoreSpad   = 23,
 };
 
@@ -32,6 +43,7 @@ enum class ConfigKind : std::uint32_t {
   Execute = 0,
   Load = 1,
   Store = 2,
+  Norm = 3,  // CONFIG_NORM: I-GELU/I-EXP constants and the norm stats id, runs on the store queue
 };
 
 // Represents a local matrix in the SPAD.  This is used for passing matrix location and shape information in the rs1/rs2 fields of commands.
@@ -72,8 +84,10 @@ inline LocalMatrix unpackLocal(std::uint64_t packed) {
 
 // bit encoding of CONFIG commands
 constexpr std::uint32_t kConfigStateIdShift             =  3;
+constexpr std::uint32_t kConfigLoadPixelRepeatsShift    =  8;
 constexpr std::uint32_t kConfigLoadBlockStrideShift     = 16;
 constexpr std::uint64_t kConfigLoadBlockStrideMask      = 0xffffull;
+constexpr std::uint32_t kConfigLoadScaleShift           = 32;
 constexpr std::uint32_t kConfigExecuteDataflowBit       =  2;
 constexpr std::uint32_t kConfigExecuteActivationShift   =  3;
 constexpr std::uint32_t kConfigExecuteSetOnlyStridesBit =  7;
@@ -84,12 +98,19 @@ constexpr std::uint32_t kConfigExecuteAccScaleShift     = 32;
 constexpr std::uint32_t kConfigExecuteCStrideShift      =  0;
 constexpr std::uint32_t kConfigExecuteRelu6ShiftShift   = 16;
 constexpr std::uint32_t kConfigExecuteInShiftShift      = 32;
-// Packs rs1 for generic CONFIG commands; CONFIG_EX uses packConfigExecuteRs1/rs2
-inline std::uint64_t packConfig(ConfigKind kind, std::uint32_t state_id = 0, std::uint32_t ld_block_stride = 0) {
+// Packs rs1 for generic CONFIG commands; CONFIG_EX uses packConfigExecuteRs1/rs2.
+// CONFIG_LD's rs1[15:8] is pixel_repeats (0 = 1) and rs1[63:32] the float32 mvin scale (0 = identity)
+inline std::uint64_t packConfig(ConfigKind kind,
+                                std::uint32_t state_id         = 0,
+                                std::uint32_t ld_block_stride  = 0,
+                                std::uint32_t ld_scale         = 0,
+                                std::uint32_t ld_pixel_repeats = 0) {
   return static_cast<std::uint64_t>(kind) |
          (static_cast<std::uint64_t>(state_id & 0x3u) << kConfigStateIdShift) |
+         (static_cast<std::uint64_t>(ld_pixel_repeats & 0xffu) << kConfigLoadPixelRepeatsShift) |
          ((static_cast<std::uint64_t>(ld_block_stride) & kConfigLoadBlockStrideMask)
-          << kConfigLoadBlockStrideShift);
+          << kConfigLoadBlockStrideShift) |
+         (static_cast<std::uint64_t>(ld_scale) << kConfigLoadScaleShift);
 }
 // Extracts the generic CONFIG state selector from rs1
 inline std::uint32_t unpackConfigStateId(std::uint64_t rs1) {
@@ -99,6 +120,14 @@ inline std::uint32_t unpackConfigStateId(std::uint64_t rs1) {
 inline std::uint32_t unpackConfigLoadBlockStride(std::uint64_t rs1) {
   return static_cast<std::uint32_t>((rs1 >> kConfigLoadBlockStrideShift) & kConfigLoadBlockStrideMask);
 }
+// Extracts CONFIG_LD rs1[15:8], the pixel_repeats MvinPixelRepeater applies (0 means 1)
+inline std::uint32_t unpackConfigLoadPixelRepeats(std::uint64_t rs1) {
+  return static_cast<std::uint32_t>((rs1 >> kConfigLoadPixelRepeatsShift) & 0xffu);
+}
+// Extracts CONFIG_LD rs1[63:32], the mvin scale applied by MvinScale/MvinScaleAcc
+inline std::uint32_t unpackConfigLoadScale(std::uint64_t rs1) {
+  return static_cast<std::uint32_t>((rs1 >> kConfigLoadScaleShift) & 0xffffffffull);
+}
 
 inline std::uint64_t packConfigExecuteRs1(std::uint32_t a_stride,
                                           bool a_transpose         = false,
@@ -164,6 +193,106 @@ inline std::uint32_t unpackConfigExecuteRelu6Shift(std::uint64_t rs2) {
 inline std::uint32_t unpackConfigExecuteInShift(std::uint64_t rs2) {
   return static_cast<std::uint32_t>((rs2 >> kConfigExecuteInShiftShift) & 0xffffffffull);
 }
+
+// CONFIG_ST: rs1[4:2] activation, rs1[6] acc_scale is Q16.16 (else float32), rs1[15:8] ReLU6 shift,
+// rs1[63:32] acc_scale; rs2 = DRAM stride. With rs1[5] set it only loads output channel
+// rs1[23:16]'s acc_scale (0 = use the row scale); a plain CONFIG_ST clears the channel scales.
+constexpr std::uint32_t kConfigStoreActivationShift   = 2;
+constexpr std::uint32_t kConfigStoreChannelScaleBit   = 5;
+constexpr std::uint32_t kConfigStoreFixedScaleBit     = 6;
+constexpr std::uint32_t kConfigStoreRelu6ShiftShift   = 8;
+constexpr std::uint32_t kConfigStoreChannelShift      = 16;
+constexpr std::uint32_t kConfigStoreAccScaleShift     = 32;
+// CONFIG_NORM (Gemmini layout): rs1[15:8] stats id, rs1[17] set only the stats id,
+// rs1[18] q_const type (0: I-EXP qln2, 1: I-EXP qln2_inv), rs1[63:32] q_const;
+// rs2[63:32] I-GELU/I-EXP qb, rs2[31:0] qc
+constexpr std::uint32_t kConfigNormStatsIdShift       =  8;
+constexpr std::uint32_t kConfigNormSetStatsIdOnlyBit  = 17;
+constexpr std::uint32_t kConfigNormQConstTypeBit      = 18;
+constexpr std::uint32_t kConfigNormQConstShift        = 32;
+constexpr std::uint32_t kConfigNormQbShift            = 32;
+
+inline std::uint64_t packConfigStoreRs1(std::uint32_t activation  = 0,
+                                        std::uint32_t relu6_shift = 0,
+                                        std::uint32_t acc_scale   = 0,
+                                        bool fixed_scale          = false) {
+  return static_cast<std::uint64_t>(ConfigKind::Store) |
+         (static_cast<std::uint64_t>(activation & 0x7u) << kConfigStoreActivationShift) |
+         (static_cast<std::uint64_t>(fixed_scale) << kConfigStoreFixedScaleBit) |
+         (static_cast<std::uint64_t>(relu6_shift & 0xffu) << kConfigStoreRelu6ShiftShift) |
+         (static_cast<std::uint64_t>(acc_scale) << kConfigStoreAccScaleShift);
+}
+// CONFIG_ST that only loads one output channel's acc_scale
+inline std::uint64_t packConfigStoreChannelScaleRs1(std::uint32_t channel, std::uint32_t acc_scale) {
+  return static_cast<std::uint64_t>(ConfigKind::Store) |
+         (std::uint64_t{1} << kConfigStoreChannelScaleBit) |
+         (static_cast<std::uint64_t>(channel & 0xffu) << kConfigStoreChannelShift) |
+         (static_cast<std::uint64_t>(acc_scale) << kConfigStoreAccScaleShift);
+}
+// Extracts CONFIG_ST rs1[5], set when the command only loads a channel scale
+inline bool unpackConfigStoreChannelScale(std::uint64_t rs1) {
+  return ((rs1 >> kConfigStoreChannelScaleBit) & 0x1u) != 0;
+}
+// Extracts CONFIG_ST rs1[6], set when acc_scale is Q16.16 fixed point
+inline bool unpackConfigStoreFixedScale(std::uint64_t rs1) {
+  return ((rs1 >> kConfigStoreFixedScaleBit) & 0x1u) != 0;
+}
+// Extracts CONFIG_ST rs1[23:16], the output channel a channel-scale CONFIG_ST loads
+inline std::uint32_t unpackConfigStoreChannel(std::uint64_t rs1) {
+  return static_cast<std::uint32_t>((rs1 >> kConfigStoreChannelShift) & 0xffu);
+}
+// Extracts CONFIG_ST rs1[4:2], the store-path activation selector
+inline std::uint32_t unpackConfigStoreActivation(std::uint64_t rs1) {
+  return static_cast<std::uint32_t>((rs1 >> kConfigStoreActivationShift) & 0x7u);
+}
+// Extracts CONFIG_ST rs1[15:8], the store-path ReLU6 shift
+inline std::uint32_t unpackConfigStoreRelu6Shift(std::uint64_t rs1) {
+  return static_cast<std::uint32_t>((rs1 >> kConfigStoreRelu6ShiftShift) & 0xffu);
+}
+// Extracts CONFIG_ST rs1[63:32], the accumulator scale applied on mvout
+inline std::uint32_t unpackConfigStoreAccScale(std::uint64_t rs1) {
+  return static_cast<std::uint32_t>((rs1 >> kConfigStoreAccScaleShift) & 0xffffffffull);
+}
+
+inline std::uint64_t packConfigNormRs1(std::uint32_t q_const      = 0,
+                                       bool q_const_is_inv        = false,
+                                       std::uint32_t stats_id     = 0,
+                                       bool set_stats_id_only     = false) {
+  return static_cast<std::uint64_t>(ConfigKind::Norm) |
+         (static_cast<std::uint64_t>(stats_id & 0xffu) << kConfigNormStatsIdShift) |
+         (static_cast<std::uint64_t>(set_stats_id_only) << kConfigNormSetStatsIdOnlyBit) |
+         (static_cast<std::uint64_t>(q_const_is_inv) << kConfigNormQConstTypeBit) |
+         (static_cast<std::uint64_t>(q_const) << kConfigNormQConstShift);
+}
+
+inline std::uint64_t packConfigNormRs2(std::int32_t qb, std::int32_t qc) {
+  return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(qb)) << kConfigNormQbShift) |
+         static_cast<std::uint64_t>(static_cast<std::uint32_t>(qc));
+}
+// Extracts CONFIG_NORM rs1[15:8], the normalizer stats id
+inline std::uint32_t unpackConfigNormStatsId(std::uint64_t rs1) {
+  return static_cast<std::uint32_t>((rs1 >> kConfigNormStatsIdShift) & 0xffu);
+}
+// Extracts CONFIG_NORM rs1[17], which limits CONFIG_NORM to the stats id
+inline bool unpackConfigNormSetStatsIdOnly(std::uint64_t rs1) {
+  return ((rs1 >> kConfigNormSetStatsIdOnlyBit) & 0x1u) != 0;
+}
+// Extracts CONFIG_NORM rs1[18], set when q_const is qln2_inv rather than qln2
+inline bool unpackConfigNormQConstIsInv(std::uint64_t rs1) {
+  return ((rs1 >> kConfigNormQConstTypeBit) & 0x1u) != 0;
+}
+// Extracts CONFIG_NORM rs1[63:32], the I-EXP range-reduction constant
+inline std::uint32_t unpackConfigNormQConst(std::uint64_t rs1) {
+  return static_cast<std::uint32_t>((rs1 >> kConfigNormQConstShift) & 0xffffffffull);
+}
+// Extracts CONFIG_NORM rs2[63:32], the I-GELU/I-EXP polynomial qb
+inline std::int32_t unpackConfigNormQb(std::uint64_t rs2) {
+  return static_cast<std::int32_t>(static_cast<std::uint32_t>(rs2 >> kConfigNormQbShift));
+}
+// Extracts CONFIG_NORM rs2[31:0], the I-GELU/I-EXP polynomial qc
+inline std::int32_t unpackConfigNormQc(std::uint64_t rs2) {
+  return static_cast<std::int32_t>(static_cast<std::uint32_t>(rs2 & 0xffffffffull));
+}
 // Packs STORE_SPAD destination metadata: local address plus stride
 inline std::uint64_t packStoreSpadDestination(std::uint32_t local_addr, std::uint32_t stride = 1) {
   return (static_cast<std::uint64_t>(stride) << 32) | local_addr;
@@ -177,4 +306,113 @@ inline std::uint32_t unpackStoreSpadDestinationStride(std::uint64_t rs1) {
   return static_cast<std::uint32_t>(rs1 >> 32);
 }
 
+// LOOP_WS commands (Gemmini layout), consumed by SmeshUnrolledCmdQueue:
+// LOOP_WS_CONFIG_BOUNDS   rs1 = trailing-tile padding, rs2 = tile counts, both packLoopWsBounds()
+// LOOP_WS_CONFIG_ADDRS_AB rs1 = A DRAM addr, rs2 = B DRAM addr
+// LOOP_WS_CONFIG_ADDRS_DC rs1 = D DRAM addr (0: no bias), rs2 = C DRAM addr (0: no mvout)
+// LOOP_WS_CONFIG_STRIDES_AB/DC rs1/rs2 = DRAM row strides in bytes
+// LOOP_WS                 rs1 = packLoopWsRs1(), starts the loop
+constexpr std::uint32_t kLoopWsBoundJShift     = 16;
+constexpr std::uint32_t kLoopWsBoundKShift     = 32;
+constexpr std::uint32_t kLoopWsFullCBit        =  1;
+constexpr std::uint32_t kLoopWsLowDBit         =  2;
+constexpr std::uint32_t kLoopWsActivationShift =  8;
+
+struct LoopWsBounds {
+  std::uint32_t i = 0;
+  std::uint32_t j = 0;
+  std::uint32_t k = 0;
+};
+// Packs an I/J/K triple: bits [15:0] I, [31:16] J, [47:32] K
+inline std::uint64_t packLoopWsBounds(std::uint32_t i, std::uint32_t j, std::uint32_t k) {
+  return (static_cast<std::uint64_t>(k & 0xffffu) << kLoopWsBoundKShift) |
+         (static_cast<std::uint64_t>(j & 0xffffu) << kLoopWsBoundJShift) |
+         static_cast<std::uint64_t>(i & 0xffffu);
+}
+
+inline LoopWsBounds unpackLoopWsBounds(std::uint64_t packed) {
+  return LoopWsBounds{
+      static_cast<std::uint32_t>(packed & 0xffffu),
+      static_cast<std::uint32_t>((packed >> kLoopWsBoundJShift) & 0xffffu),
+      static_cast<std::uint32_t>((packed >> kLoopWsBoundKShift) & 0xffffu),
+  };
+}
+// Packs LOOP_WS rs1: full_C mvouts full accumulator rows, low_D reads bias as Elem instead of Acc
+inline std::uint64_t packLoopWsRs1(std::uint32_t activation = 0, bool full_c = true, bool low_d = false) {
+  return (static_cast<std::uint64_t>(activation & 0x3u) << kLoopWsActivationShift) |
+         (static_cast<std::uint64_t>(low_d) << kLoopWsLowDBit) |
+         (static_cast<std::uint64_t>(full_c) << kLoopWsFullCBit);
+}
+// Extracts LOOP_WS rs1[9:8], the activation forwarded through CONFIG_EX
+inline std::uint32_t unpackLoopWsActivation(std::uint64_t rs1) {
+  return static_cast<std::uint32_t>((rs1 >> kLoopWsActivationShift) & 0x3u);
+}
+// Extracts LOOP_WS rs1[1], full-width C mvout
+inline bool unpackLoopWsFullC(std::uint64_t rs1) {
+  return ((rs1 >> kLoopWsFullCBit) & 0x1u) != 0;
+}
+// Extracts LOOP_WS rs1[2], Elem-width bias
+inline bool unpackLoopWsLowD(std::uint64_t rs1) {
+  return ((rs1 >> kLoopWsLowDBit) & 0x1u) != 0;
+}
+// Is this one of the LOOP_WS commands the unroller consumes?
+inline bool isLoopWsFunct(SmeshFunct funct) {
+  return funct >= SmeshFunct::LoopWs && funct <= SmeshFunct::LoopWsConfigStridesDC;
+}
+
+// LOOP_CONV_WS commands, consumed by SmeshUnrolledCmdQueue. Square images and
+// kernels; NHWC Elem input, HWIO Elem weights, one Acc bias per output channel,
+// NHWC output (Acc with full_C):
+// LOOP_CONV_WS_CONFIG_DIMS     rs1 = packLoopConvDims(), rs2 = output image dim
+// LOOP_CONV_WS_CONFIG_KERNEL   rs1 = packLoopConvKernel()
+// LOOP_CONV_WS_CONFIG_ADDRS_WO rs1 = weights DRAM addr, rs2 = output DRAM addr (0: no mvout)
+// LOOP_CONV_WS_CONFIG_ADDRS_BI rs1 = bias DRAM addr (0: no bias), rs2 = input DRAM addr
+// LOOP_CONV_WS                 rs1 = packLoopWsRs1() (same activation/full_C/low_D bits), starts the loop
+struct LoopConvDims {
+  std::uint32_t batch        = 0;
+  std::uint32_t in_dim       = 0;
+  std::uint32_t in_channels  = 0;
+  std::uint32_t out_channels = 0;
+};
+
+struct LoopConvKernel {
+  std::uint32_t kernel_dim = 0;
+  std::uint32_t stride     = 1;
+  std::uint32_t padding    = 0;
+  std::uint32_t dilation   = 1;
+};
+// Packs four 16-bit fields, f0 in bits [15:0]
+inline std::uint64_t packLoopConvFields(std::uint32_t f0, std::uint32_t f1, std::uint32_t f2, std::uint32_t f3) {
+  return (static_cast<std::uint64_t>(f3 & 0xffffu) << 48) |
+         (static_cast<std::uint64_t>(f2 & 0xffffu) << 32) |
+         (static_cast<std::uint64_t>(f1 & 0xffffu) << 16) |
+         static_cast<std::uint64_t>(f0 & 0xffffu);
+}
+
+inline std::uint32_t unpackLoopConvField(std::uint64_t packed, std::uint32_t index) {
+  return static_cast<std::uint32_t>((packed >> (16 * index)) & 0xffffu);
+}
+
+inline std::uint64_t packLoopConvDims(const LoopConvDims& dims) {
+  return packLoopConvFields(dims.batch, dims.in_dim, dims.in_channels, dims.out_channels);
+}
+
+inline LoopConvDims unpackLoopConvDims(std::uint64_t rs1) {
+  return LoopConvDims{unpackLoopConvField(rs1, 0), unpackLoopConvField(rs1, 1),
+                      unpackLoopConvField(rs1, 2), unpackLoopConvField(rs1, 3)};
+}
+
+inline std::uint64_t packLoopConvKernel(const LoopConvKernel& kernel) {
+  return packLoopConvFields(kernel.kernel_dim, kernel.stride, kernel.padding, kernel.dilation);
+}
+
+inline LoopConvKernel unpackLoopConvKernel(std::uint64_t rs1) {
+  return LoopConvKernel{unpackLoopConvField(rs1, 0), unpackLoopConvField(rs1, 1),
+                        unpackLoopConvField(rs1, 2), unpackLoopConvField(rs1, 3)};
+}
+// Is this one of the LOOP_CONV_WS commands the unroller consumes?
+inline bool isLoopConvFunct(SmeshFunct funct) {
+  return funct >= SmeshFunct::LoopConvWs && funct <= SmeshFunct::LoopConvWsConfigAddrsBI;
+}
+
 } // namespace smesh
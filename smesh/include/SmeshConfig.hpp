@@ -13,10 +13,15 @@ until there is code which consumes them.
 
 #include <cstddef>
 
+// mesh width; a standalone build can widen it (tb_mesh_core_wide uses 16 to run the 8-lane row kernels)
+#ifndef SMESH_DIM
+#define SMESH_DIM 4
+#endif
+
 namespace smesh {
 
 struct SmeshConfig {
-  std::size_t dim = 4;
+  std::size_t dim = SMESH_DIM;
 
   std::size_t sp_banks      =  4;
   std::size_t sp_bank_rows  =  4;
@@ -29,15 +34,24 @@ struct SmeshConfig {
   std::size_t elem_bits     =  8;
   std::size_t acc_bits      = 32;
   std::size_t dma_max_bytes = 64;
+  std::size_t dma_max_inflight = 4; // DmaReader outstanding row reads (reorder-buffer slots)
+  std::size_t acc_scale_latency     = 1; // AccScaleUnit pipeline stages
+  std::size_t acc_scale_max_latency = 8; // ceiling for AccScaleUnit::setLatency
+  std::size_t norm_latency          = 3; // Normalizer reduction pipeline stages
+  std::size_t norm_max_latency      = 8; // ceiling for Normalizer::setLatency
+  std::size_t norm_stats            = 256; // Normalizer stats entries: one per 8-bit CONFIG_NORM stats id
 
   std::size_t rs_load_entries    = 2;
   std::size_t rs_execute_entries = 2;
   std::size_t rs_store_entries   = 2;
+  std::size_t rs_max_entries     = 64; // ceiling for SmeshRS::setEntries (one bit per row in an RS mask)
   std::size_t ex_queue_length    = 8; // ExCtrl cmd q len
   std::size_t max_simultaneous_matmuls = 5; // set counter size in Mesher logic
+  bool mesh_transaction_level = false; // MeshHull computes row results directly instead of stepping MeshCore
 
   bool ex_read_from_acc = true;  // true: ExCtrl reads from accum when local addr says accum
   bool ex_write_to_spad = true;
+  bool ex_overlap_preload = true; // ExCtrl streams the next PRELOAD in alongside a COMPUTE (mul_pre)
 };
 
 constexpr SmeshConfig kDefaultConfig{};
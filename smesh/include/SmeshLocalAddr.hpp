@@ -142,6 +142,12 @@ constexpr SmeshLocalAddr makeAccAddr(std::uint32_t full_acc_addr, bool do_accumu
       ((norm_cmd & 0x7u) << kLocalAddrNormShift)}; // encoded accumulator address
 }
 
+// makes the invalid/padding address (garbage operand, e.g. WS compute with no D)
+constexpr SmeshLocalAddr makeGarbageAddr() {
+  return SmeshLocalAddr{kLocalAddrDataMask | kLocalAddrGarbageMask | kLocalAddrIsAccMask |
+                        kLocalAddrAccumulateMask | kLocalAddrReadFullAccRowMask};
+}
+
 // Calculate address and overflow together, wrapping at the selected local
 // memory size while preserving metadata.
 constexpr SmeshLocalAddrAddResult add_with_overflow(SmeshLocalAddr addr, std::uint32_t offset) {
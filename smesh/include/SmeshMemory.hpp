@@ -4,50 +4,65 @@
 // Sebastian Claudiusz Magierowski Apr 26 2026
 /*
 Tiny fake host memory.
+
+Bytes live in 4 KiB pages allocated on first write; a page that was never
+written reads as zero. Bulk read/write and readRow/writeRow copy a whole row
+per call (page by page), so mvin/mvout do one page lookup per row rather than
+one tree lookup per byte. Acc values are little-endian.
 */
 #pragma once
 
 #include "SmeshTypes.hpp"
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <map>
+#include <memory>
+#include <unordered_map>
 
 namespace smesh {
 
 class SmeshMemory {
  public:
-  void reset() { bytes_.clear(); }
+  static constexpr std::uint64_t kPageBytes = 4096;
 
-  void writeElem(std::uint64_t addr, Elem value) {
-    bytes_[addr] = static_cast<std::uint8_t>(value);
-  }
+  void reset();
 
-  Elem readElem(std::uint64_t addr) const {
-    return static_cast<Elem>(readByte(addr));
-  }
+  // raw byte copies; [addr, addr+bytes) may span pages
+  void write(std::uint64_t addr, const void* src, std::size_t bytes);
+  void read(std::uint64_t addr, void* dst, std::size_t bytes) const;
 
-  void writeAcc(std::uint64_t addr, Acc value) {
-    const auto uvalue = static_cast<std::uint32_t>(value);
-    for (std::uint64_t i = 0; i < sizeof(Acc); ++i) {
-      bytes_[addr + i] = static_cast<std::uint8_t>((uvalue >> (8 * i)) & 0xffu);
-    }
-  }
+  // one contiguous row of n values starting at addr
+  void writeRow(std::uint64_t addr, const Elem* src, std::size_t n) { write(addr, src, n * sizeof(Elem)); }
+  void readRow(std::uint64_t addr, Elem* dst, std::size_t n) const { read(addr, dst, n * sizeof(Elem)); }
+  void writeRow(std::uint64_t addr, const Acc* src, std::size_t n);
+  void readRow(std::uint64_t addr, Acc* dst, std::size_t n) const;
 
+  void writeElem(std::uint64_t addr, Elem value) { writeRow(addr, &value, 1); }
+  Elem readElem(std::uint64_t addr) const {
+    Elem value = 0;
+    readRow(addr, &value, 1);
+    return value;
+  }
+  void writeAcc(std::uint64_t addr, Acc value) { writeRow(addr, &value, 1); }
   Acc readAcc(std::uint64_t addr) const {
-    std::uint32_t value = 0;
-    for (std::uint64_t i = 0; i < sizeof(Acc); ++i) {
-      value |= static_cast<std::uint32_t>(readByte(addr + i)) << (8 * i);
-    }
-    return static_cast<Acc>(value);
+    Acc value = 0;
+    readRow(addr, &value, 1);
+    return value;
   }
 
+  std::size_t residentPages() const { return pages_.size(); }
+
  private:
-  std::uint8_t readByte(std::uint64_t addr) const {
-    const auto it = bytes_.find(addr);
-    return it == bytes_.end() ? 0 : it->second;
-  }
+  using Page = std::array<std::uint8_t, kPageBytes>;
+
+  const Page* findPage(std::uint64_t page_num) const; // nullptr: never written
+  Page& touchPage(std::uint64_t page_num);            // allocates (zeroed) on demand
 
-  std::map<std::uint64_t, std::uint8_t> bytes_;
+  std::unordered_map<std::uint64_t, std::unique_ptr<Page>> pages_;
+  // last page hit; pages never move once allocated, so the pointer stays valid until reset()
+  mutable std::uint64_t last_num_ = 0;
+  mutable Page* last_page_ = nullptr;
 };
 
 } // namespace smesh
@@ -114,7 +114,10 @@ struct DmaWriteReq {
   SmeshLocalAddr laddr{};
   u16 dest = 0;
   u8 acc_act = 0;
+  u8 acc_relu6_shift = 0;
   u32 acc_scale = 0;
+  bit acc_scale_fixed = false;      // acc_scale is Q16.16, else float32 (Requantize.hpp)
+  AccScaleRow acc_channel_scale{};  // per-output-channel acc_scale, 0 = acc_scale
   u32 acc_igelu_qb = 0;
   u32 acc_igelu_qc = 0;
   u32 acc_iexp_qln2 = 0;
@@ -152,7 +155,10 @@ struct AccumReadReq {
   SmeshLocalAddr laddr{};
   u16 len = 0; // number of row elements being read from accum (not bytes)
   u8 act = 0;
+  u8 relu6_shift = 0;
   u32 scale = 0;
+  bit scale_fixed = false;
+  AccScaleRow channel_scale{};
   u32 igelu_qb = 0;
   u32 igelu_qc = 0;
   u32 iexp_qln2 = 0;
@@ -168,7 +174,14 @@ struct AccumReadResp {
   u8  mask = 0;
   u16 len = 0; // number of row elements being read from accum (not bytes)
   u8  act = 0;
+  u8  relu6_shift = 0;
   u32 scale = 0;
+  bit scale_fixed = false;
+  AccScaleRow channel_scale{};
+  u32 igelu_qb = 0;
+  u32 igelu_qc = 0;
+  u32 iexp_qln2 = 0;
+  u32 iexp_qln2_inv = 0;
   bit full = false;
   u16 cmd_id = 0;
   bit from_dma = true;
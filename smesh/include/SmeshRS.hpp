@@ -5,8 +5,12 @@
 /*
 Reservation-station vocabulary for smesh.
 
-This header defines the lightweight entry and classification types. The Cascade
-reservation-station component will be introduced separately.
+This header defines the lightweight entry and classification types and the
+Cascade reservation-station component. Each queue (load, execute, store) holds
+1..kRsMaxEntries rows, set at runtime with setEntries(). Rows are tracked with
+64-bit masks, one bit per row: a free mask picks the allocation row, a ready
+mask picks issue candidates, and each entry's waiters_* masks name the rows
+whose deps_* hold its bit, so complete() only visits the rows it wakes.
 */
 #pragma once
 
@@ -15,9 +19,13 @@ reservation-station component will be introduced separately.
 
 #include <array>
 #include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 namespace smesh {
 
+using SmeshRsMask = std::uint64_t; // one bit per RS row of a queue
+
 enum class SmeshQueueClass : std::uint8_t {
   Load,
   Execute,
@@ -95,9 +103,12 @@ struct SmeshRsEntry {
   SmeshCmd cmd{};
   SmeshRsTag rs_tag = 0; // smesh v0 command-completion tag
 
-  std::uint32_t deps_ld = 0; // bit 0 represents the current load entry
-  std::uint32_t deps_ex = 0; // bit 0 represents the current execute entry
-  std::uint32_t deps_st = 0; // bit 0 represents the current store entry
+  SmeshRsMask deps_ld = 0; // bit i represents load row i
+  SmeshRsMask deps_ex = 0; // bit i represents execute row i
+  SmeshRsMask deps_st = 0; // bit i represents store row i
+  SmeshRsMask waiters_ld = 0; // load rows whose deps_* hold this row's bit
+  SmeshRsMask waiters_ex = 0; // execute rows whose deps_* hold this row's bit
+  SmeshRsMask waiters_st = 0; // store rows whose deps_* hold this row's bit
   std::uint32_t allocated_at = 0; // allocation sequence number for debugging
   // convenience fn: all dependencies cleared for this entry?
   bool ready() const {
@@ -131,6 +142,7 @@ inline SmeshQueueClass classifyCommand(const SmeshCmd& cmd) {
         case ConfigKind::Execute:
           return SmeshQueueClass::Execute;
         case ConfigKind::Store:
+        case ConfigKind::Norm:
           return SmeshQueueClass::Store;
       }
       return SmeshQueueClass::Invalid;
@@ -138,6 +150,19 @@ inline SmeshQueueClass classifyCommand(const SmeshCmd& cmd) {
 
     case SmeshFunct::Flush:
       return SmeshQueueClass::System; // system cmd bypasses RS
+
+    case SmeshFunct::LoopWs:
+    case SmeshFunct::LoopWsConfigBounds:
+    case SmeshFunct::LoopWsConfigAddrsAB:
+    case SmeshFunct::LoopWsConfigAddrsDC:
+    case SmeshFunct::LoopWsConfigStridesAB:
+    case SmeshFunct::LoopWsConfigStridesDC:
+    case SmeshFunct::LoopConvWs:
+    case SmeshFunct::LoopConvWsConfigDims:
+    case SmeshFunct::LoopConvWsConfigKernel:
+    case SmeshFunct::LoopConvWsConfigAddrsWO:
+    case SmeshFunct::LoopConvWsConfigAddrsBI:
+      return SmeshQueueClass::Invalid; // unrolled before the RS
   }
 
   return SmeshQueueClass::Invalid; // cmd can't be classified
@@ -197,12 +222,46 @@ public:
   void updateComplete();
   void reset();
 
+  // ********** DEPTH **********
+
+  void setEntries(std::size_t ld, std::size_t ex, std::size_t st); // 1..kRsMaxEntries each; change only while empty
+  std::size_t entries(SmeshQueueClass q) const;   // rows in queue q
+  std::size_t occupancy(SmeshQueueClass q) const; // valid rows in queue q
+
+  // counters
+  std::uint64_t cycles() const { return cycles_; }
+  std::uint64_t fullStallCycles(SmeshQueueClass q) const; // alloc_in head waited on a full queue q
+  std::uint64_t allocations(SmeshQueueClass q) const;
+  std::size_t   peakOccupancy(SmeshQueueClass q) const;
+  double averageOccupancy(SmeshQueueClass q) const;
+
 private:
+  // one RS queue: rows plus the masks that stand in for the row scans
+  struct Queue {
+    std::vector<SmeshRsEntry> rows;
+    SmeshRsMask all   = 0; // bit i set for every implemented row
+    SmeshRsMask free  = 0; // row i empty
+    SmeshRsMask ready = 0; // row i valid, not issued, no deps
+    std::uint64_t occupancy_sum     = 0;
+    std::uint64_t full_stall_cycles = 0;
+    std::uint64_t allocations       = 0;
+    std::size_t   peak_occupancy    = 0;
+  };
+  struct RowRef {
+    std::uint8_t q   = 0;
+    std::uint8_t row = 0;
+  };
+
+  Queue& queue(SmeshQueueClass q);
+  const Queue& queue(SmeshQueueClass q) const;
+  void fillDependencies(SmeshRsEntry& entry, std::size_t q, std::size_t row);
+  const SmeshRsEntry* oldestReady(const Queue& q) const;
+
   SmeshRSConfigState config_state_{};
-  std::array<SmeshRsEntry, kDefaultConfig.rs_load_entries> entries_ld_{};
-  std::array<SmeshRsEntry, kDefaultConfig.rs_execute_entries> entries_ex_{};
-  std::array<SmeshRsEntry, kDefaultConfig.rs_store_entries> entries_st_{};
+  std::array<Queue, 3> queues_{}; // load, execute, store
+  std::unordered_map<SmeshRsTag, RowRef> rows_by_tag_; // live rs_tag -> row, replaces the tag scan
   SmeshRsTag next_rs_tag_ = 0;
+  std::uint64_t cycles_ = 0;
   std::uint32_t instructions_allocated_ = 0;
   bool load_issue_port_enabled_ = false;
   bool execute_issue_port_enabled_ = false;
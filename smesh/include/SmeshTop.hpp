@@ -22,6 +22,7 @@ easy to inspect.
 #include "ArbReadLocal.hpp"
 #include "ArbWriteLocal.hpp"
 #include "DmaIssueQueues.hpp"
+#include "DmaMemArb.hpp"
 #include "DmaReadCompletionMux.hpp"
 #include "DmaReader.hpp"
 #include "DmaWriter.hpp"
@@ -61,15 +62,33 @@ class SmeshTop : public Component {
   Output(bit, cmd_ready);
 
   // Memory accessors let the testbench connect the current memory boundary.
-  auto& memReq() { return dma_reader_->mem_req; }        // when top.memReq() is called, give them mem_req of dma_reader_
-  auto& memResp() { return dma_reader_->mem_resp; }      // when top.memResp() is called, give them mem_resp of dma_reader_
+  auto& memReq() { return dma_mem_arb_->mem_req; }       // loads and stores share one port through DmaMemArb
+  auto& memResp() { return dma_mem_arb_->mem_resp; }
+
+  // RS depth per queue (1..kRsMaxEntries); set before Sim::reset or while the RS is empty
+  void setRsEntries(std::size_t ld, std::size_t ex, std::size_t st) { rs_->setEntries(ld, ex, st); }
+  // AccScaleUnit pipeline depth (1..kAccScaleMaxLatency); set before Sim::reset or while it is empty
+  void setAccScaleLatency(std::size_t n) { acc_scale_unit_->setLatency(n); }
+  // Normalizer reduction depth (1..kNormMaxLatency); same rule
+  void setNormLatency(std::size_t n) { normalizer_->setLatency(n); }
 
   // narrow inspection accessors for testbench to check internal state
+  const SmeshUnrolledCmdQueue& unrolledCmdQueue() const { return *unrolled_cmd_queue_; }
   const SmeshRS& rs()     const { return *rs_; }
   const LdCtrl&  ldCtrl() const { return *ld_ctrl_; }
+  const DmaReader& dmaReader() const { return *dma_reader_; }
+  const DmaMemArb& dmaMemArb() const { return *dma_mem_arb_; }
+  const StCtrl&  stCtrl() const { return *st_ctrl_; }
+  const SpadWriter& spadWriter() const { return *spad_writer_; }
   const Spad&    spad()   const { return *spad_; }
   const SpadDmaReadPipe& spadDmaReadPipe() const { return *spad_dma_read_pipe_[0]; }
   const Accum&   accum()  const { return *accum_; }
+  const AccScaleUnit& accScaleUnit() const { return *acc_scale_unit_; }
+  const Normalizer& normalizer() const { return *normalizer_; }
+  const ExCtrl&  exCtrl() const { return *ex_ctrl_; }
+  // per-bank read arbitration: execute reads win, store reads held off count as conflicts
+  const ArbReadSpad&  arbReadSpad(std::size_t bank)  const { return *arb_read_spad_[bank]; }
+  const ArbReadAccum& arbReadAccum(std::size_t bank) const { return *arb_read_accum_[bank]; }
 
   // Store-path monitor taps for testbench-only checkers.
   auto& storeSpadReadReqVal() { return st_read_ctrl_->dmawrite_spad[0]; }
@@ -104,6 +123,7 @@ class SmeshTop : public Component {
   Output(DmaReadResp, write_arb_zero_bits_);
   WriteCtrl*               write_ctrl_ = nullptr;
   std::array<ArbRespSpad*, kSpBanks> arb_resp_spad_{};
+  std::array<ArbRespAccum*, kAccBanks> arb_resp_accum_{};
   DmaWriteNormQueue*       write_norm_queue_ = nullptr;
   StNormCtrl*              st_norm_ctrl_ = nullptr;
   Normalizer*              normalizer_ = nullptr;
@@ -117,6 +137,7 @@ class SmeshTop : public Component {
   DmaWriter*               dma_writer_ = nullptr;
   SpadWriter*              spad_writer_ = nullptr;
   DmaReader*               dma_reader_ = nullptr;
+  DmaMemArb*               dma_mem_arb_ = nullptr;
   MvinScaleSplit*          mvin_scale_split_ = nullptr;
   MvinScale*               mvin_scale_ = nullptr;
   MvinScaleAcc*            mvin_scale_acc_ = nullptr;
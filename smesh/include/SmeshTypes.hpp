@@ -26,11 +26,33 @@ constexpr std::size_t kLoadStates       = kDefaultConfig.load_states;        //
 constexpr std::size_t kRsLoadEntries    = kDefaultConfig.rs_load_entries;    // M4v0 RS load slots
 constexpr std::size_t kRsExecuteEntries = kDefaultConfig.rs_execute_entries; // M4v0 RS execute slots
 constexpr std::size_t kRsStoreEntries   = kDefaultConfig.rs_store_entries;   // M4v0 RS store slots
+constexpr std::size_t kRsMaxEntries     = kDefaultConfig.rs_max_entries;     // runtime RS depth ceiling per queue
 constexpr std::size_t kMaxSimultaneousMatmuls = kDefaultConfig.max_simultaneous_matmuls;
+constexpr std::size_t kDmaMaxBytes      = kDefaultConfig.dma_max_bytes;      // largest single DMA memory burst
+constexpr std::size_t kDmaMaxInflight   = kDefaultConfig.dma_max_inflight;   // DmaReader in-flight table size
+constexpr std::size_t kAccScaleLatency  = kDefaultConfig.acc_scale_latency;  // default AccScaleUnit pipeline depth
+constexpr std::size_t kAccScaleMaxLatency = kDefaultConfig.acc_scale_max_latency;
+constexpr std::size_t kNormLatency      = kDefaultConfig.norm_latency;       // default Normalizer pipeline depth
+constexpr std::size_t kNormMaxLatency   = kDefaultConfig.norm_max_latency;
+constexpr std::size_t kNormStats        = kDefaultConfig.norm_stats;         // Normalizer stats entries
+constexpr bool        kMeshTransactionLevel = kDefaultConfig.mesh_transaction_level;
 
 constexpr std::uint8_t kExDataflowWS = 0;
 constexpr std::uint8_t kExDataflowOS = 1;
 
+static_assert(kRsMaxEntries > 0 && kRsMaxEntries <= 64,
+              "RS rows must fit a 64-bit dependency mask");
+static_assert(kRsLoadEntries <= kRsMaxEntries && kRsExecuteEntries <= kRsMaxEntries &&
+              kRsStoreEntries <= kRsMaxEntries,
+              "default RS depths must not exceed kRsMaxEntries");
+static_assert(kDmaMaxInflight > 0 && kDmaMaxInflight <= 0xffffu,
+              "DMA in-flight reads must fit the memory transaction ID");
+static_assert(kAccScaleLatency >= 1 && kAccScaleLatency <= kAccScaleMaxLatency,
+              "default AccScaleUnit depth must be 1..kAccScaleMaxLatency");
+static_assert(kNormLatency >= 1 && kNormLatency <= kNormMaxLatency,
+              "default Normalizer depth must be 1..kNormMaxLatency");
+static_assert(kNormStats > 0 && kNormStats <= 0x100u,
+              "Normalizer stats ids must fit CONFIG_NORM's 8-bit field");
 static_assert(kSpBanks > 0 && (kSpBanks & (kSpBanks - 1)) == 0,
               "scratchpad bank count must be a power of two");
 static_assert(kSpBankRows > 0 && (kSpBankRows & (kSpBankRows - 1)) == 0,
@@ -45,6 +67,7 @@ using Acc = std::int32_t;
 
 using MeshInputRow = std::array<Elem, kDim>;
 using MeshAccumRow = std::array<Acc, kDim>;
+using AccScaleRow  = std::array<std::uint32_t, kDim>; // per-output-channel acc_scale words (Requantize.hpp)
 
 struct MatrixShape {
   std::size_t rows = 0;
@@ -14,6 +14,7 @@ Standalone smesh scratchpad memory. Initially provides one load-path write port.
 #include "SmeshTypes.hpp"
 
 #include <array>
+#include <cstdint>
 
 namespace smesh {
 
@@ -28,12 +29,13 @@ class Spad : public Component {
   Clock(clk);
 
   FifoOutput(DmaReadCompletion, dma_resp); // completion FIFO: let LdCtrl know last spad write is done
-  // Banked write ports. For now Spad accepts at most one write per cycle.
+  // Banked write ports; every bank can take one write per cycle.
   InputArray(bit, write_val_bnk, kSpBanks);
   OutputArray(bit, write_rdy_bnk, kSpBanks);
   InputArray(DmaReadResp, write_bits_bnk, kSpBanks);
 
-  // Banked read request ports. For now Spad accepts at most one read per cycle.
+  // Banked read request ports; every bank serves one read per cycle, so execute
+  // operand reads and store reads proceed in parallel on different banks.
   InputArray(bit, read_req_val_bnk, kSpBanks);
   OutputArray(bit, read_req_rdy_bnk, kSpBanks);
   InputArray(SpadReadReq, read_req_bits_bnk, kSpBanks);
@@ -51,13 +53,22 @@ class Spad : public Component {
   void reset();
 
   bool hasAcceptedWrite() const { return write_accepted_; }
+  std::uint64_t reads(std::size_t bank) const { return reads_[bank]; }
+  std::uint64_t writes(std::size_t bank) const { return writes_[bank]; }
+  std::uint64_t exReads() const { return ex_reads_; }
   const Row& row(SmeshLocalAddr addr) const;
+  // Test helper for seeding a row without modeling the write path.
+  void loadRowForTest(SmeshLocalAddr addr, const Row& data);
 
  private:
   std::array<std::array<Row, kSpBankRows>, kSpBanks> banks_{};
   bool write_accepted_ = false;
-  bool read_resp_valid_ = false;   // reg holds response valid while waiting for read pipe to pop it
-  SpadReadResp read_resp_entry_{}; // reg holds response while waiting for read pipe to pop it
+  std::array<bool, kSpBanks> read_accepting_{};     // read_req_rdy as driven this cycle
+  std::array<bool, kSpBanks> read_resp_valid_{};    // per-bank reg holds response until its consumer pops it
+  std::array<SpadReadResp, kSpBanks> read_resp_entry_{};
+  std::array<std::uint64_t, kSpBanks> reads_{};
+  std::array<std::uint64_t, kSpBanks> writes_{};
+  std::uint64_t ex_reads_ = 0;
 };
 
 } // namespace smesh
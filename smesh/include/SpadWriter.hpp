@@ -3,7 +3,10 @@
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 13 2026
 /*
-Store-side scratchpad writer skeleton.
+Store-side scratchpad writer: lands STORE_SPAD rows in the scratchpad.
+
+Holds one row, presents it to the destination bank's ArbWriteSpad (lowest
+priority), and acks StCtrl on write_ack once the arbiter fires it.
 */
 
 #pragma once
@@ -25,10 +28,24 @@ class SpadWriter : public Component {
   Input(bit, req_val);
   Input(StWriterReq, req_bits);
   Output(bit, req_rdy);
-  FifoOutput(DmaReadResp, spad_write_out);
+  OutputArray(bit, spad_write_val, kSpBanks);          // row for ArbWriteSpad, one per bank
+  OutputArray(DmaReadResp, spad_write_bits, kSpBanks);
+  InputArray(bit, spad_write_fire, kSpBanks);          // arbiter took the row this cycle
+  FifoOutput(DmaWriteResp, write_ack);                 // row landed: tell StCtrl
 
   void updateReady();
-  void update();
+  void updateView();
+  void updateAccept();
+  void updateAck();
+  void reset();
+
+  std::uint64_t rowsWritten() const { return rows_written_; }
+
+ private:
+  bool entry_valid_ = false;
+  bool accepting_   = false; // req_rdy as driven this cycle
+  DmaReadResp entry_{};
+  std::uint64_t rows_written_ = 0;
 };
 
 } // namespace smesh
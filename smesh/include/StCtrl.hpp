@@ -4,6 +4,19 @@
 // Sebastian Claudiusz Magierowski Jul 1 2026
 /*
 Skeleton for the smesh store controller.
+
+A store leaves as one DmaWriteReq per row, one row per cycle: local row
+laddr + r goes to DRAM vaddr + r * stride (the CONFIG_ST rs2 stride, 0 = packed
+rows), or for STORE_SPAD to the destination row advanced by r * its rs1[63:32]
+stride. Its RS tag completes when the last row's write lands: dma_resp carries
+external memory write acks (via DmaMemArb), spad_resp the SpadWriter's
+scratchpad acks, norm_resp the Normalizer's ack for a stats-only row
+(norm_cmd != RESET), which writes nothing.
+read_resp only says StReadCtrl accepted a row's local read.
+A CONFIG_ST or CONFIG_NORM moves nothing; it latches the store registers
+(activation, ReLU6 shift, acc_scale and per-channel scales, DRAM stride,
+I-GELU/I-EXP constants, norm stats id) that are stamped on every later
+DmaWriteReq, and its tag is handed back on the next free completion slot.
 */
 #pragma once
 
@@ -11,6 +24,8 @@ Skeleton for the smesh store controller.
 
 #include "SmeshPorts.hpp"
 
+#include <unordered_map>
+
 namespace smesh {
 
 class StCtrl : public Component {
@@ -23,11 +38,53 @@ class StCtrl : public Component {
 
   FifoInput(SmeshIssue, cmd_in);
   FifoOutput(DmaWriteReq, dma_req);
-  FifoInput(DmaWriteResp, dma_resp);
+  FifoInput(DmaWriteResp, read_resp);  // StReadCtrl accepted the local read
+  FifoInput(DmaWriteResp, dma_resp);   // external memory write ack
+  FifoInput(DmaWriteResp, spad_resp);  // scratchpad write ack (STORE_SPAD)
+  FifoInput(DmaWriteResp, norm_resp);  // stats-only mvout reduced by the Normalizer
   FifoOutput(SmeshRsTag, completed);
 
   void updateDispatch();
+  void updateRead();
   void updateComplete();
+  void reset();
+
+  std::uint64_t dispatched() const { return dispatched_; }
+  std::uint64_t readsAccepted() const { return reads_accepted_; }
+  std::uint64_t writesAcked() const { return writes_acked_; }
+  std::uint64_t spadWritesAcked() const { return spad_writes_acked_; }
+  std::uint64_t statsAcked() const { return stats_acked_; }
+  std::uint64_t outstanding() const { return dispatched_ - writes_acked_ - spad_writes_acked_ - stats_acked_; }
+
+ private:
+  void applyConfig(std::uint64_t rs1, std::uint64_t rs2);
+  void issueRow();
+
+  std::uint64_t dispatched_ = 0;
+  std::uint64_t reads_accepted_ = 0;
+  std::uint64_t writes_acked_ = 0;
+  std::uint64_t spad_writes_acked_ = 0;
+  std::uint64_t stats_acked_ = 0;
+  bool          active_valid_ = false; // store command still issuing rows
+  SmeshIssue    active_{};
+  SmeshLocalAddr base_laddr_{};
+  std::uint32_t rows_     = 0;
+  std::uint32_t cols_     = 0;
+  std::uint32_t next_row_ = 0;
+  std::unordered_map<SmeshRsTag, std::uint32_t> rows_left_; // dispatched store tag -> row acks still due
+  bool          config_pending_ = false; // CONFIG_ST waiting to report completion
+  SmeshRsTag    config_tag_     = 0;
+  std::uint8_t  act_            = 0; // CONFIG_ST store registers
+  std::uint8_t  relu6_shift_    = 0;
+  std::uint32_t acc_scale_      = 0;
+  std::uint32_t dram_stride_    = 0; // bytes between stored DRAM rows, 0 = packed
+  bool          acc_scale_fixed_ = false;
+  AccScaleRow   channel_scale_{};  // per-output-channel acc_scale, cleared by a plain CONFIG_ST
+  std::int32_t  igelu_qb_       = 0; // CONFIG_NORM store registers
+  std::int32_t  igelu_qc_       = 0;
+  std::int32_t  iexp_qln2_      = 0;
+  std::uint32_t iexp_qln2_inv_  = 0;
+  std::uint16_t norm_stats_id_  = 0;
 };
 
 } // namespace smesh
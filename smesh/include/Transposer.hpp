@@ -0,0 +1,58 @@
+// **********************************************************************
+// smesh/include/Transposer.hpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Aug 6 2026
+/*
+kDim x kDim systolic transposer between Mesher's transposer_in/out ports.
+
+Always-out design: a grid of kDim x kDim registers that every accepted row
+shifts by one position. The shift direction alternates every kDim rows:
+  left: in_row[r] enters row r on the right, out_col[r] = row r's left reg
+  up:   in_row[c] enters col c on the bottom, out_col[c] = col c's top reg
+so while one block of kDim rows is shifted in, the previous block leaves as
+its columns (out_col on the j-th row of a block = column j of the previous
+block). There is no ready or valid: every in_row_val beat is accepted, and
+out_col_bits is read from the registers before that beat shifts in. The
+first kDim beats drain zeros.
+*/
+
+#pragma once
+
+#include <cascade/Cascade.hpp>
+
+#include "SmeshTypes.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace smesh {
+
+class Transposer : public Component {
+  DECLARE_COMPONENT(Transposer);
+
+ public:
+  Transposer(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+
+  Input(bit,           in_row_val);
+  Input(MeshInputRow,  in_row_bits);
+  Output(MeshInputRow, out_col_bits);
+
+  void updateOut();   // column leaving the grid (from registers only)
+  void updateShift(); // shift the accepted row in
+  void reset();
+
+  std::uint64_t rowsIn() const { return rows_in_; }
+  std::uint64_t blocks() const { return blocks_; } // direction turns (completed kDim-row blocks)
+
+ private:
+  std::array<MeshInputRow, kDim> regs_{}; // regs_[row][col]
+  bool          up_      = false;         // false: shift left, true: shift up
+  std::size_t   counter_ = 0;             // rows accepted in the current block
+  std::uint64_t rows_in_ = 0;
+  std::uint64_t blocks_  = 0;
+};
+
+} // namespace smesh
@@ -3,70 +3,147 @@
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 13 2026
 /*
-Accumulator scale-stage skeleton implementation.
+Accumulator scale-stage implementation.
 */
 
 #include "AccScaleUnit.hpp"
 
+#include "Activation.hpp"
+#include "Requantize.hpp"
+
 namespace smesh {
 
 namespace {
-
-MeshInputRow narrowAccumRow(const MeshAccumRow& row) {
-  MeshInputRow narrow{};
-  for (std::size_t lane = 0; lane < kDim; ++lane) {
-    narrow[lane] = static_cast<Elem>(row[lane]);
-  }
-  return narrow;
+// the store command's activation, with the constants StCtrl stamped on it
+ActivationParams activationParams(const AccumReadResp& acc) {
+  ActivationParams params{};
+  params.relu6_shift   = static_cast<std::uint8_t>(acc.relu6_shift);
+  params.igelu_qb      = static_cast<std::int32_t>(static_cast<std::uint32_t>(acc.igelu_qb));
+  params.igelu_qc      = static_cast<std::int32_t>(static_cast<std::uint32_t>(acc.igelu_qc));
+  params.iexp_qln2     = static_cast<std::int32_t>(static_cast<std::uint32_t>(acc.iexp_qln2));
+  params.iexp_qln2_inv = static_cast<std::uint32_t>(acc.iexp_qln2_inv);
+  return params;
 }
 
 } // namespace
 
 AccScaleUnit::AccScaleUnit(std::string /*name*/, IMPL_CTOR) {
-  UPDATE(updateReady).writes(req_rdy);
-  UPDATE(updateOutView).writes(out_val, out_bits);
-  UPDATE(updateOutPop).reads(out_rdy_issue, out_rdy_exresp);
-  UPDATE(update).reads(req_val, req_bits);
+  UPDATE(updateReady).reads(req_val, ex_req_val, out_rdy_issue, out_rdy_exresp).writes(req_rdy, ex_req_rdy);
+  UPDATE(updateOutView).writes(out_val, out_val_exresp, out_bits);
+  UPDATE(update).reads(req_val, req_bits, ex_req_val, ex_req_bits, out_rdy_issue, out_rdy_exresp);
 }
 
+void AccScaleUnit::setLatency(std::size_t n) {
+  assert_always(n >= 1 && n <= kAccScaleMaxLatency, "AccScaleUnit latency must be 1..kAccScaleMaxLatency");
+  assert_always(count_ == 0, "AccScaleUnit: change latency only while empty");
+  latency_ = n;
+}
+// store data keeps the stage; an execute read takes it only when no store data is offered.
+// A full pipeline still accepts when its last row leaves this cycle, since every row then moves up.
 void AccScaleUnit::updateReady() {
-  req_rdy = bit(!out_valid_);
+  const auto& last = stages_[latency_ - 1];
+  const bool selected_ready = last.resp.from_dma != 0 ? out_rdy_issue != 0 : out_rdy_exresp != 0;
+  accepting_ = count_ < latency_ || (last.valid && selected_ready);
+  req_rdy = bit(accepting_);
+  bool granted = req_val != 0;
+  for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
+    const bool take = accepting_ && !granted && ex_req_val[bank] != 0;
+    ex_req_rdy[bank] = bit(take);
+    granted = granted || take;
+  }
 }
 
 void AccScaleUnit::updateOutView() {
-  out_val = bit(out_valid_);
-  out_bits = out_valid_ ? out_entry_ : AccScaleResp{};
+  const auto& last = stages_[latency_ - 1];
+  out_val = bit(last.valid && last.resp.from_dma != 0);
+  out_val_exresp = bit(last.valid && last.resp.from_dma == 0);
+  out_bits = last.valid ? last.resp : AccScaleResp{};
 }
+// pop the last stage, move every row whose next stage is free, then take the new row into stage 0
+void AccScaleUnit::update() {
+  ++cycles_;
+  occupancy_sum_ += count_;
 
-void AccScaleUnit::updateOutPop() {
-  const bool selected_ready = out_entry_.from_dma != 0 ? out_rdy_issue != 0
-                                                       : out_rdy_exresp != 0;
-  if (out_valid_ && selected_ready) {
-    out_valid_ = false;
-    out_entry_ = AccScaleResp{};
+  auto& last = stages_[latency_ - 1];
+  if (last.valid) {
+    const bool selected_ready = last.resp.from_dma != 0 ? out_rdy_issue != 0 : out_rdy_exresp != 0;
+    if (selected_ready) {
+      last = Stage{};
+      --count_;
+    } else {
+      ++out_stall_cycles_;
+    }
+  }
+  for (std::size_t stage = latency_ - 1; stage > 0; --stage) {
+    if (!stages_[stage].valid && stages_[stage - 1].valid) {
+      stages_[stage] = stages_[stage - 1];
+      stages_[stage - 1] = Stage{};
+    }
   }
-}
 
-void AccScaleUnit::update() {
-  if (req_val == 0 || out_valid_) {
+  bool offered = req_val != 0;
+  for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
+    offered = offered || ex_req_val[bank] != 0;
+  }
+  if (!accepting_) {
+    full_stall_cycles_ += offered ? 1 : 0;
     return;
   }
 
-  const auto req = *req_bits;
-  const auto& acc = req.norm.acc_read_resp;
+  AccumReadResp acc{};
+  if (req_val != 0) {
+    acc = req_bits->norm.acc_read_resp;
+  } else {
+    std::size_t bank = 0;
+    while (bank < kAccBanks && ex_req_val[bank] == 0) {
+      ++bank;
+    }
+    if (bank == kAccBanks) {
+      return;
+    }
+    acc = *ex_req_bits[bank];
+  }
+  const auto act = decodeActivation(static_cast<std::uint32_t>(acc.act));
+  const auto format = acc.scale_fixed != 0 ? AccScaleFormat::Fixed16 : AccScaleFormat::Float32;
+  const auto activated = activateRow(acc.data, act, activationParams(acc));
   AccScaleResp resp{};
-  resp.full_data = acc.data;
-  resp.data = narrowAccumRow(acc.data);
+  resp.full_data = activated;
+  resp.data = requantizeRow(activated, static_cast<std::uint32_t>(acc.scale), acc.channel_scale, format);
   resp.acc_bank_id = static_cast<u16>(acc.laddr.acc_bank());
   resp.from_dma = acc.from_dma;
-  out_entry_ = resp;
-  out_valid_ = true;
+  stages_[0].valid = true;
+  stages_[0].resp = resp;
+  ++count_;
+  ++rows_;
+  accepting_ = false;
 
-  trace("acc_scale_unit: accepted acc_laddr=0x%x bank=%u len=%u cmd_id=%u",
+  trace("acc_scale_unit: accepted acc_laddr=0x%x bank=%u act=%u scale=0x%x%s len=%u cmd_id=%u occupancy=%zu",
         static_cast<unsigned>(acc.laddr.raw),
         static_cast<unsigned>(resp.acc_bank_id),
+        static_cast<unsigned>(act),
+        static_cast<unsigned>(acc.scale),
+        format == AccScaleFormat::Fixed16 ? " (q16.16)" : "",
         static_cast<unsigned>(acc.len),
-        static_cast<unsigned>(acc.cmd_id));
+        static_cast<unsigned>(acc.cmd_id),
+        count_);
+}
+
+void AccScaleUnit::reset() {
+  accepting_ = false;
+  stages_.fill(Stage{});
+  count_ = 0;
+  cycles_ = 0;
+  rows_ = 0;
+  full_stall_cycles_ = 0;
+  out_stall_cycles_ = 0;
+  occupancy_sum_ = 0;
+  req_rdy.reset(1);
+  out_val.reset(0);
+  out_val_exresp.reset(0);
+  out_bits.reset(AccScaleResp{});
+  for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
+    ex_req_rdy[bank].reset(0);
+  }
 }
 
 } // namespace smesh
@@ -27,143 +27,137 @@ void Accum::updateWriteReady() {
 }
 
 void Accum::updateWrite() {
-  bool has_write = false;
-  DmaReadResp write{};
-
+  bool completed = false; // one completion per cycle; only the single mvin stream marks last
   for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
     if (write_val_bnk[bank] == 0) {
       continue;
     }
-    const auto pending = *write_bits_bnk[bank];
-    if (static_cast<bool>(pending.last) && dma_resp.full()) {
-      return;
+    const auto write = *write_bits_bnk[bank];
+    if (static_cast<bool>(write.last) && dma_resp.full()) {
+      continue;
     }
-    write = pending;
-    has_write = true;
-    break;
-  }
 
-  if (!has_write) {
-    return;
-  }
-
-  assert_always(write.laddr.is_acc_addr(), "Accum write received a scratchpad address");  // check that dest is actual accum addr
+    assert_always(write.laddr.is_acc_addr(), "Accum write received a scratchpad address");  // check that dest is actual accum addr
+    assert_always(write.laddr.acc_bank() == bank, "Accum write arrived on the wrong bank port");
 
-  auto& destination = banks_[write.laddr.acc_bank()][write.laddr.acc_row()];  // select accum bank & row
-  const auto mask = static_cast<std::uint8_t>(write.mask);
-  for (std::size_t lane = 0; lane < kDim; ++lane) { // for ea. lane (i.e., col of memory row)
-    if ((mask & (std::uint8_t{1} << lane)) != 0) {  // if mask bit is set...
-      if (write.has_acc_bitwidth != 0) {
+    auto& destination = banks_[bank][write.laddr.acc_row()];  // select accum row
+    const auto mask = static_cast<std::uint8_t>(write.mask);
+    const bool accumulate = write.laddr.accumulate();          // read-modify-write add instead of overwrite
+    for (std::size_t lane = 0; lane < kDim; ++lane) { // for ea. lane (i.e., col of memory row)
+      if ((mask & (std::uint8_t{1} << lane)) != 0) {  // if mask bit is set...
         std::uint32_t word = 0;
-        for (std::size_t byte = 0; byte < sizeof(Acc); ++byte) {
-          word |= static_cast<std::uint32_t>(write.data[lane * sizeof(Acc) + byte]) << (8 * byte);
+        if (write.has_acc_bitwidth != 0) {
+          for (std::size_t byte = 0; byte < sizeof(Acc); ++byte) {
+            word |= static_cast<std::uint32_t>(write.data[lane * sizeof(Acc) + byte]) << (8 * byte);
+          }
+        } else {
+          const auto byte = static_cast<std::uint8_t>(write.data[lane]);            // ...copy byte from writ.data
+          word = static_cast<std::uint32_t>(static_cast<Acc>(static_cast<Elem>(byte))); // ...sign-extended to 32 bits
         }
-        destination[lane] = static_cast<Acc>(word);
-      } else {
-        const auto byte = static_cast<std::uint8_t>(write.data[lane]);            // ...copy byte from writ.data
-        destination[lane] = static_cast<Acc>(static_cast<Elem>(byte));             // ...to accum row lane (sign-extended to 32 bits)
+        // accumulator adds wrap at the accumulator width, like the SRAM's adder
+        destination[lane] = accumulate
+                                ? static_cast<Acc>(static_cast<std::uint32_t>(destination[lane]) + word)
+                                : static_cast<Acc>(word);
       }
     }
+    // if this write is marked last, push completion message to LdCtrl completion FIFO
+    if (static_cast<bool>(write.last)) {
+      assert_always(!completed, "Accum saw two last writes in one cycle");
+      DmaReadCompletion completion{};
+      completion.bytes_read = write.bytes_read;
+      completion.cmd_id = write.cmd_id;
+      dma_resp.push(completion);
+      completed = true;
+    }
+    // mark that write happened and emit a trace
+    write_accepted_ = true;
+    ++writes_[bank];
+    accumulates_ += accumulate ? 1 : 0;
+    trace("accum: write bank=%u row=%u mask=0x%x acc=%u cmd_id=%u last=%u",
+          static_cast<unsigned>(bank),
+          static_cast<unsigned>(write.laddr.acc_row()),
+          static_cast<unsigned>(write.mask),
+          static_cast<unsigned>(accumulate),
+          static_cast<unsigned>(write.cmd_id),
+          static_cast<unsigned>(write.last));
   }
-  // if this write is marked last, push completion message to LdCtrl completion FIFO
-  if (static_cast<bool>(write.last)) {
-    DmaReadCompletion completion{};
-    completion.bytes_read = write.bytes_read;
-    completion.cmd_id = write.cmd_id;
-    dma_resp.push(completion);
-  }
-  // mark that write happened and emit a trace
-  write_accepted_ = true;
-  trace("accum: write bank=%u row=%u mask=0x%x cmd_id=%u last=%u",
-        static_cast<unsigned>(write.laddr.acc_bank()),
-        static_cast<unsigned>(write.laddr.acc_row()),
-        static_cast<unsigned>(write.mask),
-        static_cast<unsigned>(write.cmd_id),
-        static_cast<unsigned>(write.last));
 }
-// provide read req ready signal to StReadCtrl so it can inspect it
+// a bank takes a new read only while its response reg is empty
 void Accum::updateReadReady() {
   for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
-    read_req_rdy_bnk[bank] = bit(!read_resp_valid_);
+    read_accepting_[bank] = !read_resp_valid_[bank];
+    read_req_rdy_bnk[bank] = bit(read_accepting_[bank]);
   }
 }
-// shows current response to outside world
+// shows every bank's current response to outside world
 void Accum::updateReadRespView() {
   for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
-    read_resp_val_bnk[bank] = 0;
-    read_resp_bits_bnk[bank] = AccumReadResp{};
-  }
-
-  if (read_resp_valid_) {
-    const auto bank = read_resp_entry_.laddr.acc_bank();
-    read_resp_val_bnk[bank] = 1;
-    read_resp_bits_bnk[bank] = read_resp_entry_;
+    read_resp_val_bnk[bank] = bit(read_resp_valid_[bank]);
+    read_resp_bits_bnk[bank] = read_resp_valid_[bank] ? read_resp_entry_[bank] : AccumReadResp{};
   }
 }
-// consumes/clears response when downsream block is ready
+// consumes/clears a bank's response when its downstream block is ready
 void Accum::updateReadRespPop() {
-  if (!read_resp_valid_) {
-    return;
-  }
-
-  const auto bank = read_resp_entry_.laddr.acc_bank();
-  if (read_resp_rdy_bnk[bank] != 0) {
-    read_resp_valid_ = false;
-    read_resp_entry_ = AccumReadResp{};
+  for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
+    if (read_resp_valid_[bank] && read_resp_rdy_bnk[bank] != 0) {
+      read_resp_valid_[bank] = false;
+      read_resp_entry_[bank] = AccumReadResp{};
+    }
   }
 }
-
+// each bank serves the request its ArbReadAccum granted (execute reads win there)
 void Accum::updateRead() {
-  const bool exread = false; // TODO: execute read wins once ExCtrl has a local-memory read port
-  bool has_request = false;
-  AccumReadReq req{};
   for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
-    if (read_req_val_bnk[bank] != 0) {
-      req = *read_req_bits_bnk[bank];
-      has_request = true;
-      break;
+    if (read_req_val_bnk[bank] == 0 || !read_accepting_[bank]) {
+      continue;
     }
+    const auto req = *read_req_bits_bnk[bank];
+    assert_always(req.laddr.is_acc_addr(), "Accum read received a scratchpad address");
+    assert_always(req.laddr.acc_bank() == bank, "Accum read arrived on the wrong bank port");
+
+    AccumReadResp resp{};
+    resp.laddr = req.laddr;
+    resp.len = req.len;
+    resp.act = req.act;
+    resp.relu6_shift = req.relu6_shift;
+    resp.scale = req.scale;
+    resp.scale_fixed = req.scale_fixed;
+    resp.channel_scale = req.channel_scale;
+    resp.igelu_qb = req.igelu_qb;
+    resp.igelu_qc = req.igelu_qc;
+    resp.iexp_qln2 = req.iexp_qln2;
+    resp.iexp_qln2_inv = req.iexp_qln2_inv;
+    resp.full = req.full;
+    resp.cmd_id = req.cmd_id;
+    resp.from_dma = req.from_dma;
+    resp.data = banks_[bank][req.laddr.acc_row()];
+    for (std::size_t lane = 0; lane < kDim; ++lane) {
+      resp.mask |= static_cast<u8>(u8{1} << lane);
+    }
+    read_resp_entry_[bank] = resp;
+    read_resp_valid_[bank] = true;
+    read_accepting_[bank] = false;
+    ++reads_[bank];
+    ex_reads_ += req.from_dma != 0 ? 0 : 1;
+    trace("accum: %s read bank=%u row=%u mask=0x%x cmd_id=%u",
+          req.from_dma != 0 ? "dma" : "ex",
+          static_cast<unsigned>(bank),
+          static_cast<unsigned>(req.laddr.acc_row()),
+          static_cast<unsigned>(resp.mask),
+          static_cast<unsigned>(req.cmd_id));
   }
-
-  if (!exread && !has_request) {
-    return;
-  }
-  if (exread) {
-    return;
-  }
-  if (read_resp_valid_) {
-    return;
-  }
-
-  assert_always(req.laddr.is_acc_addr(), "Accum read received a scratchpad address");
-
-  const auto& source = banks_[req.laddr.acc_bank()][req.laddr.acc_row()];
-  AccumReadResp resp{};
-  resp.laddr = req.laddr;
-  resp.len = req.len;
-  resp.act = req.act;
-  resp.scale = req.scale;
-  resp.full = req.full;
-  resp.cmd_id = req.cmd_id;
-  resp.from_dma = req.from_dma;
-  resp.data = source;
-  for (std::size_t lane = 0; lane < kDim; ++lane) {
-    resp.mask |= static_cast<u8>(u8{1} << lane);
-  }
-  read_resp_entry_ = resp;
-  read_resp_valid_ = true;
-  trace("accum: dma read bank=%u row=%u mask=0x%x cmd_id=%u",
-        static_cast<unsigned>(req.laddr.acc_bank()),
-        static_cast<unsigned>(req.laddr.acc_row()),
-        static_cast<unsigned>(resp.mask),
-        static_cast<unsigned>(req.cmd_id));
 }
 
 void Accum::reset() {
   banks_ = {};
   write_accepted_ = false;
-  read_resp_valid_ = false;
-  read_resp_entry_ = AccumReadResp{};
+  read_accepting_ = {};
+  read_resp_valid_ = {};
+  read_resp_entry_ = {};
+  reads_ = {};
+  writes_ = {};
+  ex_reads_ = 0;
+  accumulates_ = 0;
   for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
     write_rdy_bnk[bank].reset(1);
     read_req_rdy_bnk[bank].reset(1);
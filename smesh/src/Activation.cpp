@@ -0,0 +1,132 @@
+// **********************************************************************
+// smesh/src/Activation.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Aug 26 2026
+/*
+Integer-only activation kernels.
+*/
+
+#include "Activation.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace smesh {
+
+namespace {
+
+constexpr std::int64_t kAccMin = std::numeric_limits<Acc>::min();
+constexpr std::int64_t kAccMax = std::numeric_limits<Acc>::max();
+// (q + qb) is held to +-2^31 so its square plus qc stays inside int64
+constexpr std::int64_t kPolyInMax = std::int64_t{1} << 31;
+// |q| * factor stays inside int64, and any larger I-GELU factor saturates Acc anyway
+constexpr std::int64_t kGeluFactorMax = (std::int64_t{1} << 32) - 1;
+
+Acc saturateToAcc(std::int64_t value) {
+  return static_cast<Acc>(std::min(std::max(value, kAccMin), kAccMax));
+}
+
+std::int64_t relu6Limit(std::uint8_t shift) {
+  return std::int64_t{6} << std::min<std::uint8_t>(shift, 32);
+}
+
+Acc reluLane(Acc q) {
+  return std::max<Acc>(q, 0);
+}
+
+Acc relu6Lane(Acc q, std::int64_t six) {
+  return static_cast<Acc>(std::min(std::max<std::int64_t>(q, 0), six)); // never above q, so no saturation
+}
+
+// (q + qb)^2 + qc, the I-BERT second-order polynomial
+std::int64_t poly(std::int64_t q, const ActivationParams& params) {
+  const std::int64_t shifted = std::min(std::max(q + params.igelu_qb, -kPolyInMax), kPolyInMax);
+  return shifted * shifted + params.igelu_qc;
+}
+
+Acc igeluLane(Acc q, const ActivationParams& params) {
+  const std::int64_t q64    = q;
+  const std::int64_t sign   = q64 < 0 ? -1 : 1;
+  const std::int64_t clip   = -std::int64_t{params.igelu_qb}; // -b/S: erf is flat beyond this
+  const std::int64_t q_erf  = sign * poly(std::min(q64 * sign, clip), params);
+  // q_1 = floor(1/S_erf) = qc since c = 1
+  const std::int64_t factor = std::min(std::max(q_erf + params.igelu_qc, -kGeluFactorMax), kGeluFactorMax);
+  return saturateToAcc(q64 * factor);
+}
+
+Acc iexpLane(Acc q, const ActivationParams& params) {
+  const std::int64_t qln2  = std::max<std::int64_t>(params.iexp_qln2, 1);
+  const std::int64_t q_neg = std::min<std::int64_t>(q, 0);
+  // z = floor(-q / qln2) via the fixed-point reciprocal; past 64 the result shifts to zero anyway
+  const auto z_est = (static_cast<std::uint64_t>(-q_neg) * params.iexp_qln2_inv) >> 16;
+  std::int64_t z   = static_cast<std::int64_t>(std::min<std::uint64_t>(z_est, 64));
+  std::int64_t qp  = q_neg + z * qln2;
+  // one-step fixup for the reciprocal's rounding
+  const std::int64_t fix = (qp <= -qln2 ? 1 : 0) - (qp > 0 ? 1 : 0);
+  z  += fix;
+  qp += fix * qln2;
+  const std::int64_t value = poly(qp, params) >> std::min<std::int64_t>(z, 63);
+  // zero when range reduction is not configured or the shift is out of range
+  return params.iexp_qln2 > 0 && z < 64 ? saturateToAcc(value) : 0;
+}
+
+} // namespace
+
+Activation decodeActivation(std::uint32_t raw) {
+  return raw < kActivationCount ? static_cast<Activation>(raw) : Activation::None;
+}
+
+Acc activate(Acc q, Activation act, const ActivationParams& params) {
+  switch (act) {
+    case Activation::None:
+      return q;
+    case Activation::Relu:
+      return reluLane(q);
+    case Activation::Relu6:
+      return relu6Lane(q, relu6Limit(params.relu6_shift));
+    case Activation::IGelu:
+      return igeluLane(q, params);
+    case Activation::IExp:
+      return iexpLane(q, params);
+    case Activation::LayerNorm:
+    case Activation::Softmax:
+      return q; // row-wide, done by the Normalizer
+  }
+  return q;
+}
+
+// one dispatch per row, then the same lane kernel across all kDim lanes
+MeshAccumRow activateRow(const MeshAccumRow& row, Activation act, const ActivationParams& params) {
+  MeshAccumRow out = row;
+  switch (act) {
+    case Activation::Relu:
+      for (std::size_t lane = 0; lane < kDim; ++lane) {
+        out[lane] = reluLane(row[lane]);
+      }
+      break;
+    case Activation::Relu6: {
+      const std::int64_t six = relu6Limit(params.relu6_shift);
+      for (std::size_t lane = 0; lane < kDim; ++lane) {
+        out[lane] = relu6Lane(row[lane], six);
+      }
+      break;
+    }
+    case Activation::IGelu:
+      for (std::size_t lane = 0; lane < kDim; ++lane) {
+        out[lane] = igeluLane(row[lane], params);
+      }
+      break;
+    case Activation::IExp:
+      for (std::size_t lane = 0; lane < kDim; ++lane) {
+        out[lane] = iexpLane(row[lane], params);
+      }
+      break;
+    case Activation::None:
+    case Activation::LayerNorm:
+    case Activation::Softmax:
+      break; // row-wide kinds are done by the Normalizer
+  }
+  return out;
+}
+
+} // namespace smesh
@@ -14,6 +14,7 @@ ArbReadSpad::ArbReadSpad(std::string /*name*/, IMPL_CTOR) {
   UPDATE(update)
       .reads(exread_val, exread_bits, dmawrite_val, dmawrite_bits, read_req_rdy)
       .writes(exread_rdy, dmawrite_rdy, read_req_val, read_req_bits);
+  UPDATE(updateCount).reads(exread_val, dmawrite_val, read_req_rdy);
 }
 
 void ArbReadSpad::update() {
@@ -27,10 +28,28 @@ void ArbReadSpad::update() {
   dmawrite_rdy = bit(!exread && dmawrite && read_req_rdy != 0);
 }
 
+void ArbReadSpad::updateCount() {
+  if (Sim::state == Sim::SimResetting || read_req_rdy == 0) {
+    return;
+  }
+  const bool exread   = exread_val   != 0;
+  const bool dmawrite = dmawrite_val != 0;
+  ex_reads_  += exread ? 1 : 0;
+  dma_reads_ += !exread && dmawrite ? 1 : 0;
+  conflicts_ += exread && dmawrite ? 1 : 0;
+}
+
+void ArbReadSpad::reset() {
+  ex_reads_  = 0;
+  dma_reads_ = 0;
+  conflicts_ = 0;
+}
+
 ArbReadAccum::ArbReadAccum(std::string /*name*/, IMPL_CTOR) {
   UPDATE(update)
       .reads(exread_val, exread_bits, dmawrite_val, dmawrite_bits, read_req_rdy)
       .writes(exread_rdy, dmawrite_rdy, read_req_val, read_req_bits);
+  UPDATE(updateCount).reads(exread_val, dmawrite_val, read_req_rdy);
 }
 
 void ArbReadAccum::update() {
@@ -44,6 +63,23 @@ void ArbReadAccum::update() {
   dmawrite_rdy = bit(!exread && dmawrite && read_req_rdy != 0);
 }
 
+void ArbReadAccum::updateCount() {
+  if (Sim::state == Sim::SimResetting || read_req_rdy == 0) {
+    return;
+  }
+  const bool exread   = exread_val   != 0;
+  const bool dmawrite = dmawrite_val != 0;
+  ex_reads_  += exread ? 1 : 0;
+  dma_reads_ += !exread && dmawrite ? 1 : 0;
+  conflicts_ += exread && dmawrite ? 1 : 0;
+}
+
+void ArbReadAccum::reset() {
+  ex_reads_  = 0;
+  dma_reads_ = 0;
+  conflicts_ = 0;
+}
+
 ArbRespSpad::ArbRespSpad(std::string /*name*/, IMPL_CTOR) {
   UPDATE(update)
       .reads(read_resp_val, read_resp_bits, dma_resp_rdy, ex_resp_rdy)
@@ -55,6 +91,27 @@ void ArbRespSpad::update() {
   const bool selected_ready = resp.from_dma != 0 ? dma_resp_rdy != 0 : ex_resp_rdy != 0;
   read_resp_rdy = bit(read_resp_val != 0 && selected_ready);
 }
+// valid and ready are separate updates: both consumers derive their ready from the valid
+ArbRespAccum::ArbRespAccum(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(updateValid)
+      .reads(read_resp_val, read_resp_bits)
+      .writes(dma_resp_val, ex_resp_val);
+  UPDATE(updateReady)
+      .reads(read_resp_val, read_resp_bits, dma_resp_rdy, ex_resp_rdy)
+      .writes(read_resp_rdy);
+}
+
+void ArbRespAccum::updateValid() {
+  const bool from_dma = read_resp_bits->from_dma != 0;
+  dma_resp_val = bit(read_resp_val != 0 && from_dma);
+  ex_resp_val  = bit(read_resp_val != 0 && !from_dma);
+}
+
+void ArbRespAccum::updateReady() {
+  const bool from_dma = read_resp_bits->from_dma != 0;
+  read_resp_rdy = bit(read_resp_val != 0 && (from_dma ? dma_resp_rdy != 0 : ex_resp_rdy != 0));
+}
+
 // send respones back to ExCtrl (for ex to accum read reqs)
 AccumExResp::AccumExResp(std::string /*name*/, IMPL_CTOR) {
   UPDATE(update)
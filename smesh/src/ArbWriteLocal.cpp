@@ -12,7 +12,7 @@ namespace smesh {
 
 ArbWriteSpad::ArbWriteSpad(std::string /*name*/, IMPL_CTOR) {
   UPDATE(updateReady)
-      .reads(write_rdy)
+      .reads(write_rdy, exwrite_val)
       .writes(exwrite_rdy, dmaread_rdy, zerowrite_rdy);
   UPDATE(updateWrite)
       .reads(exwrite_val,
@@ -20,28 +20,37 @@ ArbWriteSpad::ArbWriteSpad(std::string /*name*/, IMPL_CTOR) {
              dmaread_val,
              dmaread_bits,
              zerowrite_val,
-             zerowrite_bits)
-      .writes(write_val, write_bits);
+             zerowrite_bits,
+             spadwrite_val,
+             spadwrite_bits,
+             write_rdy)
+      .writes(write_val, write_bits, spadwrite_fire);
 }
 
 void ArbWriteSpad::updateReady() {
-  // TODO: once multiple write sources can be active, refine source-ready
-  // backpressure to account for priority without creating valid/ready loops.
+  // execute writeback rows have no ready (the mesh cannot stall), so they hold the
+  // bank off from the lower sources; exwrite_val never depends on these readies
+  const bool free = write_rdy != 0 && exwrite_val == 0;
   exwrite_rdy   = bit(write_rdy != 0);
-  dmaread_rdy   = bit(write_rdy != 0);
-  zerowrite_rdy = bit(write_rdy != 0);
+  dmaread_rdy   = bit(free);
+  zerowrite_rdy = bit(free);
 }
 
 void ArbWriteSpad::updateWrite() {
   const bool exwrite   = exwrite_val   != 0;
   const bool dmaread   = dmaread_val   != 0;
   const bool zerowrite = zerowrite_val != 0;
+  // SpadWriter only gets the port when nothing else wants it (no ready loop: it learns via fire)
+  const bool spadwrite = spadwrite_val != 0 && !exwrite && !dmaread && !zerowrite && write_rdy != 0;
 
-  write_val = bit(exwrite || dmaread || zerowrite);
+  write_val = bit(exwrite || dmaread || zerowrite || spadwrite);
+  spadwrite_fire = bit(spadwrite);
   if (exwrite) {
     write_bits = *exwrite_bits;
   } else if (dmaread) {
     write_bits = *dmaread_bits;
+  } else if (spadwrite) {
+    write_bits = *spadwrite_bits;
   } else {
     write_bits = *zerowrite_bits;
   }
@@ -52,13 +61,14 @@ void ArbWriteSpad::reset() {
   exwrite_rdy.reset(1);
   dmaread_rdy.reset(1);
   zerowrite_rdy.reset(1);
+  spadwrite_fire.reset(0);
   write_val.reset(0);
   write_bits.reset(DmaReadResp{});
 }
 
 ArbWriteAccum::ArbWriteAccum(std::string /*name*/, IMPL_CTOR) {
   UPDATE(updateReady)
-      .reads(write_rdy)
+      .reads(write_rdy, exwrite_val)
       .writes(exwrite_rdy, dmaread_full_rdy, dmaread_rdy, zerowrite_rdy);
   UPDATE(updateWrite)
       .reads(exwrite_val,
@@ -73,12 +83,13 @@ ArbWriteAccum::ArbWriteAccum(std::string /*name*/, IMPL_CTOR) {
 }
 
 void ArbWriteAccum::updateReady() {
-  // TODO: once multiple write sources can be active, refine source-ready
-  // backpressure to account for priority without creating valid/ready loops.
+  // TODO: refine priority among the load-return sources without creating valid/ready loops.
+  // Execute writeback rows cannot stall, so they always hold the bank off from the rest.
+  const bool free = write_rdy != 0 && exwrite_val == 0;
   exwrite_rdy = bit(write_rdy != 0);
-  dmaread_full_rdy = bit(write_rdy != 0);
-  dmaread_rdy = bit(write_rdy != 0);
-  zerowrite_rdy = bit(write_rdy != 0);
+  dmaread_full_rdy = bit(free);
+  dmaread_rdy = bit(free);
+  zerowrite_rdy = bit(free);
 }
 
 void ArbWriteAccum::updateWrite() {
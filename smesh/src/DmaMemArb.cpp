@@ -0,0 +1,80 @@
+// **********************************************************************
+// smesh/src/DmaMemArb.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Jul 18 2026
+/*
+DMA memory-port arbiter implementation.
+*/
+
+#include "DmaMemArb.hpp"
+
+namespace smesh {
+
+DmaMemArb::DmaMemArb(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(updateRequest).reads(rd_req, wr_req).writes(mem_req);
+  UPDATE(updateResponse).reads(mem_resp).writes(rd_resp, wr_ack);
+}
+
+void DmaMemArb::updateRequest() {
+  if (mem_req.full()) {
+    return;
+  }
+  const bool rd = !rd_req.empty();
+  const bool wr = !wr_req.empty();
+  if (!rd && !wr) {
+    return;
+  }
+
+  const bool take_write = wr && (!rd || !last_was_write_);
+  last_was_write_ = take_write;
+  if (take_write) {
+    auto req = wr_req.pop();
+    const auto cmd_id = static_cast<std::uint16_t>(req.id);
+    assert_always((cmd_id & kWriteIdBit) == 0, "DmaMemArb store cmd_id collides with the write-ID tag");
+    req.id = u16(static_cast<std::uint16_t>(kWriteIdBit | cmd_id));
+    mem_req.push(req);
+    ++writes_;
+    trace("dma_mem_arb: write addr=0x%llx bytes=%u cmd_id=%u",
+          static_cast<unsigned long long>(req.addr),
+          static_cast<unsigned>(req.size),
+          static_cast<unsigned>(cmd_id));
+  } else {
+    const auto req = rd_req.pop();
+    assert_always((static_cast<std::uint16_t>(req.id) & kWriteIdBit) == 0, "DmaMemArb read ID collides with the write-ID tag");
+    mem_req.push(req);
+    ++reads_;
+  }
+}
+
+void DmaMemArb::updateResponse() {
+  if (mem_resp.empty()) {
+    return;
+  }
+  const auto& pending = mem_resp.peek();
+  const auto id = static_cast<std::uint16_t>(pending.id);
+  if ((id & kWriteIdBit) != 0) { // store ack
+    if (wr_ack.full()) {
+      return;
+    }
+    mem_resp.pop();
+    DmaWriteResp ack{};
+    ack.cmd_id = u16(static_cast<std::uint16_t>(id & ~kWriteIdBit));
+    wr_ack.push(ack);
+    ++write_acks_;
+    trace("dma_mem_arb: write ack cmd_id=%u", static_cast<unsigned>(ack.cmd_id));
+    return;
+  }
+  if (rd_resp.full()) {
+    return;
+  }
+  rd_resp.push(mem_resp.pop());
+}
+
+void DmaMemArb::reset() {
+  last_was_write_ = true;
+  reads_      = 0;
+  writes_     = 0;
+  write_acks_ = 0;
+}
+
+} // namespace smesh
@@ -3,74 +3,138 @@
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 6 2026
 /*
-Minimal DMA reader implementation.
+DMA reader implementation.
+Each row is fetched as one smem burst (up to kDmaMaxBytes) rather than 8-byte beats.
+Reads are pipelined: the memory ID is the in-flight slot, and rows retire from the
+head slot so resp_out order matches req_in order.
 */
 
 #include "DmaReader.hpp"
 
 namespace smesh {
 
+static_assert(std::tuple_size<DmaReadData>::value <= kDmaMaxBytes, "a DMA row must fit in one memory burst");
+static_assert(kDmaMaxBytes <= smem::kMaxBurstBytes, "dma_max_bytes exceeds the smem burst size");
+
+namespace {
+
+// bytes one row occupies in memory: cols elements, at accumulator width for acc-bitwidth mvins
+std::uint16_t rowBytes(const DmaReadReq& req) {
+  const auto cols = static_cast<std::uint16_t>(req.cols);
+  return static_cast<std::uint16_t>(cols * (req.has_acc_bitwidth != 0 ? sizeof(Acc) : sizeof(Elem)));
+}
+
+} // namespace
+
 DmaReader::DmaReader(std::string /*name*/, IMPL_CTOR) {
   UPDATE(updateRequest).reads(req_in).writes(mem_req);     // update reads from req_in & writes to mem_req
   UPDATE(updateResponse).reads(mem_resp).writes(resp_out);
 }
 
+void DmaReader::setMaxInflight(std::size_t n) {
+  assert_always(n >= 1 && n <= kDmaMaxInflight, "DmaReader max in-flight must be 1..kDmaMaxInflight");
+  assert_always(count_ == 0, "DmaReader: change max in-flight only while idle");
+  max_inflight_ = n;
+}
+
 void DmaReader::updateRequest() {
-  if (waiting_ || req_in.empty() || mem_req.full()) {
+  ++cycles_;
+  occupancy_sum_ += count_;
+  if (req_in.empty() || mem_req.full()) {
+    return;
+  }
+  if (count_ >= max_inflight_) { // in-flight table full: request waits
+    ++full_stall_cycles_;
     return;
   }
 
-  active_ = req_in.pop();
-  const auto bytes = static_cast<std::uint16_t>(active_.cols);
-  assert_always(bytes > 0 && bytes <= sizeof(std::uint64_t), "DmaReader currently supports one 1-to-8-byte row");
+  const auto index = (head_ + count_) % kDmaMaxInflight;
+  auto& slot = slots_[index];
+  slot.req = req_in.pop();
+  const auto bytes = rowBytes(slot.req);
+  assert_always(bytes > 0 && bytes <= std::tuple_size<DmaReadData>::value, "DmaReader row must be 1 to DmaReadData-size bytes");
 
   smem::MemReq req{};
-  req.addr = active_.vaddr;
+  req.addr = slot.req.vaddr;
   req.size = u16(bytes);
   req.write = false;
-  req.id = active_.cmd_id;
+  req.id = u16(static_cast<std::uint16_t>(index)); // slot index tags the transaction
   mem_req.push(req);
-  waiting_ = true;
+  slot.valid = true;
+  slot.done = false;
+  last_req_ = slot.req;
+  ++count_;
+  ++reads_;
+  if (count_ > peak_inflight_) {
+    peak_inflight_ = count_;
+  }
 
-  trace("dma_reader: read addr=0x%llx bytes=%u cmd_id=%u",
+  trace("dma_reader: read addr=0x%llx bytes=%u slot=%u cmd_id=%u inflight=%u",
         static_cast<unsigned long long>(req.addr),
         static_cast<unsigned>(req.size),
-        static_cast<unsigned>(req.id));
+        static_cast<unsigned>(index),
+        static_cast<unsigned>(slot.req.cmd_id),
+        static_cast<unsigned>(count_));
 }
 
 void DmaReader::updateResponse() {
-  if (!waiting_ || mem_resp.empty() || resp_out.full()) {
-    return;
+  // 1) file at most one memory response into its slot
+  if (!mem_resp.empty()) {
+    const auto resp = mem_resp.pop();
+    const auto index = static_cast<std::size_t>(static_cast<std::uint16_t>(resp.id));
+    assert_always(index < kDmaMaxInflight && slots_[index].valid && !slots_[index].done, "DmaReader response ID does not match an outstanding read");
+    assert_always(static_cast<std::uint8_t>(resp.err) == 0, "DmaReader memory response reported an error");
+
+    auto& slot = slots_[index];
+    const auto bytes = rowBytes(slot.req);
+    const auto cols  = static_cast<std::uint16_t>(slot.req.cols);
+    DmaReadResp& dma_resp = slot.resp;
+    dma_resp = DmaReadResp{};
+    smem::get_rdata(resp, dma_resp.data.data(), bytes);
+    dma_resp.laddr         = slot.req.laddr;
+    dma_resp.mask          = u8(cols >= 8 ? 0xffu : ((1u << cols) - 1u)); // one bit per lane
+    dma_resp.has_acc_bitwidth = slot.req.has_acc_bitwidth;
+    dma_resp.scale         = slot.req.scale;
+    dma_resp.repeats       = slot.req.repeats;
+    dma_resp.len           = slot.req.cols;
+    dma_resp.bytes_read    = u16(bytes);
+    dma_resp.pixel_repeats = slot.req.pixel_repeats;
+    dma_resp.cmd_id        = slot.req.cmd_id;
+    dma_resp.last          = true;
+    slot.done = true;
+    if (index != head_) {
+      ++reordered_;
+    }
   }
 
-  const auto resp = mem_resp.pop();
-  assert_always(static_cast<std::uint16_t>(resp.id) == static_cast<std::uint16_t>(active_.cmd_id), "DmaReader response ID does not match active request");
-  assert_always(static_cast<std::uint8_t>(resp.err) == 0, "DmaReader memory response reported an error");
-
-  const auto bytes = static_cast<std::uint16_t>(active_.cols);
-  DmaReadResp dma_resp{};
-  dma_resp.data          = packDmaReadData(resp.rdata);
-  dma_resp.laddr         = active_.laddr;
-  dma_resp.mask          = u8(bytes == 8 ? 0xffu : ((1u << bytes) - 1u));
-  dma_resp.has_acc_bitwidth = active_.has_acc_bitwidth;
-  dma_resp.scale         = active_.scale;
-  dma_resp.repeats       = active_.repeats;
-  dma_resp.len           = active_.cols;
-  dma_resp.bytes_read    = u16(bytes);
-  dma_resp.pixel_repeats = active_.pixel_repeats;
-  dma_resp.cmd_id        = active_.cmd_id;
-  dma_resp.last          = true;
-  resp_out.push(dma_resp);
-  waiting_               = false;
-
-  trace("dma_reader: response data=0x%llx cmd_id=%u",
-        static_cast<unsigned long long>(low64DmaReadData(dma_resp.data)),
-        static_cast<unsigned>(resp.id));
+  // 2) retire the oldest row once its data is back
+  auto& head = slots_[head_];
+  if (count_ == 0 || !head.done || resp_out.full()) {
+    return;
+  }
+  resp_out.push(head.resp);
+  trace("dma_reader: response data=0x%llx slot=%u cmd_id=%u",
+        static_cast<unsigned long long>(low64DmaReadData(head.resp.data)),
+        static_cast<unsigned>(head_),
+        static_cast<unsigned>(head.resp.cmd_id));
+  head = Slot{};
+  head_ = (head_ + 1) % kDmaMaxInflight;
+  --count_;
 }
 
 void DmaReader::reset() {
-  waiting_ = false;
-  active_ = {};
+  for (auto& slot : slots_) {
+    slot = Slot{};
+  }
+  head_  = 0;
+  count_ = 0;
+  last_req_ = {};
+  cycles_            = 0;
+  occupancy_sum_     = 0;
+  reads_             = 0;
+  full_stall_cycles_ = 0;
+  reordered_         = 0;
+  peak_inflight_     = 0;
 }
 
 } // namespace smesh
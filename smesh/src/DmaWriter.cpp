@@ -4,25 +4,15 @@
 // Sebastian Claudiusz Magierowski Jul 13 2026
 /*
 Store-side DMA writer skeleton implementation.
+Each store row leaves as one smem burst carrying all len_bytes of data.
 */
 
 #include "DmaWriter.hpp"
 
 namespace smesh {
 
-namespace {
-
-// Writer currently extracts the low 64 bits since smem::MemReq still has u64 data fields
-std::uint64_t low64(const StWriterData& data) {
-  // TODO: remove this adapter once the external memory write packet carries a full store row.
-  std::uint64_t value = 0;
-  for (std::size_t i = 0; i < data.size() && i < sizeof(value); ++i) {
-    value |= static_cast<std::uint64_t>(data[i]) << (8 * i);
-  }
-  return value;
-}
-
-} // namespace
+static_assert(std::tuple_size<StWriterData>::value <= kDmaMaxBytes, "a store row must fit in one memory burst");
+static_assert(kDmaMaxBytes <= smem::kMaxBurstBytes, "dma_max_bytes exceeds the smem burst size");
 
 DmaWriter::DmaWriter(std::string /*name*/, IMPL_CTOR) {
   UPDATE(updateReady).writes(req_rdy);
@@ -40,15 +30,18 @@ void DmaWriter::update() {
 
   const auto writer_req = *req_bits;
   const auto issue = writer_req.issue;
+  const auto bytes = static_cast<std::uint16_t>(writer_req.len_bytes);
+  assert_always(bytes <= std::tuple_size<StWriterData>::value, "DmaWriter store is wider than StWriterData");
+  static const StWriterData kZeros{};
   smem::MemReq req{};
   req.addr = issue.vaddr;
   req.write = true;
-  req.size = writer_req.len_bytes;
   req.id = issue.cmd_id;
-  req.wdata = writer_req.data_is_all_zeros ? u64(0) : u64(low64(writer_req.data));
+  smem::put_wdata(req, writer_req.data_is_all_zeros ? kZeros.data() : writer_req.data.data(), bytes);
   mem_req.push(req);
-  trace("dma_writer: store vaddr=0x%llx data=0x%llx cmd_id=%u",
+  trace("dma_writer: store vaddr=0x%llx bytes=%u data=0x%llx cmd_id=%u",
         static_cast<unsigned long long>(req.addr),
+        static_cast<unsigned>(bytes),
         static_cast<unsigned long long>(req.wdata),
         static_cast<unsigned>(req.id));
 }
@@ -22,6 +22,11 @@ ExCtrl::ExCtrl(std::string /*name*/, IMPL_CTOR) {
   feed_signals_    = new ExCtrlFeedSignals("ExCtrlFeedSignals");
   mesh_cntl_pack_  = new ExCtrlMeshCntlPack("ExCtrlMeshCntlPack");
   mesh_cntl_queue_ = new ExCtrlMeshCntlQueue("ExCtrlMeshCntlQueue");
+  mesh_cntl_deq_   = new ExCtrlMeshCntlDeqCtrl("ExCtrlMeshCntlDeqCtrl");
+  mesh_in_sel_pad_ = new ExCtrlMeshInSelPad("ExCtrlMeshInSelPad");
+  mesher_          = new Mesher("Mesher");
+  transposer_      = new Transposer("Transposer");
+  writeback_       = new ExCtrlWriteback("ExCtrlWriteback");
 
   cmd_queue_->clk       << clk;
   completion_->clk      << clk;
@@ -37,6 +42,11 @@ ExCtrl::ExCtrl(std::string /*name*/, IMPL_CTOR) {
   feed_signals_->clk    << clk;
   mesh_cntl_pack_->clk  << clk;
   mesh_cntl_queue_->clk << clk;
+  mesh_cntl_deq_->clk   << clk;
+  mesh_in_sel_pad_->clk << clk;
+  mesher_->clk          << clk;
+  transposer_->clk      << clk;
+  writeback_->clk       << clk;
   
   cmd_queue_->cmd_in    << cmd_in;
   cmd_queue_->pop_count << cmd_state_->cmd_pop_count;
@@ -52,11 +62,15 @@ ExCtrl::ExCtrl(std::string /*name*/, IMPL_CTOR) {
     tag_select_->head_bits[i]  << cmd_queue_->head_bits[i];
   }
   for (std::size_t i = 0; i < kRsExecuteEntries; ++i) {
-    cmd_decoder_->tags_in_progress[i] << decoder_tags_in_progress_[i];
+    cmd_decoder_->tags_in_progress[i] << mesher_->tags_in_progress[i];
   }
   cmd_state_->do_config                       << cmd_decoder_->do_config;
   cmd_state_->raw_hazards_are_impossible      << cmd_decoder_->raw_hazards_are_impossible;
   cmd_state_->raw_hazard_pre                  << cmd_decoder_->raw_hazard_pre;
+  cmd_state_->raw_hazard_mulpre               << cmd_decoder_->raw_hazard_mulpre;
+  cmd_state_->c_address_rs2                   << cmd_decoder_->c_address_rs2;
+  cmd_state_->about_to_fire_all_rows          << row_feed_->about_to_fire_all_rows;
+  cmd_state_->mul_pre_en                      << state_mul_pre_en_;
   cmd_state_->a_should_be_fed_into_transposer << cmd_decoder_->a_should_be_fed_into_transposer;
   cmd_state_->b_should_be_fed_into_transposer << cmd_decoder_->b_should_be_fed_into_transposer;
   cmd_state_->d_should_be_fed_into_transposer << cmd_decoder_->d_should_be_fed_into_transposer;
@@ -75,6 +89,12 @@ ExCtrl::ExCtrl(std::string /*name*/, IMPL_CTOR) {
   completion_->config_val          << cmd_state_->config_val;
   completion_->config_rs_tag_valid << cmd_state_->config_rs_tag_valid;
   completion_->config_rs_tag       << cmd_state_->config_rs_tag;
+  completion_->mesh_completed_val  << writeback_->completed_val;
+  completion_->mesh_completed_bits << writeback_->completed_bits;
+  for (std::size_t i = 0; i < 2; ++i) {
+    completion_->ex_pending_val[i]  << cmd_state_->ex_pending_val[i];
+    completion_->ex_pending_bits[i] << cmd_state_->ex_pending_bits[i];
+  }
   // send out completed signals from ExCtrl
   completed_val  << completion_->completed_val;
   completed_bits << completion_->completed_bits;
@@ -108,7 +128,7 @@ ExCtrl::ExCtrl(std::string /*name*/, IMPL_CTOR) {
 
   // mesh completion-tag selection for future mesh-control queue enqueue path
   tag_select_->preload_cmd_place     << cmd_decoder_->preload_cmd_place;
-  tag_select_->performing_single_mul << tag_select_performing_single_mul_; // temp until FSM exposes this mode
+  tag_select_->performing_single_mul << cmd_state_->performing_single_mul;
   tag_select_->c_address_rs2         << cmd_decoder_->c_address_rs2;
 
   // operand packaging for A/B/D read-priority logic
@@ -128,7 +148,7 @@ ExCtrl::ExCtrl(std::string /*name*/, IMPL_CTOR) {
   op_pack_->b_fire_started     << row_feed_->b_fire_started;
   op_pack_->d_fire_started     << row_feed_->d_fire_started;
 
-  // A/B/D read-priority gating; im2col is explicitly idle in this model stage.
+  // A/B/D read-priority gating; im2col stays idle (LOOP_CONV gathers rows with strided MVINs).
   read_prio_->a_operand    << op_pack_->a_operand;
   read_prio_->b_operand    << op_pack_->b_operand;
   read_prio_->d_operand    << op_pack_->d_operand;
@@ -169,8 +189,8 @@ ExCtrl::ExCtrl(std::string /*name*/, IMPL_CTOR) {
     rd_req_->accum_read_req_rdy[bank] << accum_read_req_rdy[bank];
   }
 
-  // Derived row-feed handshake signals. These will drive row-feed state and MQ
-  // packaging once those paths are connected.
+  // Derived row-feed handshake signals: they advance row-feed state and mark
+  // which streams each MQ packet carries.
   feed_signals_->start_inputting_a << cmd_state_->start_inputting_a;
   feed_signals_->start_inputting_b << cmd_state_->start_inputting_b;
   feed_signals_->start_inputting_d << cmd_state_->start_inputting_d;
@@ -189,10 +209,9 @@ ExCtrl::ExCtrl(std::string /*name*/, IMPL_CTOR) {
   row_feed_->a_addr_stride << cmd_state_->a_addr_stride;
   row_feed_->cntl_rdy      << cntl_rdy_;
 
-  // Mesh-control packet packaging. Its output will feed MQ once MQ is installed
-  // inside ExCtrl.
-  mesh_cntl_pack_->perform_mul_pre        << mesh_cntl_pack_perform_mul_pre_;
-  mesh_cntl_pack_->perform_single_mul     << tag_select_performing_single_mul_;
+  // Mesh-control packet packaging for MQ.
+  mesh_cntl_pack_->perform_mul_pre        << cmd_state_->performing_mul_pre;
+  mesh_cntl_pack_->perform_single_mul     << cmd_state_->performing_single_mul;
   mesh_cntl_pack_->perform_single_preload << cmd_state_->performing_single_preload;
   mesh_cntl_pack_->a_bank                 << cmd_rowaddr_->dataAbank;
   mesh_cntl_pack_->b_bank                 << cmd_rowaddr_->dataBbank;
@@ -228,36 +247,104 @@ ExCtrl::ExCtrl(std::string /*name*/, IMPL_CTOR) {
   mesh_cntl_pack_->im2colling             << im2colling_;
   mesh_cntl_pack_->first                  << row_feed_->first;
 
-  // MQ: one control packet per active row-feed cycle. Dequeue is held idle
-  // until the Mesher/deq-control side is installed in ExCtrl.
+  // MQ: one control packet per active row-feed cycle, popped as its rows enter Mesher.
   mesh_cntl_queue_->enq_val            << cmd_state_->computing;
   mesh_cntl_queue_->enq_bits           << mesh_cntl_pack_->enq_bits;
-  mesh_cntl_queue_->mesh_cntl_deq_rdy  << mesh_cntl_deq_rdy_;
+  mesh_cntl_queue_->mesh_cntl_deq_rdy  << mesh_cntl_deq_->mesh_cntl_deq_rdy;
+
+  // MQ head selects and pads the operand rows returned by Spad/Accum
+  mesh_in_sel_pad_->cntl_val    << mesh_cntl_queue_->cntl_val;
+  mesh_in_sel_pad_->cntl_bits   << mesh_cntl_queue_->cntl_bits;
+  mesh_in_sel_pad_->im2col_data << im2col_data_;
+  mesh_in_sel_pad_->im2col_val  << im2col_wire_;
+  mesh_in_sel_pad_->mesh_a_rdy  << mesher_->a_rdy;
+  mesh_in_sel_pad_->mesh_b_rdy  << mesher_->b_rdy;
+  mesh_in_sel_pad_->mesh_d_rdy  << mesher_->d_rdy;
+  for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
+    mesh_in_sel_pad_->spad_read_val[bank]  << spad_read_resp_val[bank];
+    mesh_in_sel_pad_->spad_read_data[bank] << spad_read_resp_bits[bank];
+  }
+  for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
+    mesh_in_sel_pad_->accum_read_val[bank]  << accum_read_resp_val[bank];
+    mesh_in_sel_pad_->accum_read_data[bank] << accum_read_resp_bits[bank];
+  }
+  // a bank's read response is popped as the operand row it holds enters Mesher
+  for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
+    spad_read_resp_rdy[bank] << mesh_in_sel_pad_->spad_read_rdy[bank];
+  }
+  for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
+    accum_read_resp_rdy[bank] << mesh_in_sel_pad_->accum_read_rdy[bank];
+  }
+
+  // MQ pops once its A/B/D rows are taken; the first packet of a matmul also issues the Mesher request
+  mesh_cntl_deq_->control_state << cmd_state_->control_state;
+  mesh_cntl_deq_->cntl_val      << mesh_cntl_queue_->cntl_val;
+  mesh_cntl_deq_->cntl_bits     << mesh_cntl_queue_->cntl_bits;
+  mesh_cntl_deq_->mesh_a_fire   << mesh_in_sel_pad_->mesh_a_fire;
+  mesh_cntl_deq_->mesh_b_fire   << mesh_in_sel_pad_->mesh_b_fire;
+  mesh_cntl_deq_->mesh_d_fire   << mesh_in_sel_pad_->mesh_d_fire;
+  mesh_cntl_deq_->mesh_a_rdy    << mesher_->a_rdy;
+  mesh_cntl_deq_->mesh_b_rdy    << mesher_->b_rdy;
+  mesh_cntl_deq_->mesh_d_rdy    << mesher_->d_rdy;
+  mesh_cntl_deq_->mesh_req_rdy  << mesher_->req_rdy;
+
+  mesher_->req_val  << mesh_cntl_deq_->mesh_cntl_req_val;
+  mesher_->req_bits << mesh_cntl_queue_->mesh_req_bits;
+  mesher_->a_val    << mesh_in_sel_pad_->mesh_a_val;
+  mesher_->a_bits   << mesh_in_sel_pad_->mesh_a;
+  mesher_->b_val    << mesh_in_sel_pad_->mesh_b_val;
+  mesher_->b_bits   << mesh_in_sel_pad_->mesh_b;
+  mesher_->d_val    << mesh_in_sel_pad_->mesh_d_val;
+  mesher_->d_bits   << mesh_in_sel_pad_->mesh_d;
+  // the one operand the dataflow/transpose config picks runs through the transposer
+  transposer_->in_row_val          << mesher_->transposer_in_row_val;
+  transposer_->in_row_bits         << mesher_->transposer_in_row_bits;
+  mesher_->transposer_out_col_bits << transposer_->out_col_bits;
+
+  // mesh results land in Spad/Accum at the tag's C address; the writeback has priority on each bank
+  writeback_->mesh_resp_val    << mesher_->resp_val;
+  writeback_->mesh_resp_bits   << mesher_->resp_bits;
+  writeback_->current_dataflow << cmd_state_->current_dataflow;
+  writeback_->c_addr_stride    << cmd_state_->c_addr_stride;
+  writeback_->activation       << cmd_state_->activation;
+  writeback_->relu6_shift      << cmd_state_->relu6_shift;
+  writeback_->aligned_to       << writeback_aligned_to_;
+  writeback_->ex_write_to_spad << decoder_ex_write_to_spad_;
+  writeback_->ex_write_to_acc  << writeback_ex_write_to_acc_;
+  for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
+    writeback_->spad_write_rdy[bank] << spad_write_rdy[bank];
+    spad_write_val[bank]             << writeback_->spad_write_val[bank];
+    spad_write_bits[bank]            << writeback_->spad_write_bits[bank];
+  }
+  for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
+    writeback_->accum_write_rdy[bank] << accum_write_rdy[bank];
+    accum_write_val[bank]             << writeback_->accum_write_val[bank];
+    accum_write_bits[bank]            << writeback_->accum_write_bits[bank];
+  }
 
   UPDATE(updateReadPorts).writes(spad_read_req_val,
                                  spad_read_req_bits,
-                                 spad_read_resp_rdy,
                                  accum_read_req_val,
-                                 accum_read_req_bits,
-                                 accum_read_resp_rdy);
-  UPDATE(updateWritePorts).writes(spad_write_val,
-                                  spad_write_bits,
-                                  accum_write_val,
-                                  accum_write_bits);
+                                 accum_read_req_bits);
   UPDATE(updateDecoderInputs).writes(decoder_ex_read_from_acc_,
                                      decoder_ex_write_to_spad_,
-                                     mesh_cntl_pack_perform_mul_pre_,
-                                     tag_select_performing_single_mul_,
+                                     state_mul_pre_en_,
                                      im2col_wire_,
                                      im2col_en_)
                              .writes(im2colling_,
-                                     mesh_cntl_deq_rdy_,
+                                     im2col_data_,
                                      cntl_rdy_,
-                                     decoder_tags_in_progress_,
-                                     row_addr_block_size_);
+                                     row_addr_block_size_)
+                             .writes(writeback_aligned_to_,
+                                     writeback_ex_write_to_acc_);
 }
 
 ExCtrl::~ExCtrl() {
+  delete writeback_;
+  delete transposer_;
+  delete mesher_;
+  delete mesh_in_sel_pad_;
+  delete mesh_cntl_deq_;
   delete mesh_cntl_queue_;
   delete mesh_cntl_pack_;
   delete feed_signals_;
@@ -281,7 +368,6 @@ void ExCtrl::updateReadPorts() {
     req.from_dma             = rd_req_->spad_read_req_from_dma[bank];
     spad_read_req_val[bank]  = rd_req_->spad_read_req_val[bank];
     spad_read_req_bits[bank] = req;
-    spad_read_resp_rdy[bank] = 0;
   }
 
   for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
@@ -297,66 +383,45 @@ void ExCtrl::updateReadPorts() {
     req.from_dma              = rd_req_->accum_read_req_from_dma[bank];
     accum_read_req_val[bank]  = rd_req_->accum_read_req_val[bank];
     accum_read_req_bits[bank] = req;
-    accum_read_resp_rdy[bank] = 0;
   }
 }
 
-void ExCtrl::updateWritePorts() {
-  spad_write_val  = 0;
-  spad_write_bits = DmaReadResp{};
-
-  accum_write_val  = 0;
-  accum_write_bits = DmaReadResp{}; 
-}
-
 void ExCtrl::updateDecoderInputs() {
   decoder_ex_read_from_acc_         = bit(kDefaultConfig.ex_read_from_acc);
   decoder_ex_write_to_spad_         = bit(kDefaultConfig.ex_write_to_spad);
-  mesh_cntl_pack_perform_mul_pre_   = 0;
-  tag_select_performing_single_mul_ = 0;
+  state_mul_pre_en_                 = bit(preload_overlap_);
   im2col_wire_                      = 0;
   im2col_en_                        = 0;
   im2colling_                       = 0;
-  mesh_cntl_deq_rdy_ = 0; // TODO: connect to ExCtrlMeshCntlDeqCtrl once installed in ExCtrl.
+  im2col_data_                      = 0;
   cntl_rdy_ = mesh_cntl_queue_->enq_rdy;
-  for (std::size_t i = 0; i < kRsExecuteEntries; ++i) {
-    decoder_tags_in_progress_[i] = MesherTag{};
-  }
   row_addr_block_size_      = static_cast<u32>(kDefaultConfig.dim);
+  writeback_aligned_to_     = 0;
+  writeback_ex_write_to_acc_ = 1;
 }
 
 void ExCtrl::reset() {
   decoder_ex_read_from_acc_.reset(bit(kDefaultConfig.ex_read_from_acc));
   decoder_ex_write_to_spad_.reset(bit(kDefaultConfig.ex_write_to_spad));
-  mesh_cntl_pack_perform_mul_pre_.reset(0);
-  tag_select_performing_single_mul_.reset(0);
+  state_mul_pre_en_.reset(bit(preload_overlap_));
   im2col_wire_.reset(0);
   im2col_en_.reset(0);
   im2colling_.reset(0);
-  mesh_cntl_deq_rdy_.reset(0);
+  im2col_data_.reset(0);
   cntl_rdy_.reset(1);
-  for (std::size_t i = 0; i < kRsExecuteEntries; ++i) {
-    decoder_tags_in_progress_[i].reset(MesherTag{});
-  }
   row_addr_block_size_.reset(static_cast<u32>(kDefaultConfig.dim));
+  writeback_aligned_to_.reset(0);
+  writeback_ex_write_to_acc_.reset(1);
 
   for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
     spad_read_req_val[bank].reset(0);
     spad_read_req_bits[bank].reset(SpadReadReq{});
-    spad_read_resp_rdy[bank].reset(0);
   }
 
   for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
     accum_read_req_val[bank].reset(0);
     accum_read_req_bits[bank].reset(AccumReadReq{});
-    accum_read_resp_rdy[bank].reset(0);
   }
-
-  spad_write_val.reset(0);
-  spad_write_bits.reset(DmaReadResp{});
-
-  accum_write_val.reset(0);
-  accum_write_bits.reset(DmaReadResp{});
 }
 
 } // namespace smesh
@@ -10,30 +10,76 @@ namespace smesh {
 ExCtrlCompletion::ExCtrlCompletion(std::string /*name*/, IMPL_CTOR) {
   UPDATE(updatePendingView)
       .writes(pending_completed_valid);
-  UPDATE(updateConfigCompletion)
-      .reads(config_val, config_rs_tag_valid, config_rs_tag)
+  UPDATE(updateCompletion)
+      .reads(config_val, config_rs_tag_valid, config_rs_tag,
+             mesh_completed_val, mesh_completed_bits,
+             ex_pending_val, ex_pending_bits)
       .writes(completed_val, completed_bits);
 }
 // are any pending completion registers occupied?
 void ExCtrlCompletion::updatePendingView() {
-  pending_completed_valid = bit(pending_completed_valid_[0] || pending_completed_valid_[1]);
+  bool any = false;
+  for (std::size_t i = 0; i < kPending; ++i) {
+    any = any || pending_completed_valid_[i];
+  }
+  pending_completed_valid = bit(any);
 }
-// direct the correct signal to completion block completed output
-void ExCtrlCompletion::updateConfigCompletion() {
+
+void ExCtrlCompletion::park(SmeshRsTag tag) {
+  for (std::size_t i = 0; i < kPending; ++i) {
+    if (!pending_completed_valid_[i]) {
+      pending_completed_valid_[i] = true;
+      pending_completed_bits_[i]  = tag;
+      return;
+    }
+  }
+  assert_always(false, "ExCtrlCompletion has no free pending register");
+}
+// direct the correct signal to completion block completed output (mesh > pending > config)
+void ExCtrlCompletion::updateCompletion() {
   completed_val  = 0;
   completed_bits = 0;
 
-  if (config_val != 0) {
-    completed_val  = config_rs_tag_valid;
-    completed_bits = config_rs_tag;
+  bool port_busy = false;
+  if (mesh_completed_val != 0) {
+    completed_val  = 1;
+    completed_bits = *mesh_completed_bits;
+    port_busy      = true;
+  } else {
+    for (std::size_t i = 0; i < kPending && !port_busy; ++i) {
+      if (pending_completed_valid_[i]) {
+        completed_val  = 1;
+        completed_bits = pending_completed_bits_[i];
+        pending_completed_valid_[i] = false;
+        port_busy = true;
+      }
+    }
+  }
+
+  // retired COMPUTE/PRELOAD tags queue up behind whatever holds the port
+  for (std::size_t i = 0; i < 2; ++i) {
+    if (ex_pending_val[i] != 0) {
+      park(*ex_pending_bits[i]);
+    }
+  }
+
+  if (config_val == 0 || config_rs_tag_valid == 0) {
+    return;
   }
+  if (!port_busy) {
+    completed_val  = 1;
+    completed_bits = *config_rs_tag;
+    return;
+  }
+  // park the CONFIG completion behind the one that won the port
+  park(*config_rs_tag);
 }
 
 void ExCtrlCompletion::reset() {
-  pending_completed_valid_[0] = false;
-  pending_completed_valid_[1] = false;
-  pending_completed_bits_[0] = 0;
-  pending_completed_bits_[1] = 0;
+  for (std::size_t i = 0; i < kPending; ++i) {
+    pending_completed_valid_[i] = false;
+    pending_completed_bits_[i]  = 0;
+  }
 
   pending_completed_valid.reset(0);
   completed_val.reset(0);
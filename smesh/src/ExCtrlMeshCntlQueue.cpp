@@ -22,6 +22,10 @@ ExCtrlMeshReq makeMeshReq(const ExCtrlMeshCntl& cntl) {
   req.tag.addr             = cntl.c_addr;
   req.tag.rows             = cntl.c_rows;
   req.tag.cols             = cntl.c_cols;
+  // a lone COMPUTE preloads nothing, so no result of the mesh belongs to its tag
+  if (cntl.perform_single_mul != 0) {
+    req.tag.addr = makeGarbageAddr();
+  }
   req.flush = 0;
   return req;
 }
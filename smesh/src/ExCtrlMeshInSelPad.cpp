@@ -48,7 +48,8 @@ ExCtrlMeshInSelPad::ExCtrlMeshInSelPad(std::string /*name*/, IMPL_CTOR) {
       .reads(accum_read_val, spad_read_data)
       .reads(accum_read_data)
       .writes(mesh_a, mesh_b, mesh_d, mesh_a_val, mesh_b_val, mesh_d_val)
-      .writes(mesh_a_fire, mesh_b_fire, mesh_d_fire);
+      .writes(mesh_a_fire, mesh_b_fire, mesh_d_fire)
+      .writes(spad_read_rdy, accum_read_rdy);
 }
 
 void ExCtrlMeshInSelPad::update() {
@@ -102,9 +103,27 @@ void ExCtrlMeshInSelPad::update() {
   mesh_a_val = next_mesh_a_val;
   mesh_b_val = next_mesh_b_val;
   mesh_d_val = next_mesh_d_val;
-  mesh_a_fire = bit(static_cast<bool>(next_mesh_a_val) && mesh_a_rdy != 0);
-  mesh_b_fire = bit(static_cast<bool>(next_mesh_b_val) && mesh_b_rdy != 0);
-  mesh_d_fire = bit(static_cast<bool>(next_mesh_d_val) && mesh_d_rdy != 0);
+  const bool a_fire = next_mesh_a_val != 0 && mesh_a_rdy != 0;
+  const bool b_fire = next_mesh_b_val != 0 && mesh_b_rdy != 0;
+  const bool d_fire = next_mesh_d_val != 0 && mesh_d_rdy != 0;
+  mesh_a_fire = bit(a_fire);
+  mesh_b_fire = bit(b_fire);
+  mesh_d_fire = bit(d_fire);
+
+  // an operand consumed a memory read only if it was neither zero, garbage, fully padded nor im2col
+  const bool a_read = a_fire && cntl.a_garbage == 0 && cntl.a_unpadded_cols != 0 && cntl.im2colling == 0;
+  const bool b_read = b_fire && cntl.b_garbage == 0 && cntl.b_unpadded_cols != 0 && cntl.accumulate_zeros == 0;
+  const bool d_read = d_fire && cntl.d_garbage == 0 && cntl.d_unpadded_cols != 0 && cntl.preload_zeros == 0;
+  for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
+    spad_read_rdy[bank] = bit((a_read && cntl.a_read_from_acc == 0 && a_spad_index == bank) ||
+                              (b_read && cntl.b_read_from_acc == 0 && b_spad_index == bank) ||
+                              (d_read && cntl.d_read_from_acc == 0 && d_spad_index == bank));
+  }
+  for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
+    accum_read_rdy[bank] = bit((a_read && cntl.a_read_from_acc != 0 && a_acc_index == bank) ||
+                               (b_read && cntl.b_read_from_acc != 0 && b_acc_index == bank) ||
+                               (d_read && cntl.d_read_from_acc != 0 && d_acc_index == bank));
+  }
 }
 
 } // namespace smesh
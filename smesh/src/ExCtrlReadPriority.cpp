@@ -5,18 +5,64 @@
 
 #include "ExCtrlReadPriority.hpp"
 
+#include <array>
+
 namespace smesh {
 
+namespace {
+
+// operand issues a real Spad/Accum read (not garbage, not idle)
+bool readsMemory(const ExCtrlOperand& op) {
+  return op.start_inputting != 0 && op.is_garbage == 0;
+}
+// operand already fed every row of the current operation
+bool isDone(const ExCtrlOperand& op) {
+  return op.started != 0 && op.counter == 0;
+}
+// both operands land on the same single-ported bank
+bool sameBank(const ExCtrlOperand& x, const ExCtrlOperand& y) {
+  if (x.addr.is_acc_addr() != y.addr.is_acc_addr()) {
+    return false;
+  }
+  return x.addr.is_acc_addr() ? x.addr.acc_bank() == y.addr.acc_bank()
+                              : x.addr.sp_bank() == y.addr.sp_bank();
+}
+
+} // namespace
+
 ExCtrlReadPriority::ExCtrlReadPriority(std::string /*name*/, IMPL_CTOR) {
   UPDATE(update)
       .reads(a_operand, b_operand, d_operand, total_rows, im2col_wire, im2col_en)
       .writes(a_valid, b_valid, d_valid);
 }
 
+// While any stream is being fed, A/B/D advance row by row in lockstep (garbage
+// streams included, so Mesher always sees a complete row). A stream waits when
+// it is a row ahead of another live stream, or when a higher-priority stream
+// wants the same bank for the same row.
 void ExCtrlReadPriority::update() {
-  a_valid = 0;
-  b_valid = 0;
-  d_valid = 0;
+  const std::array<ExCtrlOperand, 3> ops{{*a_operand, *b_operand, *d_operand}};
+  const bool firing = ops[0].start_inputting != 0 || ops[1].start_inputting != 0 || ops[2].start_inputting != 0;
+
+  std::array<bool, 3> valid{};
+  for (std::size_t i = 0; i < ops.size(); ++i) {
+    valid[i] = firing && !isDone(ops[i]);
+    for (std::size_t j = 0; j < ops.size() && valid[i]; ++j) {
+      if (j == i || isDone(ops[j])) {
+        continue;
+      }
+      const bool behind   = ops[j].counter < ops[i].counter;
+      const bool conflict = ops[j].counter == ops[i].counter &&
+                            ops[j].priority < ops[i].priority &&
+                            readsMemory(ops[i]) && readsMemory(ops[j]) &&
+                            sameBank(ops[i], ops[j]);
+      valid[i] = !behind && !conflict;
+    }
+  }
+
+  a_valid = bit(valid[0]);
+  b_valid = bit(valid[1]);
+  d_valid = bit(valid[2]);
 }
 
 } // namespace smesh
@@ -55,29 +55,59 @@ ExCtrlReadReqLogic::ExCtrlReadReqLogic(std::string /*name*/, IMPL_CTOR) {
               accum_read_req_from_dma);
 }
 
+// An operand reads its bank only when it is live this beat: granted by
+// ExCtrlReadPriority, fed by the FSM, and not zero, garbage or row padding.
+// A stream is held back (ready low) by its own bank refusing the request, or
+// by a full mesh-control queue, which could not record the row-beat.
 void ExCtrlReadReqLogic::update() {
-  a_ready = 0;
-  b_ready = 0;
-  d_ready = 0;
+  const bool read_a = a_valid != 0 && start_inputting_a != 0 && multiply_garbage == 0 && a_row_is_not_all_zeros != 0;
+  const bool read_b = b_valid != 0 && start_inputting_b != 0 && accumulate_zeros == 0 && b_row_is_not_all_zeros != 0;
+  const bool read_d = d_valid != 0 && start_inputting_d != 0 && preload_zeros == 0 && d_row_is_not_all_zeros != 0;
+  const bool cntl   = cntl_rdy != 0;
+
+  bool next_a_ready = cntl;
+  bool next_b_ready = cntl;
+  bool next_d_ready = cntl;
 
   for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
-    spad_read_req_val[bank] = 0;
-    spad_read_req_addr[bank] = SmeshLocalAddr{};
+    const bool rd_a = read_a && a_read_from_acc == 0 && dataAbank == bank;
+    const bool rd_b = read_b && b_read_from_acc == 0 && dataBbank == bank;
+    const bool rd_d = read_d && d_read_from_acc == 0 && dataDbank == bank;
+    const bool rdy  = spad_read_req_rdy[bank] != 0;
+    next_a_ready = next_a_ready && !(rd_a && !rdy);
+    next_b_ready = next_b_ready && !(rd_b && !rdy);
+    next_d_ready = next_d_ready && !(rd_d && !rdy);
+
+    spad_read_req_val[bank]      = bit((rd_a || rd_b || rd_d) && cntl);
+    spad_read_req_addr[bank]     = rd_a ? *a_address : rd_b ? *b_address : *d_address;
     spad_read_req_from_dma[bank] = 0;
   }
 
   for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
-    accum_read_req_val[bank] = 0;
-    accum_read_req_addr[bank] = SmeshLocalAddr{};
-    accum_read_req_scale[bank] = 0;
-    accum_read_req_full[bank] = 0;
-    accum_read_req_act[bank] = 0;
-    accum_read_req_igelu_qb[bank] = 0;
-    accum_read_req_igelu_qc[bank] = 0;
-    accum_read_req_iexp_qln2[bank] = 0;
+    const bool rd_a = read_a && a_read_from_acc != 0 && dataABankAcc == bank;
+    const bool rd_b = read_b && b_read_from_acc != 0 && dataBBankAcc == bank;
+    const bool rd_d = read_d && d_read_from_acc != 0 && dataDBankAcc == bank;
+    const bool rdy  = accum_read_req_rdy[bank] != 0;
+    next_a_ready = next_a_ready && !(rd_a && !rdy);
+    next_b_ready = next_b_ready && !(rd_b && !rdy);
+    next_d_ready = next_d_ready && !(rd_d && !rdy);
+
+    // execute reads take the raw accumulator row: no activation, no rescale, narrow width
+    accum_read_req_val[bank]           = bit((rd_a || rd_b || rd_d) && cntl);
+    accum_read_req_addr[bank]          = rd_a ? *a_address : rd_b ? *b_address : *d_address;
+    accum_read_req_scale[bank]         = 0;
+    accum_read_req_full[bank]          = 0;
+    accum_read_req_act[bank]           = 0;
+    accum_read_req_igelu_qb[bank]      = 0;
+    accum_read_req_igelu_qc[bank]      = 0;
+    accum_read_req_iexp_qln2[bank]     = 0;
     accum_read_req_iexp_qln2_inv[bank] = 0;
-    accum_read_req_from_dma[bank] = 0;
+    accum_read_req_from_dma[bank]      = 0;
   }
+
+  a_ready = bit(next_a_ready);
+  b_ready = bit(next_b_ready);
+  d_ready = bit(next_d_ready);
 }
 
 } // namespace smesh
@@ -7,6 +7,22 @@
 
 namespace smesh {
 
+namespace {
+
+// a stream has fed every row once its final row-beat fires, or once it has already wrapped
+bool streamDone(std::uint32_t counter, bool started, bool fire, std::uint32_t total_rows) {
+  return (fire && counter + 1 >= total_rows) || (started && counter == 0);
+}
+
+std::uint32_t nextCounter(std::uint32_t counter, bool fire, std::uint32_t total_rows) {
+  if (!fire) {
+    return counter;
+  }
+  return counter + 1 >= total_rows ? 0u : counter + 1;
+}
+
+} // namespace
+
 ExCtrlRowFeedState::ExCtrlRowFeedState(std::string /*name*/, IMPL_CTOR) {
   UPDATE(updateView)
       .writes(a_fire_counter,
@@ -20,8 +36,12 @@ ExCtrlRowFeedState::ExCtrlRowFeedState(std::string /*name*/, IMPL_CTOR) {
               mul_pre_counter_sub)
       .writes(mul_pre_counter_count,
               mul_pre_counter_lock,
-              preload_zero_counter,
-              about_to_fire_all_rows);
+              preload_zero_counter);
+  UPDATE(updateAboutToFire)
+      .reads(a_fire, b_fire, d_fire, total_rows, cntl_rdy)
+      .writes(about_to_fire_all_rows);
+  UPDATE(updateState)
+      .reads(firing, a_fire, b_fire, d_fire, total_rows, a_addr_stride, cntl_rdy);
 }
 
 void ExCtrlRowFeedState::updateView() {
@@ -37,7 +57,44 @@ void ExCtrlRowFeedState::updateView() {
   mul_pre_counter_count  = mul_pre_counter_count_;
   mul_pre_counter_lock   = bit(mul_pre_counter_lock_);
   preload_zero_counter   = preload_zero_counter_;
-  about_to_fire_all_rows = 0;
+}
+
+bool ExCtrlRowFeedState::allRowsFired() {
+  const auto rows = static_cast<std::uint32_t>(*total_rows);
+  return streamDone(a_fire_counter_, a_fire_started_, a_fire != 0, rows) &&
+         streamDone(b_fire_counter_, b_fire_started_, b_fire != 0, rows) &&
+         streamDone(d_fire_counter_, d_fire_started_, d_fire != 0, rows) &&
+         cntl_rdy != 0;
+}
+
+void ExCtrlRowFeedState::updateAboutToFire() {
+  about_to_fire_all_rows = bit(allRowsFired());
+}
+
+// Advance the counters on every accepted row-beat. The A address steps by
+// a_addr_stride and rewinds with its counter; finishing the operation clears
+// the started flags so the next packet is marked first.
+void ExCtrlRowFeedState::updateState() {
+  const auto rows = static_cast<std::uint32_t>(*total_rows);
+  const bool finished = allRowsFired();
+
+  if (a_fire != 0) {
+    const auto next = nextCounter(a_fire_counter_, true, rows);
+    a_addr_offset_ = next == 0 ? 0u : a_addr_offset_ + static_cast<std::uint32_t>(*a_addr_stride);
+    a_fire_counter_ = next;
+  }
+  b_fire_counter_ = nextCounter(b_fire_counter_, b_fire != 0, rows);
+  d_fire_counter_ = nextCounter(d_fire_counter_, d_fire != 0, rows);
+
+  if (finished || firing == 0) {
+    a_fire_started_ = false;
+    b_fire_started_ = false;
+    d_fire_started_ = false;
+  } else {
+    a_fire_started_ = a_fire_started_ || a_fire != 0;
+    b_fire_started_ = b_fire_started_ || b_fire != 0;
+    d_fire_started_ = d_fire_started_ || d_fire != 0;
+  }
 }
 
 void ExCtrlRowFeedState::reset() {
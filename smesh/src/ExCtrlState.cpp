@@ -5,6 +5,8 @@
 
 #include "ExCtrlState.hpp"
 
+#include "Activation.hpp"
+
 namespace smesh {
 
 ExCtrlState::ExCtrlState(std::string /*name*/, IMPL_CTOR) {
@@ -13,11 +15,14 @@ ExCtrlState::ExCtrlState(std::string /*name*/, IMPL_CTOR) {
              head_bits,
              do_config,
              do_preloads,
+             do_computes,
              matmul_in_progress,
              pending_completed_valid,
-             raw_hazards_are_impossible,
-             raw_hazard_pre)
-      .reads(a_should_be_fed_into_transposer,
+             raw_hazards_are_impossible)
+      .reads(raw_hazard_pre,
+             raw_hazard_mulpre,
+             mul_pre_en,
+             a_should_be_fed_into_transposer,
              b_should_be_fed_into_transposer,
              d_should_be_fed_into_transposer,
              in_prop)
@@ -27,18 +32,25 @@ ExCtrlState::ExCtrlState(std::string /*name*/, IMPL_CTOR) {
               current_dataflow,
               a_addr_stride,
               c_addr_stride,
-              shift)
+              shift,
+              activation,
+              relu6_shift)
       .writes(
               config_val,
               config_rs_tag_valid,
               config_rs_tag,
               performing_single_preload,
-              computing,
-              start_inputting_a,
-              start_inputting_b)
-      .writes(start_inputting_d,
+              performing_mul_pre,
+              performing_single_mul,
+              computing)
+      .writes(start_inputting_a,
+              start_inputting_b,
+              start_inputting_d,
               prop,
-              cmd_pop_count);
+              control_state);
+  UPDATE(updateProgress)
+      .reads(about_to_fire_all_rows, head_val, head_bits, c_address_rs2)
+      .writes(cmd_pop_count, ex_pending_val, ex_pending_bits);
 }
 
 void ExCtrlState::update() {
@@ -46,16 +58,27 @@ void ExCtrlState::update() {
   config_rs_tag_valid    = 0;
   config_rs_tag          = 0;
   performing_single_preload = 0;
+  performing_mul_pre     = 0;
+  performing_single_mul  = 0;
   computing              = 0;
   start_inputting_a      = 0;
   start_inputting_b      = 0;
   start_inputting_d      = 0;
   prop                   = 0;
-  cmd_pop_count          = 0;
-  bool taking_single_preload = false;
+  control_state          = static_cast<std::uint8_t>(state_);
+  was_computing_         = state_ == ExCtrlFsmState::Compute;
+  config_taken_          = false;
+  bool taking_op         = false;
 
   switch (state_) {
     case ExCtrlFsmState::WaitingForCmd: {
+      const bool raw_free_pre = raw_hazards_are_impossible != 0 || raw_hazard_pre == 0;
+      // COMPUTE at cmd(0) with its successor's PRELOAD at cmd(1); cmd(2) is needed for the RAW check
+      const bool mul_pre_pair = mul_pre_en != 0 && head_val[0] != 0 && do_computes[0] != 0 &&
+                                head_val[1] != 0 && do_preloads[1] != 0;
+      const bool raw_free_mulpre = raw_hazards_are_impossible != 0 ||
+                                   (head_val[2] != 0 && raw_hazard_mulpre == 0);
+      const bool waiting_for_third = mul_pre_pair && raw_hazards_are_impossible == 0 && head_val[2] == 0;
       // if cmd(0) has valid CONFIG and we can accept it
       if (head_val[0] != 0 && do_config != 0 && matmul_in_progress == 0 && pending_completed_valid == 0) {
         const auto issue = *head_bits[0];
@@ -66,14 +89,19 @@ void ExCtrlState::update() {
         config_val          = 1;
         config_rs_tag_valid = issue.rs_tag_valid;
         config_rs_tag       = issue.rs_tag;
-        // tell cmd q how many entries to pop (1 for CONFIG)
-        cmd_pop_count       = 1; 
+        // tell cmd q to pop the CONFIG (updateProgress drives the pop count)
+        config_taken_       = true;
 
         if (kind == ConfigKind::Execute) {
           const bool set_only_strides = unpackConfigExecuteSetOnlyStrides(rs1);
           config_initialized_ = true;
           if (!set_only_strides) {
             in_shift_         = static_cast<std::uint8_t>(unpackConfigExecuteInShift(rs2));
+            activation_       = static_cast<std::uint8_t>(unpackConfigExecuteActivation(rs1));
+            // CONFIG_EX has no room for the I-GELU constants; those activations belong on CONFIG_ST
+            assert_always(decodeActivation(activation_) != Activation::IGelu,
+                          "CONFIG_EX selects I-GELU, which only the store path supports");
+            relu6_shift_      = static_cast<std::uint8_t>(unpackConfigExecuteRelu6Shift(rs2));
             a_transpose_      = unpackConfigExecuteATranspose(rs1);
             bd_transpose_     = unpackConfigExecuteBTranspose(rs1);
             current_dataflow_ = static_cast<std::uint8_t>(unpackConfigExecuteDataflow(rs1));
@@ -82,28 +110,38 @@ void ExCtrlState::update() {
           c_addr_stride_ = unpackConfigExecuteCStride(rs2);
         }
       // if cmd(0) has valid PRELOAD and cmd(1) is also present and no RAW hazard blocks  
-      } else if (head_val[0] != 0 && do_preloads[0] != 0 && head_val[1] != 0 &&
-                 (raw_hazards_are_impossible != 0 || raw_hazard_pre == 0)) {
-        taking_single_preload   = true;
+      } else if (head_val[0] != 0 && do_preloads[0] != 0 && head_val[1] != 0 && raw_free_pre) {
+        taking_op               = true;
         perform_single_preload_ = true;
+      // if cmd(0) is a COMPUTE whose successor PRELOAD can ride along on D
+      } else if (mul_pre_pair && raw_free_mulpre) {
+        taking_op        = true;
+        perform_mul_pre_ = true;
+      // otherwise a lone COMPUTE, unless the overlap is only waiting on cmd(2) to arrive
+      } else if (head_val[0] != 0 && do_computes[0] != 0 && !waiting_for_third) {
+        taking_op           = true;
+        perform_single_mul_ = true;
+      }
+      if (taking_op) {
         state_ = ExCtrlFsmState::Compute;
       }
       break;
     }
 
     case ExCtrlFsmState::Compute:
+      // keep issuing one row-beat per cycle, if memory/mesh are ready
       if (perform_single_preload_) {
-        // keep issuing one preload row-beat per cycle, if memory/mesh are ready
         start_inputting_a = a_should_be_fed_into_transposer; // false for simple WS
         start_inputting_b = b_should_be_fed_into_transposer; // false for simple WS
         start_inputting_d = 1;
-
-        // TODO: check for completion of the single PRELOAD row-beats
-        // if (about_to_fire_all_rows) {
-        //   finish PRELOAD
-        // }
+      } else if (perform_mul_pre_) {
+        start_inputting_a = 1;
+        start_inputting_b = 1;
+        start_inputting_d = 1;
+      } else if (perform_single_mul_) {
+        start_inputting_a = bit(a_should_be_fed_into_transposer == 0);
+        start_inputting_b = bit(b_should_be_fed_into_transposer == 0);
       }
-      // TODO: issue operand reads and wait for all rows to enter the mesh.
       break;
 
     case ExCtrlFsmState::Flush:
@@ -115,11 +153,15 @@ void ExCtrlState::update() {
       break;
   }
 
-  const auto next_performing_single_preload = bit((perform_single_preload_ && state_ == ExCtrlFsmState::Compute) ||
-                                                 taking_single_preload);
+  const bool active = state_ == ExCtrlFsmState::Compute;
+  const auto next_performing_single_preload = bit(active && perform_single_preload_);
+  const auto next_performing_mul_pre        = bit(active && perform_mul_pre_);
+  const auto next_performing_single_mul     = bit(active && perform_single_mul_);
   performing_single_preload = next_performing_single_preload;
-  // TODO: include performing_mul_pre and performing_single_mul when those modes exist.
-  computing = next_performing_single_preload;
+  performing_mul_pre        = next_performing_mul_pre;
+  performing_single_mul     = next_performing_single_mul;
+  computing = bit(next_performing_single_preload != 0 || next_performing_mul_pre != 0 ||
+                  next_performing_single_mul != 0);
   prop = next_performing_single_preload != 0 ? bit(in_prop_flush_) : *in_prop;
   config_initialized = bit(config_initialized_);
   a_transpose        = bit(a_transpose_);
@@ -128,6 +170,50 @@ void ExCtrlState::update() {
   a_addr_stride      = a_addr_stride_;
   c_addr_stride      = c_addr_stride_;
   shift              = in_shift_;
+  activation         = activation_;
+  relu6_shift        = relu6_shift_;
+}
+
+// Retire the operation whose last row-beat fires this cycle. A COMPUTE has
+// nothing left to do once its rows are in the mesh; a PRELOAD completes here
+// only when its C address is garbage, otherwise its tag rides to the writeback.
+void ExCtrlState::updateProgress() {
+  cmd_pop_count = config_taken_ ? 1 : 0;
+  for (std::size_t i = 0; i < 2; ++i) {
+    ex_pending_val[i]  = 0;
+    ex_pending_bits[i] = 0;
+  }
+  if (!was_computing_ || about_to_fire_all_rows == 0) {
+    return;
+  }
+
+  const auto cmd0 = *head_bits[0];
+  const auto cmd1 = *head_bits[1];
+  const bool c_garbage = (*c_address_rs2).is_garbage();
+  if (perform_single_preload_) {
+    cmd_pop_count      = 1;
+    ex_pending_val[0]  = bit(cmd0.rs_tag_valid != 0 && c_garbage);
+    ex_pending_bits[0] = cmd0.rs_tag;
+  } else if (perform_mul_pre_) {
+    cmd_pop_count      = 2;
+    ex_pending_val[0]  = cmd0.rs_tag_valid;
+    ex_pending_bits[0] = cmd0.rs_tag;
+    ex_pending_val[1]  = bit(head_val[1] != 0 && cmd1.rs_tag_valid != 0 && c_garbage);
+    ex_pending_bits[1] = cmd1.rs_tag;
+  } else if (perform_single_mul_) {
+    cmd_pop_count      = 1;
+    ex_pending_val[0]  = cmd0.rs_tag_valid;
+    ex_pending_bits[0] = cmd0.rs_tag;
+  }
+  trace("ex_state: retired preload=%u mulpre=%u mul=%u",
+        static_cast<unsigned>(perform_single_preload_),
+        static_cast<unsigned>(perform_mul_pre_),
+        static_cast<unsigned>(perform_single_mul_));
+
+  perform_single_preload_ = false;
+  perform_mul_pre_        = false;
+  perform_single_mul_     = false;
+  state_ = ExCtrlFsmState::WaitingForCmd;
 }
 
 void ExCtrlState::reset() {
@@ -136,9 +222,15 @@ void ExCtrlState::reset() {
   a_transpose_        = false;
   bd_transpose_       = false;
   perform_single_preload_ = false;
+  perform_mul_pre_    = false;
+  perform_single_mul_ = false;
+  was_computing_      = false;
+  config_taken_       = false;
   in_prop_flush_      = false;
   current_dataflow_   = kExDataflowWS;
   in_shift_           = 0;
+  activation_         = 0;
+  relu6_shift_        = 0;
   a_addr_stride_      = 1;
   c_addr_stride_      = 1;
 
@@ -149,16 +241,25 @@ void ExCtrlState::reset() {
   a_addr_stride.reset(1);
   c_addr_stride.reset(1);
   shift.reset(0);
+  activation.reset(0);
+  relu6_shift.reset(0);
   config_val.reset(0);
   config_rs_tag_valid.reset(0);
   config_rs_tag.reset(0);
   performing_single_preload.reset(0);
+  performing_mul_pre.reset(0);
+  performing_single_mul.reset(0);
   computing.reset(0);
   start_inputting_a.reset(0);
   start_inputting_b.reset(0);
   start_inputting_d.reset(0);
   prop.reset(0);
+  control_state.reset(static_cast<std::uint8_t>(ExCtrlFsmState::WaitingForCmd));
   cmd_pop_count.reset(0);
+  for (std::size_t i = 0; i < 2; ++i) {
+    ex_pending_val[i].reset(0);
+    ex_pending_bits[i].reset(0);
+  }
 }
 
 } // namespace smesh
@@ -5,15 +5,36 @@
 
 #include "ExCtrlWriteback.hpp"
 
+#include "Activation.hpp"
+
+#include <algorithm>
+#include <limits>
+
 namespace smesh {
 
+namespace {
+// clip an accumulator lane to the scratchpad element width
+Elem saturateToElem(Acc value) {
+  const Acc lo = std::numeric_limits<Elem>::min();
+  const Acc hi = std::numeric_limits<Elem>::max();
+  return static_cast<Elem>(std::min(std::max(value, lo), hi));
+}
+// lane mask for the first cols lanes of a row
+u8 laneMask(std::uint32_t cols) {
+  const auto lanes = std::min<std::uint32_t>(cols, static_cast<std::uint32_t>(kDim));
+  return static_cast<u8>(lanes >= 8 ? 0xffu : ((1u << lanes) - 1u));
+}
+
+} // namespace
+
 ExCtrlWriteback::ExCtrlWriteback(std::string /*name*/, IMPL_CTOR) {
-  UPDATE(updateView)
+  UPDATE(update)
       .reads(mesh_resp_val,
              mesh_resp_bits,
              current_dataflow,
              c_addr_stride,
              activation,
+             relu6_shift,
              aligned_to,
              ex_write_to_spad,
              ex_write_to_acc)
@@ -28,39 +49,94 @@ ExCtrlWriteback::ExCtrlWriteback(std::string /*name*/, IMPL_CTOR) {
       .writes(mesh_completed_rs_tag_fire,
               completed_val,
               completed_bits);
-  UPDATE(updateState)
-      .reads(mesh_resp_val, mesh_resp_bits);
 }
 
-void ExCtrlWriteback::updateView() {
+void ExCtrlWriteback::update() {
   for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
     spad_write_val[bank]  = 0;
     spad_write_bits[bank] = DmaReadResp{};
   }
-
   for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
     accum_write_val[bank]  = 0;
     accum_write_bits[bank] = DmaReadResp{};
   }
-
   output_counter             = output_counter_;
   start_array_outputting     = 0;
   mesh_completed_rs_tag_fire = 0;
   completed_val              = 0;
   completed_bits             = 0;
-}
 
-void ExCtrlWriteback::updateState() {
-  const bool mesh_resp_fire = mesh_resp_val != 0;
+  if (mesh_resp_val == 0) {
+    return;
+  }
+
+  const auto resp = *mesh_resp_bits;
+  const auto tag  = resp.tag;
+  // WS rows leave the mesh top row first; OS rows drain bottom row first
+  const bool dataflow_ws = current_dataflow == kExDataflowWS;
+  const std::uint32_t row = dataflow_ws ? output_counter_
+                                        : static_cast<std::uint32_t>(kDim) - 1u - output_counter_;
+  const bool write_this_row = row < tag.rows;
+  const auto w_address      = tag.addr + row * static_cast<std::uint32_t>(*c_addr_stride);
+  const bool write_to_acc   = w_address.is_acc_addr();
+  const bool do_write       = !tag.addr.is_garbage() && write_this_row &&
+                              (write_to_acc ? ex_write_to_acc != 0 : ex_write_to_spad != 0);
+
+  if (do_write) {
+    DmaReadResp write{};
+    write.laddr = w_address;
+    write.mask  = laneMask(tag.cols);
+    write.len   = static_cast<u16>(std::min<std::uint32_t>(tag.cols, static_cast<std::uint32_t>(kDim)));
+    write.last  = false; // not a load: no LdCtrl completion from local memory
+    if (write_to_acc) {
+      // full-width row; Accum adds it in place when the address carries the accumulate bit
+      write.has_acc_bitwidth = true;
+      for (std::size_t lane = 0; lane < kDim; ++lane) {
+        const auto word = static_cast<std::uint32_t>(resp.data[lane]);
+        for (std::size_t byte = 0; byte < sizeof(Acc); ++byte) {
+          write.data[lane * sizeof(Acc) + byte] = static_cast<std::uint8_t>((word >> (8 * byte)) & 0xffu);
+        }
+      }
+      write.bytes_read = static_cast<u16>(write.len * sizeof(Acc));
+      accum_write_val[w_address.acc_bank()]  = 1;
+      accum_write_bits[w_address.acc_bank()] = write;
+      ++acc_rows_written_;
+    } else {
+      ActivationParams params{};
+      params.relu6_shift   = static_cast<std::uint8_t>(*relu6_shift);
+      const auto act       = decodeActivation(static_cast<std::uint32_t>(*activation)); // ExCtrlState rejects I-GELU
+      const auto activated = activateRow(resp.data, act, params);
+      for (std::size_t lane = 0; lane < kDim; ++lane) {
+        write.data[lane] = static_cast<std::uint8_t>(saturateToElem(activated[lane]));
+      }
+      write.bytes_read = write.len;
+      spad_write_val[w_address.sp_bank()]  = 1;
+      spad_write_bits[w_address.sp_bank()] = write;
+      ++spad_rows_written_;
+    }
+    start_array_outputting = 1;
+    trace("ex_writeback: %s row=%u laddr=0x%x mask=0x%x accumulate=%u",
+          write_to_acc ? "acc" : "spad",
+          static_cast<unsigned>(row),
+          static_cast<unsigned>(w_address.raw),
+          static_cast<unsigned>(write.mask),
+          static_cast<unsigned>(w_address.accumulate()));
+  }
 
-  // TODO: advance/reset output_counter_ when mesh output routing is implemented.
-  if (mesh_resp_fire && static_cast<bool>(mesh_resp_bits->last)) {
-    output_counter_ = 0;
+  // the last row of a tagged matmul completes its RS entry
+  const bool last = static_cast<bool>(resp.last);
+  if (last && tag.rs_tag_valid != 0) {
+    mesh_completed_rs_tag_fire = 1;
+    completed_val              = 1;
+    completed_bits             = tag.rs_tag;
   }
+  output_counter_ = last ? 0u : output_counter_ + 1u;
 }
 
 void ExCtrlWriteback::reset() {
-  output_counter_ = 0;
+  output_counter_    = 0;
+  spad_rows_written_ = 0;
+  acc_rows_written_  = 0;
 
   for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
     spad_write_val[bank].reset(0);
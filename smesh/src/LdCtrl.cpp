@@ -56,11 +56,16 @@ void LdCtrl::updateAccept() {
     assert_always(state_id < load_config_.size(), "LdCtrl CONFIG load-state ID is out of range");
     load_config_[state_id].ld_block_stride = unpackConfigLoadBlockStride(static_cast<std::uint64_t>(active_.cmd.rs1));
     load_config_[state_id].dram_row_stride = static_cast<std::uint32_t>(active_.cmd.rs2);
+    load_config_[state_id].scale = unpackConfigLoadScale(static_cast<std::uint64_t>(active_.cmd.rs1));
+    const auto pixel_repeats = unpackConfigLoadPixelRepeats(static_cast<std::uint64_t>(active_.cmd.rs1));
+    load_config_[state_id].pixel_repeats = static_cast<std::uint8_t>(pixel_repeats == 0 ? 1 : pixel_repeats);
     command_done_ = true;
-    trace("ld_ctrl: config state=%u dram_stride=%u block_stride=%u",
+    trace("ld_ctrl: config state=%u dram_stride=%u block_stride=%u scale=0x%x pixel_repeats=%u",
           static_cast<unsigned>(state_id),
           static_cast<unsigned>(load_config_[state_id].dram_row_stride),
-          static_cast<unsigned>(load_config_[state_id].ld_block_stride));
+          static_cast<unsigned>(load_config_[state_id].ld_block_stride),
+          static_cast<unsigned>(load_config_[state_id].scale),
+          static_cast<unsigned>(load_config_[state_id].pixel_repeats));
     return;
   }
 
@@ -74,18 +79,22 @@ void LdCtrl::updateAccept() {
   rows_               = static_cast<std::uint32_t>(local.shape.rows);
   cols_               = static_cast<std::uint32_t>(local.shape.cols);
   next_row_           = 0; // it's a new mvin, it hasn't issued any row reqs yet
-  request_in_flight_  = false;
+  rows_in_flight_     = 0;
   const auto& config  = load_config_[loadStateId(funct)];
   dram_row_stride_    = config.dram_row_stride;
   ld_block_stride_    = config.ld_block_stride;
-  expected_bytes_     = rows_ * cols_;
+  scale_              = config.scale;
+  pixel_repeats_      = config.pixel_repeats;
+  // an accumulator destination with read_full_acc_row set loads 32-bit rows (bias/partial sums)
+  acc_bitwidth_       = base_laddr_.is_acc_addr() && base_laddr_.read_full_acc_row();
+  expected_bytes_     = rows_ * cols_ * static_cast<std::uint32_t>(acc_bitwidth_ ? sizeof(Acc) : sizeof(Elem));
   returned_bytes_     = 0;
   dma_response_valid_ = false;
 }
 
 void LdCtrl::updateIssue() {
   if (!active_valid_ || command_done_ || 
-      request_in_flight_ || next_row_ >= rows_ || 
+      rows_in_flight_ >= kDmaMaxInflight || next_row_ >= rows_ || 
       dma_req.full()) {
     return;
   }
@@ -95,9 +104,12 @@ void LdCtrl::updateIssue() {
   req.laddr          = base_laddr_ + next_row_;
   req.cols           = u16(static_cast<std::uint16_t>(cols_));
   req.block_stride   = u16(static_cast<std::uint16_t>(ld_block_stride_));
+  req.scale          = u32(scale_);
+  req.pixel_repeats  = u8(pixel_repeats_);
+  req.has_acc_bitwidth = bit(acc_bitwidth_);
   req.cmd_id         = u16(active_.rs_tag);
   dma_req.push(req);         // push DMA read request to memory controller
-  request_in_flight_ = true; // just pushed, so one DMA row request is outstanding
+  ++rows_in_flight_;  // just pushed, so one more DMA row request is outstanding
   ++next_row_;
 
   trace("ld_ctrl: dma request vaddr=0x%llx laddr=0x%x cols=%u cmd_id=%u",
@@ -120,7 +132,7 @@ void LdCtrl::updateDmaResponse() {
 
   const auto response = dma_resp.pop();
   returned_bytes_     = new_returned_bytes;
-  request_in_flight_  = false;  // just got resposne, so no DMA row request is outstanding
+  --rows_in_flight_;            // just got resposne, so one fewer DMA row request is outstanding
   response_rs_tag_    = static_cast<SmeshRsTag>(response.cmd_id);
   dma_response_valid_ = true;
 
@@ -147,7 +159,7 @@ void LdCtrl::reset() {
   active_             = {};
   command_done_       = false;
   dma_response_valid_ = false;
-  request_in_flight_  = false;
+  rows_in_flight_     = 0;
   base_vaddr_         = 0;
   base_laddr_         = {};
   rows_               = 0;
@@ -155,12 +167,17 @@ void LdCtrl::reset() {
   next_row_           = 0;
   dram_row_stride_    = 0;
   ld_block_stride_    = 0;
+  scale_              = 0;
+  pixel_repeats_      = 1;
+  acc_bitwidth_       = false;
   expected_bytes_     = 0;
   returned_bytes_     = 0;
   response_rs_tag_    = 0;
   for (auto& config : load_config_) {
     config.dram_row_stride = static_cast<std::uint32_t>(kDim);
     config.ld_block_stride = static_cast<std::uint32_t>(kDim);
+    config.scale           = 0;
+    config.pixel_repeats   = 1;
   }
 }
 
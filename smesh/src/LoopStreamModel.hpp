@@ -0,0 +1,151 @@
+// **********************************************************************
+// smesh/src/LoopStreamModel.hpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Aug 8 2026
+/*
+Testbench-only functional replay of an unrolled command stream (LOOP_WS /
+LOOP_CONV_WS output) on a small DRAM/spad/accumulator model, in program order
+(what the RS guarantees for dependent commands). CONFIG_LD/ST strides, MVIN
+into spad or accumulator (Acc-wide only with read_full_acc_row, as LdCtrl
+loads it), PRELOAD/COMPUTE_FLIP with the accumulate bit and
+garbage operands as zeros, full-width MVOUT.
+*/
+#pragma once
+
+#include "SmeshCommand.hpp"
+#include "SmeshPorts.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace smesh {
+
+class LoopStreamModel {
+ public:
+  std::vector<std::uint8_t> dram = std::vector<std::uint8_t>(1 << 16, 0);
+  std::size_t ex_configs    = 0;
+  std::uint32_t activation  = 0;
+  std::size_t half_flips    = 0; // k-steps whose spad half differs from the previous step's
+  std::size_t computes      = 0; // k-step computes; garbage-A ones count as clears
+  std::size_t clears        = 0;
+  std::uint64_t a_bytes     = 0; // DRAM bytes moved by MVIN (A operand)
+
+  void run(const SmeshCmd& cmd) {
+    const auto funct = static_cast<SmeshFunct>(static_cast<std::uint32_t>(cmd.funct));
+    const auto rs1   = static_cast<std::uint64_t>(cmd.rs1);
+    const auto rs2   = static_cast<std::uint64_t>(cmd.rs2);
+    switch (funct) {
+      case SmeshFunct::Config: {
+        const auto kind = static_cast<ConfigKind>(rs1 & 0x3u);
+        if (kind == ConfigKind::Load) {
+          ld_stride_.at(unpackConfigStateId(rs1)) = rs2;
+        } else if (kind == ConfigKind::Store && !unpackConfigStoreChannelScale(rs1)) { // channel scales keep the stride
+          st_stride_ = rs2;
+        } else if (kind == ConfigKind::Execute) {
+          ++ex_configs;
+          activation = unpackConfigExecuteActivation(rs1);
+        }
+        return;
+      }
+      case SmeshFunct::Mvin:
+      case SmeshFunct::Mvin2:
+        mvinSpad(rs1, unpackLocal(rs2), ld_stride_.at(funct == SmeshFunct::Mvin ? 0 : 1), funct == SmeshFunct::Mvin);
+        return;
+      case SmeshFunct::Mvin3:
+        mvinAcc(rs1, unpackLocal(rs2), ld_stride_.at(2));
+        return;
+      case SmeshFunct::Preload: // garbage B preloads zero weights
+        b_ = unpackLocal(rs1);
+        c_ = unpackLocal(rs2);
+        return;
+      case SmeshFunct::ComputeFlip:
+        compute(unpackLocal(rs1));
+        return;
+      case SmeshFunct::Mvout:
+        mvout(rs1, unpackLocal(rs2));
+        return;
+      default:
+        return;
+    }
+  }
+
+ private:
+  std::array<std::array<Elem, kDim>, kSpRows> spad_{};
+  std::array<std::array<Acc, kDim>, kAccRows> acc_{};
+  std::array<std::uint64_t, kLoadStates> ld_stride_{};
+  std::uint64_t st_stride_ = 0;
+  LocalMatrix b_{};
+  LocalMatrix c_{};
+  bool last_half_valid_ = false;
+  std::uint32_t last_half_ = 0;
+
+  template <typename T>
+  T load(std::uint64_t addr) const {
+    T v{};
+    std::memcpy(&v, &dram.at(addr), sizeof(T));
+    return v;
+  }
+
+  void mvinSpad(std::uint64_t vaddr, const LocalMatrix& dst, std::uint64_t stride, bool a_operand) {
+    const auto row = makeLocalAddr(dst.row).full_sp_addr();
+    for (std::size_t r = 0; r < dst.shape.rows; ++r) {
+      spad_.at(row + r).fill(0);
+      for (std::size_t c = 0; c < dst.shape.cols; ++c) {
+        spad_.at(row + r).at(c) = load<Elem>(vaddr + r * stride + c * sizeof(Elem));
+        a_bytes += a_operand ? sizeof(Elem) : 0;
+      }
+    }
+  }
+
+  void mvinAcc(std::uint64_t vaddr, const LocalMatrix& dst, std::uint64_t stride) {
+    const auto row = makeLocalAddr(dst.row).full_acc_addr();
+    const bool elem_d = !makeLocalAddr(dst.row).read_full_acc_row();
+    for (std::size_t r = 0; r < dst.shape.rows; ++r) {
+      acc_.at(row + r).fill(0);
+      for (std::size_t c = 0; c < dst.shape.cols; ++c) {
+        acc_.at(row + r).at(c) = elem_d ? load<Elem>(vaddr + r * stride + c)
+                                        : load<Acc>(vaddr + r * stride + c * sizeof(Acc));
+      }
+    }
+  }
+
+  void compute(const LocalMatrix& a) {
+    const bool a_zero = makeLocalAddr(a.row).is_garbage();
+    const bool b_zero = makeLocalAddr(b_.row).is_garbage();
+    const auto a_row = makeLocalAddr(a.row).full_sp_addr();
+    const auto b_row = makeLocalAddr(b_.row).full_sp_addr();
+    const auto c_addr = makeLocalAddr(c_.row);
+    if (a_zero) { // garbage A: clears C
+      ++clears;
+    } else {
+      const std::uint32_t half = a_row / (kSpRows / 2);
+      half_flips += last_half_valid_ && half != last_half_ ? 1 : 0;
+      last_half_valid_ = true;
+      last_half_ = half;
+      ++computes;
+    }
+    for (std::size_t r = 0; r < c_.shape.rows; ++r) {
+      for (std::size_t c = 0; c < c_.shape.cols; ++c) {
+        Acc sum = c_addr.accumulate() ? acc_.at(c_addr.full_acc_addr() + r).at(c) : 0;
+        for (std::size_t k = 0; !a_zero && !b_zero && k < a.shape.cols; ++k) {
+          sum += static_cast<Acc>(spad_.at(a_row + r).at(k)) * spad_.at(b_row + k).at(c);
+        }
+        acc_.at(c_addr.full_acc_addr() + r).at(c) = sum;
+      }
+    }
+  }
+
+  void mvout(std::uint64_t vaddr, const LocalMatrix& src) {
+    const auto row = makeLocalAddr(src.row).full_acc_addr();
+    for (std::size_t r = 0; r < src.shape.rows; ++r) {
+      for (std::size_t c = 0; c < src.shape.cols; ++c) {
+        const Acc v = acc_.at(row + r).at(c);
+        std::memcpy(&dram.at(vaddr + r * st_stride_ + c * sizeof(Acc)), &v, sizeof(v));
+      }
+    }
+  }
+};
+
+} // namespace smesh
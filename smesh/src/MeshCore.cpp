@@ -5,8 +5,52 @@
 
 #include "MeshCore.hpp"
 
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace smesh {
 
+namespace {
+
+// One PE row of the WS MAC: b = keep ? b_in + a * w : b (int8 x int8 -> int32 lanes).
+void macRow(const MeshInputRow& a, const MeshInputRow& w, const MeshAccumRow& b_in, const MeshAccumRow& keep, MeshAccumRow& b) {
+  std::size_t col = 0;
+#if defined(__AVX2__)
+  for (; col + 8 <= kDim; col += 8) {
+    const __m256i av   = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(a.data() + col)));
+    const __m256i wv   = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(w.data() + col)));
+    const __m256i bin  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b_in.data() + col));
+    const __m256i bold = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.data() + col));
+    const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keep.data() + col));
+    const __m256i sum  = _mm256_add_epi32(bin, _mm256_mullo_epi32(av, wv));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(b.data() + col), _mm256_blendv_epi8(bold, sum, mask));
+  }
+#elif defined(__ARM_NEON)
+  for (; col + 8 <= kDim; col += 8) {
+    const int16x8_t av = vmovl_s8(vld1_s8(a.data() + col));
+    const int16x8_t wv = vmovl_s8(vld1_s8(w.data() + col));
+    const int32x4_t lo = vmlal_s16(vld1q_s32(b_in.data() + col),     vget_low_s16(av),  vget_low_s16(wv));
+    const int32x4_t hi = vmlal_s16(vld1q_s32(b_in.data() + col + 4), vget_high_s16(av), vget_high_s16(wv));
+    vst1q_s32(b.data() + col,     vbslq_s32(vreinterpretq_u32_s32(vld1q_s32(keep.data() + col)),     lo, vld1q_s32(b.data() + col)));
+    vst1q_s32(b.data() + col + 4, vbslq_s32(vreinterpretq_u32_s32(vld1q_s32(keep.data() + col + 4)), hi, vld1q_s32(b.data() + col + 4)));
+  }
+#endif
+  // portable tail/fallback: work on a local copy so the compiler sees no aliasing
+  MeshAccumRow next = b;
+  for (std::size_t i = col; i < kDim; ++i) {
+    const Acc sum = b_in[i] + static_cast<Acc>(a[i]) * static_cast<Acc>(w[i]);
+    next[i] = (sum & keep[i]) | (next[i] & ~keep[i]);
+  }
+  b = next;
+}
+
+} // namespace
+
 void MeshCore::reset() {
   c1_            = InputGrid{};
   c2_            = InputGrid{};
@@ -18,70 +62,125 @@ void MeshCore::reset() {
   out_b_         = MeshAccumRow{};
   out_b_control_ = CtrlRow{};
   out_b_status_  = StatusRow{};
+  acc1_          = AccumGrid{};
+  acc2_          = AccumGrid{};
+  c_path_        = AccumGrid{};
+  out_c_         = MeshAccumRow{};
+  last_prop_     = InputGrid{};
+  masks_         = {};
 }
 
+// Rows are advanced bottom-up so row-1 still holds last cycle's B/D/control/status
+// when row reads it, and each row's A shifts right in place: no next-state grids.
 void MeshCore::step(const MeshCoreIn& in) {
-  InputGrid    next_a{};
-  InputGrid    next_c1 = c1_;
-  InputGrid    next_c2 = c2_;
-  AccumGrid    next_b = b_path_;    // working copy of B/out_b state
-  InputGrid    next_d = d_path_;    // working copy of D/out_c state (not used for WS)
-  CtrlGrid     next_control_path{};
-  StatusGrid   next_status_path{};
-  MeshAccumRow next_out_b{};
-  CtrlRow      next_out_b_control{};
-  StatusRow    next_out_b_status{};
-
-  // A always flows LR; B/out_b and D/out_c flow TB under their aligned valid status.
-  for (std::size_t row = 0; row < kDim; ++row) {
+  LaneMasks top{};
+  for (std::size_t col = 0; col < kDim; ++col) {
+    const bool valid = in.status[col].valid;
+    const bool os    = in.control[col].dataflow == kExDataflowOS;
+    top.keep[col]  = valid && !os ? Acc(-1) : Acc(0);
+    top.valid[col] = valid && !os ? Elem(-1) : Elem(0);
+    top.live[col]  = valid ? Elem(-1) : Elem(0);
+    top.prop[col]  = in.control[col].prop ? Elem(-1) : Elem(0);
+    top.any_ws     = top.any_ws || (valid && !os);
+    top.any_os     = top.any_os || (valid && os);
+  }
+
+  for (std::size_t r = kDim; r-- > 0;) {
+    // A always flows LR
+    auto& a = a_path_[r];
+    std::copy_backward(a.begin(), a.end() - 1, a.end());
+    a[0] = in.in_a[r];
+
+    // control/status (and their masks) flow TB
+    control_path_[r] = r == 0 ? in.control : control_path_[r - 1];
+    status_path_[r]  = r == 0 ? in.status  : status_path_[r - 1];
+    masks_[r]        = r == 0 ? top        : masks_[r - 1];
+    const auto& m = masks_[r];
+    if (!m.any_ws && !m.any_os) {
+      continue; // no valid PE in this row: B/D/C/c1/c2/acc1/acc2 hold
+    }
+    if (m.any_os) {
+      stepOsRow(r, in); // before WS touches b_path_[r]; reads only row r-1 and row r OS lanes
+    }
+
+    auto& last_prop = last_prop_[r];
     for (std::size_t col = 0; col < kDim; ++col) {
-      // what is inside PE[row][col] this cycle?
-      const auto a       = col == 0     ? in.in_a[row]    : a_path_[row][col-1];       // A flows LR
-      const auto b_in    = row == 0     ? in.in_b[col]    : b_path_[row-1][col];       // B flows TB
-      const auto d_in    = row == 0     ? in.in_d[col]    : d_path_[row-1][col];       // D flows TB
-      const auto control = row == 0     ? in.control[col] : control_path_[row-1][col]; // ctrl flows TB
-      const auto status  = row == 0     ? in.status[col]  : status_path_[row-1][col];  // id/last/valid flows TB
-      const auto weight  = control.prop ? c2_[row][col]   : c1_[row][col];             // weight=c2 if prop=1, c1 if prop=0
-
-      next_a[row][col] = a; // A that's leaving this PE and going LR
-
-      if (status.valid) {  // if PE's signal is valid...
-        next_b[row][col] = b_in + static_cast<Acc>(a) * static_cast<Acc>(weight); // ...update B/out_b for PE below
-      }
-
-      if (status.valid) { // if PE's signal is valid...
-        if (control.prop) {
-          next_d[row][col]  = c1_[row][col]; // ...send old c1 downward on D/out_c
-          next_c1[row][col] = d_in; // ...update c1 for this PE if prop=1
-        } else {
-          next_d[row][col]  = c2_[row][col]; // ...send old c2 downward on D/out_c
-          next_c2[row][col] = d_in; // ...update c2 for this PE if prop=0
-        }
-      }
-
-      next_control_path[row][col] = control; // control that's leaving this PE and going TB
-      next_status_path[row][col]  = status;  // status that's leaving this PE and going TB
+      last_prop[col] = static_cast<Elem>((m.live[col] & m.prop[col]) | (~m.live[col] & last_prop[col]));
     }
+    if (!m.any_ws) {
+      continue;
+    }
+
+    const MeshInputRow c1 = c1_[r];
+    const MeshInputRow c2 = c2_[r];
+    const MeshInputRow d  = d_path_[r];
+    const MeshInputRow d_in = r == 0 ? in.in_d : d_path_[r - 1];
+    MeshInputRow weight{};
+    MeshInputRow next_c1{};
+    MeshInputRow next_c2{};
+    MeshInputRow next_d{};
+    for (std::size_t col = 0; col < kDim; ++col) {
+      const Elem take_c1 = static_cast<Elem>(m.valid[col] & m.prop[col]);  // valid, prop=1
+      const Elem take_c2 = static_cast<Elem>(m.valid[col] & ~m.prop[col]); // valid, prop=0
+      weight[col]  = static_cast<Elem>((m.prop[col] & c2[col]) | (~m.prop[col] & c1[col])); // c2 if prop=1, c1 if prop=0
+      next_d[col]  = static_cast<Elem>((take_c1 & c1[col]) | (take_c2 & c2[col]) | (~m.valid[col] & d[col])); // old c1/c2 down on D/out_c
+      next_c1[col] = static_cast<Elem>((take_c1 & d_in[col]) | (~take_c1 & c1[col])); // update c1 if prop=1
+      next_c2[col] = static_cast<Elem>((take_c2 & d_in[col]) | (~take_c2 & c2[col])); // update c2 if prop=0
+    }
+
+    // B/out_b: MAC for valid PEs (uses this cycle's weight, before c1/c2 latch d_in)
+    macRow(a, weight, r == 0 ? in.in_b : b_path_[r - 1], m.keep, b_path_[r]);
+
+    c1_[r]     = next_c1;
+    c2_[r]     = next_c2;
+    d_path_[r] = next_d;
   }
 
-  // compute out_b and status/ctrl emerging from bottom row
+  // out_b/out_c and status/ctrl emerging from bottom row
+  out_b_         = b_path_[kDim - 1];
+  out_c_         = c_path_[kDim - 1];
+  out_b_control_ = control_path_[kDim - 1];
+  out_b_status_  = status_path_[kDim - 1];
+}
+
+// OS lanes of one PE row: accumulate a*b into the active set, pass B down unchanged,
+// and move the idle set one row down the C path (shifted on the first beat after a flip).
+void MeshCore::stepOsRow(std::size_t r, const MeshCoreIn& in) {
+  const auto& control = control_path_[r];
+  const auto& status  = status_path_[r];
+  const auto& a       = a_path_[r];
   for (std::size_t col = 0; col < kDim; ++col) {
-    next_out_b[col]         = next_b[kDim - 1][col];
-    next_out_b_control[col] = next_control_path[kDim - 1][col];
-    next_out_b_status[col]  = next_status_path[kDim - 1][col];
+    if (!status[col].valid || control[col].dataflow != kExDataflowOS) {
+      continue;
+    }
+    const Acc  b_in  = r == 0 ? in.in_b[col] : b_path_[r - 1][col];
+    const Acc  c_in  = r == 0 ? static_cast<Acc>(in.in_d[col]) : c_path_[r - 1][col];
+    const bool prop  = control[col].prop;
+    const bool flip  = prop != (last_prop_[r][col] != 0);
+    const auto shift = flip ? control[col].shift : std::uint8_t{0};
+    auto& drain = prop ? acc1_[r][col] : acc2_[r][col]; // idle set: drains down C, takes C from above
+    auto& accum = prop ? acc2_[r][col] : acc1_[r][col]; // active set: accumulates
+    c_path_[r][col] = roundingShift(drain, shift);
+    drain = c_in;
+    accum += static_cast<Acc>(a[col]) * b_in;
+    b_path_[r][col] = b_in; // B (weights) flows TB unchanged
   }
+}
 
-  // update state
-  c1_            = next_c1;
-  c2_            = next_c2;
-  a_path_        = next_a;
-  b_path_        = next_b;
-  d_path_        = next_d;
-  control_path_  = next_control_path;
-  status_path_   = next_status_path;
-  out_b_         = next_out_b;
-  out_b_control_ = next_out_b_control;
-  out_b_status_  = next_out_b_status;
+// round half to even, as OS results leave the PE
+Acc MeshCore::roundingShift(Acc value, unsigned shift) {
+  if (shift == 0) {
+    return value;
+  }
+  shift = std::min(shift, 31u);
+  const std::int64_t v    = value;
+  std::int64_t       q    = v >> shift;
+  const std::int64_t rem  = v - q * (std::int64_t{1} << shift);
+  const std::int64_t half = std::int64_t{1} << (shift - 1);
+  if (rem > half || (rem == half && (q & 1) != 0)) {
+    ++q;
+  }
+  return static_cast<Acc>(q);
 }
 
 void MeshCore::loadC2ForTest(const InputGrid& weights) {
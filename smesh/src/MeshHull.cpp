@@ -18,12 +18,29 @@ void MeshHull::reset() {
   control_skew_ = SkewState<MeshCoreControl>{};
   status_skew_  = SkewState<MeshCoreStatus>{};
   out_b_skew_   = SkewState<Acc>{};
-  out_status_skew_ = SkewState<MeshCoreStatus>{};
+  out_c_skew_   = SkewState<Acc>{};
+  out_control_skew_ = SkewState<MeshCoreControl>{};
+  out_status_skew_  = SkewState<MeshCoreStatus>{};
   out_          = MeshHullOut{};
+  tl_regs_      = {};
+  tl_row0_      = {};
+  tl_acc_       = {};
+  tl_acc_row0_  = {};
+  tl_last_prop_ = false;
+  tl_queue_     = {};
+  tl_head_      = 0;
+}
+
+void MeshHull::setTransactionLevel(bool en) {
+  tl_ = en;
+  reset();
 }
 
 void MeshHull::loadC2ForTest(const MeshCore::InputGrid& weights) {
   core_.loadC2ForTest(weights);
+  for (std::size_t r = 0; r < kDim; ++r) {
+    tl_regs_[1][(r + tl_row0_[1]) % kDim] = weights[r];
+  }
 }
 
 void MeshHull::step(const MeshHullIn& in) {
@@ -46,36 +63,121 @@ void MeshHull::step(const MeshHullIn& in) {
     next_d_buf = in.d_is_from_transposer != 0 ? in.transposer_out_col_bits                : in.d_bits;
   }
 
+  if (tl_) {
+    stepTransaction(in, current_a_buf, current_b_buf, current_d_buf);
+  } else {
+    stepCore(in, current_a_buf, current_b_buf, current_d_buf);
+  }
+
+  a_buf_   = next_a_buf;
+  b_buf_   = next_b_buf;
+  d_buf_   = next_d_buf;
+}
+// full model: skew the buffered rows into MeshCore, step it, de-skew its bottom row
+void MeshHull::stepCore(const MeshHullIn& in, const MeshInputRow& a, const MeshAccumRow& b, const MeshInputRow& d) {
   MeshCoreIn core_in{}; // temporary input bundle to MeshCore for this cycle
   MeshCoreControlRow control_in{}; // bundle for control inputs (just one so far though)
   MeshCoreStatusRow status_in{};   // bundle for status inputs
   for (std::size_t lane = 0; lane < kDim; ++lane) {
-    control_in[lane].prop   = in.pe_control.propagate != 0;
+    control_in[lane].prop     = in.pe_control.propagate != 0;
+    control_in[lane].dataflow = static_cast<std::uint8_t>(in.pe_control.dataflow);
+    control_in[lane].shift    = static_cast<std::uint8_t>(in.pe_control.shift);
     status_in[lane].in_id   = in.matmul_id;
     status_in[lane].in_last = in.last_fire != 0;
     status_in[lane].valid   = in.not_paused != 0;
   }
 
-  core_in.in_a    = stepInputSkew(a_skew_, current_a_buf);
-  core_in.in_b    = stepInputSkew(b_skew_, current_b_buf);
-  core_in.in_d    = stepInputSkew(d_skew_, current_d_buf);
+  core_in.in_a    = stepInputSkew(a_skew_, a);
+  core_in.in_b    = stepInputSkew(b_skew_, b);
+  core_in.in_d    = stepInputSkew(d_skew_, d);
   core_in.control = stepInputSkew(control_skew_, control_in);
   core_in.status  = stepInputSkew(status_skew_, status_in);
 
   core_.step(core_in); // update systolic Core state based on the inputs and get new outputs
 
-  a_buf_   = next_a_buf;
-  b_buf_   = next_b_buf;
-  d_buf_   = next_d_buf;
-
-  const auto out_b          = stepOutputSkew(out_b_skew_, core_.outB());
-  const auto out_status_row = stepOutputSkew(out_status_skew_, core_.outBStatus());
-  const auto out_status     = out_status_row[0];
-  out_.resp_data     = out_b;
+  const auto out_b           = stepOutputSkew(out_b_skew_, core_.outB());
+  const auto out_c           = stepOutputSkew(out_c_skew_, core_.outC());
+  const auto out_control_row = stepOutputSkew(out_control_skew_, core_.outBControl());
+  const auto out_status_row  = stepOutputSkew(out_status_skew_, core_.outBStatus());
+  const auto out_status      = out_status_row[0];
+  out_.resp_data     = out_control_row[0].dataflow == kExDataflowOS ? out_c : out_b;
   out_.resp_valid    = bit(out_status.valid);
   out_.resp_last     = bit(out_status.in_last);
   out_.out_matmul_id = out_status.in_id;
 }
+// transaction-level model: apply this step's beat to c1/c2 at once and delay its result
+void MeshHull::stepTransaction(const MeshHullIn& in, const MeshInputRow& a, const MeshAccumRow& b, const MeshInputRow& d) {
+  TlResult result{};
+  result.status.in_id   = in.matmul_id;
+  result.status.in_last = in.last_fire != 0;
+  result.status.valid   = in.not_paused != 0;
+
+  const bool prop = in.pe_control.propagate != 0;
+  if (result.status.valid && in.pe_control.dataflow == kExDataflowOS) {
+    const bool flip = prop != tl_last_prop_;
+    stepTransactionOs(prop, flip, static_cast<std::uint8_t>(in.pe_control.shift), a, b, d, result.data);
+  } else if (result.status.valid) {
+    const std::size_t w = prop ? 1 : 0; // weights in use: c2 if prop=1, c1 if prop=0
+    const std::size_t s = prop ? 0 : 1; // the other set takes the D column
+    // out = b + a * W, one weight row at a time so the inner loop runs across lanes
+    result.data = b;
+    for (std::size_t r = 0; r < kDim; ++r) {
+      const Acc a_r = static_cast<Acc>(a[r]);
+      if (a_r == 0) {
+        continue;
+      }
+      const auto& w_row = tl_regs_[w][(r + tl_row0_[w]) % kDim];
+      for (std::size_t col = 0; col < kDim; ++col) {
+        result.data[col] += a_r * static_cast<Acc>(w_row[col]);
+      }
+    }
+    // D: each row of the other set takes the row above's old value, d enters row 0
+    tl_row0_[s] = (tl_row0_[s] + kDim - 1) % kDim;
+    tl_regs_[s][tl_row0_[s]] = d;
+  }
+  if (result.status.valid) {
+    tl_last_prop_ = prop;
+  }
+
+  // queue slots are reused in order: after this write the head is the result written kTlLatency steps ago
+  tl_queue_[tl_head_] = result;
+  tl_head_ = (tl_head_ + 1) % tl_queue_.size();
+  const auto& emitted = tl_queue_[tl_head_];
+  out_.resp_data     = emitted.data;
+  out_.resp_valid    = bit(emitted.status.valid);
+  out_.resp_last     = bit(emitted.status.in_last);
+  out_.out_matmul_id = emitted.status.in_id;
+}
+// one OS beat: rank-1 update of the active accumulators, the other set drains one row
+void MeshHull::stepTransactionOs(bool prop, bool flip, std::uint8_t shift,
+                                 const MeshInputRow& a, const MeshAccumRow& b, const MeshInputRow& d, MeshAccumRow& out) {
+  const std::size_t acc   = prop ? 1 : 0; // accumulating: acc2 if prop=1, acc1 if prop=0
+  const std::size_t drain = prop ? 0 : 1;
+  auto& drain_regs = tl_acc_[drain];
+  if (flip && shift != 0) { // every PE shifts the value it passes on the first beat after a flip
+    for (auto& row : drain_regs) {
+      for (auto& v : row) {
+        v = MeshCore::roundingShift(v, shift);
+      }
+    }
+  }
+  auto& row0 = tl_acc_row0_[drain];
+  out  = drain_regs[(kDim - 1 + row0) % kDim];
+  row0 = (row0 + kDim - 1) % kDim;
+  drain_regs[row0] = widenInputRow(d);
+
+  auto& acc_regs = tl_acc_[acc];
+  for (std::size_t r = 0; r < kDim; ++r) {
+    const Acc a_r = static_cast<Acc>(a[r]);
+    if (a_r == 0) {
+      continue;
+    }
+    auto& acc_row = acc_regs[(r + tl_acc_row0_[acc]) % kDim];
+    for (std::size_t col = 0; col < kDim; ++col) {
+      acc_row[col] += a_r * b[col];
+    }
+  }
+}
 // Widen element bitdwidth of row input vector to accumulator and hence partial sum bitwidth
 MeshAccumRow MeshHull::widenInputRow(const MeshInputRow& row) const {
   MeshAccumRow widened{};
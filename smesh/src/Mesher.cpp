@@ -35,17 +35,53 @@ MesherTag makeGarbageTag() {
 } // namespace
 
 Mesher::Mesher(std::string /*name*/, IMPL_CTOR) {
+  // ready/tag outputs depend on registered state only, so ExCtrl's deq control and
+  // input select can read them and still drive req_val/a_val/b_val/d_val this cycle
+  UPDATE(updateReady)
+      .writes(req_rdy,
+              a_rdy, b_rdy, d_rdy)
+      .writes(tags_in_progress);
   UPDATE(update)
       .reads(req_val, req_bits,
              a_val, a_bits,
              b_val, b_bits,
              d_val, d_bits)
       .reads(transposer_out_col_bits)
-      .writes(req_rdy,
-              a_rdy, b_rdy, d_rdy,
-              transposer_in_row_val, transposer_in_row_bits,
-              resp_val, resp_bits)
-      .writes(tags_in_progress);
+      .writes(transposer_in_row_val, transposer_in_row_bits,
+              resp_val, resp_bits);
+}
+
+Mesher::Readiness Mesher::readiness() const {
+  Readiness r{};
+  r.input_next_row = req_state_valid_ && ((a_written_ && b_written_ && d_written_) || req_state_.flush > 0);
+  // note: keep input_next_row first so C++ does not evaluate total_rows - 1 when no request is active.
+  r.last_fire = r.input_next_row && fire_counter_ == req_state_.total_rows - 1;
+  r.req       = !req_state_valid_ || r.last_fire;
+  r.a         = !a_written_ || r.input_next_row || r.req;
+  r.b         = !b_written_ || r.input_next_row || r.req;
+  r.d         = !d_written_ || r.input_next_row || r.req;
+  return r;
+}
+
+void Mesher::updateReady() {
+  const auto ready = readiness();
+  req_rdy = bit(ready.req);
+  a_rdy   = bit(ready.a);
+  b_rdy   = bit(ready.b);
+  d_rdy   = bit(ready.d);
+
+  // tags still owed a writeback, oldest first: what the decoder checks for RAW hazards and
+  // what keeps CONFIG from changing c_addr_stride/dataflow under an in-flight matmul
+  std::size_t out = 0;
+  for (std::uint8_t i = 0; i < tagq_count_ && out < kRsExecuteEntries; ++i) {
+    const auto& tag = tagq_[wrappingAdd(tagq_head_, i, static_cast<std::uint8_t>(kTagQueueEntries))].tag;
+    if (tag.rs_tag_valid != 0 || !tag.addr.is_garbage()) {
+      tags_in_progress[out++] = tag;
+    }
+  }
+  for (; out < kRsExecuteEntries; ++out) {
+    tags_in_progress[out] = makeGarbageTag(); // empty slots never match an operand address
+  }
 }
 
 void Mesher::update() {
@@ -68,21 +104,16 @@ void Mesher::update() {
   // *******************
   // Combinational Logic
   // *******************
-  const bool input_next_row_into_spatial_array = cur_req_state_valid && ((cur_a_written && cur_b_written && cur_d_written) || cur_req_state.flush > 0);
+  const auto ready = readiness();
+  const bool input_next_row_into_spatial_array = ready.input_next_row;
   const bool pause = !cur_req_state_valid || !input_next_row_into_spatial_array;
   const auto total_fires = cur_req_state.total_rows;
-  // note: keep input_next_row_into_spatial_array first so C++ does not evaluate total_fires - 1 when no request is active.
-  const bool last_fire = input_next_row_into_spatial_array && cur_fire_counter == total_fires - 1;
-
-  const bool req_ready = !cur_req_state_valid || last_fire;
-  const bool a_ready   = !cur_a_written || input_next_row_into_spatial_array || req_ready;
-  const bool b_ready   = !cur_b_written || input_next_row_into_spatial_array || req_ready;
-  const bool d_ready   = !cur_d_written || input_next_row_into_spatial_array || req_ready;
+  const bool last_fire = ready.last_fire;
 
-  req_rdy = bit(req_ready);
-  a_rdy   = bit(a_ready);
-  b_rdy   = bit(b_ready);
-  d_rdy   = bit(d_ready);
+  const bool req_ready = ready.req;
+  const bool a_ready   = ready.a;
+  const bool b_ready   = ready.b;
+  const bool d_ready   = ready.d;
 
   const bool req_fire = req_val != 0 && req_ready;
   const bool a_fire   = a_val != 0 && a_ready;
@@ -161,10 +192,6 @@ void Mesher::update() {
   next_resp_bits.total_rows = total_rows_id_matches ? total_rows_q_front_bits.total_rows : static_cast<std::uint32_t>(kDim);
   resp_bits = next_resp_bits;
 
-  for (std::size_t i = 0; i < kRsExecuteEntries; ++i) {
-    tags_in_progress[i] = MesherTag{};
-  }
-
   // pop tagq when matching o/p ID appears and this is last o/p row for that tagged operation
   const bool tagq_deq_fire = resp_valid && resp_last && tagq_id_matches;
   // pop total_rows_q when matching o/p ID appears and this is last o/p for for that request
@@ -213,6 +240,7 @@ void Mesher::update() {
 
   if (input_next_row_into_spatial_array) {
     next_fire_counter = wrappingAdd(cur_fire_counter, 1u, total_fires); // track how many rows of current req have entered mesh
+    row_beats_ += cur_req_state.flush == 0 ? 1 : 0;
     next_a_written    = false;
     next_b_written    = false;
     next_d_written    = false;
@@ -269,6 +297,7 @@ void Mesher::reset() {
   b_written_          = false;
   d_written_          = false;
   fire_counter_       = 0;
+  row_beats_          = 0;
   tagq_               = {};
   tagq_head_          = 0;
   tagq_tail_          = 0;
@@ -285,7 +314,7 @@ void Mesher::reset() {
   resp_val.reset(0);
   resp_bits.reset(MesherResp{});
   for (std::size_t i = 0; i < kRsExecuteEntries; ++i) {
-    tags_in_progress[i].reset(MesherTag{});
+    tags_in_progress[i].reset(makeGarbageTag());
   }
 }
 
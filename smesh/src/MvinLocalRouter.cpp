@@ -11,9 +11,7 @@ Load-path local-memory router implementation.
 namespace smesh {
 
 MvinLocalRouter::MvinLocalRouter(std::string /*name*/, IMPL_CTOR) {
-  UPDATE(update)
-      .reads(data_in, dmaread_spad_rdy, dmaread_accum_rdy)
-      .writes(dmaread_spad, dmaread_accum);
+  UPDATE(update).reads(data_in, dmaread_spad_rdy, dmaread_accum_rdy);
   UPDATE(updateView)
       .writes(dmaread_spad_val,
               dmaread_spad_bits,
@@ -25,52 +23,26 @@ void MvinLocalRouter::update() {
   if (Sim::state == Sim::SimResetting) {
     return;
   }
-
-  if (!entry_valid_) {
-    if (data_in.empty()) {
-      return;
-    }
-    entry_ = data_in.pop();
-    entry_valid_ = true;
-    return;
-  }
-
-  const auto& pending = entry_;
-  if (pending.laddr.is_acc_addr()) { // if data from DMA destined for accum...
-    if (dmaread_accum_rdy != 0) {
-      trace("mvin_local_router: deq accum laddr=0x%x cmd_id=%u",
-            static_cast<unsigned>(pending.laddr.raw),
-            static_cast<unsigned>(pending.cmd_id));
-      entry_ = DmaReadResp{};
-      entry_valid_ = false;
+  // the held row leaves only when its destination's WriteCtrl port takes it
+  if (entry_valid_) {
+    const auto& pending = entry_;
+    const bool to_accum = pending.laddr.is_acc_addr(); // if data from DMA destined for accum...
+    if ((to_accum ? dmaread_accum_rdy : dmaread_spad_rdy) == 0) {
       return;
     }
-    if (dmaread_accum.full()) {
-      return;
-    }
-    dmaread_accum.push(pending);
-    trace("mvin_local_router: to accum laddr=0x%x cmd_id=%u",
-          static_cast<unsigned>(pending.laddr.raw),
-          static_cast<unsigned>(pending.cmd_id));
-  } else {                           // if data from DMA destined for spad...
-    if (dmaread_spad_rdy != 0) {
-      trace("mvin_local_router: deq spad laddr=0x%x cmd_id=%u",
-            static_cast<unsigned>(pending.laddr.raw),
-            static_cast<unsigned>(pending.cmd_id));
-      entry_ = DmaReadResp{};
-      entry_valid_ = false;
-      return;
-    }
-    if (dmaread_spad.full()) {
-      return;
-    }
-    dmaread_spad.push(pending);
-    trace("mvin_local_router: to spad laddr=0x%x cmd_id=%u",
+    trace("mvin_local_router: deq %s laddr=0x%x cmd_id=%u",
+          to_accum ? "accum" : "spad",
           static_cast<unsigned>(pending.laddr.raw),
           static_cast<unsigned>(pending.cmd_id));
+    entry_ = DmaReadResp{};
+    entry_valid_ = false;
   }
-  entry_ = DmaReadResp{};
-  entry_valid_ = false;
+
+  if (data_in.empty()) {
+    return;
+  }
+  entry_ = data_in.pop();
+  entry_valid_ = true;
 }
 
 void MvinLocalRouter::updateView() {
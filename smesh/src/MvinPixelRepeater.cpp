@@ -10,20 +10,80 @@ Load-path pixel repetition stage implementation.
 
 namespace smesh {
 
+namespace {
+
+constexpr std::uint32_t kLaneMask = (std::uint32_t{1} << kDim) - 1u;
+
+// copy k starts k * len lanes in and k rows up; it must stay inside the row and the memory
+bool copyFits(const DmaReadResp& row, std::uint32_t k) {
+  const auto shift = k * static_cast<std::uint32_t>(static_cast<std::uint16_t>(row.len));
+  return k == 0 || (shift < kDim && row.laddr.data() >= k);
+}
+
+DmaReadResp repeatCopy(const DmaReadResp& row, std::uint32_t k) {
+  if (k == 0) {
+    return row;
+  }
+  const auto shift = k * static_cast<std::uint32_t>(static_cast<std::uint16_t>(row.len));
+  DmaReadResp copy = row;
+  copy.data = DmaReadData{};
+  for (std::size_t lane = 0; lane + shift < kDim; ++lane) {
+    copy.data[lane + shift] = row.data[lane];
+  }
+  copy.mask = u8(static_cast<std::uint8_t>((static_cast<std::uint32_t>(static_cast<std::uint8_t>(row.mask)) << shift) & kLaneMask));
+  copy.laddr = SmeshLocalAddr{(row.laddr.raw & ~kLocalAddrDataMask) | ((row.laddr.data() - k) & kLocalAddrDataMask)};
+  copy.bytes_read = 0;
+  copy.last = false;
+  return copy;
+}
+
+} // namespace
+
 MvinPixelRepeater::MvinPixelRepeater(std::string /*name*/, IMPL_CTOR) {
   UPDATE(update).reads(data_in).writes(data_out);
 }
 
 void MvinPixelRepeater::update() {
-  if (data_in.empty() || data_out.full()) {
+  if (!entry_valid_) {
+    if (data_in.empty()) {
+      return;
+    }
+    entry_ = data_in.pop();
+    entry_valid_ = true;
+    const auto repeats = static_cast<std::uint32_t>(static_cast<std::uint8_t>(entry_.pixel_repeats));
+    repeat_ = repeats > 1 ? repeats - 1 : 0;
+  }
+  while (repeat_ > 0 && !copyFits(entry_, repeat_)) {
+    ++dropped_;
+    --repeat_;
+  }
+  if (data_out.full()) {
     return;
   }
 
-  const auto data = data_in.pop();
-  assert_always(static_cast<std::uint8_t>(data.pixel_repeats) == 1,
-                "MvinPixelRepeater currently supports pixel_repeats=1 only");
-  data_out.push(data);
-  trace("mvin_pixel_repeater: identity data cmd_id=%u last=%u", static_cast<unsigned>(data.cmd_id), static_cast<unsigned>(data.last));
+  const auto copy = repeatCopy(entry_, repeat_);
+  data_out.push(copy);
+  ++copies_;
+  trace("mvin_pixel_repeater: copy k=%u laddr=0x%x mask=0x%x cmd_id=%u last=%u",
+        static_cast<unsigned>(repeat_),
+        static_cast<unsigned>(copy.laddr.raw),
+        static_cast<unsigned>(copy.mask),
+        static_cast<unsigned>(copy.cmd_id),
+        static_cast<unsigned>(copy.last));
+  if (repeat_ == 0) {
+    entry_ = DmaReadResp{};
+    entry_valid_ = false;
+  } else {
+    --repeat_;
+  }
+}
+
+void MvinPixelRepeater::reset() {
+  entry_valid_ = false;
+  entry_ = DmaReadResp{};
+  repeat_ = 0;
+  copies_ = 0;
+  dropped_ = 0;
 }
 
 } // namespace smesh
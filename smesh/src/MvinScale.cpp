@@ -8,7 +8,50 @@ Load-path scaling stage implementation.
 
 #include "MvinScale.hpp"
 
+#include "Requantize.hpp"
+
 namespace smesh {
+
+namespace {
+// input-width rows carry one byte per lane
+DmaReadResp scaleInput(DmaReadResp resp) {
+  if (static_cast<std::uint32_t>(resp.scale) == kAccScaleIdentity) {
+    return resp;
+  }
+  MeshInputRow row{};
+  for (std::size_t lane = 0; lane < kDim; ++lane) {
+    row[lane] = static_cast<Elem>(resp.data[lane]);
+  }
+  const auto scaled = scaleInputRow(row, static_cast<std::uint32_t>(resp.scale));
+  for (std::size_t lane = 0; lane < kDim; ++lane) {
+    resp.data[lane] = static_cast<std::uint8_t>(scaled[lane]);
+  }
+  return resp;
+}
+// accumulator-width rows carry four little-endian bytes per lane
+DmaReadResp scaleAccum(DmaReadResp resp) {
+  if (static_cast<std::uint32_t>(resp.scale) == kAccScaleIdentity) {
+    return resp;
+  }
+  MeshAccumRow row{};
+  for (std::size_t lane = 0; lane < kDim; ++lane) {
+    std::uint32_t word = 0;
+    for (std::size_t byte = 0; byte < sizeof(Acc); ++byte) {
+      word |= static_cast<std::uint32_t>(resp.data[lane * sizeof(Acc) + byte]) << (8 * byte);
+    }
+    row[lane] = static_cast<Acc>(word);
+  }
+  const auto scaled = scaleAccumRow(row, static_cast<std::uint32_t>(resp.scale));
+  for (std::size_t lane = 0; lane < kDim; ++lane) {
+    const auto word = static_cast<std::uint32_t>(scaled[lane]);
+    for (std::size_t byte = 0; byte < sizeof(Acc); ++byte) {
+      resp.data[lane * sizeof(Acc) + byte] = static_cast<std::uint8_t>((word >> (8 * byte)) & 0xffu);
+    }
+  }
+  return resp;
+}
+
+} // namespace
 // scale normal width data coming from DMA reader
 MvinScale::MvinScale(std::string /*name*/, IMPL_CTOR) {
   UPDATE(update).reads(data_in).writes(data_out);
@@ -19,15 +62,16 @@ void MvinScale::update() {
     return;
   }
 
-  const auto data = data_in.pop();
+  const auto data = scaleInput(data_in.pop());
   data_out.push(data);
-  trace("mvin_scale: identity data cmd_id=%u last=%u", static_cast<unsigned>(data.cmd_id), static_cast<unsigned>(data.last));
+  trace("mvin_scale: data scale=0x%x cmd_id=%u last=%u",
+        static_cast<unsigned>(data.scale),
+        static_cast<unsigned>(data.cmd_id),
+        static_cast<unsigned>(data.last));
 }
 // scale accumulator-width data coming from DMA reader
 MvinScaleAcc::MvinScaleAcc(std::string /*name*/, IMPL_CTOR) {
-  UPDATE(update)
-      .reads(data_in, data_rdy)
-      .writes(data_out);
+  UPDATE(update).reads(data_in, data_rdy);
   UPDATE(updateView).writes(data_val, data_bits);
 }
 
@@ -35,35 +79,21 @@ void MvinScaleAcc::update() {
   if (Sim::state == Sim::SimResetting) {
     return;
   }
-
-  if (!entry_valid_) {
-    if (data_in.empty()) {
-      return;
-    }
-    entry_ = data_in.pop();
-    entry_valid_ = true;
-    return;
-  }
-
-  if (data_rdy != 0) {
-    trace("mvin_scale_acc: explicit data cmd_id=%u last=%u",
+  // the held row leaves only when WriteCtrl's accumulator-width port takes it
+  if (entry_valid_ && data_rdy != 0) {
+    trace("mvin_scale_acc: data scale=0x%x cmd_id=%u last=%u",
+          static_cast<unsigned>(entry_.scale),
           static_cast<unsigned>(entry_.cmd_id),
           static_cast<unsigned>(entry_.last));
     entry_ = DmaReadResp{};
     entry_valid_ = false;
-    return;
   }
 
-  if (data_out.full()) {
+  if (entry_valid_ || data_in.empty()) {
     return;
   }
-
-  data_out.push(entry_);
-  trace("mvin_scale_acc: identity data cmd_id=%u last=%u",
-        static_cast<unsigned>(entry_.cmd_id),
-        static_cast<unsigned>(entry_.last));
-  entry_ = DmaReadResp{};
-  entry_valid_ = false;
+  entry_ = scaleAccum(data_in.pop());
+  entry_valid_ = true;
 }
 
 void MvinScaleAcc::updateView() {
@@ -3,52 +3,249 @@
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 12 2026
 /*
-Transform/joins accumulator read data and norm metadata.
+Accumulator normalization stage implementation. The stats entry a row updates
+(or reads, for an output row) is only touched in the last stage, so rows of
+one stats id see each other's effects in command order.
 */
 
 #include "Normalizer.hpp"
 
+#include "Activation.hpp"
+#include "Requantize.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace smesh {
 
+namespace {
+
+ActivationParams iexpParams(const AccumReadResp& acc) {
+  ActivationParams params{};
+  params.igelu_qb      = static_cast<std::int32_t>(static_cast<std::uint32_t>(acc.igelu_qb));
+  params.igelu_qc      = static_cast<std::int32_t>(static_cast<std::uint32_t>(acc.igelu_qc));
+  params.iexp_qln2     = static_cast<std::int32_t>(static_cast<std::uint32_t>(acc.iexp_qln2));
+  params.iexp_qln2_inv = static_cast<std::uint32_t>(acc.iexp_qln2_inv);
+  return params;
+}
+
+Acc saturateToAcc(std::int64_t value) {
+  const std::int64_t lo = std::numeric_limits<Acc>::min();
+  const std::int64_t hi = std::numeric_limits<Acc>::max();
+  return static_cast<Acc>(std::min(std::max(value, lo), hi));
+}
+
+std::size_t rowLanes(const AccNormReq& req) {
+  return std::min<std::size_t>(static_cast<std::uint16_t>(req.cmd.len), kDim);
+}
+
+bool isMomentCmd(NormCmd cmd) {
+  return cmd == NormCmd::Sum || cmd == NormCmd::Mean ||
+         cmd == NormCmd::Variance || cmd == NormCmd::InvStddev;
+}
+
+// every acc_scale of the row times factor, as float32 words
+void scaleRowBy(AccumReadResp& acc, float factor) {
+  const auto format = acc.scale_fixed != 0 ? AccScaleFormat::Fixed16 : AccScaleFormat::Float32;
+  acc.scale = accScaleFromFloat(accScaleToFloat(static_cast<std::uint32_t>(acc.scale), format) * factor);
+  for (auto& word : acc.channel_scale) {
+    if (word != 0) {
+      word = accScaleFromFloat(accScaleToFloat(word, format) * factor);
+    }
+  }
+  acc.scale_fixed = false;
+}
+
+} // namespace
+
 Normalizer::Normalizer(std::string /*name*/, IMPL_CTOR) {
-  UPDATE(updateReady).writes(req_rdy);
+  UPDATE(updateReady).reads(resp_rdy).writes(req_rdy);
   UPDATE(updateRespView).writes(resp_val, resp_bits);
-  UPDATE(updateRespPop).reads(resp_rdy);
-  UPDATE(update).reads(req_val, req_bits);
+  UPDATE(update).reads(req_val, req_bits, resp_rdy).writes(stats_done);
 }
 
-void Normalizer::updateReady() {
-  req_rdy = bit(!resp_valid_);
+void Normalizer::setLatency(std::size_t n) {
+  assert_always(n >= 1 && n <= kNormMaxLatency, "Normalizer latency must be 1..kNormMaxLatency");
+  assert_always(count_ == 0, "Normalizer: change latency only while empty");
+  latency_ = n;
 }
 
+// a full pipeline still accepts when its last row leaves this cycle, since every row then moves up
+void Normalizer::updateReady() {
+  const auto& last = stages_[latency_ - 1];
+  const bool output = static_cast<NormCmd>(static_cast<std::uint8_t>(last.req.cmd.cmd)) == NormCmd::Reset;
+  const bool leaving = last.valid && (output ? resp_rdy != 0 : !stats_done.full());
+  accepting_ = count_ < latency_ || leaving;
+  req_rdy = bit(accepting_);
+}
+// only output (RESET) rows are advertised; stats rows end here
 void Normalizer::updateRespView() {
-  resp_val = bit(resp_valid_);
-  resp_bits = resp_valid_ ? resp_entry_ : AccNormReq{};
+  const auto& last = stages_[latency_ - 1];
+  const bool output = last.valid && static_cast<NormCmd>(static_cast<std::uint8_t>(last.req.cmd.cmd)) == NormCmd::Reset;
+  resp_val = bit(output);
+  resp_bits = output ? normalize(last.req) : AccNormReq{};
 }
+// fold one stats row into its entry
+void Normalizer::reduce(const AccNormReq& req) {
+  const auto id = static_cast<std::size_t>(static_cast<std::uint16_t>(req.cmd.stats_id));
+  assert_always(id < kNormStats, "Normalizer stats id is past kNormStats");
+  auto& entry = stats_[id];
+  const auto cmd = static_cast<NormCmd>(static_cast<std::uint8_t>(req.cmd.cmd));
+  const auto& acc = req.acc_read_resp;
+  const auto lanes = rowLanes(req);
+
+  if (isMomentCmd(cmd)) {
+    if (entry.moments_final) { // a new LayerNorm row starts over
+      entry.sum = 0;
+      entry.sum_sq = 0;
+      entry.count = 0;
+      entry.moments_final = false;
+    }
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+      const std::int64_t x = acc.data[lane];
+      entry.sum += x;
+      entry.sum_sq += static_cast<__int128>(x) * x;
+    }
+    entry.count += static_cast<std::uint32_t>(lanes);
+    if (cmd != NormCmd::Sum && entry.count > 0) {
+      const double n = entry.count;
+      const double mean = static_cast<double>(entry.sum) / n;
+      entry.mean = saturateToAcc(std::llrint(mean));
+      entry.variance = std::max(static_cast<double>(entry.sum_sq) / n - mean * mean, 0.0);
+      entry.inv_stddev = entry.variance > 0.0 ? static_cast<float>(1.0 / std::sqrt(entry.variance)) : 1.0f;
+      entry.moments_final = true;
+    }
+    return;
+  }
 
-void Normalizer::updateRespPop() {
-  if (resp_valid_ && resp_rdy != 0) {
-    resp_valid_ = false;
-    resp_entry_ = AccNormReq{};
+  if (cmd == NormCmd::Max) {
+    if (entry.exp_final) { // a new softmax row starts over
+      entry.max_valid = false;
+      entry.sum_exp = 0;
+      entry.exp_final = false;
+    }
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+      entry.max = entry.max_valid ? std::max(entry.max, acc.data[lane]) : acc.data[lane];
+      entry.max_valid = true;
+    }
+    return;
   }
-}
 
+  // SUM_EXP / INV_SUM_EXP
+  if (entry.exp_final) {
+    entry.sum_exp = 0;
+    entry.exp_final = false;
+  }
+  const auto params = iexpParams(acc);
+  for (std::size_t lane = 0; lane < lanes; ++lane) {
+    entry.sum_exp += activate(saturateToAcc(std::int64_t{acc.data[lane]} - entry.max), Activation::IExp, params);
+  }
+  if (cmd == NormCmd::InvSumExp) {
+    entry.inv_sum_exp = entry.sum_exp > 0 ? static_cast<float>(1.0 / static_cast<double>(entry.sum_exp)) : 1.0f;
+    entry.exp_final = true;
+  }
+}
+// apply the row's LayerNorm/Softmax activation with its entry's statistics
+AccNormReq Normalizer::normalize(const AccNormReq& req) const {
+  const auto act = decodeActivation(static_cast<std::uint8_t>(req.acc_read_resp.act));
+  if (act != Activation::LayerNorm && act != Activation::Softmax) {
+    return req;
+  }
+  const auto id = static_cast<std::size_t>(static_cast<std::uint16_t>(req.cmd.stats_id));
+  assert_always(id < kNormStats, "Normalizer stats id is past kNormStats");
+  const auto& entry = stats_[id];
+  AccNormReq out = req;
+  auto& acc = out.acc_read_resp;
+  if (act == Activation::LayerNorm) {
+    for (std::size_t lane = 0; lane < kDim; ++lane) {
+      acc.data[lane] = saturateToAcc(std::int64_t{acc.data[lane]} - entry.mean);
+    }
+    scaleRowBy(acc, entry.inv_stddev);
+  } else {
+    const auto params = iexpParams(acc);
+    for (std::size_t lane = 0; lane < kDim; ++lane) {
+      acc.data[lane] = activate(saturateToAcc(std::int64_t{acc.data[lane]} - entry.max), Activation::IExp, params);
+    }
+    scaleRowBy(acc, entry.inv_sum_exp);
+  }
+  acc.act = u8(static_cast<std::uint8_t>(Activation::None)); // done here, AccScaleUnit only requantizes
+  return out;
+}
+// retire the last stage, move every row whose next stage is free, then take the new row into stage 0
 void Normalizer::update() {
-  if (req_val == 0 || resp_valid_) {
+  ++cycles_;
+  occupancy_sum_ += count_;
+
+  auto& last = stages_[latency_ - 1];
+  if (last.valid) {
+    const bool output = static_cast<NormCmd>(static_cast<std::uint8_t>(last.req.cmd.cmd)) == NormCmd::Reset;
+    const bool done = output ? resp_rdy != 0 : !stats_done.full();
+    if (done) {
+      if (output) {
+        ++rows_;
+      } else {
+        reduce(last.req);
+        DmaWriteResp ack{};
+        ack.cmd_id = last.req.acc_read_resp.cmd_id;
+        stats_done.push(ack);
+        ++stats_rows_;
+        trace("normalizer: reduced stats_id=%u norm_cmd=%u cmd_id=%u",
+              static_cast<unsigned>(last.req.cmd.stats_id),
+              static_cast<unsigned>(last.req.cmd.cmd),
+              static_cast<unsigned>(ack.cmd_id));
+      }
+      last = Stage{};
+      --count_;
+    } else {
+      ++out_stall_cycles_;
+    }
+  }
+  for (std::size_t stage = latency_ - 1; stage > 0; --stage) {
+    if (!stages_[stage].valid && stages_[stage - 1].valid) {
+      stages_[stage] = stages_[stage - 1];
+      stages_[stage - 1] = Stage{};
+    }
+  }
+
+  if (req_val == 0) {
+    return;
+  }
+  if (!accepting_) {
+    ++full_stall_cycles_;
     return;
   }
 
   const auto req = *req_bits;
   assert_always(req.acc_read_resp.from_dma != 0, "Normalizer received non-DMA accumulator response");
-  resp_entry_ = req;
-  resp_valid_ = true;
+  stages_[0].valid = true;
+  stages_[0].req = req;
+  ++count_;
+  accepting_ = false;
 
-  trace("normalizer: accepted acc_laddr=0x%x len=%u stats_id=%u norm_cmd=%u cmd_id=%u",
+  trace("normalizer: accepted acc_laddr=0x%x len=%u stats_id=%u norm_cmd=%u cmd_id=%u occupancy=%zu",
         static_cast<unsigned>(req.acc_read_resp.laddr.raw),
         static_cast<unsigned>(req.cmd.len),
         static_cast<unsigned>(req.cmd.stats_id),
         static_cast<unsigned>(req.cmd.cmd),
-        static_cast<unsigned>(req.acc_read_resp.cmd_id));
+        static_cast<unsigned>(req.acc_read_resp.cmd_id),
+        count_);
+}
+
+void Normalizer::reset() {
+  accepting_ = false;
+  stages_.fill(Stage{});
+  stats_.fill(Stats{});
+  count_ = 0;
+  cycles_ = 0;
+  rows_ = 0;
+  stats_rows_ = 0;
+  full_stall_cycles_ = 0;
+  out_stall_cycles_ = 0;
+  occupancy_sum_ = 0;
+  req_rdy.reset(1);
+  resp_val.reset(0);
+  resp_bits.reset(AccNormReq{});
 }
 
 } // namespace smesh
@@ -0,0 +1,210 @@
+// **********************************************************************
+// smesh/src/Requantize.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Aug 27 2026
+/*
+Requantization kernels. The row kernel resolves the lane scales first and then
+runs one branch-free multiply/round/clamp loop over the row, so the per-lane
+work vectorizes.
+
+The mvin row kernels share one scale across the row; with AVX2 they scale four
+lanes at a time on the same exact int64 product, and otherwise (or when the
+multiplier needs more than 32 bits) they take the portable per-lane loop.
+*/
+
+#include "Requantize.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace smesh {
+
+namespace {
+
+constexpr std::int64_t kElemMin = std::numeric_limits<Elem>::min();
+constexpr std::int64_t kElemMax = std::numeric_limits<Elem>::max();
+constexpr std::int64_t kAccMin  = std::numeric_limits<Acc>::min();
+constexpr std::int64_t kAccMax  = std::numeric_limits<Acc>::max();
+
+float scaleToFloat(std::uint32_t word) {
+  if (word == kAccScaleIdentity) {
+    return 1.0f;
+  }
+  float scale = 0.0f;
+  std::memcpy(&scale, &word, sizeof(scale));
+  return scale;
+}
+
+std::uint32_t scaleToFixed(std::uint32_t word) {
+  return word == kAccScaleIdentity ? (1u << kAccScaleFixedBits) : word;
+}
+
+// any nonzero acc times this is past the Acc range, and |acc| * it stays inside int64
+constexpr std::int64_t kSaturatingMult = (std::int64_t{1} << 32) - 1;
+
+// a float32 scale as an exact integer multiplier and right shift: scale = mult * 2^-shift
+struct ExactScale {
+  std::int64_t mult  = 0;
+  int          shift = 0;
+};
+
+ExactScale toExact(float scale) {
+  if (std::isnan(scale)) {
+    return ExactScale{}; // a NaN scale zeroes the lane
+  }
+  if (std::isinf(scale)) {
+    return ExactScale{scale > 0 ? kSaturatingMult : -kSaturatingMult, 0};
+  }
+  int exp = 0;
+  const auto mult = static_cast<std::int64_t>(std::ldexp(std::frexp(scale, &exp), 24)); // the 24-bit significand
+  exp -= 24;
+  if (exp >= 0) { // scale >= 2^24: past 2^32 the multiplier only saturates
+    return ExactScale{exp > 8 ? (mult > 0 ? kSaturatingMult : -kSaturatingMult) : mult * (std::int64_t{1} << exp), 0};
+  }
+  return ExactScale{mult, std::min(-exp, 62)}; // past 62 the 55-bit product rounds to zero either way
+}
+// product >> shift, rounded half to even
+std::int64_t roundShift(std::int64_t product, int shift) {
+  const std::int64_t one  = std::int64_t{1} << shift;
+  const std::int64_t half = one >> 1;
+  const std::int64_t rem  = product & (one - 1);
+  std::int64_t q          = product >> shift; // floor
+  q += (rem > half || (rem == half && half != 0 && (q & 1) != 0)) ? 1 : 0;
+  return q;
+}
+// int32 x 24-bit significand needs up to 55 bits, so the product is formed exactly in
+// int64 and rounded once, ties to even; then saturated to the Elem range
+Elem requantizeFloat(Acc acc, ExactScale scale) {
+  const std::int64_t q = roundShift(static_cast<std::int64_t>(acc) * scale.mult, scale.shift);
+  return static_cast<Elem>(std::min(std::max(q, kElemMin), kElemMax));
+}
+// same rounding, saturating to the full accumulator range
+Acc scaleAccFloat(Acc acc, ExactScale scale) {
+  const std::int64_t q = roundShift(static_cast<std::int64_t>(acc) * scale.mult, scale.shift);
+  return static_cast<Acc>(std::min(std::max(q, kAccMin), kAccMax));
+}
+// Q16.16 product, then a round-half-to-even shift
+Elem requantizeFixed(Acc acc, std::uint32_t scale) {
+  const std::int64_t product = static_cast<std::int64_t>(acc) * static_cast<std::int64_t>(scale);
+  const std::int64_t q       = roundShift(product, kAccScaleFixedBits);
+  return static_cast<Elem>(std::min(std::max(q, kElemMin), kElemMax));
+}
+
+#if defined(__AVX2__)
+// the vector kernel multiplies by the low 32 bits of each 64-bit lane
+bool fitsVectorMult(ExactScale scale) {
+  return scale.mult >= std::numeric_limits<std::int32_t>::min() &&
+         scale.mult <= std::numeric_limits<std::int32_t>::max();
+}
+// four sign-extended lanes: roundShift(v * mult, shift) clamped to [lo, hi], as int32.
+// AVX2 has no 64-bit arithmetic shift, so the product (|p| <= 2^62) is biased by 2^62
+// and floored with a logical shift; the bias is a multiple of 2^shift (shift <= 62).
+__m128i scaleLanes(__m256i v, ExactScale scale, std::int64_t lo, std::int64_t hi) {
+  const std::int64_t bias = std::int64_t{1} << 62;
+  const std::int64_t one  = std::int64_t{1} << scale.shift;
+  const __m256i half = _mm256_set1_epi64x(one >> 1);
+  const __m256i unit = _mm256_set1_epi64x(1);
+  const __m256i p    = _mm256_add_epi64(_mm256_mul_epi32(v, _mm256_set1_epi64x(scale.mult)), _mm256_set1_epi64x(bias));
+  const __m256i rem  = _mm256_and_si256(p, _mm256_set1_epi64x(one - 1));
+  __m256i q = _mm256_sub_epi64(_mm256_srl_epi64(p, _mm_cvtsi32_si128(scale.shift)), _mm256_set1_epi64x(bias >> scale.shift));
+  const __m256i odd  = _mm256_cmpeq_epi64(_mm256_and_si256(q, unit), unit);
+  const __m256i tie  = _mm256_and_si256(_mm256_cmpeq_epi64(rem, half), odd);
+  const __m256i up   = _mm256_or_si256(_mm256_cmpgt_epi64(rem, half), scale.shift != 0 ? tie : _mm256_setzero_si256());
+  q = _mm256_sub_epi64(q, up); // up is -1 where the lane rounds away from the floor
+  const __m256i hi_v = _mm256_set1_epi64x(hi);
+  const __m256i lo_v = _mm256_set1_epi64x(lo);
+  q = _mm256_blendv_epi8(q, hi_v, _mm256_cmpgt_epi64(q, hi_v));
+  q = _mm256_blendv_epi8(q, lo_v, _mm256_cmpgt_epi64(lo_v, q));
+  return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(q, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6)));
+}
+#endif
+
+} // namespace
+
+float accScaleToFloat(std::uint32_t scale, AccScaleFormat format) {
+  return format == AccScaleFormat::Fixed16
+             ? static_cast<float>(scaleToFixed(scale)) / static_cast<float>(1u << kAccScaleFixedBits)
+             : scaleToFloat(scale);
+}
+
+Elem requantize(Acc acc, std::uint32_t scale, AccScaleFormat format) {
+  return format == AccScaleFormat::Fixed16 ? requantizeFixed(acc, scaleToFixed(scale))
+                                           : requantizeFloat(acc, toExact(scaleToFloat(scale)));
+}
+
+MeshInputRow requantizeRow(const MeshAccumRow& row,
+                           std::uint32_t row_scale,
+                           const AccScaleRow& channel_scale,
+                           AccScaleFormat format) {
+  MeshInputRow out{};
+  if (format == AccScaleFormat::Fixed16) {
+    std::array<std::uint32_t, kDim> scale{};
+    for (std::size_t lane = 0; lane < kDim; ++lane) {
+      scale[lane] = scaleToFixed(channel_scale[lane] != 0 ? channel_scale[lane] : row_scale);
+    }
+    for (std::size_t lane = 0; lane < kDim; ++lane) {
+      out[lane] = requantizeFixed(row[lane], scale[lane]);
+    }
+    return out;
+  }
+  std::array<ExactScale, kDim> scale{};
+  for (std::size_t lane = 0; lane < kDim; ++lane) {
+    scale[lane] = toExact(scaleToFloat(channel_scale[lane] != 0 ? channel_scale[lane] : row_scale));
+  }
+  for (std::size_t lane = 0; lane < kDim; ++lane) {
+    out[lane] = requantizeFloat(row[lane], scale[lane]);
+  }
+  return out;
+}
+
+MeshInputRow scaleInputRow(const MeshInputRow& row, std::uint32_t scale) {
+  if (scale == kAccScaleIdentity) {
+    return row;
+  }
+  const auto factor = toExact(scaleToFloat(scale));
+  MeshInputRow out{};
+  std::size_t lane = 0;
+#if defined(__AVX2__)
+  if (fitsVectorMult(factor)) {
+    for (; lane + 4 <= kDim; lane += 4) {
+      std::int32_t in = 0;
+      std::memcpy(&in, row.data() + lane, sizeof(in));
+      const __m128i q   = scaleLanes(_mm256_cvtepi8_epi64(_mm_cvtsi32_si128(in)), factor, kElemMin, kElemMax);
+      const auto packed = _mm_cvtsi128_si32(_mm_packs_epi16(_mm_packs_epi32(q, q), q)); // already in Elem range
+      std::memcpy(out.data() + lane, &packed, sizeof(packed));
+    }
+  }
+#endif
+  for (; lane < kDim; ++lane) {
+    out[lane] = requantizeFloat(row[lane], factor);
+  }
+  return out;
+}
+
+MeshAccumRow scaleAccumRow(const MeshAccumRow& row, std::uint32_t scale) {
+  if (scale == kAccScaleIdentity) {
+    return row;
+  }
+  const auto factor = toExact(scaleToFloat(scale));
+  MeshAccumRow out{};
+  std::size_t lane = 0;
+#if defined(__AVX2__)
+  if (fitsVectorMult(factor)) {
+    for (; lane + 4 <= kDim; lane += 4) {
+      const __m256i v = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row.data() + lane)));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + lane), scaleLanes(v, factor, kAccMin, kAccMax));
+    }
+  }
+#endif
+  for (; lane < kDim; ++lane) {
+    out[lane] = scaleAccFloat(row[lane], factor);
+  }
+  return out;
+}
+
+} // namespace smesh
@@ -8,6 +8,8 @@ Command-path queue implementations.
 
 #include "SmeshCmdQueues.hpp"
 
+#include <algorithm>
+
 namespace smesh {
 
 SmeshCmdQueue::SmeshCmdQueue(std::string /*name*/, IMPL_CTOR) {
@@ -30,19 +32,458 @@ void SmeshCmdQueue::updateAccept() {
   trace("cmd_queue: accepted funct=%u", static_cast<unsigned>(cmd.funct));
 }
 
+namespace {
+
+constexpr std::uint32_t kSpHalfRows = static_cast<std::uint32_t>(kSpRows / 2);
+constexpr std::uint32_t kDimRows    = static_cast<std::uint32_t>(kDim);
+
+// config steps in emission order
+constexpr std::uint32_t kLoopConfigLdA = 0;
+constexpr std::uint32_t kLoopConfigLdB = 1;
+constexpr std::uint32_t kLoopConfigLdD = 2;
+constexpr std::uint32_t kLoopConfigEx  = 3;
+constexpr std::uint32_t kLoopConfigSt  = 4;
+constexpr std::uint32_t kLoopConfigSteps = 5;
+
+SmeshCmd makeCmd(SmeshFunct funct, std::uint64_t rs1, std::uint64_t rs2) {
+  return SmeshCmd{u32(static_cast<std::uint32_t>(funct)), u64(rs1), u64(rs2)};
+}
+
+// size of tile idx along a dim of count tiles; the last one loses pad rows/cols
+std::size_t tileExtent(std::uint64_t idx, std::uint32_t count, std::uint32_t pad) {
+  return idx + 1 == count ? kDim - pad : kDim;
+}
+
+std::uint64_t blocks(std::uint32_t extent) {
+  return (extent + kDim - 1) / kDim;
+}
+
+} // namespace
+
 SmeshUnrolledCmdQueue::SmeshUnrolledCmdQueue(std::string /*name*/, IMPL_CTOR) {
   UPDATE(update).reads(cmd_in).writes(cmd_out);
 }
 
+// emit one unrolled command, then absorb one command from cmd_in: loop configs
+// always, loop starts and host commands only once the previous loop is unrolled
 void SmeshUnrolledCmdQueue::update() {
-  if (cmd_in.empty() || cmd_out.full()) {
+  if (Sim::state == Sim::SimResetting) {
+    return;
+  }
+
+  bool pushed = false;
+  if (loopActive()) {
+    if (cmd_out.full()) {
+      ++out_stall_cycles_;
+    } else {
+      const auto cmd = loopCmd();
+      cmd_out.push(cmd);
+      pushed = true;
+      ++loop_cmds_out_;
+      trace("unrolled_cmd_queue: loop tile=%llu step=%llu funct=%u",
+            static_cast<unsigned long long>(tile_idx_),
+            static_cast<unsigned long long>(step_idx_),
+            static_cast<unsigned>(cmd.funct));
+      advanceLoop();
+    }
+  }
+
+  if (cmd_in.empty()) {
+    return;
+  }
+  const auto funct = static_cast<SmeshFunct>(static_cast<std::uint32_t>(cmd_in.peek().funct));
+  if ((isLoopWsFunct(funct) && funct != SmeshFunct::LoopWs) ||
+      (isLoopConvFunct(funct) && funct != SmeshFunct::LoopConvWs)) {
+    configureLoop(cmd_in.pop());
+    return;
+  }
+  if (loopActive()) {
+    return;
+  }
+  if (funct == SmeshFunct::LoopWs || funct == SmeshFunct::LoopConvWs) {
+    startLoop(funct == SmeshFunct::LoopWs ? LoopKind::Ws : LoopKind::Conv, cmd_in.pop());
+    return;
+  }
+  if (pushed || cmd_out.full()) {
     return;
   }
 
   const auto cmd = cmd_in.pop();
   cmd_out.push(cmd);
+  ++passed_through_;
 
   trace("unrolled_cmd_queue: accepted funct=%u", static_cast<unsigned>(cmd.funct));
 }
 
+void SmeshUnrolledCmdQueue::configureLoop(const SmeshCmd& cmd) {
+  const auto funct = static_cast<SmeshFunct>(static_cast<std::uint32_t>(cmd.funct));
+  const auto rs1   = static_cast<std::uint64_t>(cmd.rs1);
+  const auto rs2   = static_cast<std::uint64_t>(cmd.rs2);
+  switch (funct) {
+    case SmeshFunct::LoopWsConfigBounds:
+      next_ws_.pad   = unpackLoopWsBounds(rs1);
+      next_ws_.tiles = unpackLoopWsBounds(rs2);
+      break;
+    case SmeshFunct::LoopWsConfigAddrsAB:
+      next_ws_.a_addr = rs1;
+      next_ws_.b_addr = rs2;
+      break;
+    case SmeshFunct::LoopWsConfigAddrsDC:
+      next_ws_.d_addr = rs1;
+      next_ws_.c_addr = rs2;
+      break;
+    case SmeshFunct::LoopWsConfigStridesAB:
+      next_ws_.a_stride = rs1;
+      next_ws_.b_stride = rs2;
+      break;
+    case SmeshFunct::LoopWsConfigStridesDC:
+      next_ws_.d_stride = rs1;
+      next_ws_.c_stride = rs2;
+      break;
+    case SmeshFunct::LoopConvWsConfigDims:
+      next_conv_.dims    = unpackLoopConvDims(rs1);
+      next_conv_.out_dim = static_cast<std::uint32_t>(rs2 & 0xffffu);
+      break;
+    case SmeshFunct::LoopConvWsConfigKernel:
+      next_conv_.kernel = unpackLoopConvKernel(rs1);
+      break;
+    case SmeshFunct::LoopConvWsConfigAddrsWO:
+      next_conv_.weights = rs1;
+      next_conv_.output  = rs2;
+      break;
+    case SmeshFunct::LoopConvWsConfigAddrsBI:
+      next_conv_.bias  = rs1;
+      next_conv_.input = rs2;
+      break;
+    default:
+      assert_always(false, "SmeshUnrolledCmdQueue: not a loop config command");
+  }
+  ++loop_cmds_in_;
+  trace("unrolled_cmd_queue: loop config funct=%u", static_cast<unsigned>(cmd.funct));
+}
+
+void SmeshUnrolledCmdQueue::startLoop(LoopKind kind, const SmeshCmd& cmd) {
+  const auto rs1 = static_cast<std::uint64_t>(cmd.rs1);
+  kind_       = kind;
+  activation_ = unpackLoopWsActivation(rs1);
+  full_c_     = unpackLoopWsFullC(rs1);
+  low_d_      = unpackLoopWsLowD(rs1);
+
+  if (kind_ == LoopKind::Ws) {
+    ws_ = next_ws_;
+    assert_always(ws_.tiles.i > 0 && ws_.tiles.j > 0 && ws_.tiles.k > 0,
+                  "LOOP_WS needs at least one tile along I, J and K");
+    assert_always(ws_.pad.i < kDim && ws_.pad.j < kDim && ws_.pad.k < kDim,
+                  "LOOP_WS padding must leave part of the last tile");
+    num_tiles_ = static_cast<std::uint64_t>(ws_.tiles.i) * ws_.tiles.j;
+    num_steps_ = ws_.tiles.k;
+  } else {
+    conv_ = next_conv_;
+    const auto& dims   = conv_.dims;
+    const auto& kernel = conv_.kernel;
+    assert_always(dims.batch > 0 && dims.in_dim > 0 && dims.in_channels > 0 && dims.out_channels > 0 &&
+                      conv_.out_dim > 0 && kernel.kernel_dim > 0,
+                  "LOOP_CONV_WS needs non-empty images, channels and kernel");
+    assert_always(kernel.stride > 0 && kernel.dilation > 0, "LOOP_CONV_WS stride and dilation start at 1");
+    num_tiles_ = static_cast<std::uint64_t>(dims.batch) * conv_.out_dim * blocks(conv_.out_dim) * blocks(dims.out_channels);
+    num_steps_ = static_cast<std::uint64_t>(kernel.kernel_dim) * kernel.kernel_dim * blocks(dims.in_channels);
+    ++conv_loops_;
+  }
+  assert_always(2 * kDim <= kSpHalfRows && 2 * kDim <= kAccRows,
+                "loop double buffering needs A+B tiles per spad half and two accumulator tiles");
+
+  phase_       = LoopPhase::Config;
+  config_step_ = kLoopConfigLdA;
+  tile_idx_    = 0;
+  step_idx_    = 0;
+  ++loops_;
+  ++loop_cmds_in_;
+  trace("unrolled_cmd_queue: loop start %s tiles=%llu steps=%llu",
+        kind_ == LoopKind::Ws ? "ws" : "conv",
+        static_cast<unsigned long long>(num_tiles_),
+        static_cast<unsigned long long>(num_steps_));
+}
+
+bool SmeshUnrolledCmdQueue::hasBias() const {
+  return kind_ == LoopKind::Ws ? ws_.d_addr != 0 : conv_.bias != 0;
+}
+
+bool SmeshUnrolledCmdQueue::hasStore() const {
+  return kind_ == LoopKind::Ws ? ws_.c_addr != 0 : conv_.output != 0;
+}
+
+bool SmeshUnrolledCmdQueue::configStepUsed(std::uint32_t step) const {
+  if (step == kLoopConfigLdD) {
+    return hasBias();
+  }
+  if (step == kLoopConfigSt) {
+    return hasStore();
+  }
+  return true;
+}
+
+// channels fastest, then output column blocks, output rows, images
+SmeshUnrolledCmdQueue::LoopConvPos SmeshUnrolledCmdQueue::convPos() const {
+  const std::uint64_t och_blocks  = blocks(conv_.dims.out_channels);
+  const std::uint64_t ocol_blocks = blocks(conv_.out_dim);
+  std::uint64_t rest = tile_idx_;
+  LoopConvPos pos{};
+  pos.och0  = static_cast<std::uint32_t>((rest % och_blocks) * kDim);
+  rest /= och_blocks;
+  pos.ocol0 = static_cast<std::uint32_t>((rest % ocol_blocks) * kDim);
+  rest /= ocol_blocks;
+  pos.orow  = static_cast<std::uint32_t>(rest % conv_.out_dim);
+  pos.batch = static_cast<std::uint32_t>(rest / conv_.out_dim);
+  return pos;
+}
+
+SmeshUnrolledCmdQueue::LoopTile SmeshUnrolledCmdQueue::tileGeom() const {
+  const std::uint64_t d_bytes = low_d_ ? sizeof(Elem) : sizeof(Acc);
+  const std::uint64_t c_bytes = full_c_ ? sizeof(Acc) : sizeof(Elem);
+  LoopTile tile{};
+  if (kind_ == LoopKind::Ws) {
+    const std::uint64_t i = tile_idx_ / ws_.tiles.j;
+    const std::uint64_t j = tile_idx_ % ws_.tiles.j;
+    tile.rows   = tileExtent(i, ws_.tiles.i, ws_.pad.i);
+    tile.cols   = tileExtent(j, ws_.tiles.j, ws_.pad.j);
+    tile.d_addr = ws_.d_addr + i * kDim * ws_.d_stride + j * kDim * d_bytes;
+    tile.c_addr = ws_.c_addr + i * kDim * ws_.c_stride + j * kDim * c_bytes;
+    return tile;
+  }
+  const auto pos = convPos();
+  const std::uint64_t och = conv_.dims.out_channels;
+  tile.rows   = std::min<std::size_t>(kDim, conv_.out_dim - pos.ocol0);
+  tile.cols   = std::min<std::size_t>(kDim, och - pos.och0);
+  tile.d_addr = conv_.bias + pos.och0 * d_bytes; // same bias row for every pixel (DRAM stride 0)
+  tile.c_addr = conv_.output +
+                ((static_cast<std::uint64_t>(pos.batch) * conv_.out_dim + pos.orow) * conv_.out_dim + pos.ocol0) * och * c_bytes +
+                pos.och0 * c_bytes;
+  return tile;
+}
+
+bool SmeshUnrolledCmdQueue::stepGeom(LoopStep& step) const {
+  if (kind_ == LoopKind::Ws) {
+    const std::uint64_t i = tile_idx_ / ws_.tiles.j;
+    const std::uint64_t j = tile_idx_ % ws_.tiles.j;
+    step.row_off = 0;
+    step.rows    = tileExtent(i, ws_.tiles.i, ws_.pad.i);
+    step.k       = tileExtent(step_idx_, ws_.tiles.k, ws_.pad.k);
+    step.a_addr  = ws_.a_addr + i * kDim * ws_.a_stride + step_idx_ * kDim * sizeof(Elem);
+    step.b_addr  = ws_.b_addr + step_idx_ * kDim * ws_.b_stride + j * kDim * sizeof(Elem);
+    return true;
+  }
+
+  const auto& dims   = conv_.dims;
+  const auto& kernel = conv_.kernel;
+  const auto  pos    = convPos();
+  const std::uint64_t ich_blocks = blocks(dims.in_channels);
+  const std::uint64_t ich0 = (step_idx_ % ich_blocks) * kDim;
+  const std::uint64_t tap  = step_idx_ / ich_blocks;
+  const std::int64_t krow  = static_cast<std::int64_t>(tap / kernel.kernel_dim);
+  const std::int64_t kcol  = static_cast<std::int64_t>(tap % kernel.kernel_dim);
+  const std::int64_t in_dim = dims.in_dim;
+
+  // input pixel under this tap for output pixel (orow, ocol); outside the image is zero padding
+  const std::int64_t irow = static_cast<std::int64_t>(pos.orow) * kernel.stride + krow * kernel.dilation - kernel.padding;
+  auto icolOf = [&](std::int64_t ocol) {
+    return ocol * kernel.stride + kcol * kernel.dilation - kernel.padding;
+  };
+  if (irow < 0 || irow >= in_dim) {
+    return false;
+  }
+  const std::int64_t tile_rows = std::min<std::int64_t>(kDim, conv_.out_dim - pos.ocol0);
+  std::int64_t lo = 0;
+  while (lo < tile_rows && icolOf(pos.ocol0 + lo) < 0) {
+    ++lo;
+  }
+  std::int64_t hi = tile_rows;
+  while (hi > lo && icolOf(pos.ocol0 + hi - 1) >= in_dim) {
+    --hi;
+  }
+  if (lo == hi) {
+    return false;
+  }
+
+  const std::uint64_t ich  = dims.in_channels;
+  const std::uint64_t och  = dims.out_channels;
+  const std::uint64_t icol = static_cast<std::uint64_t>(icolOf(pos.ocol0 + lo));
+  step.row_off = static_cast<std::uint32_t>(lo);
+  step.rows    = static_cast<std::size_t>(hi - lo);
+  step.k       = std::min<std::size_t>(kDim, ich - ich0);
+  step.a_addr  = conv_.input +
+                 ((static_cast<std::uint64_t>(pos.batch) * dims.in_dim + static_cast<std::uint64_t>(irow)) * dims.in_dim + icol) * ich * sizeof(Elem) +
+                 ich0 * sizeof(Elem);
+  step.b_addr  = conv_.weights + (tap * ich + ich0) * och * sizeof(Elem) + pos.och0 * sizeof(Elem);
+  return true;
+}
+
+SmeshCmd SmeshUnrolledCmdQueue::loopCmd() const {
+  const LoopTile tile = tileGeom();
+  const std::uint32_t a_base = static_cast<std::uint32_t>(steps_done_ % 2) * kSpHalfRows; // A then B in the half
+  const std::uint32_t a_row  = a_base + step_.row_off;
+  const std::uint32_t b_row  = a_base + kDimRows;
+  const std::uint32_t c_row  = static_cast<std::uint32_t>(tiles_done_ % 2) * kDimRows;
+
+  switch (phase_) {
+    case LoopPhase::Config: {
+      const bool conv = kind_ == LoopKind::Conv;
+      const std::uint64_t c_bytes = full_c_ ? sizeof(Acc) : sizeof(Elem);
+      switch (config_step_) {
+        case kLoopConfigLdA: // conv: next patch row is conv-stride input pixels on
+          return makeCmd(SmeshFunct::Config, packConfig(ConfigKind::Load, 0, kDimRows),
+                         conv ? conv_.kernel.stride * conv_.dims.in_channels * sizeof(Elem) : ws_.a_stride);
+        case kLoopConfigLdB:
+          return makeCmd(SmeshFunct::Config, packConfig(ConfigKind::Load, 1, kDimRows),
+                         conv ? conv_.dims.out_channels * sizeof(Elem) : ws_.b_stride);
+        case kLoopConfigLdD: // conv: one bias row broadcast to every pixel
+          return makeCmd(SmeshFunct::Config, packConfig(ConfigKind::Load, 2, kDimRows), conv ? 0 : ws_.d_stride);
+        case kLoopConfigEx:
+          return makeCmd(SmeshFunct::Config,
+                         packConfigExecuteRs1(1, false, false, kExDataflowWS, false, activation_),
+                         packConfigExecuteRs2(1));
+        default:
+          return makeCmd(SmeshFunct::Config, packConfigStoreRs1(activation_),
+                         conv ? conv_.dims.out_channels * c_bytes : ws_.c_stride);
+      }
+    }
+    case LoopPhase::ClearPreload: // zero weights into a non-accumulating C ...
+      return makeCmd(SmeshFunct::Preload,
+                     packLocal(makeGarbageAddr(), MatrixShape{kDim, tile.cols}),
+                     packLocal(makeAccAddr(c_row), MatrixShape{tile.rows, tile.cols}));
+    case LoopPhase::ClearCompute: // ... times zero activations clears the slot
+      return makeCmd(SmeshFunct::ComputeFlip,
+                     packLocal(makeGarbageAddr(), MatrixShape{tile.rows, kDim}),
+                     packLocal(makeGarbageAddr(), MatrixShape{tile.rows, tile.cols}));
+    case LoopPhase::Bias: // an Acc-wide D needs read_full_acc_row so LdCtrl moves 32-bit rows
+      return makeCmd(SmeshFunct::Mvin3, tile.d_addr,
+                     packLocal(makeAccAddr(c_row, false, !low_d_), MatrixShape{tile.rows, tile.cols}));
+    case LoopPhase::LoadA:
+      return makeCmd(SmeshFunct::Mvin, step_.a_addr,
+                     packLocal(makeSpAddr(a_row), MatrixShape{step_.rows, step_.k}));
+    case LoopPhase::LoadB:
+      return makeCmd(SmeshFunct::Mvin2, step_.b_addr,
+                     packLocal(makeSpAddr(b_row), MatrixShape{step_.k, tile.cols}));
+    case LoopPhase::Preload:
+      return makeCmd(SmeshFunct::Preload,
+                     packLocal(makeSpAddr(b_row), MatrixShape{step_.k, tile.cols}),
+                     packLocal(makeAccAddr(c_row + step_.row_off, tile_init_), MatrixShape{step_.rows, tile.cols}));
+    case LoopPhase::Compute:
+      return makeCmd(SmeshFunct::ComputeFlip,
+                     packLocal(makeSpAddr(a_row), MatrixShape{step_.rows, step_.k}),
+                     packLocal(makeGarbageAddr(), MatrixShape{step_.rows, tile.cols}));
+    case LoopPhase::Store:
+      return makeCmd(SmeshFunct::Mvout, tile.c_addr,
+                     packLocal(makeAccAddr(c_row, false, full_c_), MatrixShape{tile.rows, tile.cols}));
+    case LoopPhase::Idle:
+      break;
+  }
+  return SmeshCmd{};
+}
+
+void SmeshUnrolledCmdQueue::beginTile() {
+  tile_init_ = false;
+  step_idx_  = 0;
+  if (hasBias()) {
+    phase_ = LoopPhase::Bias;
+  } else if (kind_ == LoopKind::Conv) {
+    phase_ = LoopPhase::ClearPreload; // padding may keep some rows out of the first k-step
+  } else {
+    nextStep();
+  }
+}
+
+void SmeshUnrolledCmdQueue::nextStep() {
+  for (; step_idx_ < num_steps_; ++step_idx_) {
+    if (stepGeom(step_)) {
+      phase_ = LoopPhase::LoadA;
+      return;
+    }
+    ++skipped_steps_;
+  }
+  if (hasStore()) {
+    phase_ = LoopPhase::Store;
+    return;
+  }
+  endTile();
+}
+
+void SmeshUnrolledCmdQueue::endTile() {
+  ++tiles_done_;
+  if (++tile_idx_ < num_tiles_) {
+    beginTile();
+    return;
+  }
+  phase_ = LoopPhase::Idle;
+  trace("unrolled_cmd_queue: loop done");
+}
+
+void SmeshUnrolledCmdQueue::advanceLoop() {
+  switch (phase_) {
+    case LoopPhase::Config:
+      do {
+        ++config_step_;
+      } while (config_step_ < kLoopConfigSteps && !configStepUsed(config_step_));
+      if (config_step_ == kLoopConfigSteps) {
+        beginTile();
+      }
+      return;
+    case LoopPhase::ClearPreload:
+      phase_ = LoopPhase::ClearCompute;
+      return;
+    case LoopPhase::ClearCompute:
+    case LoopPhase::Bias:
+      tile_init_ = true;
+      nextStep();
+      return;
+    case LoopPhase::LoadA:
+      phase_ = LoopPhase::LoadB;
+      return;
+    case LoopPhase::LoadB:
+      phase_ = LoopPhase::Preload;
+      return;
+    case LoopPhase::Preload:
+      phase_ = LoopPhase::Compute;
+      return;
+    case LoopPhase::Compute:
+      ++steps_done_;
+      tile_init_ = true;
+      ++step_idx_;
+      nextStep();
+      return;
+    case LoopPhase::Store:
+      endTile();
+      return;
+    case LoopPhase::Idle:
+      return;
+  }
+}
+
+void SmeshUnrolledCmdQueue::reset() {
+  next_ws_     = LoopWsRegs{};
+  next_conv_   = LoopConvRegs{};
+  ws_          = LoopWsRegs{};
+  conv_        = LoopConvRegs{};
+  kind_        = LoopKind::Ws;
+  phase_       = LoopPhase::Idle;
+  activation_  = 0;
+  full_c_      = true;
+  low_d_       = false;
+  config_step_ = 0;
+  num_tiles_   = 0;
+  num_steps_   = 0;
+  tile_idx_    = 0;
+  step_idx_    = 0;
+  tile_init_   = false;
+  step_        = LoopStep{};
+  steps_done_  = 0;
+  tiles_done_  = 0;
+  loops_            = 0;
+  conv_loops_       = 0;
+  loop_cmds_in_     = 0;
+  loop_cmds_out_    = 0;
+  skipped_steps_    = 0;
+  passed_through_   = 0;
+  out_stall_cycles_ = 0;
+}
+
 } // namespace smesh
@@ -56,8 +56,10 @@ std::uint64_t SmeshDevice::executeCustom(SmeshMemory& mem, SmeshFunct funct, std
         require(state_id < state_.load_stride_bytes.size(), "invalid mvin state id");
         state_.load_stride_bytes.at(state_id) = static_cast<std::uint32_t>(rs2);
       } else if (kind == ConfigKind::Store) {
-        state_.store_stride_bytes = static_cast<std::uint32_t>(rs2);
-      } else if (kind != ConfigKind::Execute) {
+        if (!unpackConfigStoreChannelScale(rs1)) { // a channel-scale CONFIG_ST leaves the stride alone
+          state_.store_stride_bytes = static_cast<std::uint32_t>(rs2);
+        }
+      } else if (kind != ConfigKind::Execute && kind != ConfigKind::Norm) {
         throw std::runtime_error("unsupported config kind");
       }
       return 0;
@@ -99,6 +101,18 @@ std::uint64_t SmeshDevice::executeCustom(SmeshMemory& mem, SmeshFunct funct, std
       throw std::runtime_error("compute_stay is not implemented yet");
     case SmeshFunct::StoreSpad:
       throw std::runtime_error("store_spad is not implemented yet");
+    case SmeshFunct::LoopWs:
+    case SmeshFunct::LoopWsConfigBounds:
+    case SmeshFunct::LoopWsConfigAddrsAB:
+    case SmeshFunct::LoopWsConfigAddrsDC:
+    case SmeshFunct::LoopWsConfigStridesAB:
+    case SmeshFunct::LoopWsConfigStridesDC:
+    case SmeshFunct::LoopConvWs:
+    case SmeshFunct::LoopConvWsConfigDims:
+    case SmeshFunct::LoopConvWsConfigKernel:
+    case SmeshFunct::LoopConvWsConfigAddrsWO:
+    case SmeshFunct::LoopConvWsConfigAddrsBI:
+      throw std::runtime_error("loop commands are unrolled by SmeshUnrolledCmdQueue, not the functional device");
   }
 
   throw std::runtime_error("unsupported smesh funct");
@@ -110,10 +124,7 @@ void SmeshDevice::mvin(SmeshMemory& mem, std::uint64_t dram_addr, std::uint32_t
   require(stride_bytes >= shape.cols * sizeof(Elem), "mvin stride is too small");
 
   for (std::size_t r = 0; r < shape.rows; ++r) {
-    for (std::size_t c = 0; c < shape.cols; ++c) {
-      state_.spad.at(spad_row + r).at(c) =
-          mem.readElem(dram_addr + r * stride_bytes + c * sizeof(Elem));
-    }
+    mem.readRow(dram_addr + r * stride_bytes, state_.spad.at(spad_row + r).data(), shape.cols);
   }
 }
 
@@ -172,10 +183,7 @@ void SmeshDevice::mvout(SmeshMemory& mem, std::uint64_t dram_addr, std::uint32_t
   require(stride_bytes >= shape.cols * sizeof(Acc), "mvout stride is too small");
 
   for (std::size_t r = 0; r < shape.rows; ++r) {
-    for (std::size_t c = 0; c < shape.cols; ++c) {
-      mem.writeAcc(dram_addr + r * stride_bytes + c * sizeof(Acc),
-                   state_.accumulator.at(acc_row + r).at(c));
-    }
+    mem.writeRow(dram_addr + r * stride_bytes, state_.accumulator.at(acc_row + r).data(), shape.cols);
   }
 }
 
@@ -0,0 +1,113 @@
+// **********************************************************************
+// smesh/src/SmeshMemory.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Jul 19 2026
+/*
+Paged fake host memory implementation.
+*/
+
+#include "SmeshMemory.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace smesh {
+
+void SmeshMemory::reset() {
+  pages_.clear();
+  last_num_ = 0;
+  last_page_ = nullptr;
+}
+
+const SmeshMemory::Page* SmeshMemory::findPage(std::uint64_t page_num) const {
+  if (last_page_ != nullptr && last_num_ == page_num) {
+    return last_page_;
+  }
+  const auto it = pages_.find(page_num);
+  if (it == pages_.end()) {
+    return nullptr;
+  }
+  last_num_ = page_num;
+  last_page_ = it->second.get();
+  return last_page_;
+}
+
+SmeshMemory::Page& SmeshMemory::touchPage(std::uint64_t page_num) {
+  if (last_page_ != nullptr && last_num_ == page_num) {
+    return *last_page_;
+  }
+  auto& page = pages_[page_num];
+  if (!page) {
+    page = std::make_unique<Page>();
+    page->fill(0);
+  }
+  last_num_ = page_num;
+  last_page_ = page.get();
+  return *page;
+}
+
+void SmeshMemory::write(std::uint64_t addr, const void* src, std::size_t bytes) {
+  const auto* in = static_cast<const std::uint8_t*>(src);
+  while (bytes != 0) {
+    const auto off = static_cast<std::size_t>(addr % kPageBytes);
+    const auto chunk = std::min<std::size_t>(bytes, kPageBytes - off);
+    std::memcpy(touchPage(addr / kPageBytes).data() + off, in, chunk);
+    addr += chunk;
+    in += chunk;
+    bytes -= chunk;
+  }
+}
+
+void SmeshMemory::read(std::uint64_t addr, void* dst, std::size_t bytes) const {
+  auto* out = static_cast<std::uint8_t*>(dst);
+  while (bytes != 0) {
+    const auto off = static_cast<std::size_t>(addr % kPageBytes);
+    const auto chunk = std::min<std::size_t>(bytes, kPageBytes - off);
+    const Page* page = findPage(addr / kPageBytes);
+    if (page == nullptr) {
+      std::memset(out, 0, chunk); // unwritten memory reads as zero
+    } else {
+      std::memcpy(out, page->data() + off, chunk);
+    }
+    addr += chunk;
+    out += chunk;
+    bytes -= chunk;
+  }
+}
+// Acc rows are serialized little-endian through a stack buffer, one bulk copy per call
+void SmeshMemory::writeRow(std::uint64_t addr, const Acc* src, std::size_t n) {
+  std::array<std::uint8_t, kDim * sizeof(Acc)> buf{};
+  while (n != 0) {
+    const auto count = std::min<std::size_t>(n, kDim);
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto uvalue = static_cast<std::uint32_t>(src[i]);
+      for (std::size_t b = 0; b < sizeof(Acc); ++b) {
+        buf[i * sizeof(Acc) + b] = static_cast<std::uint8_t>((uvalue >> (8 * b)) & 0xffu);
+      }
+    }
+    write(addr, buf.data(), count * sizeof(Acc));
+    addr += count * sizeof(Acc);
+    src += count;
+    n -= count;
+  }
+}
+
+void SmeshMemory::readRow(std::uint64_t addr, Acc* dst, std::size_t n) const {
+  std::array<std::uint8_t, kDim * sizeof(Acc)> buf{};
+  while (n != 0) {
+    const auto count = std::min<std::size_t>(n, kDim);
+    read(addr, buf.data(), count * sizeof(Acc));
+    for (std::size_t i = 0; i < count; ++i) {
+      std::uint32_t value = 0;
+      for (std::size_t b = 0; b < sizeof(Acc); ++b) {
+        value |= static_cast<std::uint32_t>(buf[i * sizeof(Acc) + b]) << (8 * b);
+      }
+      dst[i] = static_cast<Acc>(value);
+    }
+    addr += count * sizeof(Acc);
+    dst += count;
+    n -= count;
+  }
+}
+
+} // namespace smesh
@@ -7,6 +7,8 @@ Reservation station for smesh.
 input port: alloc_in: SmeshCmd, RS allocation input
 
 updateAlloc() receives input and (with help) allocates it into RS.
+Free-row selection, issue candidates and dependency wakeup all work on per-queue
+row masks, so allocate(), markIssued() and complete() never scan empty rows.
 */
 
 #include "SmeshRS.hpp"
@@ -198,6 +200,17 @@ void fillOperands(SmeshRsEntry& entry, const SmeshRSConfigState& config_state) {
 
     case SmeshFunct::Config:
     case SmeshFunct::Flush:
+    case SmeshFunct::LoopWs:
+    case SmeshFunct::LoopWsConfigBounds:
+    case SmeshFunct::LoopWsConfigAddrsAB:
+    case SmeshFunct::LoopWsConfigAddrsDC:
+    case SmeshFunct::LoopWsConfigStridesAB:
+    case SmeshFunct::LoopWsConfigStridesDC:
+    case SmeshFunct::LoopConvWs:
+    case SmeshFunct::LoopConvWsConfigDims:
+    case SmeshFunct::LoopConvWsConfigKernel:
+    case SmeshFunct::LoopConvWsConfigAddrsWO:
+    case SmeshFunct::LoopConvWsConfigAddrsBI:
       break;
   }
 }
@@ -236,23 +249,45 @@ bool dependsOn(const SmeshRsEntry& new_entry, const SmeshRsEntry& older_entry) {
   // New opb read after an older write: RAW.
   return older_entry.opa_is_dst && opOverlaps(new_entry.opb, older_entry.opa);
 }
-// Compute the dependency masks for a new entry based on all older entries in the RS
-void fillDependencies(SmeshRsEntry& entry, const std::array<SmeshRsEntry, kDefaultConfig.rs_load_entries>& older_ld, const std::array<SmeshRsEntry, kDefaultConfig.rs_execute_entries>& older_ex, const std::array<SmeshRsEntry, kDefaultConfig.rs_store_entries>& older_st) {
-  // clear all dependency masks
-  entry.deps_ld = 0;
-  entry.deps_ex = 0;
-  entry.deps_st = 0;
-  // check each older entry for a dependency and set the appropriate bit in the mask
-  // dependency bit i corresponds to RS rows i
-  for (std::size_t i = 0; i < older_ld.size(); ++i) {
-    if (dependsOn(entry, older_ld[i])) { entry.deps_ld |= std::uint32_t{1} << i; }
-  }
-  for (std::size_t i = 0; i < older_ex.size(); ++i) {
-    if (dependsOn(entry, older_ex[i])) { entry.deps_ex |= std::uint32_t{1} << i; }
-  }
-  for (std::size_t i = 0; i < older_st.size(); ++i) {
-    if (dependsOn(entry, older_st[i])) { entry.deps_st |= std::uint32_t{1} << i; }
+// ********** ROW MASK HELPERS **********
+
+constexpr SmeshRsMask rowBit(std::size_t row) {
+  return SmeshRsMask{1} << row;
+}
+// mask with the low n bits set (n <= 64)
+constexpr SmeshRsMask lowMask(std::size_t n) {
+  return n >= 64 ? ~SmeshRsMask{0} : rowBit(n) - 1;
+}
+// index of the lowest set bit (mask must be non-zero): the priority encoder on a free/ready mask
+std::size_t lowestRow(SmeshRsMask mask) {
+  return static_cast<std::size_t>(__builtin_ctzll(mask));
+}
+std::size_t rowCount(SmeshRsMask mask) {
+  return static_cast<std::size_t>(__builtin_popcountll(mask));
+}
+
+// queues_ index for a queue class; System/Invalid have no rows
+std::size_t queueIndex(SmeshQueueClass q) {
+  switch (q) {
+    case SmeshQueueClass::Load:
+      return 0;
+    case SmeshQueueClass::Execute:
+      return 1;
+    case SmeshQueueClass::Store:
+      return 2;
+    case SmeshQueueClass::System:
+    case SmeshQueueClass::Invalid:
+      break;
   }
+  throw std::logic_error("SmeshRS queue class has no RS rows");
+}
+// deps_* field of entry that tracks rows of queue index q
+SmeshRsMask& depsFor(SmeshRsEntry& entry, std::size_t q) {
+  return q == 0 ? entry.deps_ld : q == 1 ? entry.deps_ex : entry.deps_st;
+}
+// waiters_* field of entry that tracks rows of queue index q
+SmeshRsMask& waitersFor(SmeshRsEntry& entry, std::size_t q) {
+  return q == 0 ? entry.waiters_ld : q == 1 ? entry.waiters_ex : entry.waiters_st;
 }
 
 } // namespace
@@ -263,6 +298,7 @@ SmeshRS::SmeshRS(std::string /*name*/, IMPL_CTOR) {
   UPDATE(updateIssueExecute).writes(issue_ex);
   UPDATE(updateIssueStore).writes(issue_st);
   UPDATE(updateComplete).reads(completed);
+  setEntries(kRsLoadEntries, kRsExecuteEntries, kRsStoreEntries);
 }
 
 // ********** RS STATUS **********
@@ -270,20 +306,10 @@ SmeshRS::SmeshRS(std::string /*name*/, IMPL_CTOR) {
 const SmeshRSConfigState& SmeshRS::configState() const {
   return config_state_;
 }
-// check if every row in all RS entries is empty (invalid)
+// every row in all RS queues is free
 bool SmeshRS::empty() const {
-  for (const auto& entry : entries_ld_) {
-    if (entry.valid) {
-      return false;
-    }
-  }
-  for (const auto& entry : entries_ex_) {
-    if (entry.valid) {
-      return false;
-    }
-  }
-  for (const auto& entry : entries_st_) {
-    if (entry.valid) {
+  for (const auto& q : queues_) {
+    if (q.free != q.all) {
       return false;
     }
   }
@@ -294,98 +320,106 @@ bool SmeshRS::busy() const {
   return !empty();
 }
 
+// ********** DEPTH **********
+
+void SmeshRS::setEntries(std::size_t ld, std::size_t ex, std::size_t st) {
+  const std::array<std::size_t, 3> depth{ld, ex, st};
+  for (const auto n : depth) {
+    assert_always(n >= 1 && n <= kRsMaxEntries, "SmeshRS entries per queue must be 1..kRsMaxEntries");
+  }
+  assert_always(empty(), "SmeshRS: change entries only while empty");
+  for (std::size_t i = 0; i < queues_.size(); ++i) {
+    auto& q = queues_[i];
+    q.rows.assign(depth[i], SmeshRsEntry{});
+    q.all = lowMask(depth[i]);
+    q.free = q.all;
+    q.ready = 0;
+  }
+}
+
+SmeshRS::Queue& SmeshRS::queue(SmeshQueueClass q) {
+  return queues_[queueIndex(q)];
+}
+
+const SmeshRS::Queue& SmeshRS::queue(SmeshQueueClass q) const {
+  return queues_[queueIndex(q)];
+}
+
+std::size_t SmeshRS::entries(SmeshQueueClass q) const {
+  return queue(q).rows.size();
+}
+
+std::size_t SmeshRS::occupancy(SmeshQueueClass q) const {
+  const auto& rs_q = queue(q);
+  return rowCount(rs_q.all & ~rs_q.free);
+}
+
+std::uint64_t SmeshRS::fullStallCycles(SmeshQueueClass q) const {
+  return queue(q).full_stall_cycles;
+}
+
+std::uint64_t SmeshRS::allocations(SmeshQueueClass q) const {
+  return queue(q).allocations;
+}
+
+std::size_t SmeshRS::peakOccupancy(SmeshQueueClass q) const {
+  return queue(q).peak_occupancy;
+}
+
+double SmeshRS::averageOccupancy(SmeshQueueClass q) const {
+  return cycles_ ? double(queue(q).occupancy_sum) / double(cycles_) : 0.0;
+}
+
 // ********** ALLOCATION **********
 
-// TODO: Share free-row selection with allocate() instead of searching twice.
-// How does HW do it?
-bool SmeshRS::canAccept(const SmeshCmd& cmd) const { // does a free row exist?
-  switch (classifyCommand(cmd)) {
-    case SmeshQueueClass::Load:
-      for (const auto& entry : entries_ld_) {
-        if (!entry.valid) {
-          return true;
-        }
-      }
-      return false;
-    case SmeshQueueClass::Execute:
-      for (const auto& entry : entries_ex_) {
-        if (!entry.valid) {
-          return true;
-        }
-      }
-      return false;
-    case SmeshQueueClass::Store:
-      for (const auto& entry : entries_st_) {
-        if (!entry.valid) {
-          return true;
-        }
-      }
-      return false;
-    case SmeshQueueClass::System:
-    case SmeshQueueClass::Invalid:
-      return false;
+// does a free row exist? (same free mask allocate() takes its row from)
+bool SmeshRS::canAccept(const SmeshCmd& cmd) const {
+  const auto q = classifyCommand(cmd);
+  if (q == SmeshQueueClass::System || q == SmeshQueueClass::Invalid) {
+    return false;
   }
-  return false;
+  return queue(q).free != 0;
 }
 
 bool SmeshRS::allocate(const SmeshCmd& cmd) { // convenience wrapper for allocate() that ignores rs_tag_out
   return allocate(cmd, nullptr);
 }
-// places new command into appropriate RS entry and fills its operands and dependencies
+// places new command into lowest free row of its queue and fills its operands and dependencies
 bool SmeshRS::allocate(const SmeshCmd& cmd, SmeshRsTag* rs_tag_out) {
   if (!canAccept(cmd)) {
     return false;
   }
 
-  SmeshRsEntry* slot = nullptr; // pointer to RS entry where new command will be placed
-  const auto queue = classifyCommand(cmd);
-  switch (queue) {
-    case SmeshQueueClass::Load:
-      for (auto& entry : entries_ld_) {
-        if (!entry.valid) {
-          slot = &entry;
-          break;
-        }
-      }
-      break;
-    case SmeshQueueClass::Execute:
-      for (auto& entry : entries_ex_) {
-        if (!entry.valid) {
-          slot = &entry;
-          break;
-        }
-      }
-      break;
-    case SmeshQueueClass::Store:
-      for (auto& entry : entries_st_) {
-        if (!entry.valid) {
-          slot = &entry;
-          break;
-        }
-      }
-      break;
-    case SmeshQueueClass::System:
-    case SmeshQueueClass::Invalid:
-      return false;
-  }
-  if (slot == nullptr) {
-    return false;
-  }
+  const auto queue_class = classifyCommand(cmd);
+  const auto qi = queueIndex(queue_class);
+  auto& q = queues_[qi];
+  const auto row = lowestRow(q.free);
 
   SmeshRsEntry new_entry{};
   new_entry.valid             = true;
-  new_entry.q                 = queue;
+  new_entry.q                 = queue_class;
   new_entry.is_config         = static_cast<SmeshFunct>(static_cast<std::uint32_t>(cmd.funct)) == SmeshFunct::Config;
   new_entry.issued            = false;
-  new_entry.complete_on_issue = new_entry.is_config && queue != SmeshQueueClass::Execute; // true if config ld or st
+  new_entry.complete_on_issue = new_entry.is_config && queue_class != SmeshQueueClass::Execute; // true if config ld or st
   new_entry.cmd               = cmd;
   new_entry.rs_tag            = next_rs_tag_++;
   new_entry.allocated_at      = instructions_allocated_++;
+  assert_always(rows_by_tag_.find(new_entry.rs_tag) == rows_by_tag_.end(), "SmeshRS rs_tag wrapped onto a live entry");
 
   fillOperands(new_entry, config_state_);
-  fillDependencies(new_entry, entries_ld_, entries_ex_, entries_st_);
+  fillDependencies(new_entry, qi, row);
 
-  *slot = new_entry;
+  q.rows[row] = new_entry;
+  q.free &= ~rowBit(row);
+  if (new_entry.ready()) {
+    q.ready |= rowBit(row);
+  }
+  rows_by_tag_[new_entry.rs_tag] = RowRef{static_cast<std::uint8_t>(qi), static_cast<std::uint8_t>(row)};
+  ++q.allocations;
+  const auto occupied = rowCount(q.all & ~q.free);
+  if (occupied > q.peak_occupancy) {
+    q.peak_occupancy = occupied;
+  }
   updateConfigState(cmd, config_state_);
 
   if (rs_tag_out != nullptr) {
@@ -393,14 +427,42 @@ bool SmeshRS::allocate(const SmeshCmd& cmd, SmeshRsTag* rs_tag_out) {
   }
   return true;
 }
+// Compute the dependency masks for a new entry (going into row `row` of queue
+// index `qi`) against every occupied row, and register it as a waiter on each
+// row it depends on. Dependency bit i corresponds to RS row i.
+void SmeshRS::fillDependencies(SmeshRsEntry& entry, std::size_t qi, std::size_t row) {
+  entry.deps_ld = 0;
+  entry.deps_ex = 0;
+  entry.deps_st = 0;
+  for (std::size_t k = 0; k < queues_.size(); ++k) {
+    auto& older_q = queues_[k];
+    auto& deps = depsFor(entry, k);
+    for (auto occupied = older_q.all & ~older_q.free; occupied != 0; occupied &= occupied - 1) {
+      const auto i = lowestRow(occupied);
+      auto& older = older_q.rows[i];
+      if (dependsOn(entry, older)) {
+        deps |= rowBit(i);
+        waitersFor(older, qi) |= rowBit(row);
+      }
+    }
+  }
+}
 // consumes commands and allocates rows when capacity permits
 void SmeshRS::updateAlloc() {
+  ++cycles_;
+  for (auto& q : queues_) {
+    q.occupancy_sum += rowCount(q.all & ~q.free);
+  }
   if (alloc_in.empty()) {
     return;
   }
 
   const auto cmd = alloc_in.peek();
   if (!canAccept(cmd)) {
+    const auto q = classifyCommand(cmd);
+    if (q != SmeshQueueClass::System && q != SmeshQueueClass::Invalid) {
+      ++queue(q).full_stall_cycles; // queue full: front end stalls behind this command
+    }
     return;
   }
 
@@ -414,19 +476,12 @@ void SmeshRS::updateAlloc() {
 // which entry is currently occupied
 const SmeshRsEntry& SmeshRS::entry() const {
   const SmeshRsEntry* oldest = nullptr;
-  for (const auto& entry : entries_ld_) {
-    if (entry.valid && (oldest == nullptr || entry.allocated_at < oldest->allocated_at)) {
-      oldest = &entry;
-    }
-  }
-  for (const auto& entry : entries_ex_) {
-    if (entry.valid && (oldest == nullptr || entry.allocated_at < oldest->allocated_at)) {
-      oldest = &entry;
-    }
-  }
-  for (const auto& entry : entries_st_) {
-    if (entry.valid && (oldest == nullptr || entry.allocated_at < oldest->allocated_at)) {
-      oldest = &entry;
+  for (const auto& q : queues_) {
+    for (auto occupied = q.all & ~q.free; occupied != 0; occupied &= occupied - 1) {
+      const auto& entry = q.rows[lowestRow(occupied)];
+      if (oldest == nullptr || entry.allocated_at < oldest->allocated_at) {
+        oldest = &entry;
+      }
     }
   }
   if (oldest == nullptr) {
@@ -437,52 +492,42 @@ const SmeshRsEntry& SmeshRS::entry() const {
 
 // read LOAD RS row
 const SmeshRsEntry& SmeshRS::loadEntry(std::size_t row) const {
-  return entries_ld_.at(row);
+  return queues_[0].rows.at(row);
 }
 // read EXECUTE RS row
 const SmeshRsEntry& SmeshRS::executeEntry(std::size_t row) const {
-  return entries_ex_.at(row);
+  return queues_[1].rows.at(row);
 }
 // read STORE RS row
 const SmeshRsEntry& SmeshRS::storeEntry(std::size_t row) const {
-  return entries_st_.at(row);
+  return queues_[2].rows.at(row);
 }
 
 // ********** ISSUE **********
 // issueLoad/Execute/Store selects ready command and returns pointer to it
-// issue LOAD entry to LOAD issue port (search for oldest valid entry)
-const SmeshRsEntry* SmeshRS::issueLoad() const {
+
+// oldest row among the queue's ready mask (valid, not issued, no dependencies)
+const SmeshRsEntry* SmeshRS::oldestReady(const Queue& q) const {
   const SmeshRsEntry* oldest = nullptr;
-  for (const auto& entry : entries_ld_) {
-    // if row is valid, not issued, and ready (no dependencies), and is older than the current oldest, update oldest
-    if (entry.valid && !entry.issued && entry.ready() &&
-        (oldest == nullptr || entry.allocated_at < oldest->allocated_at)) {
+  for (auto ready = q.ready; ready != 0; ready &= ready - 1) {
+    const auto& entry = q.rows[lowestRow(ready)];
+    if (oldest == nullptr || entry.allocated_at < oldest->allocated_at) {
       oldest = &entry;
     }
   }
   return oldest;
 }
-// issue EXECUTE entry to EXECUTE issue port (search for oldest valid entry)
+// issue LOAD entry to LOAD issue port
+const SmeshRsEntry* SmeshRS::issueLoad() const {
+  return oldestReady(queues_[0]);
+}
+// issue EXECUTE entry to EXECUTE issue port
 const SmeshRsEntry* SmeshRS::issueExecute() const {
-  const SmeshRsEntry* oldest = nullptr;
-  for (const auto& entry : entries_ex_) {
-    if (entry.valid && !entry.issued && entry.ready() &&
-        (oldest == nullptr || entry.allocated_at < oldest->allocated_at)) {
-      oldest = &entry;
-    }
-  }
-  return oldest;
+  return oldestReady(queues_[1]);
 }
-// issue STORE entry to STORE issue port (search for oldest valid entry)
+// issue STORE entry to STORE issue port
 const SmeshRsEntry* SmeshRS::issueStore() const {
-  const SmeshRsEntry* oldest = nullptr;
-  for (const auto& entry : entries_st_) {
-    if (entry.valid && !entry.issued && entry.ready() &&
-        (oldest == nullptr || entry.allocated_at < oldest->allocated_at)) {
-      oldest = &entry;
-    }
-  }
-  return oldest;
+  return oldestReady(queues_[2]);
 }
 
 // runs each cycle ("update"): send oldest ready load command to LdCtrl and mark its RS entry issued
@@ -491,7 +536,7 @@ void SmeshRS::updateIssueLoad() {
     return;
   }
 
-  const auto* entry = issueLoad(); // scan load RS entries & pick oldest that's valid, not issued, ready (no deps)
+  const auto* entry = issueLoad(); // oldest row in the load ready mask
   if (entry == nullptr) {
     return;
   }
@@ -529,7 +574,7 @@ void SmeshRS::updateIssueStore() {
     return;
   }
 
-  const auto* entry = issueStore(); // scan load RS entries & pick oldest that's valid, not issued, ready (no deps)
+  const auto* entry = issueStore(); // oldest row in the store ready mask
   if (entry == nullptr) {
     return;
   }
@@ -541,29 +586,18 @@ void SmeshRS::updateIssueStore() {
   issue_st.push(issue);
   markIssued(entry->rs_tag);
 }
+
 // mark RS entry found by issue (based on rs_tag) as issued once controller accepts it
 // (note this is purely conceptual, SmeshShell just runs markIssued() after issue() for now)
 bool SmeshRS::markIssued(SmeshRsTag rs_tag) {
-  for (auto& entry : entries_ld_) {
-    if (entry.valid && entry.rs_tag == rs_tag) {
-      entry.issued = true;
-      return true;
-    }
-  }
-  for (auto& entry : entries_ex_) {
-    if (entry.valid && entry.rs_tag == rs_tag) {
-      entry.issued = true;
-      return true;
-    }
-  }
-  for (auto& entry : entries_st_) {
-    if (entry.valid && entry.rs_tag == rs_tag) {
-      entry.issued = true;
-      return true;
-    }
+  const auto it = rows_by_tag_.find(rs_tag);
+  if (it == rows_by_tag_.end()) {
+    return false;
   }
-
-  return false;
+  auto& q = queues_[it->second.q];
+  q.rows[it->second.row].issued = true;
+  q.ready &= ~rowBit(it->second.row);
+  return true;
 }
 
 // ********** COMPLETION **********
@@ -577,97 +611,58 @@ void SmeshRS::updateComplete() {
   assert_always(complete(rs_tag), "SmeshRS received completion for an unknown RS tag");
 }
 
-// mark RS entry as completed (based on rs_tag) and free it, clearing dependencies in other entries
+// mark RS entry as completed (based on rs_tag) and free it, waking the rows in its waiters_* masks
 bool SmeshRS::complete(SmeshRsTag rs_tag) {
-  SmeshRsEntry* completed_entry = nullptr;
-  std::size_t completed_row = 0;
-
-  // search all all the LD entries
-  for (std::size_t i = 0; i < entries_ld_.size(); ++i) {
-    if (entries_ld_[i].valid && entries_ld_[i].rs_tag == rs_tag) {
-      completed_entry = &entries_ld_[i];
-      completed_row = i;
-      break;
-    }
+  const auto it = rows_by_tag_.find(rs_tag);
+  if (it == rows_by_tag_.end()) {
+    return false;
   }
-  // if not found in LD, search all the EX entries
-  if (completed_entry == nullptr) {
-    for (std::size_t i = 0; i < entries_ex_.size(); ++i) {
-      if (entries_ex_[i].valid && entries_ex_[i].rs_tag == rs_tag) {
-        completed_entry = &entries_ex_[i];
-        completed_row = i;
-        break;
+  const std::size_t qi = it->second.q;
+  const std::size_t row = it->second.row;
+  rows_by_tag_.erase(it);
+
+  auto& completed_q = queues_[qi];
+  auto& completed_entry = completed_q.rows[row];
+  const auto completed_bit = rowBit(row); // dep bit to clear corresponding to the completed entry's row
+
+  for (std::size_t k = 0; k < queues_.size(); ++k) {
+    auto& other_q = queues_[k];
+    // wake: clear the completed row's bit in every row waiting on it
+    for (auto waiters = waitersFor(completed_entry, k); waiters != 0; waiters &= waiters - 1) {
+      const auto i = lowestRow(waiters);
+      auto& dependent = other_q.rows[i];
+      depsFor(dependent, qi) &= ~completed_bit;
+      if (dependent.valid && !dependent.issued && dependent.ready()) {
+        other_q.ready |= rowBit(i);
       }
     }
-  }
-  // if not found in EX, search all the ST entries
-  if (completed_entry == nullptr) {
-    for (std::size_t i = 0; i < entries_st_.size(); ++i) {
-      if (entries_st_[i].valid && entries_st_[i].rs_tag == rs_tag) {
-        completed_entry = &entries_st_[i];
-        completed_row = i;
-        break;
-      }
+    // retract: a row completed ahead of its own deps (tests do this) leaves no stale waiter bits behind
+    for (auto deps = depsFor(completed_entry, k); deps != 0; deps &= deps - 1) {
+      waitersFor(other_q.rows[lowestRow(deps)], qi) &= ~completed_bit;
     }
   }
-  if (completed_entry == nullptr) {
-    return false;
-  }
-
-  const auto completed_q = completed_entry->q; // remember whether it was a LOAD, EXECUTE, or STORE entry
-  const auto completed_bit = std::uint32_t{1} << completed_row; // dep bit to clear corresponding to the completed entry's row
-
-  // visit every entry that might have a dependency on the completed entry and clear that dependency
-  switch (completed_q) {
-    case SmeshQueueClass::Load:
-      for (auto& dependent : entries_ld_) {
-        dependent.deps_ld &= ~completed_bit; // clear completed row's bit in deps_ld if LOAD completed
-      }
-      for (auto& dependent : entries_ex_) {
-        dependent.deps_ld &= ~completed_bit;
-      }
-      for (auto& dependent : entries_st_) {
-        dependent.deps_ld &= ~completed_bit;
-      }
-      break;
-    case SmeshQueueClass::Execute:
-      for (auto& dependent : entries_ld_) {
-        dependent.deps_ex &= ~completed_bit; // clear completed row's bit in deps_ex if EXECUTE completed
-      }
-      for (auto& dependent : entries_ex_) {
-        dependent.deps_ex &= ~completed_bit;
-      }
-      for (auto& dependent : entries_st_) {
-        dependent.deps_ex &= ~completed_bit;
-      }
-      break;
-    case SmeshQueueClass::Store:
-      for (auto& dependent : entries_ld_) {
-        dependent.deps_st &= ~completed_bit; // clear completed row's bit in deps_st if STORE completed
-      }
-      for (auto& dependent : entries_ex_) {
-        dependent.deps_st &= ~completed_bit;
-      }
-      for (auto& dependent : entries_st_) {
-        dependent.deps_st &= ~completed_bit;
-      }
-      break;
-    case SmeshQueueClass::System:
-    case SmeshQueueClass::Invalid:
-      break;
-  }
 
-  *completed_entry = SmeshRsEntry{}; // clear completed entry itself
+  completed_entry = SmeshRsEntry{}; // clear completed entry itself
+  completed_q.free |= completed_bit;
+  completed_q.ready &= ~completed_bit;
   return true;
 }
 
 void SmeshRS::reset() {
   config_state_ = {};
-  entries_ld_ = {};
-  entries_ex_ = {};
-  entries_st_ = {};
+  for (auto& q : queues_) { // keep the depth chosen by setEntries()
+    q.rows.assign(q.rows.size(), SmeshRsEntry{});
+    q.free = q.all;
+    q.ready = 0;
+    q.occupancy_sum = 0;
+    q.full_stall_cycles = 0;
+    q.allocations = 0;
+    q.peak_occupancy = 0;
+  }
+  rows_by_tag_.clear();
   next_rs_tag_ = 0;
   instructions_allocated_ = 0;
+  cycles_ = 0;
   load_issue_port_enabled_ = false;
   store_issue_port_enabled_ = false;
 }
@@ -102,7 +102,7 @@ void SmeshShell::update() {
   // execute RS entry selected for issue
   try {
     // TODO: Replace this conceptual acceptance with explicit controller ready/valid handshakes
-    rs_->markIssued(entry.rs_tag); // search all RS rows for entry.rs_tag that's been selected for issue
+    rs_->markIssued(entry.rs_tag); // look up the RS row holding entry.rs_tag that's been selected for issue
     const auto funct = static_cast<SmeshFunct>(static_cast<std::uint32_t>(entry.cmd.funct)); // determine which cmd's been issued
     // if issued cmd is mvin/mvin2/mvin3, start multicycle DRAM-to-spad transfer
     if (external_memory_ && (funct == SmeshFunct::Mvin || funct == SmeshFunct::Mvin2 || funct == SmeshFunct::Mvin3)) {
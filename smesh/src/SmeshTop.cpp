@@ -37,6 +37,9 @@ SmeshTop::SmeshTop(std::string /*name*/, IMPL_CTOR) {
   for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
     arb_resp_spad_[bank] = new ArbRespSpad("ArbRespSpad");
   }
+  for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
+    arb_resp_accum_[bank] = new ArbRespAccum("ArbRespAccum");
+  }
   write_norm_queue_     = new DmaWriteNormQueue("DmaWriteNormQueue");
   st_norm_ctrl_         = new StNormCtrl("StNormCtrl");
   normalizer_           = new Normalizer("Normalizer");
@@ -50,6 +53,7 @@ SmeshTop::SmeshTop(std::string /*name*/, IMPL_CTOR) {
   dma_writer_           = new DmaWriter("DmaWriter");
   spad_writer_          = new SpadWriter("SpadWriter");
   dma_reader_           = new DmaReader("DmaReader");
+  dma_mem_arb_          = new DmaMemArb("DmaMemArb");
   mvin_scale_split_     = new MvinScaleSplit("MvinScaleSplit");
   mvin_scale_           = new MvinScale("MvinScale");
   mvin_scale_acc_       = new MvinScaleAcc("MvinScaleAcc");
@@ -89,6 +93,9 @@ SmeshTop::SmeshTop(std::string /*name*/, IMPL_CTOR) {
   for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
     arb_resp_spad_[bank]->clk << clk;
   }
+  for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
+    arb_resp_accum_[bank]->clk << clk;
+  }
   write_norm_queue_->clk     << clk;
   st_norm_ctrl_->clk         << clk;
   normalizer_->clk           << clk;
@@ -102,6 +109,7 @@ SmeshTop::SmeshTop(std::string /*name*/, IMPL_CTOR) {
   dma_writer_->clk           << clk;
   spad_writer_->clk          << clk;
   dma_reader_->clk           << clk;
+  dma_mem_arb_->clk          << clk;
   mvin_scale_split_->clk     << clk;
   mvin_scale_->clk           << clk;
   mvin_scale_acc_->clk       << clk;
@@ -127,7 +135,9 @@ SmeshTop::SmeshTop(std::string /*name*/, IMPL_CTOR) {
   completion_arb_->st_completed << st_ctrl_->completed;
   rs_->completed   << completion_arb_->rs_completed;
   read_issue_queue_->req_in << ld_ctrl_->dma_req;      
-  dma_reader_->req_in       << read_issue_queue_->req_out;   
+  dma_reader_->req_in       << read_issue_queue_->req_out;
+  dma_mem_arb_->rd_req      << dma_reader_->mem_req;
+  dma_reader_->mem_resp     << dma_mem_arb_->rd_resp;   
   ex_ctrl_->cmd_in << rs_->issue_ex;
   st_ctrl_->cmd_in << rs_->issue_st;                   
   write_dispatch_queue_->req_in << st_ctrl_->dma_req;  
@@ -143,7 +153,7 @@ SmeshTop::SmeshTop(std::string /*name*/, IMPL_CTOR) {
   write_dispatch_queue_->deq_rdy << st_read_ctrl_->read_req_fire;
   write_norm_queue_->enq_val   << st_read_ctrl_->read_req_fire;
   write_norm_queue_->enq_bits  << write_dispatch_queue_->deq_bits;
-  st_ctrl_->dma_resp           << st_read_ctrl_->dma_resp;
+  st_ctrl_->read_resp          << st_read_ctrl_->dma_resp;
   st_norm_ctrl_->norm_deq_val  << write_norm_queue_->deq_val;
   st_norm_ctrl_->norm_deq_bits << write_norm_queue_->deq_bits;
   st_norm_ctrl_->normalizer_cmd_rdy << normalizer_->req_rdy;
@@ -187,20 +197,19 @@ SmeshTop::SmeshTop(std::string /*name*/, IMPL_CTOR) {
   dma_writer_->req_bits << st_issue_mux_->writer_req_bits;
   spad_writer_->req_val  << st_issue_ctrl_->spad_writer_req_val;
   spad_writer_->req_bits << st_issue_mux_->writer_req_bits;
-  dma_writer_->mem_req.sendToBitBucket();              // later: connect to store-side external memory boundary
-  spad_writer_->spad_write_out.sendToBitBucket();      // later: connect to store-spad destination path
+  dma_mem_arb_->wr_req   << dma_writer_->mem_req;
+  st_ctrl_->dma_resp     << dma_mem_arb_->wr_ack;
+  st_ctrl_->spad_resp    << spad_writer_->write_ack;
+  st_ctrl_->norm_resp    << normalizer_->stats_done;
   write_issue_queue_->deq_rdy << st_issue_ctrl_->issue_deq_rdy;
   mvin_scale_split_->data_in << dma_reader_->resp_out;
   mvin_scale_->data_in       << mvin_scale_split_->normal_out;
   mvin_scale_acc_->data_in   << mvin_scale_split_->acc_out;
   mvin_scale_acc_->data_rdy  << write_ctrl_->dmaread_accum_full_rdy;
-  mvin_scale_acc_->data_out.sendToBitBucket();
   pixel_repeater_->data_in << mvin_scale_->data_out;    
   local_router_->data_in   << pixel_repeater_->data_out; 
   local_router_->dmaread_spad_rdy << write_ctrl_->dmaread_spad_rdy;
   local_router_->dmaread_accum_rdy << write_ctrl_->dmaread_accum_rdy;
-  local_router_->dmaread_spad.sendToBitBucket(); 
-  local_router_->dmaread_accum.sendToBitBucket(); 
   write_ctrl_->dmaread_spad_val        << local_router_->dmaread_spad_val;
   write_ctrl_->dmaread_spad_bits       << local_router_->dmaread_spad_bits;
   write_ctrl_->dmaread_accum_val       << local_router_->dmaread_accum_val;
@@ -208,20 +217,25 @@ SmeshTop::SmeshTop(std::string /*name*/, IMPL_CTOR) {
   write_ctrl_->dmaread_accum_full_val  << mvin_scale_acc_->data_val;
   write_ctrl_->dmaread_accum_full_bits << mvin_scale_acc_->data_bits;
   for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
-    arb_write_spad_[bank]->exwrite_val    << write_arb_zero_val_;
-    arb_write_spad_[bank]->exwrite_bits   << write_arb_zero_bits_;
+    arb_write_spad_[bank]->exwrite_val    << ex_ctrl_->spad_write_val[bank];
+    arb_write_spad_[bank]->exwrite_bits   << ex_ctrl_->spad_write_bits[bank];
+    ex_ctrl_->spad_write_rdy[bank]        << arb_write_spad_[bank]->exwrite_rdy;
     arb_write_spad_[bank]->dmaread_val    << write_ctrl_->arb_spad_dmaread_val[bank];
     arb_write_spad_[bank]->dmaread_bits   << write_ctrl_->arb_spad_dmaread_bits[bank];
     write_ctrl_->arb_spad_dmaread_rdy[bank] << arb_write_spad_[bank]->dmaread_rdy;
     arb_write_spad_[bank]->zerowrite_val  << write_arb_zero_val_;
     arb_write_spad_[bank]->zerowrite_bits << write_arb_zero_bits_;
+    arb_write_spad_[bank]->spadwrite_val  << spad_writer_->spad_write_val[bank];
+    arb_write_spad_[bank]->spadwrite_bits << spad_writer_->spad_write_bits[bank];
+    spad_writer_->spad_write_fire[bank]   << arb_write_spad_[bank]->spadwrite_fire;
     arb_write_spad_[bank]->write_rdy      << spad_->write_rdy_bnk[bank];
     spad_->write_val_bnk[bank]            << arb_write_spad_[bank]->write_val;
     spad_->write_bits_bnk[bank]           << arb_write_spad_[bank]->write_bits;
   }
   for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
-    arb_write_accum_[bank]->exwrite_val       << write_arb_zero_val_;
-    arb_write_accum_[bank]->exwrite_bits      << write_arb_zero_bits_;
+    arb_write_accum_[bank]->exwrite_val       << ex_ctrl_->accum_write_val[bank];
+    arb_write_accum_[bank]->exwrite_bits      << ex_ctrl_->accum_write_bits[bank];
+    ex_ctrl_->accum_write_rdy[bank]           << arb_write_accum_[bank]->exwrite_rdy;
     arb_write_accum_[bank]->dmaread_val       << write_ctrl_->arb_accum_dmaread_val[bank];
     arb_write_accum_[bank]->dmaread_bits      << write_ctrl_->arb_accum_dmaread_bits[bank];
     write_ctrl_->arb_accum_dmaread_rdy[bank]  << arb_write_accum_[bank]->dmaread_rdy;
@@ -273,17 +287,24 @@ SmeshTop::SmeshTop(std::string /*name*/, IMPL_CTOR) {
   }
   acc_scale_unit_->out_rdy_issue  << st_issue_ctrl_->acc_data_rdy;
   acc_scale_unit_->out_rdy_exresp << accum_ex_resp_->acc_rdy_exresp;
-  accum_ex_resp_->acc_val         << acc_scale_unit_->out_val;
+  accum_ex_resp_->acc_val         << acc_scale_unit_->out_val_exresp;
   accum_ex_resp_->acc_bits        << acc_scale_unit_->out_bits;
   for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
     ex_ctrl_->accum_read_resp_val[bank]  << accum_ex_resp_->ex_resp_val[bank];
     ex_ctrl_->accum_read_resp_bits[bank] << accum_ex_resp_->ex_resp_bits[bank];
     accum_ex_resp_->ex_resp_rdy[bank]    << ex_ctrl_->accum_read_resp_rdy[bank];
   }
+  // each accum bank's response goes to the store path (StNormCtrl) or, for execute reads, AccScaleUnit
   for (std::size_t bank = 0; bank < kAccBanks; ++bank) {
-    st_norm_ctrl_->accum_read_resp_val[bank]  << accum_->read_resp_val_bnk[bank];
+    arb_resp_accum_[bank]->read_resp_val      << accum_->read_resp_val_bnk[bank];
+    arb_resp_accum_[bank]->read_resp_bits     << accum_->read_resp_bits_bnk[bank];
+    arb_resp_accum_[bank]->dma_resp_rdy       << st_norm_ctrl_->accum_read_resp_rdy[bank];
+    arb_resp_accum_[bank]->ex_resp_rdy        << acc_scale_unit_->ex_req_rdy[bank];
+    accum_->read_resp_rdy_bnk[bank]           << arb_resp_accum_[bank]->read_resp_rdy;
+    st_norm_ctrl_->accum_read_resp_val[bank]  << arb_resp_accum_[bank]->dma_resp_val;
     st_norm_ctrl_->accum_read_resp_bits[bank] << accum_->read_resp_bits_bnk[bank];
-    accum_->read_resp_rdy_bnk[bank]           << st_norm_ctrl_->accum_read_resp_rdy[bank];
+    acc_scale_unit_->ex_req_val[bank]         << arb_resp_accum_[bank]->ex_resp_val;
+    acc_scale_unit_->ex_req_bits[bank]        << accum_->read_resp_bits_bnk[bank];
   }
   completion_mux_->spad_in  << spad_->dma_resp;         
   completion_mux_->accum_in << accum_->dma_resp;       
@@ -310,6 +331,7 @@ SmeshTop::~SmeshTop() {
   delete mvin_scale_acc_;
   delete mvin_scale_;
   delete mvin_scale_split_;
+  delete dma_mem_arb_;
   delete dma_reader_;
   delete spad_writer_;
   delete dma_writer_;
@@ -323,6 +345,9 @@ SmeshTop::~SmeshTop() {
   delete normalizer_;
   delete st_norm_ctrl_;
   delete write_norm_queue_;
+  for (auto* arb : arb_resp_accum_) {
+    delete arb;
+  }
   for (auto* arb : arb_resp_spad_) {
     delete arb;
   }
@@ -28,134 +28,114 @@ void Spad::updateWriteReady() {
 }
 
 void Spad::updateWrite() {
-  bool has_write = false;
-  DmaReadResp write{};
-
+  bool completed = false; // one completion per cycle; only the single mvin stream marks last
   for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
     if (write_val_bnk[bank] == 0) {
       continue;
     }
-    const auto pending = *write_bits_bnk[bank];
-    if (static_cast<bool>(pending.last) && dma_resp.full()) {
-      return;
+    const auto write = *write_bits_bnk[bank];
+    if (static_cast<bool>(write.last) && dma_resp.full()) {
+      continue;
     }
-    write = pending;
-    has_write = true;
-    break;
-  }
 
-  if (!has_write) {
-    return;
-  }
-
-  assert_always(!write.laddr.is_acc_addr(),
-                "Spad write received an accumulator address");
-
-  auto& destination = banks_[write.laddr.sp_bank()][write.laddr.sp_row()];
-  const auto data = low64DmaReadData(write.data);
-  const auto mask = static_cast<std::uint8_t>(write.mask);
-  for (std::size_t lane = 0; lane < kDim; ++lane) {
-    if ((mask & (std::uint8_t{1} << lane)) != 0) {
-      destination[lane] = static_cast<Elem>((data >> (lane * 8)) & 0xffu);
+    assert_always(!write.laddr.is_acc_addr(),
+                  "Spad write received an accumulator address");
+    assert_always(write.laddr.sp_bank() == bank, "Spad write arrived on the wrong bank port");
+
+    auto& destination = banks_[bank][write.laddr.sp_row()];
+    const auto data = low64DmaReadData(write.data);
+    const auto mask = static_cast<std::uint8_t>(write.mask);
+    for (std::size_t lane = 0; lane < kDim; ++lane) {
+      if ((mask & (std::uint8_t{1} << lane)) != 0) {
+        destination[lane] = static_cast<Elem>((data >> (lane * 8)) & 0xffu);
+      }
+    }
+    // if this is final write push {bytes_read, cmd_id} on completion FIFO to LdCtrl
+    if (static_cast<bool>(write.last)) {
+      assert_always(!completed, "Spad saw two last writes in one cycle");
+      DmaReadCompletion completion{};
+      completion.bytes_read = write.bytes_read;
+      completion.cmd_id = write.cmd_id;
+      dma_resp.push(completion);
+      completed = true;
     }
-  }
-  // if this is final write push {bytes_read, cmd_id} on completion FIFO to LdCtrl
-  if (static_cast<bool>(write.last)) {
-    DmaReadCompletion completion{};
-    completion.bytes_read = write.bytes_read;
-    completion.cmd_id = write.cmd_id;
-    dma_resp.push(completion);
-  }
 
-  write_accepted_ = true;
-  trace("spad: write bank=%u row=%u mask=0x%x cmd_id=%u last=%u",
-        static_cast<unsigned>(write.laddr.sp_bank()),
-        static_cast<unsigned>(write.laddr.sp_row()),
-        static_cast<unsigned>(write.mask),
-        static_cast<unsigned>(write.cmd_id),
-        static_cast<unsigned>(write.last));
+    write_accepted_ = true;
+    ++writes_[bank];
+    trace("spad: write bank=%u row=%u mask=0x%x cmd_id=%u last=%u",
+          static_cast<unsigned>(bank),
+          static_cast<unsigned>(write.laddr.sp_row()),
+          static_cast<unsigned>(write.mask),
+          static_cast<unsigned>(write.cmd_id),
+          static_cast<unsigned>(write.last));
+  }
 }
-// provide read req ready signal to StReadCtrl so it can inspect it
+// a bank takes a new read only while its response reg is empty
 void Spad::updateReadReady() {
   for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
-    read_req_rdy_bnk[bank] = bit(!read_resp_valid_);
+    read_accepting_[bank] = !read_resp_valid_[bank];
+    read_req_rdy_bnk[bank] = bit(read_accepting_[bank]);
   }
 }
-// expose current held spad read response onto o/p ports
+// expose every bank's held read response onto its o/p ports
 void Spad::updateReadRespView() {
   for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
-    read_resp_val_bnk[bank] = 0;
-    read_resp_bits_bnk[bank] = SpadReadResp{};
-  }
-
-  if (read_resp_valid_) {
-    const auto bank = read_resp_entry_.laddr.sp_bank();
-    read_resp_val_bnk[bank] = 1;
-    read_resp_bits_bnk[bank] = read_resp_entry_;
+    read_resp_val_bnk[bank] = bit(read_resp_valid_[bank]);
+    read_resp_bits_bnk[bank] = read_resp_valid_[bank] ? read_resp_entry_[bank] : SpadReadResp{};
   }
 }
 
 void Spad::updateReadRespPop() {
-  if (!read_resp_valid_) {
-    return;
-  }
-
-  const auto bank = read_resp_entry_.laddr.sp_bank();
-  if (read_resp_rdy_bnk[bank] != 0) {
-    read_resp_valid_ = false;
-    read_resp_entry_ = SpadReadResp{};
+  for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
+    if (read_resp_valid_[bank] && read_resp_rdy_bnk[bank] != 0) {
+      read_resp_valid_[bank] = false;
+      read_resp_entry_[bank] = SpadReadResp{};
+    }
   }
 }
-
+// each bank serves the request its ArbReadSpad granted (execute reads win there)
 void Spad::updateRead() {
-  const bool exread = false; // TODO: execute read wins once ExCtrl has a local-memory read port
-  bool has_request = false;
-  SpadReadReq req{};
   for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
-    if (read_req_val_bnk[bank] != 0) {
-      req = *read_req_bits_bnk[bank];
-      has_request = true;
-      break;
+    if (read_req_val_bnk[bank] == 0 || !read_accepting_[bank]) {
+      continue;
     }
+    const auto req = *read_req_bits_bnk[bank];
+    assert_always(!req.laddr.is_acc_addr(),
+                  "Spad read received an accumulator address");
+    assert_always(req.laddr.sp_bank() == bank, "Spad read arrived on the wrong bank port");
+
+    SpadReadResp resp{};
+    resp.laddr = req.laddr;
+    resp.len = req.len;
+    resp.cmd_id = req.cmd_id;
+    resp.from_dma = req.from_dma;
+    resp.data = banks_[bank][req.laddr.sp_row()];
+    for (std::size_t lane = 0; lane < kDim; ++lane) {
+      resp.mask |= static_cast<u8>(u8{1} << lane);
+    }
+    read_resp_entry_[bank] = resp;
+    read_resp_valid_[bank] = true;
+    read_accepting_[bank] = false;
+    ++reads_[bank];
+    ex_reads_ += req.from_dma != 0 ? 0 : 1;
+    trace("spad: %s read bank=%u row=%u mask=0x%x cmd_id=%u",
+          req.from_dma != 0 ? "dma" : "ex",
+          static_cast<unsigned>(bank),
+          static_cast<unsigned>(req.laddr.sp_row()),
+          static_cast<unsigned>(resp.mask),
+          static_cast<unsigned>(req.cmd_id));
   }
-
-  if (!exread && !has_request) {
-    return;
-  }
-  if (exread) {
-    return;
-  }
-  if (read_resp_valid_) {
-    return;
-  }
-
-  assert_always(!req.laddr.is_acc_addr(),
-                "Spad read received an accumulator address");
-
-  const auto& source = banks_[req.laddr.sp_bank()][req.laddr.sp_row()];
-  SpadReadResp resp{};
-  resp.laddr = req.laddr;
-  resp.len = req.len;
-  resp.cmd_id = req.cmd_id;
-  resp.from_dma = req.from_dma;
-  resp.data = source;
-  for (std::size_t lane = 0; lane < kDim; ++lane) {
-    resp.mask |= static_cast<u8>(u8{1} << lane);
-  }
-  read_resp_entry_ = resp;
-  read_resp_valid_ = true;
-  trace("spad: dma read bank=%u row=%u mask=0x%x cmd_id=%u",
-        static_cast<unsigned>(req.laddr.sp_bank()),
-        static_cast<unsigned>(req.laddr.sp_row()),
-        static_cast<unsigned>(resp.mask),
-        static_cast<unsigned>(req.cmd_id));
 }
 
 void Spad::reset() {
   banks_ = {};
   write_accepted_ = false;
-  read_resp_valid_ = false;
-  read_resp_entry_ = SpadReadResp{};
+  read_accepting_ = {};
+  read_resp_valid_ = {};
+  read_resp_entry_ = {};
+  reads_ = {};
+  writes_ = {};
+  ex_reads_ = 0;
   for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
     write_rdy_bnk[bank].reset(1);
     read_req_rdy_bnk[bank].reset(1);
@@ -168,4 +148,8 @@ const Spad::Row& Spad::row(SmeshLocalAddr addr) const {
   return banks_[addr.sp_bank()][addr.sp_row()];
 }
 
+void Spad::loadRowForTest(SmeshLocalAddr addr, const Row& data) {
+  banks_[addr.sp_bank()][addr.sp_row()] = data;
+}
+
 } // namespace smesh
@@ -3,7 +3,7 @@
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 13 2026
 /*
-Store-side scratchpad writer skeleton implementation.
+Store-side scratchpad writer implementation.
 */
 
 #include "SpadWriter.hpp"
@@ -12,33 +12,73 @@ namespace smesh {
 
 SpadWriter::SpadWriter(std::string /*name*/, IMPL_CTOR) {
   UPDATE(updateReady).writes(req_rdy);
-  UPDATE(update).reads(req_val, req_bits).writes(spad_write_out);
+  UPDATE(updateView).writes(spad_write_val, spad_write_bits);
+  UPDATE(updateAccept).reads(req_val, req_bits);
+  UPDATE(updateAck).reads(spad_write_fire).writes(write_ack);
 }
 
 void SpadWriter::updateReady() {
-  req_rdy = bit(!spad_write_out.full());
+  accepting_ = !entry_valid_;
+  req_rdy = bit(accepting_);
+}
+// present the held row to its destination bank (only while its ack has somewhere to go)
+void SpadWriter::updateView() {
+  for (std::size_t bank = 0; bank < kSpBanks; ++bank) {
+    spad_write_val[bank] = 0;
+    spad_write_bits[bank] = entry_;
+  }
+  if (!entry_valid_ || write_ack.full()) {
+    return;
+  }
+  spad_write_val[entry_.laddr.sp_bank()] = 1;
 }
 
-void SpadWriter::update() {
-  if (req_val == 0 || spad_write_out.full()) {
+void SpadWriter::updateAccept() {
+  if (!accepting_ || req_val == 0) {
     return;
   }
 
   const auto writer_req = *req_bits;
   const auto issue = writer_req.issue;
+  // STORE_SPAD carries its destination local address in rs1 (see packStoreSpadDestination)
+  const auto dst = makeLocalAddr(static_cast<std::uint32_t>(static_cast<std::uint64_t>(issue.vaddr) & 0xffffffffull));
+  assert_always(!dst.is_acc_addr() && !dst.is_garbage(), "SpadWriter destination must be a scratchpad address");
+  const auto len = static_cast<std::uint16_t>(issue.len);
   DmaReadResp write{};
-  write.laddr = issue.laddr;
-  write.mask = 0xf;
+  write.laddr = dst;
+  write.mask = u8(len >= 8 ? 0xffu : ((1u << len) - 1u));
   write.bytes_read = writer_req.len_bytes;
+  write.len = issue.len;
   write.pixel_repeats = 1;
   write.cmd_id = issue.cmd_id;
-  write.last = true;
+  write.last = false; // not a load: no LdCtrl completion from the scratchpad
   write.data = writer_req.data_is_all_zeros ? DmaReadData{} : writer_req.data;
-  spad_write_out.push(write);
+  entry_ = write;
+  entry_valid_ = true;
   trace("spad_writer: local write laddr=0x%x data=0x%llx cmd_id=%u",
         static_cast<unsigned>(write.laddr.raw),
         static_cast<unsigned long long>(low64DmaReadData(write.data)),
         static_cast<unsigned>(write.cmd_id));
 }
 
+void SpadWriter::updateAck() {
+  if (!entry_valid_ || spad_write_fire[entry_.laddr.sp_bank()] == 0) {
+    return;
+  }
+  DmaWriteResp ack{};
+  ack.cmd_id = entry_.cmd_id;
+  write_ack.push(ack);
+  ++rows_written_;
+  entry_valid_ = false;
+  entry_ = DmaReadResp{};
+}
+
+void SpadWriter::reset() {
+  entry_valid_ = false;
+  accepting_ = false;
+  entry_ = DmaReadResp{};
+  rows_written_ = 0;
+  req_rdy.reset(1);
+}
+
 } // namespace smesh
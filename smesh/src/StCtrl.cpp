@@ -11,47 +11,214 @@ namespace smesh {
 
 StCtrl::StCtrl(std::string /*name*/, IMPL_CTOR) {
   UPDATE(updateDispatch).reads(cmd_in).writes(dma_req);
-  UPDATE(updateComplete).reads(dma_resp).writes(completed);
+  UPDATE(updateRead).reads(read_resp);
+  UPDATE(updateComplete).reads(dma_resp, spad_resp, norm_resp).writes(completed);
 }
 
 void StCtrl::updateDispatch() {
-  if (cmd_in.empty() || dma_req.full()) {
+  if (dma_req.full()) {
+    return;
+  }
+  if (active_valid_) { // finish the active store's rows before taking the next command
+    issueRow();
+    return;
+  }
+  if (cmd_in.empty() || config_pending_) {
     return;
   }
 
   const auto issue = cmd_in.pop();
   const auto funct = static_cast<SmeshFunct>(static_cast<std::uint32_t>(issue.cmd.funct)); // convert to enum class type
+  if (funct == SmeshFunct::Config) { // CONFIG_ST/CONFIG_NORM: latch the store registers, just retire the tag
+    applyConfig(static_cast<std::uint64_t>(issue.cmd.rs1), static_cast<std::uint64_t>(issue.cmd.rs2));
+    config_pending_ = true;
+    config_tag_     = issue.rs_tag;
+    trace("st_ctrl: config tag=%u act=%u relu6_shift=%u scale=0x%x%s stride=%u qb=%d qc=%d qln2=%d qln2_inv=%u stats_id=%u",
+          static_cast<unsigned>(issue.rs_tag),
+          static_cast<unsigned>(act_),
+          static_cast<unsigned>(relu6_shift_),
+          static_cast<unsigned>(acc_scale_),
+          acc_scale_fixed_ ? " (q16.16)" : "",
+          static_cast<unsigned>(dram_stride_),
+          static_cast<int>(igelu_qb_),
+          static_cast<int>(igelu_qc_),
+          static_cast<int>(iexp_qln2_),
+          static_cast<unsigned>(iexp_qln2_inv_),
+          static_cast<unsigned>(norm_stats_id_));
+    return;
+  }
   const auto local = unpackLocal(static_cast<std::uint64_t>(issue.cmd.rs2));
+  assert_always(local.shape.rows != 0, "StCtrl received a store with no rows");
+  active_       = issue;
+  active_valid_ = true;
+  base_laddr_   = makeLocalAddr(local.row);
+  rows_         = static_cast<std::uint32_t>(local.shape.rows);
+  cols_         = static_cast<std::uint32_t>(local.shape.cols);
+  next_row_     = 0;
+  assert_always(rows_left_.find(issue.rs_tag) == rows_left_.end(), "StCtrl store tag is already in flight");
+  rows_left_[issue.rs_tag] = rows_;
+  issueRow();
+}
+
+// one row of the active store per call: local row base + r, DRAM row base + r * stride
+// (STORE_SPAD: destination row + r * its rs1[63:32] stride, high bits kept)
+void StCtrl::issueRow() {
+  const auto funct = static_cast<SmeshFunct>(static_cast<std::uint32_t>(active_.cmd.funct));
   const bool dst_is_spad = funct == SmeshFunct::StoreSpad; // if funct=StoreSpad, then store in external spad, otherwise in main mem
+  const auto rs1 = static_cast<std::uint64_t>(active_.cmd.rs1);
+
+  std::uint64_t vaddr = 0;
+  if (dst_is_spad) {
+    const auto stride = unpackStoreSpadDestinationStride(rs1);
+    const auto dst = makeLocalAddr(static_cast<std::uint32_t>(rs1 & 0xffffffffull)) + next_row_ * (stride == 0 ? 1u : stride);
+    vaddr = (rs1 & ~0xffffffffull) | dst.raw;
+  } else {
+    const bool full_width = base_laddr_.is_acc_addr() && base_laddr_.read_full_acc_row();
+    const std::uint64_t packed = static_cast<std::uint64_t>(cols_) * (full_width ? sizeof(Acc) : sizeof(Elem));
+    vaddr = rs1 + static_cast<std::uint64_t>(next_row_) * (dram_stride_ == 0 ? packed : dram_stride_);
+  }
 
   DmaWriteReq req{};
-  req.vaddr    = issue.cmd.rs1;
-  req.laddr    = makeLocalAddr(local.row);
+  req.vaddr    = u64(vaddr);
+  req.laddr    = base_laddr_ + next_row_;
   req.dest     = u16(dst_is_spad ? 1u : 0u); // SpadWriter or DmaWriter
-  req.len      = u16(static_cast<std::uint16_t>(local.shape.cols));
-  req.block    = u16(static_cast<std::uint16_t>(local.shape.rows));
-  req.cmd_id   = u16(issue.rs_tag);
+  req.len      = u16(static_cast<std::uint16_t>(cols_));
+  req.block    = u16(static_cast<std::uint16_t>(rows_));
+  req.cmd_id   = u16(active_.rs_tag);
   req.store_en = true;
+  req.acc_act           = u8(act_);
+  req.acc_relu6_shift   = u8(relu6_shift_);
+  req.acc_scale         = u32(acc_scale_);
+  req.acc_scale_fixed   = bit(acc_scale_fixed_);
+  req.acc_channel_scale = channel_scale_;
+  req.acc_igelu_qb      = u32(static_cast<std::uint32_t>(igelu_qb_));
+  req.acc_igelu_qc      = u32(static_cast<std::uint32_t>(igelu_qc_));
+  req.acc_iexp_qln2     = u32(static_cast<std::uint32_t>(iexp_qln2_));
+  req.acc_iexp_qln2_inv = u32(iexp_qln2_inv_);
+  req.acc_norm_stats_id = u16(norm_stats_id_);
   dma_req.push(req);
+  ++dispatched_;
+  ++next_row_;
+  active_valid_ = next_row_ < rows_;
 
-  trace("st_ctrl: dispatched vaddr=0x%llx laddr=0x%x dest=%u len=%u block=%u cmd_id=%u",
+  trace("st_ctrl: dispatched vaddr=0x%llx laddr=0x%x dest=%u len=%u row=%u/%u cmd_id=%u",
         static_cast<unsigned long long>(req.vaddr),
         static_cast<unsigned>(req.laddr.raw),
         static_cast<unsigned>(req.dest),
         static_cast<unsigned>(req.len),
-        static_cast<unsigned>(req.block),
+        static_cast<unsigned>(next_row_),
+        static_cast<unsigned>(rows_),
         static_cast<unsigned>(req.cmd_id));
 }
 
+// CONFIG_ST sets the activation, scale and DRAM stride (or one channel's scale); CONFIG_NORM the
+// I-GELU/I-EXP constants and stats id
+void StCtrl::applyConfig(std::uint64_t rs1, std::uint64_t rs2) {
+  const auto kind = static_cast<ConfigKind>(rs1 & 0x3u);
+  if (kind == ConfigKind::Store && unpackConfigStoreChannelScale(rs1)) {
+    const auto channel = unpackConfigStoreChannel(rs1);
+    assert_always(channel < kDim, "CONFIG_ST channel scale names a lane past kDim");
+    channel_scale_[channel] = unpackConfigStoreAccScale(rs1);
+    return;
+  }
+  if (kind == ConfigKind::Store) {
+    act_             = static_cast<std::uint8_t>(unpackConfigStoreActivation(rs1));
+    relu6_shift_     = static_cast<std::uint8_t>(unpackConfigStoreRelu6Shift(rs1));
+    acc_scale_       = unpackConfigStoreAccScale(rs1);
+    acc_scale_fixed_ = unpackConfigStoreFixedScale(rs1);
+    dram_stride_     = static_cast<std::uint32_t>(rs2);
+    channel_scale_.fill(0);
+    return;
+  }
+  assert_always(kind == ConfigKind::Norm, "StCtrl received a non-store config");
+  norm_stats_id_ = static_cast<std::uint16_t>(unpackConfigNormStatsId(rs1));
+  assert_always(norm_stats_id_ < kNormStats, "CONFIG_NORM stats id is past kNormStats");
+  if (unpackConfigNormSetStatsIdOnly(rs1)) {
+    return;
+  }
+  const auto q_const = unpackConfigNormQConst(rs1);
+  if (unpackConfigNormQConstIsInv(rs1)) {
+    iexp_qln2_inv_ = q_const;
+  } else {
+    iexp_qln2_ = static_cast<std::int32_t>(q_const);
+  }
+  igelu_qb_ = unpackConfigNormQb(rs2);
+  igelu_qc_ = unpackConfigNormQc(rs2);
+}
+
+void StCtrl::updateRead() {
+  if (read_resp.empty()) {
+    return;
+  }
+
+  const auto response = read_resp.pop();
+  ++reads_accepted_;
+  trace("st_ctrl: read accepted tag=%u", static_cast<unsigned>(response.cmd_id));
+}
+// every row of a store acks once; the last row's ack retires the RS tag
 void StCtrl::updateComplete() {
-  if (dma_resp.empty() || completed.full()) {
+  if (completed.full()) {
     return;
   }
 
-  const auto response = dma_resp.pop();
+  DmaWriteResp response{};
+  bool row_ack = true;
+  if (!dma_resp.empty()) {
+    response = dma_resp.pop();
+    ++writes_acked_;
+  } else if (!spad_resp.empty()) {
+    response = spad_resp.pop();
+    ++spad_writes_acked_;
+  } else if (!norm_resp.empty()) {
+    response = norm_resp.pop();
+    ++stats_acked_;
+  } else if (config_pending_) {
+    response.cmd_id = u16(static_cast<std::uint16_t>(config_tag_));
+    config_pending_ = false;
+    row_ack = false;
+  } else {
+    return;
+  }
+  if (row_ack) {
+    const auto left = rows_left_.find(static_cast<SmeshRsTag>(response.cmd_id));
+    assert_always(left != rows_left_.end(), "StCtrl received a write ack for a tag with no rows due");
+    if (--left->second != 0) {
+      trace("st_ctrl: row acked tag=%u rows_left=%u", static_cast<unsigned>(response.cmd_id), static_cast<unsigned>(left->second));
+      return;
+    }
+    rows_left_.erase(left);
+  }
   completed.push(static_cast<SmeshRsTag>(response.cmd_id));
 
   trace("st_ctrl: completed tag=%u", static_cast<unsigned>(response.cmd_id));
 }
 
+void StCtrl::reset() {
+  dispatched_ = 0;
+  reads_accepted_ = 0;
+  writes_acked_ = 0;
+  spad_writes_acked_ = 0;
+  stats_acked_ = 0;
+  active_valid_ = false;
+  active_ = {};
+  base_laddr_ = {};
+  rows_ = 0;
+  cols_ = 0;
+  next_row_ = 0;
+  rows_left_.clear();
+  config_pending_ = false;
+  config_tag_ = 0;
+  act_ = 0;
+  relu6_shift_ = 0;
+  acc_scale_ = 0;
+  acc_scale_fixed_ = false;
+  dram_stride_ = 0;
+  channel_scale_.fill(0);
+  igelu_qb_ = 0;
+  igelu_qc_ = 0;
+  iexp_qln2_ = 0;
+  iexp_qln2_inv_ = 0;
+  norm_stats_id_ = 0;
+}
+
 } // namespace smesh
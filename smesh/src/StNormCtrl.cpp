@@ -22,18 +22,21 @@ Case 2/3: accumulator for this bank
 Accumulator data always goes toward the normalizer, but metadata only advances to write_scale_q when norm_cmd writes to main memory.  It writes to main memory when 3b norm_cmd sub-field in laddr field is set to 0 (RESET).  Note that this subfield can be set to other values (SUM, MEAN, VARIANCE, INV_STDDEV, MAX, SUM_EXP, INV_SUM_EXP) to indicate that the normalizer should consume the data to update stats, but not send any store-to-DRAM metadata onward.  Why do you collect stats? For normalization and activation operations on accumluator data.  For example, layer normalization (need mean, need variance / inverse stddev) and softmax (need max, need sum of exp, need inverse sum of exp) require statistics to be collected from the entire accumulator row before the normalization operation can be performed.  The normalizer consumes the data to update stats in its internal registers, but does not send any store-to-DRAM metadata onward until the stats have been collected and the norm_cmd is set to RESET.
 
 The name is confusing because RESET here effectively means: this is not one of the stats-collection phases; after this, reset/finish the norm state and let data continue.
+
+A stats-only row never reaches write_scale_q, so it only waits on the normalizer (whose reduction pipeline depth shows up as normalizer_cmd_rdy), not on scale_enq_rdy.  The Normalizer acknowledges it to StCtrl once reduced.
 */
 
 #include "StNormCtrl.hpp"
 
+#include "Normalizer.hpp"
+
 namespace smesh {
 
 namespace {
 
-constexpr std::uint32_t kNormCmdReset = 0;
 // check whether the norm_cmd subfield in laddr implies a store to main memory (i.e., norm_cmd == RESET)
 bool normCmdWritesToMainMemory(std::uint32_t norm_cmd) {
-  return norm_cmd == kNormCmdReset;
+  return norm_cmd == static_cast<std::uint32_t>(NormCmd::Reset);
 }
 
 } // namespace
@@ -84,24 +87,25 @@ void StNormCtrl::update() {
   }
   // CASE 2/3: accumulator for this bank 
   else if (targets_this_accum_bank) {
+    // only a row that goes on to main memory needs room in the scale queue
+    const bool scale_ok = !writes_to_main_memory || scale_enq_rdy != 0;
     // all relevant parts have valid data and room to consume
     const bool accum_move = norm_deq_val != 0 &&
                             accum_read_resp_val[acc_bank] != 0 &&
                             normalizer_cmd_rdy != 0 &&
-                            scale_enq_rdy != 0;
+                            scale_ok;
     // let valid norm metadata pop if there's valid accum data, normalizer is ready, and scale queue is ready
     next_norm_deq_rdy = accum_read_resp_val[acc_bank] != 0 &&
                         normalizer_cmd_rdy != 0 &&
-                        scale_enq_rdy != 0;
+                        scale_ok;
     // let normalizer consume if there's valid norm medatdata, valid accum data, and scale queue is ready
-    // (note: we don't necessarily have to wait for scale queue if norm_cmd != RESET, but we're too dumb to add this nuance)
     next_normalizer_cmd_val = norm_deq_val != 0 &&
                               accum_read_resp_val[acc_bank] != 0 &&
-                              scale_enq_rdy != 0;
+                              scale_ok;
     // let valid accum data pop if there's valid norm metadata, normalizer is ready, and scale queue is ready
     next_accum_read_resp_rdy = norm_deq_val != 0 &&
                                normalizer_cmd_rdy != 0 &&
-                               scale_enq_rdy != 0;
+                               scale_ok;
     // let scalue queue consume if all relevant parts have valid data and room to consume and norm_cmd subfield is RESET
     next_scale_enq_val = accum_move && writes_to_main_memory;
   }
@@ -49,7 +49,10 @@ void StReadCtrl::updateReadReq() {
   accum_req.laddr = laddr;
   accum_req.len = req.len;
   accum_req.act = req.acc_act;
+  accum_req.relu6_shift = req.acc_relu6_shift;
   accum_req.scale = req.acc_scale;
+  accum_req.scale_fixed = req.acc_scale_fixed;
+  accum_req.channel_scale = req.acc_channel_scale;
   accum_req.igelu_qb = req.acc_igelu_qb;
   accum_req.igelu_qc = req.acc_igelu_qc;
   accum_req.iexp_qln2 = req.acc_iexp_qln2;
@@ -0,0 +1,61 @@
+// **********************************************************************
+// smesh/src/Transposer.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Aug 6 2026
+
+#include "Transposer.hpp"
+
+#include <algorithm>
+
+namespace smesh {
+
+Transposer::Transposer(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(updateOut).writes(out_col_bits);
+  UPDATE(updateShift).reads(in_row_val, in_row_bits);
+}
+
+void Transposer::updateOut() {
+  MeshInputRow out{};
+  if (up_) {
+    out = regs_[0]; // top row
+  } else {
+    for (std::size_t row = 0; row < kDim; ++row) {
+      out[row] = regs_[row][0]; // left column
+    }
+  }
+  out_col_bits = out;
+}
+
+void Transposer::updateShift() {
+  if (Sim::state == Sim::SimResetting || in_row_val == 0) {
+    return;
+  }
+  const MeshInputRow in = *in_row_bits;
+  if (up_) {
+    std::copy(regs_.begin() + 1, regs_.end(), regs_.begin());
+    regs_[kDim - 1] = in;
+  } else {
+    for (std::size_t row = 0; row < kDim; ++row) {
+      auto& r = regs_[row];
+      std::copy(r.begin() + 1, r.end(), r.begin());
+      r[kDim - 1] = in[row];
+    }
+  }
+  ++rows_in_;
+  if (++counter_ == kDim) {
+    counter_ = 0;
+    up_      = !up_;
+    ++blocks_;
+  }
+}
+
+void Transposer::reset() {
+  regs_    = {};
+  up_      = false;
+  counter_ = 0;
+  rows_in_ = 0;
+  blocks_  = 0;
+  out_col_bits.reset(MeshInputRow{});
+}
+
+} // namespace smesh
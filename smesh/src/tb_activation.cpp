@@ -0,0 +1,85 @@
+// **********************************************************************
+// smesh/src/tb_activation.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Aug 26 2026
+/*
+Focused integer activation-kernel tests: ReLU/ReLU6 exactly, I-GELU and I-EXP
+against floating-point GELU/exp over a quantized input sweep.
+*/
+
+#include "Activation.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+
+constexpr double kScale = 1.0 / 64.0; // input quantization step S
+
+bool testRelu() {
+  smesh::ActivationParams params{};
+  params.relu6_shift = 4; // 1.0 == 16
+  const smesh::MeshAccumRow row{{-5, 0, 7, 200}};
+  const auto relu = smesh::activateRow(row, smesh::Activation::Relu, params);
+  const auto relu6 = smesh::activateRow(row, smesh::Activation::Relu6, params);
+  const auto none = smesh::activateRow(row, smesh::Activation::None, params);
+  return relu[0] == 0 && relu[1] == 0 && relu[2] == 7 && relu[3] == 200 &&
+         relu6[0] == 0 && relu6[2] == 7 && relu6[3] == 6 * 16 &&
+         none == row &&
+         smesh::decodeActivation(7) == smesh::Activation::None &&
+         smesh::decodeActivation(3) == smesh::Activation::IGelu;
+}
+
+bool testIGelu(double& worst) {
+  constexpr double a = -0.2888, b = -1.769;
+  const double s_erf_in = kScale / std::sqrt(2.0);
+  smesh::ActivationParams params{};
+  params.igelu_qb = static_cast<std::int32_t>(std::floor(b / s_erf_in));
+  params.igelu_qc = static_cast<std::int32_t>(std::floor(1.0 / (a * s_erf_in * s_erf_in)));
+  const double s_out = kScale * (a * s_erf_in * s_erf_in) / 2.0;
+
+  worst = 0.0;
+  for (int q = -6 * 64; q <= 6 * 64; ++q) {
+    const double x = q * kScale;
+    const double ref = 0.5 * x * (1.0 + std::erf(x / std::sqrt(2.0)));
+    const double got = smesh::activate(q, smesh::Activation::IGelu, params) * s_out;
+    worst = std::max(worst, std::fabs(got - ref));
+  }
+  return worst < 0.05;
+}
+
+bool testIExp(double& worst) {
+  constexpr double a = 0.3585, b = 1.353, c = 0.344;
+  smesh::ActivationParams params{};
+  params.igelu_qb = static_cast<std::int32_t>(std::floor(b / kScale));
+  params.igelu_qc = static_cast<std::int32_t>(std::floor(c / (a * kScale * kScale)));
+  params.iexp_qln2 = static_cast<std::int32_t>(std::floor(std::log(2.0) / kScale));
+  params.iexp_qln2_inv = static_cast<std::uint32_t>(std::lround(65536.0 / params.iexp_qln2));
+  const double s_out = a * kScale * kScale;
+
+  worst = 0.0;
+  for (int q = -10 * 64; q <= 0; ++q) {
+    const double ref = std::exp(q * kScale);
+    const double got = smesh::activate(q, smesh::Activation::IExp, params) * s_out;
+    worst = std::max(worst, std::fabs(got - ref));
+  }
+  // inputs above zero clamp to exp(0)
+  const bool clamped = smesh::activate(100, smesh::Activation::IExp, params) ==
+                       smesh::activate(0, smesh::Activation::IExp, params);
+  return worst < 0.02 && clamped;
+}
+
+} // namespace
+
+int main() {
+  double igelu_err = 0.0;
+  double iexp_err = 0.0;
+  const bool relu_ok = testRelu();
+  const bool igelu_ok = testIGelu(igelu_err);
+  const bool iexp_ok = testIExp(iexp_err);
+  std::printf("[ACTIVATION] %s relu_relu6\n", relu_ok ? "PASS" : "FAIL");
+  std::printf("[ACTIVATION] %s igelu max_abs_err=%.4f\n", igelu_ok ? "PASS" : "FAIL", igelu_err);
+  std::printf("[ACTIVATION] %s iexp max_abs_err=%.4f\n", iexp_ok ? "PASS" : "FAIL", iexp_err);
+  return relu_ok && igelu_ok && iexp_ok ? 0 : 1;
+}
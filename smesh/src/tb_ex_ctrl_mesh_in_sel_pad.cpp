@@ -2,7 +2,8 @@
 // smesh/src/tb_ex_ctrl_mesh_in_sel_pad.cpp
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 29 2026
-// Focused ExCtrlMeshInSelPad skeleton test.
+// Focused ExCtrlMeshInSelPad skeleton test. Only B actually read memory (A is
+// im2col, D preloads zeros), so only B's accum bank response is popped.
 
 #include <cascade/Cascade.hpp>
 #include <descore/Parameter.hpp>
@@ -50,6 +51,8 @@ class MeshInSelPadMonitor : public Component {
   Input(bit, mesh_a_fire);
   Input(bit, mesh_b_fire);
   Input(bit, mesh_d_fire);
+  InputArray(bit, spad_read_rdy, smesh::kSpBanks);
+  InputArray(bit, accum_read_rdy, smesh::kAccBanks);
 
   void update();
   void reset();
@@ -155,7 +158,8 @@ void MeshInSelPadDriver::reset() {
 MeshInSelPadMonitor::MeshInSelPadMonitor(std::string /*name*/, IMPL_CTOR) {
   UPDATE(update)
       .reads(mesh_a, mesh_b, mesh_d, mesh_a_val, mesh_b_val, mesh_d_val)
-      .reads(mesh_a_fire, mesh_b_fire, mesh_d_fire);
+      .reads(mesh_a_fire, mesh_b_fire, mesh_d_fire)
+      .reads(spad_read_rdy, accum_read_rdy);
 }
 
 void MeshInSelPadMonitor::update() {
@@ -166,7 +170,15 @@ void MeshInSelPadMonitor::update() {
   const auto a = *mesh_a;
   const auto b = *mesh_b;
   const auto d = *mesh_d;
+  bool pops_ok = true;
+  for (std::size_t bank = 0; bank < smesh::kSpBanks; ++bank) {
+    pops_ok = pops_ok && spad_read_rdy[bank] == 0;
+  }
+  for (std::size_t bank = 0; bank < smesh::kAccBanks; ++bank) {
+    pops_ok = pops_ok && (accum_read_rdy[bank] != 0) == (bank == 1);
+  }
   passed_ =
+      pops_ok &&
       a.data == smesh::MeshInputRow{static_cast<smesh::Elem>(0x55), static_cast<smesh::Elem>(0x66), static_cast<smesh::Elem>(0x77), 0} &&
       b.data == smesh::MeshInputRow{static_cast<smesh::Elem>(0x02), static_cast<smesh::Elem>(0x21), 0, 0} &&
       d.data == smesh::MeshInputRow{} &&
@@ -220,6 +232,12 @@ int main(int argc, char* argv[]) {
   monitor.mesh_a_fire << sel_pad.mesh_a_fire;
   monitor.mesh_b_fire << sel_pad.mesh_b_fire;
   monitor.mesh_d_fire << sel_pad.mesh_d_fire;
+  for (std::size_t bank = 0; bank < smesh::kSpBanks; ++bank) {
+    monitor.spad_read_rdy[bank] << sel_pad.spad_read_rdy[bank];
+  }
+  for (std::size_t bank = 0; bank < smesh::kAccBanks; ++bank) {
+    monitor.accum_read_rdy[bank] << sel_pad.accum_read_rdy[bank];
+  }
 
   Clock clk;
   driver.clk << clk;
@@ -0,0 +1,343 @@
+// **********************************************************************
+// smesh/src/tb_ex_ctrl_overlap.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Aug 20 2026
+// Preload/compute overlap benchmark. Two ExCtrl rigs, each on its own Spad and
+// Accum, run the same chain of kMatmuls WS matmuls (PRELOAD weights into C,
+// then COMPUTE) side by side:
+//   overlap : COMPUTE k and PRELOAD k+1 issue together as one mul_pre operation
+//   serial  : every PRELOAD and COMPUTE issues on its own
+// Each rig reports the cycles from its first command to its last completion and
+// the mesh utilization, i.e. compute row-beats per cycle. Both rigs start from
+// the same nonzero A and weights, so every C block must hold A * W; the
+// overlapped chain must also finish every tag and beat the serial one.
+
+#include <cascade/Cascade.hpp>
+#include <descore/Parameter.hpp>
+
+#include "Accum.hpp"
+#include "ExCtrl.hpp"
+#include "SmeshCommand.hpp"
+#include "Spad.hpp"
+
+#include <array>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kMatmuls = 8;
+constexpr smesh::SmeshRsTag kConfigTag = 1;
+
+using Block = std::array<smesh::Spad::Row, smesh::kDim>;
+
+// signed, nonzero operands so a dropped, reordered or transposed row shows up in C
+Block operandA() {
+  Block a{};
+  for (std::size_t r = 0; r < smesh::kDim; ++r) {
+    for (std::size_t k = 0; k < smesh::kDim; ++k) {
+      a[r][k] = static_cast<smesh::Elem>((r % 2 == 0 ? 1 : -1) * static_cast<int>(r + 2 * k + 1));
+    }
+  }
+  return a;
+}
+
+Block operandW() {
+  Block w{};
+  for (std::size_t k = 0; k < smesh::kDim; ++k) {
+    for (std::size_t c = 0; c < smesh::kDim; ++c) {
+      w[k][c] = static_cast<smesh::Elem>(static_cast<int>(3 * k) - static_cast<int>(2 * c) + 1);
+    }
+  }
+  return w;
+}
+
+smesh::Accum::Row productRow(const Block& a, const Block& w, std::size_t r) {
+  smesh::Accum::Row out{};
+  for (std::size_t c = 0; c < smesh::kDim; ++c) {
+    for (std::size_t k = 0; k < smesh::kDim; ++k) {
+      out[c] += static_cast<smesh::Acc>(a[r][k]) * static_cast<smesh::Acc>(w[k][c]);
+    }
+  }
+  return out;
+}
+
+smesh::SmeshIssue makeIssue(smesh::SmeshRsTag tag, smesh::SmeshFunct funct, std::uint64_t rs1, std::uint64_t rs2) {
+  smesh::SmeshIssue out{};
+  out.rs_tag_valid = 1;
+  out.rs_tag       = tag;
+  out.cmd.funct    = static_cast<std::uint32_t>(funct);
+  out.cmd.rs1      = rs1;
+  out.cmd.rs2      = rs2;
+  return out;
+}
+
+// A in Spad bank 0, weights in Spad bank 1, C blocks rotating through Accum
+std::vector<smesh::SmeshIssue> buildProgram() {
+  const auto dim = static_cast<std::uint32_t>(smesh::kDim);
+  const smesh::MatrixShape block{dim, dim};
+  std::vector<smesh::SmeshIssue> program;
+  program.push_back(makeIssue(kConfigTag, smesh::SmeshFunct::Config,
+                              smesh::packConfigExecuteRs1(1), smesh::packConfigExecuteRs2(1)));
+  for (std::uint32_t k = 0; k < kMatmuls; ++k) {
+    const auto weights = smesh::makeSpAddr(static_cast<std::uint32_t>(smesh::kSpBankRows));
+    const auto c_block = smesh::makeAccAddr((k * dim) % static_cast<std::uint32_t>(smesh::kAccRows));
+    program.push_back(makeIssue(static_cast<smesh::SmeshRsTag>(2 + 2 * k), smesh::SmeshFunct::Preload,
+                                smesh::packLocal(weights, block), smesh::packLocal(c_block, block)));
+    program.push_back(makeIssue(static_cast<smesh::SmeshRsTag>(3 + 2 * k), smesh::SmeshFunct::ComputeFlip,
+                                smesh::packLocal(smesh::makeSpAddr(0), block),
+                                smesh::packLocal(smesh::makeGarbageAddr(), block)));
+  }
+  return program;
+}
+
+} // namespace
+
+class MatmulChain : public Component {
+  DECLARE_COMPONENT(MatmulChain);
+
+ public:
+  MatmulChain(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+  FifoOutput(smesh::SmeshIssue, issue_out);
+  Input(bit, completed_val);
+  Input(smesh::SmeshRsTag, completed_bits);
+
+  void updateIssue();
+  void updateCompleted();
+  void reset();
+
+  bool done() const { return completions_ == program_.size(); }
+  bool matched() const { return matched_; }
+  std::uint64_t cycles() const { return last_cycle_ - first_cycle_ + 1; }
+
+ private:
+  const std::vector<smesh::SmeshIssue> program_ = buildProgram();
+  std::vector<bool> seen_ = std::vector<bool>(2 + 2 * kMatmuls, false);
+  std::size_t next_issue_  = 0;
+  std::size_t completions_ = 0;
+  std::uint64_t cycle_       = 0;
+  std::uint64_t first_cycle_ = 0;
+  std::uint64_t last_cycle_  = 0;
+  bool matched_ = true;
+};
+
+// Ties off the ports a chain that only reads Spad and writes Accum leaves idle.
+class LocalTieOff : public Component {
+  DECLARE_COMPONENT(LocalTieOff);
+
+ public:
+  LocalTieOff(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+  Output(bit, zero);
+  Output(bit, one);
+  Output(smesh::AccumReadReq, accum_read_req);
+  Output(smesh::ExCtrlAccumReadResp, accum_read_resp);
+
+  void update();
+  void reset();
+};
+
+MatmulChain::MatmulChain(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(updateIssue).writes(issue_out);
+  UPDATE(updateCompleted).reads(completed_val, completed_bits);
+}
+
+void MatmulChain::updateIssue() {
+  if (Sim::state == Sim::SimResetting) {
+    return;
+  }
+  ++cycle_;
+  if (next_issue_ >= program_.size() || issue_out.full()) {
+    return;
+  }
+  if (next_issue_ == 0) {
+    first_cycle_ = cycle_;
+  }
+  issue_out.push(program_[next_issue_]);
+  ++next_issue_;
+}
+
+void MatmulChain::updateCompleted() {
+  if (Sim::state == Sim::SimResetting || completed_val == 0) {
+    return;
+  }
+  const auto tag = static_cast<std::size_t>(*completed_bits);
+  if (tag >= seen_.size() || tag == 0 || seen_[tag]) {
+    matched_ = false;
+    return;
+  }
+  seen_[tag] = true;
+  ++completions_;
+  last_cycle_ = cycle_;
+}
+
+void MatmulChain::reset() {
+  seen_.assign(seen_.size(), false);
+  next_issue_  = 0;
+  completions_ = 0;
+  cycle_       = 0;
+  first_cycle_ = 0;
+  last_cycle_  = 0;
+  matched_     = true;
+}
+
+LocalTieOff::LocalTieOff(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(update).writes(zero, one, accum_read_req, accum_read_resp);
+}
+
+void LocalTieOff::update() {
+  zero = 0;
+  one  = 1;
+  accum_read_req  = smesh::AccumReadReq{};
+  accum_read_resp = smesh::ExCtrlAccumReadResp{};
+}
+
+void LocalTieOff::reset() {
+  zero.reset(0);
+  one.reset(1);
+  accum_read_req.reset(smesh::AccumReadReq{});
+  accum_read_resp.reset(smesh::ExCtrlAccumReadResp{});
+}
+
+namespace {
+
+struct Rig {
+  explicit Rig(const std::string& name)
+      : chain(name + "Chain"), ctrl(name + "ExCtrl"), spad(name + "Spad"), accum(name + "Accum"), tie(name + "TieOff") {}
+
+  MatmulChain    chain;
+  smesh::ExCtrl  ctrl;
+  smesh::Spad    spad;
+  smesh::Accum   accum;
+  LocalTieOff    tie;
+
+  void connect(Clock& clk) {
+    ctrl.cmd_in          << chain.issue_out;
+    chain.completed_val  << ctrl.completed_val;
+    chain.completed_bits << ctrl.completed_bits;
+    ctrl.cmd_in.setDelay(1);
+
+    for (std::size_t bank = 0; bank < smesh::kSpBanks; ++bank) {
+      spad.read_req_val_bnk[bank]   << ctrl.spad_read_req_val[bank];
+      spad.read_req_bits_bnk[bank]  << ctrl.spad_read_req_bits[bank];
+      ctrl.spad_read_req_rdy[bank]  << spad.read_req_rdy_bnk[bank];
+      ctrl.spad_read_resp_val[bank]  << spad.read_resp_val_bnk[bank];
+      ctrl.spad_read_resp_bits[bank] << spad.read_resp_bits_bnk[bank];
+      spad.read_resp_rdy_bnk[bank]  << ctrl.spad_read_resp_rdy[bank];
+      spad.write_val_bnk[bank]      << ctrl.spad_write_val[bank];
+      spad.write_bits_bnk[bank]     << ctrl.spad_write_bits[bank];
+      ctrl.spad_write_rdy[bank]     << spad.write_rdy_bnk[bank];
+    }
+    for (std::size_t bank = 0; bank < smesh::kAccBanks; ++bank) {
+      accum.write_val_bnk[bank]      << ctrl.accum_write_val[bank];
+      accum.write_bits_bnk[bank]     << ctrl.accum_write_bits[bank];
+      ctrl.accum_write_rdy[bank]     << accum.write_rdy_bnk[bank];
+      accum.read_req_val_bnk[bank]   << tie.zero;
+      accum.read_req_bits_bnk[bank]  << tie.accum_read_req;
+      accum.read_resp_rdy_bnk[bank]  << tie.zero;
+      ctrl.accum_read_req_rdy[bank]  << tie.one;
+      ctrl.accum_read_resp_val[bank]  << tie.zero;
+      ctrl.accum_read_resp_bits[bank] << tie.accum_read_resp;
+    }
+    spad.dma_resp.sendToBitBucket();
+    accum.dma_resp.sendToBitBucket();
+
+    chain.clk << clk;
+    ctrl.clk  << clk;
+    spad.clk  << clk;
+    accum.clk << clk;
+    tie.clk   << clk;
+  }
+
+  // A at Spad row 0, weights at the first row of bank 1, as buildProgram() reads them
+  void seed(const Block& a, const Block& w) {
+    for (std::size_t r = 0; r < smesh::kDim; ++r) {
+      spad.loadRowForTest(smesh::makeSpAddr(static_cast<std::uint32_t>(r)), a[r]);
+      spad.loadRowForTest(smesh::makeSpAddr(static_cast<std::uint32_t>(smesh::kSpBankRows + r)), w[r]);
+    }
+  }
+
+  // every matmul's C block must equal A * W
+  bool productMatches(const Block& a, const Block& w) const {
+    const auto dim = static_cast<std::uint32_t>(smesh::kDim);
+    bool ok = true;
+    for (std::uint32_t k = 0; k < kMatmuls; ++k) {
+      const auto base = (k * dim) % static_cast<std::uint32_t>(smesh::kAccRows);
+      for (std::uint32_t r = 0; r < dim; ++r) {
+        ok = ok && accum.row(smesh::makeAccAddr(base + r)) == productRow(a, w, r);
+      }
+    }
+    return ok;
+  }
+
+  double utilization() const {
+    return static_cast<double>(kMatmuls * smesh::kDim) / static_cast<double>(chain.cycles());
+  }
+
+  void report(const char* label) {
+    std::printf("  %-7s cycles=%4llu mesh_row_beats=%3llu compute_utilization=%.2f acc_rows=%llu\n",
+                label,
+                static_cast<unsigned long long>(chain.cycles()),
+                static_cast<unsigned long long>(ctrl.mesher().rowBeats()),
+                utilization(),
+                static_cast<unsigned long long>(ctrl.writeback().accRowsWritten()));
+  }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  descore::parseTraces(argc, argv);
+  Parameter::parseCommandLine(argc, argv);
+  Sim::parseDumps(argc, argv);
+
+  Rig overlap("Overlap");
+  Rig serial("Serial");
+  overlap.ctrl.setPreloadOverlap(true);
+  serial.ctrl.setPreloadOverlap(false);
+
+  Clock clk;
+  overlap.connect(clk);
+  serial.connect(clk);
+  clk.generateClock();
+
+  Cascade::params.MaxResetIterations = 1;
+  Sim::init();
+  Sim::reset();
+  const Block a = operandA();
+  const Block w = operandW();
+  overlap.seed(a, w);
+  serial.seed(a, w);
+  for (int i = 0; i < 2000 && !(overlap.chain.done() && serial.chain.done()); ++i) {
+    Sim::run();
+  }
+
+  const std::uint64_t c_rows = kMatmuls * smesh::kDim;
+  std::printf("[EX_CTRL_OVERLAP] %zu WS matmuls of %zux%zu\n", kMatmuls, smesh::kDim, smesh::kDim);
+  overlap.report("overlap");
+  serial.report("serial");
+
+  const bool complete = overlap.chain.done() && overlap.chain.matched() &&
+                        serial.chain.done() && serial.chain.matched();
+  const bool written = overlap.ctrl.writeback().accRowsWritten() == c_rows &&
+                       serial.ctrl.writeback().accRowsWritten() == c_rows;
+  const bool product = overlap.productMatches(a, w) && serial.productMatches(a, w);
+  const bool faster = complete && overlap.chain.cycles() < serial.chain.cycles();
+  if (complete) {
+    std::printf("  speedup=%.2fx\n",
+                static_cast<double>(serial.chain.cycles()) / static_cast<double>(overlap.chain.cycles()));
+  }
+
+  if (!product) {
+    std::printf("  c_matches overlap=%u serial=%u\n",
+                overlap.productMatches(a, w) ? 1u : 0u,
+                serial.productMatches(a, w) ? 1u : 0u);
+  }
+
+  const bool ok = complete && written && product && faster;
+  std::printf("[EX_CTRL_OVERLAP] %s preload_overlap\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -2,15 +2,47 @@
 // smesh/src/tb_ex_ctrl_read_priority.cpp
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 28 2026
-// Focused ExCtrlReadPriority skeleton test.
+// Focused ExCtrlReadPriority lockstep and bank-conflict test.
 
 #include <cascade/Cascade.hpp>
 #include <descore/Parameter.hpp>
 
 #include "ExCtrlReadPriority.hpp"
 
+#include <array>
 #include <cstdio>
 
+namespace {
+
+struct PriorityCase {
+  const char*   name;
+  std::uint32_t a_row, b_row, d_row;          // Spad rows (4 rows per bank)
+  std::uint32_t a_count, b_count, d_count;    // fire counters
+  bool          a_started, b_started, d_started;
+  bool          a_valid, b_valid, d_valid;    // expected grants
+};
+
+// A has priority over B over D; a stream waits for laggards and for a
+// higher-priority stream that wants its bank for the same row
+const std::array<PriorityCase, 4> kCases{{
+    {"bank_conflict", 0, 1, 2,  0, 0, 0,  false, false, false,  true,  false, false},
+    {"banks_apart",   0, 4, 8,  0, 0, 0,  false, false, false,  true,  true,  true},
+    {"a_ahead",       1, 4, 8,  1, 0, 0,  true,  true,  true,   false, true,  true},
+    {"d_done",        0, 4, 8,  0, 0, 0,  false, false, true,   true,  true,  false},
+}};
+
+smesh::ExCtrlOperand makeOperand(std::uint32_t row, std::uint32_t counter, bool started, std::uint8_t priority) {
+  smesh::ExCtrlOperand op{};
+  op.addr = smesh::makeSpAddr(row);
+  op.start_inputting = 1;
+  op.counter = counter;
+  op.started = bit(started);
+  op.priority = priority;
+  return op;
+}
+
+} // namespace
+
 class ReadPriorityDriver : public Component {
   DECLARE_COMPONENT(ReadPriorityDriver);
 
@@ -24,9 +56,13 @@ class ReadPriorityDriver : public Component {
   Output(u32, total_rows);
   Output(bit, im2col_wire);
   Output(bit, im2col_en);
+  Output(u8, case_index);
 
   void update();
   void reset();
+
+ private:
+  std::size_t step_ = 0;
 };
 
 class ReadPriorityMonitor : public Component {
@@ -39,6 +75,7 @@ class ReadPriorityMonitor : public Component {
   Input(bit, a_valid);
   Input(bit, b_valid);
   Input(bit, d_valid);
+  Input(u8, case_index);
 
   void update();
   void reset();
@@ -47,64 +84,69 @@ class ReadPriorityMonitor : public Component {
   bool passed() const { return passed_; }
 
  private:
-  bool checked_ = false;
+  std::size_t checked_ = 0;
   bool done_ = false;
   bool passed_ = false;
 };
 
 ReadPriorityDriver::ReadPriorityDriver(std::string /*name*/, IMPL_CTOR) {
-  UPDATE(update).writes(a_operand, b_operand, d_operand, total_rows, im2col_wire, im2col_en);
+  UPDATE(update).writes(a_operand, b_operand, d_operand, total_rows, im2col_wire, im2col_en, case_index);
 }
 
 void ReadPriorityDriver::update() {
-  smesh::ExCtrlOperand a{};
-  a.addr = smesh::makeSpAddr(0);
-  a.start_inputting = 1;
-  a.priority = 0;
-
-  smesh::ExCtrlOperand b{};
-  b.addr = smesh::makeSpAddr(1);
-  b.start_inputting = 1;
-  b.priority = 1;
-
-  smesh::ExCtrlOperand d{};
-  d.addr = smesh::makeSpAddr(2);
-  d.start_inputting = 1;
-  d.priority = 2;
-
-  a_operand = a;
-  b_operand = b;
-  d_operand = d;
+  const auto& c = kCases[step_ < kCases.size() ? step_ : kCases.size() - 1];
+  a_operand = makeOperand(c.a_row, c.a_count, c.a_started, 0);
+  b_operand = makeOperand(c.b_row, c.b_count, c.b_started, 1);
+  d_operand = makeOperand(c.d_row, c.d_count, c.d_started, 2);
   total_rows = 4;
   im2col_wire = 0;
   im2col_en = 0;
+  case_index = static_cast<std::uint8_t>(step_);
+  if (Sim::state != Sim::SimResetting && step_ < kCases.size()) {
+    ++step_;
+  }
 }
 
 void ReadPriorityDriver::reset() {
+  step_ = 0;
   a_operand.reset(smesh::ExCtrlOperand{});
   b_operand.reset(smesh::ExCtrlOperand{});
   d_operand.reset(smesh::ExCtrlOperand{});
   total_rows.reset(0);
   im2col_wire.reset(0);
   im2col_en.reset(0);
+  case_index.reset(0);
 }
 
 ReadPriorityMonitor::ReadPriorityMonitor(std::string /*name*/, IMPL_CTOR) {
-  UPDATE(update).reads(a_valid, b_valid, d_valid);
+  UPDATE(update).reads(a_valid, b_valid, d_valid, case_index);
 }
 
 void ReadPriorityMonitor::update() {
-  if (Sim::state == Sim::SimResetting || checked_) {
+  if (Sim::state == Sim::SimResetting || done_) {
     return;
   }
 
-  passed_ = a_valid == 0 && b_valid == 0 && d_valid == 0;
-  checked_ = true;
-  done_ = true;
+  const auto& c = kCases[static_cast<std::size_t>(*case_index) % kCases.size()];
+  const bool ok = (a_valid != 0) == c.a_valid &&
+                  (b_valid != 0) == c.b_valid &&
+                  (d_valid != 0) == c.d_valid;
+  if (!ok) {
+    std::printf("[EX_CTRL_READ_PRIORITY] %s: got a=%u b=%u d=%u\n", c.name,
+                static_cast<unsigned>(a_valid), static_cast<unsigned>(b_valid),
+                static_cast<unsigned>(d_valid));
+    done_ = true;
+    return;
+  }
+  ++checked_;
+  if (checked_ == kCases.size()) {
+    passed_ = true;
+    done_ = true;
+  }
 }
 
 void ReadPriorityMonitor::reset() {
-  checked_ = false;
+  checked_ = 0;
   done_ = false;
   passed_ = false;
 }
@@ -128,6 +170,7 @@ int main(int argc, char* argv[]) {
   monitor.a_valid << priority.a_valid;
   monitor.b_valid << priority.b_valid;
   monitor.d_valid << priority.d_valid;
+  monitor.case_index << driver.case_index;
 
   Clock clk;
   driver.clk << clk;
@@ -138,11 +181,11 @@ int main(int argc, char* argv[]) {
   Cascade::params.MaxResetIterations = 1;
   Sim::init();
   Sim::reset();
-  for (int i = 0; i < 4 && !monitor.done(); ++i) {
+  for (int i = 0; i < 8 && !monitor.done(); ++i) {
     Sim::run();
   }
 
   const bool ok = monitor.done() && monitor.passed();
-  std::printf("[EX_CTRL_READ_PRIORITY] %s skeleton\n", ok ? "PASS" : "FAIL");
+  std::printf("[EX_CTRL_READ_PRIORITY] %s lockstep\n", ok ? "PASS" : "FAIL");
   return ok ? 0 : 1;
 }
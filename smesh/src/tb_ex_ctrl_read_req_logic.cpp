@@ -2,7 +2,8 @@
 // smesh/src/tb_ex_ctrl_read_req_logic.cpp
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 28 2026
-// Focused ExCtrlReadReqLogic skeleton test.
+// Focused ExCtrlReadReqLogic test: A and B read two different spad banks and D an
+// accum bank in the same beat; B's bank refuses, which stalls only B.
 
 #include <cascade/Cascade.hpp>
 #include <descore/Parameter.hpp>
@@ -62,6 +63,8 @@ class ReadReqLogicMonitor : public Component {
   Input(bit, d_ready);
   InputArray(bit, spad_read_req_val, smesh::kSpBanks);
   InputArray(bit, accum_read_req_val, smesh::kAccBanks);
+  InputArray(smesh::SmeshLocalAddr, spad_read_req_addr, smesh::kSpBanks);
+  InputArray(bit, accum_read_req_from_dma, smesh::kAccBanks);
 
   void update();
   void reset();
@@ -111,7 +114,7 @@ void ReadReqLogicDriver::update() {
   start_inputting_b = 1;
   start_inputting_d = 1;
   a_address = smesh::makeSpAddr(0);
-  b_address = smesh::makeSpAddr(1);
+  b_address = smesh::makeSpAddr(static_cast<std::uint32_t>(smesh::kSpBankRows) + 1);
   d_address = smesh::makeAccAddr(0);
   a_valid = 1;
   b_valid = 1;
@@ -134,7 +137,7 @@ void ReadReqLogicDriver::update() {
   cntl_rdy = 1;
 
   for (std::size_t bank = 0; bank < smesh::kSpBanks; ++bank) {
-    spad_read_req_rdy[bank] = 1;
+    spad_read_req_rdy[bank] = bit(bank != 1); // B's bank is busy this beat
   }
   for (std::size_t bank = 0; bank < smesh::kAccBanks; ++bank) {
     accum_read_req_rdy[bank] = 1;
@@ -177,7 +180,9 @@ void ReadReqLogicDriver::reset() {
 }
 
 ReadReqLogicMonitor::ReadReqLogicMonitor(std::string /*name*/, IMPL_CTOR) {
-  UPDATE(update).reads(a_ready, b_ready, d_ready, spad_read_req_val, accum_read_req_val);
+  UPDATE(update)
+      .reads(a_ready, b_ready, d_ready, spad_read_req_val, accum_read_req_val)
+      .reads(spad_read_req_addr, accum_read_req_from_dma);
 }
 
 void ReadReqLogicMonitor::update() {
@@ -185,17 +190,21 @@ void ReadReqLogicMonitor::update() {
     return;
   }
 
-  bool no_spad_req = true;
+  // requests go out on every addressed bank; ready only drops for the refused stream
+  bool spad_ok = true;
   for (std::size_t bank = 0; bank < smesh::kSpBanks; ++bank) {
-    no_spad_req = no_spad_req && spad_read_req_val[bank] == 0;
+    spad_ok = spad_ok && (spad_read_req_val[bank] != 0) == (bank <= 1);
   }
-
-  bool no_accum_req = true;
+  bool accum_ok = true;
   for (std::size_t bank = 0; bank < smesh::kAccBanks; ++bank) {
-    no_accum_req = no_accum_req && accum_read_req_val[bank] == 0;
+    accum_ok = accum_ok && (accum_read_req_val[bank] != 0) == (bank == 0);
   }
 
-  passed_ = a_ready == 0 && b_ready == 0 && d_ready == 0 && no_spad_req && no_accum_req;
+  passed_ = a_ready != 0 && b_ready == 0 && d_ready != 0 &&
+            spad_ok && accum_ok &&
+            spad_read_req_addr[0]->raw == smesh::makeSpAddr(0).raw &&
+            spad_read_req_addr[1]->raw == smesh::makeSpAddr(static_cast<std::uint32_t>(smesh::kSpBankRows) + 1).raw &&
+            accum_read_req_from_dma[0] == 0;
   checked_ = true;
   done_ = true;
 }
@@ -243,10 +252,12 @@ int main(int argc, char* argv[]) {
   for (std::size_t bank = 0; bank < smesh::kSpBanks; ++bank) {
     logic.spad_read_req_rdy[bank] << driver.spad_read_req_rdy[bank];
     monitor.spad_read_req_val[bank] << logic.spad_read_req_val[bank];
+    monitor.spad_read_req_addr[bank] << logic.spad_read_req_addr[bank];
   }
   for (std::size_t bank = 0; bank < smesh::kAccBanks; ++bank) {
     logic.accum_read_req_rdy[bank] << driver.accum_read_req_rdy[bank];
     monitor.accum_read_req_val[bank] << logic.accum_read_req_val[bank];
+    monitor.accum_read_req_from_dma[bank] << logic.accum_read_req_from_dma[bank];
   }
 
   monitor.a_ready << logic.a_ready;
@@ -267,6 +278,6 @@ int main(int argc, char* argv[]) {
   }
 
   const bool ok = monitor.done() && monitor.passed();
-  std::printf("[EX_CTRL_READ_REQ_LOGIC] %s skeleton\n", ok ? "PASS" : "FAIL");
+  std::printf("[EX_CTRL_READ_REQ_LOGIC] %s per_bank_requests\n", ok ? "PASS" : "FAIL");
   return ok ? 0 : 1;
 }
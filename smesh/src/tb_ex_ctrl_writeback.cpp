@@ -2,15 +2,165 @@
 // smesh/src/tb_ex_ctrl_writeback.cpp
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 30 2026
-// Focused ExCtrlWriteback structural-boundary test.
+// Focused ExCtrlWriteback routing test. Six scripted matmuls drain through the
+// writeback, one response row per cycle:
+//   1) WS, tagged, accumulating into Accum rows 2..4 (3 of 4 rows, 2 of 4 cols)
+//   2) WS, untagged, into Spad bank 1 with stride 1 (saturated to int8)
+//   3) OS, tagged, into Accum rows 8.. with stride 2 (rows leave bottom first)
+//   4) garbage tag: no writes, no completion
+//   5) WS, ReLU6 with shift 4 (6.0 == 96), into Spad bank 0 (clamped, then saturated)
+//   6) WS, ReLU, into Accum rows 16..: partial sums stay linear
+// Each cycle's bank writes and completion are checked against the script.
 
 #include <cascade/Cascade.hpp>
 #include <descore/Parameter.hpp>
 
+#include "Activation.hpp"
 #include "ExCtrlDecoder.hpp"
 #include "ExCtrlWriteback.hpp"
 
+#include <algorithm>
 #include <cstdio>
+#include <vector>
+
+namespace {
+
+struct Step {
+  smesh::MesherResp resp{};
+  std::uint8_t  dataflow = smesh::kExDataflowWS;
+  std::uint32_t stride   = 1;
+  std::uint8_t  act      = 0;     // CONFIG_EX activation
+  std::uint8_t  relu6_shift = 0;
+  bool          write    = false; // some bank is written this cycle
+  bool          to_acc   = false;
+  smesh::SmeshLocalAddr addr{};   // expected write address
+  bool          complete = false;
+  smesh::SmeshRsTag tag  = 0;
+};
+
+smesh::MeshAccumRow rowData(std::int32_t base) {
+  smesh::MeshAccumRow row{};
+  for (std::size_t lane = 0; lane < smesh::kDim; ++lane) {
+    row[lane] = base + static_cast<std::int32_t>(lane) * 100;
+  }
+  return row;
+}
+
+smesh::ExCtrlMeshTag makeTag(bool rs_valid, smesh::SmeshRsTag rs_tag, smesh::SmeshLocalAddr addr,
+                             std::uint32_t rows, std::uint32_t cols) {
+  smesh::ExCtrlMeshTag tag{};
+  tag.rs_tag_valid = bit(rs_valid);
+  tag.rs_tag       = rs_tag;
+  tag.addr         = addr;
+  tag.rows         = rows;
+  tag.cols         = cols;
+  return tag;
+}
+
+std::vector<Step> buildScript() {
+  std::vector<Step> script;
+  const auto dim = static_cast<std::uint32_t>(smesh::kDim);
+
+  const auto acc_tag = makeTag(true, 7, smesh::makeAccAddr(2, true), 3, 2);
+  for (std::uint32_t r = 0; r < dim; ++r) {
+    Step s{};
+    s.resp.data = rowData(static_cast<std::int32_t>(10 * r));
+    s.resp.tag  = acc_tag;
+    s.resp.last = bit(r == dim - 1);
+    s.write     = r < 3;
+    s.to_acc    = true;
+    s.addr      = smesh::makeAccAddr(2 + r, true);
+    s.complete  = r == dim - 1;
+    s.tag       = 7;
+    script.push_back(s);
+  }
+
+  const auto sp_tag = makeTag(false, 0, smesh::makeSpAddr(static_cast<std::uint32_t>(smesh::kSpBankRows)), dim, dim);
+  for (std::uint32_t r = 0; r < dim; ++r) {
+    Step s{};
+    s.resp.data = rowData(r % 2 == 0 ? 300 : -300);
+    s.resp.tag  = sp_tag;
+    s.resp.last = bit(r == dim - 1);
+    s.write     = true;
+    s.addr      = smesh::makeSpAddr(static_cast<std::uint32_t>(smesh::kSpBankRows) + r);
+    script.push_back(s);
+  }
+
+  const auto os_tag = makeTag(true, 9, smesh::makeAccAddr(8), 2, dim);
+  for (std::uint32_t r = 0; r < dim; ++r) {
+    const std::uint32_t row = dim - 1 - r;
+    Step s{};
+    s.dataflow  = smesh::kExDataflowOS;
+    s.stride    = 2;
+    s.resp.data = rowData(static_cast<std::int32_t>(r));
+    s.resp.tag  = os_tag;
+    s.resp.last = bit(r == dim - 1);
+    s.write     = row < 2;
+    s.to_acc    = true;
+    s.addr      = smesh::makeAccAddr(8 + 2 * row);
+    s.complete  = r == dim - 1;
+    s.tag       = 9;
+    script.push_back(s);
+  }
+
+  smesh::ExCtrlMeshTag garbage{};
+  garbage.addr = smesh::makeGarbageAddr();
+  garbage.rows = dim;
+  garbage.cols = dim;
+  for (std::uint32_t r = 0; r < dim; ++r) {
+    Step s{};
+    s.resp.tag  = garbage;
+    s.resp.last = bit(r == dim - 1);
+    script.push_back(s);
+  }
+
+  const auto relu6_tag = makeTag(true, 11, smesh::makeSpAddr(0), dim, dim);
+  for (std::uint32_t r = 0; r < dim; ++r) {
+    Step s{};
+    s.act         = static_cast<std::uint8_t>(smesh::Activation::Relu6);
+    s.relu6_shift = 4;
+    s.resp.data   = rowData(r % 2 == 0 ? -150 : 20);
+    s.resp.tag    = relu6_tag;
+    s.resp.last   = bit(r == dim - 1);
+    s.write       = true;
+    s.addr        = smesh::makeSpAddr(r);
+    s.complete    = r == dim - 1;
+    s.tag         = 11;
+    script.push_back(s);
+  }
+
+  const auto relu_acc_tag = makeTag(false, 0, smesh::makeAccAddr(16), dim, dim);
+  for (std::uint32_t r = 0; r < dim; ++r) {
+    Step s{};
+    s.act       = static_cast<std::uint8_t>(smesh::Activation::Relu);
+    s.resp.data = rowData(-250);
+    s.resp.tag  = relu_acc_tag;
+    s.resp.last = bit(r == dim - 1);
+    s.write     = true;
+    s.to_acc    = true;
+    s.addr      = smesh::makeAccAddr(16 + r);
+    script.push_back(s);
+  }
+  return script;
+}
+// what the writeback should leave in a spad lane: activation, then int8 saturation
+smesh::Elem expectedSpad(const Step& step, smesh::Acc v) {
+  if (step.act == static_cast<std::uint8_t>(smesh::Activation::Relu) ||
+      step.act == static_cast<std::uint8_t>(smesh::Activation::Relu6)) {
+    v = std::max<smesh::Acc>(v, 0);
+  }
+  if (step.act == static_cast<std::uint8_t>(smesh::Activation::Relu6)) {
+    v = std::min<smesh::Acc>(v, 6 << step.relu6_shift);
+  }
+  return static_cast<smesh::Elem>(v > 127 ? 127 : (v < -128 ? -128 : v));
+}
+
+const std::vector<Step>& script() {
+  static const std::vector<Step> steps = buildScript();
+  return steps;
+}
+
+} // namespace
 
 class ExCtrlWritebackDriver : public Component {
   DECLARE_COMPONENT(ExCtrlWritebackDriver);
@@ -24,6 +174,7 @@ class ExCtrlWritebackDriver : public Component {
   Output(u8, current_dataflow);
   Output(u32, c_addr_stride);
   Output(u8, activation);
+  Output(u8, relu6_shift);
   Output(u32, aligned_to);
   Output(bit, ex_write_to_spad);
   Output(bit, ex_write_to_acc);
@@ -32,6 +183,9 @@ class ExCtrlWritebackDriver : public Component {
 
   void update();
   void reset();
+
+ private:
+  std::size_t step_ = 0;
 };
 
 class ExCtrlWritebackMonitor : public Component {
@@ -42,11 +196,14 @@ class ExCtrlWritebackMonitor : public Component {
 
   Clock(clk);
   InputArray(bit, spad_write_val, smesh::kSpBanks);
+  InputArray(smesh::DmaReadResp, spad_write_bits, smesh::kSpBanks);
   InputArray(bit, accum_write_val, smesh::kAccBanks);
+  InputArray(smesh::DmaReadResp, accum_write_bits, smesh::kAccBanks);
   Input(u32, output_counter);
   Input(bit, start_array_outputting);
   Input(bit, mesh_completed_rs_tag_fire);
   Input(bit, completed_val);
+  Input(smesh::SmeshRsTag, completed_bits);
 
   void update();
   void reset();
@@ -55,9 +212,11 @@ class ExCtrlWritebackMonitor : public Component {
   bool passed() const { return passed_; }
 
  private:
-  bool checked_ = false;
+  bool checkWrite(const Step& step) const;
+
+  std::size_t step_ = 0;
   bool done_ = false;
-  bool passed_ = false;
+  bool passed_ = true;
 };
 
 ExCtrlWritebackDriver::ExCtrlWritebackDriver(std::string /*name*/, IMPL_CTOR) {
@@ -67,6 +226,7 @@ ExCtrlWritebackDriver::ExCtrlWritebackDriver(std::string /*name*/, IMPL_CTOR) {
               current_dataflow,
               c_addr_stride,
               activation,
+              relu6_shift,
               aligned_to,
               ex_write_to_spad,
               ex_write_to_acc)
@@ -76,16 +236,12 @@ ExCtrlWritebackDriver::ExCtrlWritebackDriver(std::string /*name*/, IMPL_CTOR) {
 }
 
 void ExCtrlWritebackDriver::update() {
-  smesh::MesherResp resp{};
-  resp.tag.rs_tag_valid = 1;
-  resp.tag.rs_tag = 7;
-  resp.last = 1;
-
-  mesh_resp_val = 1;
-  mesh_resp_bits = resp;
+  mesh_resp_val = 0;
+  mesh_resp_bits = smesh::MesherResp{};
   current_dataflow = smesh::kExDataflowWS;
   c_addr_stride = 1;
   activation = 0;
+  relu6_shift = 0;
   aligned_to = 0;
   ex_write_to_spad = 1;
   ex_write_to_acc = 1;
@@ -95,14 +251,27 @@ void ExCtrlWritebackDriver::update() {
   for (std::size_t bank = 0; bank < smesh::kAccBanks; ++bank) {
     accum_write_rdy[bank] = 1;
   }
+  if (Sim::state == Sim::SimResetting || step_ >= script().size()) {
+    return;
+  }
+
+  const auto& step = script()[step_++];
+  mesh_resp_val = 1;
+  mesh_resp_bits = step.resp;
+  current_dataflow = step.dataflow;
+  c_addr_stride = step.stride;
+  activation = step.act;
+  relu6_shift = step.relu6_shift;
 }
 
 void ExCtrlWritebackDriver::reset() {
+  step_ = 0;
   mesh_resp_val.reset(0);
   mesh_resp_bits.reset(smesh::MesherResp{});
   current_dataflow.reset(smesh::kExDataflowWS);
   c_addr_stride.reset(1);
   activation.reset(0);
+  relu6_shift.reset(0);
   aligned_to.reset(0);
   ex_write_to_spad.reset(0);
   ex_write_to_acc.reset(0);
@@ -117,40 +286,85 @@ void ExCtrlWritebackDriver::reset() {
 ExCtrlWritebackMonitor::ExCtrlWritebackMonitor(std::string /*name*/, IMPL_CTOR) {
   UPDATE(update)
       .reads(spad_write_val,
+             spad_write_bits,
              accum_write_val,
+             accum_write_bits,
              output_counter,
-             start_array_outputting,
-             mesh_completed_rs_tag_fire,
-             completed_val);
+             start_array_outputting)
+      .reads(mesh_completed_rs_tag_fire,
+             completed_val,
+             completed_bits);
 }
+// exactly the expected bank fires, with the expected address, mask and data
+bool ExCtrlWritebackMonitor::checkWrite(const Step& step) const {
+  std::size_t writes = 0;
+  for (std::size_t bank = 0; bank < smesh::kSpBanks; ++bank) {
+    writes += spad_write_val[bank] != 0 ? 1 : 0;
+  }
+  for (std::size_t bank = 0; bank < smesh::kAccBanks; ++bank) {
+    writes += accum_write_val[bank] != 0 ? 1 : 0;
+  }
+  if (!step.write) {
+    return writes == 0 && start_array_outputting == 0;
+  }
+  if (writes != 1 || start_array_outputting == 0) {
+    return false;
+  }
 
-void ExCtrlWritebackMonitor::update() {
-  if (Sim::state == Sim::SimResetting || checked_) {
-    return;
+  const auto cols = std::min<std::uint32_t>(step.resp.tag.cols, static_cast<std::uint32_t>(smesh::kDim));
+  const auto mask = static_cast<std::uint8_t>((1u << cols) - 1u);
+  if (step.to_acc) {
+    const auto bank = step.addr.acc_bank();
+    if (accum_write_val[bank] == 0) {
+      return false;
+    }
+    const auto w = *accum_write_bits[bank];
+    bool ok = w.laddr.raw == step.addr.raw && w.mask == mask && w.has_acc_bitwidth != 0;
+    for (std::size_t lane = 0; lane < smesh::kDim; ++lane) {
+      std::uint32_t word = 0;
+      for (std::size_t byte = 0; byte < sizeof(smesh::Acc); ++byte) {
+        word |= static_cast<std::uint32_t>(w.data[lane * sizeof(smesh::Acc) + byte]) << (8 * byte);
+      }
+      ok = ok && static_cast<smesh::Acc>(word) == step.resp.data[lane];
+    }
+    return ok;
   }
 
-  bool no_writes = true;
-  for (std::size_t bank = 0; bank < smesh::kSpBanks; ++bank) {
-    no_writes = no_writes && spad_write_val[bank] == 0;
+  const auto bank = step.addr.sp_bank();
+  if (spad_write_val[bank] == 0) {
+    return false;
   }
-  for (std::size_t bank = 0; bank < smesh::kAccBanks; ++bank) {
-    no_writes = no_writes && accum_write_val[bank] == 0;
+  const auto w = *spad_write_bits[bank];
+  bool ok = w.laddr.raw == step.addr.raw && w.mask == mask && w.has_acc_bitwidth == 0;
+  for (std::size_t lane = 0; lane < smesh::kDim; ++lane) {
+    ok = ok && static_cast<smesh::Elem>(w.data[lane]) == expectedSpad(step, step.resp.data[lane]);
+  }
+  return ok;
+}
+
+void ExCtrlWritebackMonitor::update() {
+  if (Sim::state == Sim::SimResetting || done_) {
+    return;
   }
 
-  passed_ =
-      no_writes &&
-      output_counter == 0 &&
-      start_array_outputting == 0 &&
-      mesh_completed_rs_tag_fire == 0 &&
-      completed_val == 0;
-  checked_ = true;
-  done_ = true;
+  const auto& step = script()[step_];
+  const bool write_ok = checkWrite(step);
+  const bool completion_ok =
+      step.complete ? completed_val != 0 && mesh_completed_rs_tag_fire != 0 && *completed_bits == step.tag
+                    : completed_val == 0 && mesh_completed_rs_tag_fire == 0;
+  if (!write_ok || !completion_ok) {
+    std::printf("[EX_CTRL_WRITEBACK] step %zu: write_ok=%d completion_ok=%d counter=%u\n",
+                step_, write_ok ? 1 : 0, completion_ok ? 1 : 0, static_cast<unsigned>(output_counter));
+    passed_ = false;
+  }
+  ++step_;
+  done_ = step_ == script().size();
 }
 
 void ExCtrlWritebackMonitor::reset() {
-  checked_ = false;
+  step_ = 0;
   done_ = false;
-  passed_ = false;
+  passed_ = true;
 }
 
 int main(int argc, char* argv[]) {
@@ -167,22 +381,26 @@ int main(int argc, char* argv[]) {
   writeback.current_dataflow << driver.current_dataflow;
   writeback.c_addr_stride << driver.c_addr_stride;
   writeback.activation << driver.activation;
+  writeback.relu6_shift << driver.relu6_shift;
   writeback.aligned_to << driver.aligned_to;
   writeback.ex_write_to_spad << driver.ex_write_to_spad;
   writeback.ex_write_to_acc << driver.ex_write_to_acc;
   for (std::size_t bank = 0; bank < smesh::kSpBanks; ++bank) {
     writeback.spad_write_rdy[bank] << driver.spad_write_rdy[bank];
     monitor.spad_write_val[bank] << writeback.spad_write_val[bank];
+    monitor.spad_write_bits[bank] << writeback.spad_write_bits[bank];
   }
   for (std::size_t bank = 0; bank < smesh::kAccBanks; ++bank) {
     writeback.accum_write_rdy[bank] << driver.accum_write_rdy[bank];
     monitor.accum_write_val[bank] << writeback.accum_write_val[bank];
+    monitor.accum_write_bits[bank] << writeback.accum_write_bits[bank];
   }
 
   monitor.output_counter << writeback.output_counter;
   monitor.start_array_outputting << writeback.start_array_outputting;
   monitor.mesh_completed_rs_tag_fire << writeback.mesh_completed_rs_tag_fire;
   monitor.completed_val << writeback.completed_val;
+  monitor.completed_bits << writeback.completed_bits;
 
   Clock clk;
   driver.clk << clk;
@@ -193,11 +411,13 @@ int main(int argc, char* argv[]) {
   Cascade::params.MaxResetIterations = 1;
   Sim::init();
   Sim::reset();
-  for (int i = 0; i < 4 && !monitor.done(); ++i) {
+  for (std::size_t i = 0; i < script().size() + 4 && !monitor.done(); ++i) {
     Sim::run();
   }
 
-  const bool ok = monitor.done() && monitor.passed();
-  std::printf("[EX_CTRL_WRITEBACK] %s skeleton_boundary\n", ok ? "PASS" : "FAIL");
+  const bool ok = monitor.done() && monitor.passed() &&
+                  writeback.accRowsWritten() == 5 + smesh::kDim &&
+                  writeback.spadRowsWritten() == 2 * smesh::kDim;
+  std::printf("[EX_CTRL_WRITEBACK] %s routing_activation\n", ok ? "PASS" : "FAIL");
   return ok ? 0 : 1;
 }
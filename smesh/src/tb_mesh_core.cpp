@@ -2,11 +2,15 @@
 // smesh/src/tb_mesh_core.cpp
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Aug 01 2026
-// Focused plain-C++ MeshCore movement test.
+// Focused plain-C++ MeshCore movement test, plus a randomized check of step()
+// against a per-PE scalar reference. tb_mesh_core_wide builds this file at
+// kDim = 16 so the 8-lane AVX2/NEON row kernels are covered too.
 
 #include "MeshCore.hpp"
 
+#include <cstdint>
 #include <cstdio>
+#include <random>
 
 namespace {
 
@@ -35,6 +39,105 @@ smesh::MeshCoreStatusRow statusRow(const smesh::MeshCoreStatus& status) {
   return row;
 }
 
+// Per-PE model of one MeshCore cycle, written the plain way: read last cycle's
+// grids, build next-state grids, swap. Compared against MeshCore after every step.
+struct RefCore {
+  using InputGrid = smesh::MeshCore::InputGrid;
+  using AccumGrid = smesh::MeshCore::AccumGrid;
+  InputGrid c1{}, c2{}, a{}, d{}, last_prop{};
+  AccumGrid b{}, acc1{}, acc2{}, c{};
+  smesh::MeshCore::CtrlGrid   control{};
+  smesh::MeshCore::StatusGrid status{};
+
+  void step(const smesh::MeshCoreIn& in) {
+    RefCore next = *this;
+    for (std::size_t r = 0; r < smesh::kDim; ++r) {
+      for (std::size_t col = 0; col < smesh::kDim; ++col) {
+        const auto ctrl = r == 0 ? in.control[col] : control[r - 1][col];
+        const auto stat = r == 0 ? in.status[col] : status[r - 1][col];
+        const smesh::Elem a_in = col == 0 ? in.in_a[r] : a[r][col - 1];
+        const smesh::Acc  b_in = r == 0 ? in.in_b[col] : b[r - 1][col];
+        next.a[r][col]       = a_in;
+        next.control[r][col] = ctrl;
+        next.status[r][col]  = stat;
+        if (!stat.valid) {
+          continue;
+        }
+        if (ctrl.dataflow == smesh::kExDataflowOS) {
+          const smesh::Acc c_in = r == 0 ? static_cast<smesh::Acc>(in.in_d[col]) : c[r - 1][col];
+          const bool flip       = ctrl.prop != (last_prop[r][col] != 0);
+          auto& drain           = ctrl.prop ? next.acc1[r][col] : next.acc2[r][col];
+          auto& accum           = ctrl.prop ? next.acc2[r][col] : next.acc1[r][col];
+          next.c[r][col] = smesh::MeshCore::roundingShift(drain, flip ? ctrl.shift : 0);
+          drain          = c_in;
+          accum += static_cast<smesh::Acc>(a_in) * b_in;
+          next.b[r][col] = b_in;
+        } else {
+          const smesh::Elem d_in = r == 0 ? in.in_d[col] : d[r - 1][col];
+          const smesh::Elem w    = ctrl.prop ? c2[r][col] : c1[r][col];
+          next.b[r][col] = b_in + static_cast<smesh::Acc>(a_in) * static_cast<smesh::Acc>(w);
+          next.d[r][col] = ctrl.prop ? c1[r][col] : c2[r][col];
+          (ctrl.prop ? next.c1[r][col] : next.c2[r][col]) = d_in;
+        }
+        next.last_prop[r][col] = ctrl.prop ? smesh::Elem(-1) : smesh::Elem(0);
+      }
+    }
+    *this = next;
+  }
+};
+
+bool matchesRef(const smesh::MeshCore& core, const RefCore& ref) {
+  bool ok = core.c1() == ref.c1 && core.c2() == ref.c2 && core.aPath() == ref.a &&
+            core.bPath() == ref.b && core.dPath() == ref.d && core.acc1() == ref.acc1 &&
+            core.acc2() == ref.acc2 && core.cPath() == ref.c &&
+            core.outB() == ref.b[smesh::kDim - 1] && core.outC() == ref.c[smesh::kDim - 1];
+  for (std::size_t col = 0; col < smesh::kDim; ++col) {
+    ok = ok && core.outBStatus()[col].valid == ref.status[smesh::kDim - 1][col].valid &&
+         core.outBStatus()[col].in_id == ref.status[smesh::kDim - 1][col].in_id &&
+         core.outBControl()[col].prop == ref.control[smesh::kDim - 1][col].prop;
+  }
+  return ok;
+}
+// random operands, valid holes, prop flips and mixed WS/OS lanes; B inputs stay small
+// enough that the OS accumulators cannot overflow within kCycles
+bool randomEquivalence() {
+  constexpr std::size_t kCycles = 4000;
+  std::mt19937 rng(0x5eed);
+  std::uniform_int_distribution<int> elem(-128, 127);
+  std::uniform_int_distribution<int> bias(-1024, 1024);
+  std::uniform_int_distribution<int> pct(0, 99);
+  std::uniform_int_distribution<int> shift(0, 12);
+
+  smesh::MeshCore core;
+  core.reset();
+  RefCore ref;
+  bool prop = false;
+  for (std::size_t cycle = 0; cycle < kCycles; ++cycle) {
+    if (pct(rng) < 10) {
+      prop = !prop;
+    }
+    smesh::MeshCoreIn in{};
+    for (std::size_t lane = 0; lane < smesh::kDim; ++lane) {
+      in.in_a[lane]             = static_cast<smesh::Elem>(elem(rng));
+      in.in_b[lane]             = bias(rng);
+      in.in_d[lane]             = static_cast<smesh::Elem>(elem(rng));
+      in.control[lane].prop     = pct(rng) < 90 ? prop : !prop;
+      in.control[lane].dataflow = pct(rng) < 75 ? smesh::kExDataflowWS : smesh::kExDataflowOS;
+      in.control[lane].shift    = static_cast<std::uint8_t>(shift(rng));
+      in.status[lane].valid     = pct(rng) < 80;
+      in.status[lane].in_id     = static_cast<std::uint8_t>(cycle);
+      in.status[lane].in_last   = pct(rng) < 5;
+    }
+    core.step(in);
+    ref.step(in);
+    if (!matchesRef(core, ref)) {
+      std::printf("[MESH_CORE] random_equivalence dim=%zu: mismatch at cycle %zu\n", smesh::kDim, cycle);
+      return false;
+    }
+  }
+  return true;
+}
+
 } // namespace
 
 int main() {
@@ -92,5 +195,8 @@ int main() {
   ok = ok && rowEquals(core.outB(), smesh::MeshAccumRow{0, 0, 0, 0});
 
   std::printf("[MESH_CORE] %s ws_movement\n", ok ? "PASS" : "FAIL");
-  return ok ? 0 : 1;
+
+  const bool random_ok = randomEquivalence();
+  std::printf("[MESH_CORE] %s random_equivalence dim=%zu\n", random_ok ? "PASS" : "FAIL", smesh::kDim);
+  return ok && random_ok ? 0 : 1;
 }
@@ -0,0 +1,242 @@
+// **********************************************************************
+// smesh/src/tb_mesh_hull_dataflow.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Aug 05 2026
+// Same workload, both dataflows: C = A * B + D with A (M x K), B (K x kDim),
+// D (M x kDim) streamed through MeshHull back to back, full and transaction-level.
+// WS keeps kDim rows of B in the PEs and streams A rows; psums leave every pass
+// and are summed outside (one accumulator row write per row per pass).
+// OS keeps a kDim x kDim tile of C in the PEs and streams A columns and B rows;
+// D preloads through the C path and each tile drains once, bottom row first,
+// while the next tile computes. OS also runs with a rounding shift.
+
+#include "MeshHull.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kTiles = 2;
+constexpr std::size_t kM     = kTiles * smesh::kDim;
+constexpr std::size_t kK     = 3 * smesh::kDim;
+constexpr std::uint8_t kOsShift = 2;
+
+using Mat = std::vector<std::vector<int>>;
+
+struct Beat {
+  smesh::MeshInputRow a{};
+  smesh::MeshInputRow b{};
+  smesh::MeshInputRow d{};
+  bool prop = false;
+  std::uint8_t dataflow = smesh::kExDataflowWS;
+  std::uint8_t shift = 0;
+};
+
+struct Run {
+  std::vector<smesh::MeshAccumRow> rows; // one per beat, in beat order
+  int cycles = 0;
+};
+
+Mat randomMat(std::mt19937& rng, std::size_t rows, std::size_t cols, int span) {
+  Mat m(rows, std::vector<int>(cols));
+  for (auto& row : m) {
+    for (auto& v : row) {
+      v = static_cast<int>(rng() % (2 * span + 1)) - span;
+    }
+  }
+  return m;
+}
+
+smesh::MeshInputRow rowOf(const Mat& m, std::size_t r, std::size_t c0 = 0) {
+  smesh::MeshInputRow row{};
+  for (std::size_t i = 0; i < smesh::kDim; ++i) {
+    row[i] = static_cast<smesh::Elem>(m[r][c0 + i]);
+  }
+  return row;
+}
+
+// beat i's rows fire on step i and are used (not_paused) on step i+1
+Run runBeats(bool transaction_level, const std::vector<Beat>& beats) {
+  smesh::MeshHull hull;
+  hull.setTransactionLevel(transaction_level);
+  Run run{};
+  for (std::size_t s = 0; run.rows.size() < beats.size() && s < beats.size() + 8 * smesh::kDim; ++s) {
+    smesh::MeshHullIn in{};
+    if (s < beats.size()) {
+      in.a_fire = 1;
+      in.b_fire = 1;
+      in.d_fire = 1;
+      in.a_bits = beats[s].a;
+      in.b_bits = beats[s].b;
+      in.d_bits = beats[s].d;
+    }
+    if (s > 0 && s <= beats.size()) {
+      const auto& beat = beats[s - 1];
+      in.pe_control.dataflow  = u8(beat.dataflow);
+      in.pe_control.propagate = bit(beat.prop);
+      in.pe_control.shift     = u8(beat.shift);
+      in.not_paused = 1;
+    }
+    hull.step(in);
+    if (hull.out().resp_valid != 0) {
+      run.rows.push_back(hull.out().resp_data);
+    }
+    run.cycles = static_cast<int>(s + 1);
+  }
+  return run;
+}
+
+// WS: preload B chunk 0 through D, then per chunk stream all M rows of A; the
+// last kDim beats of a chunk load the next chunk into the idle weight set (it
+// shifts on every beat). D enters as the first pass's psum.
+std::vector<Beat> wsBeats(const Mat& a, const Mat& b, const Mat& d) {
+  constexpr std::size_t kChunks = kK / smesh::kDim;
+  std::vector<Beat> beats;
+  for (std::size_t j = 0; j < smesh::kDim; ++j) {
+    Beat beat{};
+    beat.d = rowOf(b, smesh::kDim - 1 - j);
+    beats.push_back(beat);
+  }
+  for (std::size_t t = 0; t < kChunks; ++t) {
+    for (std::size_t i = 0; i < kM; ++i) {
+      Beat beat{};
+      beat.prop = t % 2 == 0;
+      beat.a    = rowOf(a, i, t * smesh::kDim);
+      if (t == 0) {
+        beat.b = rowOf(d, i);
+      }
+      const std::size_t load = i + smesh::kDim - kM; // wraps for the beats before the preload window
+      if (t + 1 < kChunks && load < smesh::kDim) {
+        beat.d = rowOf(b, (t + 1) * smesh::kDim + smesh::kDim - 1 - load);
+      }
+      beats.push_back(beat);
+    }
+  }
+  return beats;
+}
+
+// OS: preload tile 0's D, then per tile stream K columns of A / rows of B; the
+// last kDim beats of a tile preload the next tile's D, the first kDim drain the last tile.
+std::vector<Beat> osBeats(const Mat& a, const Mat& b, const Mat& d, std::uint8_t shift) {
+  std::vector<Beat> beats;
+  auto osBeat = [shift](bool prop) {
+    Beat beat{};
+    beat.dataflow = smesh::kExDataflowOS;
+    beat.shift    = shift;
+    beat.prop     = prop;
+    return beat;
+  };
+  for (std::size_t j = 0; j < smesh::kDim; ++j) {
+    Beat beat = osBeat(false);
+    beat.d = rowOf(d, smesh::kDim - 1 - j);
+    beats.push_back(beat);
+  }
+  for (std::size_t t = 0; t < kTiles; ++t) {
+    for (std::size_t k = 0; k < kK; ++k) {
+      Beat beat = osBeat(t % 2 == 0);
+      for (std::size_t r = 0; r < smesh::kDim; ++r) {
+        beat.a[r] = static_cast<smesh::Elem>(a[t * smesh::kDim + r][k]);
+      }
+      beat.b = rowOf(b, k);
+      const std::size_t load = k + smesh::kDim - kK; // wraps for the beats before the preload window
+      if (t + 1 < kTiles && load < smesh::kDim) {
+        beat.d = rowOf(d, (t + 1) * smesh::kDim + smesh::kDim - 1 - load);
+      }
+      beats.push_back(beat);
+    }
+  }
+  for (std::size_t j = 0; j < smesh::kDim; ++j) {
+    beats.push_back(osBeat(kTiles % 2 == 0));
+  }
+  return beats;
+}
+
+bool checkWs(const Run& run, const Mat& expected, std::size_t& acc_row_writes) {
+  Mat acc(kM, std::vector<int>(smesh::kDim, 0));
+  acc_row_writes = 0;
+  for (std::size_t t = 0; t < kK / smesh::kDim; ++t) {
+    for (std::size_t i = 0; i < kM; ++i) {
+      const auto& row = run.rows[smesh::kDim + t * kM + i];
+      for (std::size_t c = 0; c < smesh::kDim; ++c) {
+        acc[i][c] += row[c];
+      }
+      ++acc_row_writes;
+    }
+  }
+  return acc == expected;
+}
+
+bool checkOs(const Run& run, const Mat& expected, std::uint8_t shift, std::size_t& acc_row_writes) {
+  bool ok = true;
+  acc_row_writes = 0;
+  for (std::size_t t = 0; t < kTiles; ++t) {
+    const std::size_t base = smesh::kDim + (t + 1) * kK;
+    for (std::size_t j = 0; j < smesh::kDim; ++j) {
+      const auto& row = run.rows[base + j];
+      const std::size_t i = t * smesh::kDim + smesh::kDim - 1 - j; // drains bottom row first
+      for (std::size_t c = 0; c < smesh::kDim; ++c) {
+        const double want = std::nearbyint(std::ldexp(static_cast<double>(expected[i][c]), -shift));
+        ok = ok && row[c] == static_cast<smesh::Acc>(want);
+      }
+      ++acc_row_writes;
+    }
+  }
+  return ok;
+}
+
+} // namespace
+
+int main() {
+  std::mt19937 rng(11);
+  const Mat a = randomMat(rng, kM, kK, 9);
+  const Mat b = randomMat(rng, kK, smesh::kDim, 9);
+  const Mat d = randomMat(rng, kM, smesh::kDim, 20);
+  Mat expected = d;
+  for (std::size_t i = 0; i < kM; ++i) {
+    for (std::size_t c = 0; c < smesh::kDim; ++c) {
+      for (std::size_t k = 0; k < kK; ++k) {
+        expected[i][c] += a[i][k] * b[k][c];
+      }
+    }
+  }
+
+  const auto ws_beats = wsBeats(a, b, d);
+  const auto os_beats = osBeats(a, b, d, 0);
+  const auto os_shift_beats = osBeats(a, b, d, kOsShift);
+
+  bool ok = true;
+  for (const bool tl : {false, true}) {
+    const Run ws = runBeats(tl, ws_beats);
+    const Run os = runBeats(tl, os_beats);
+    const Run os_shift = runBeats(tl, os_shift_beats);
+    std::size_t ws_acc_writes = 0;
+    std::size_t os_acc_writes = 0;
+    std::size_t unused = 0;
+    const bool ws_ok = ws.rows.size() == ws_beats.size() && checkWs(ws, expected, ws_acc_writes);
+    const bool os_ok = os.rows.size() == os_beats.size() && checkOs(os, expected, 0, os_acc_writes);
+    const bool shift_ok = os_shift.rows.size() == os_shift_beats.size() && checkOs(os_shift, expected, kOsShift, unused);
+    ok = ok && ws_ok && os_ok && shift_ok;
+    std::printf("  %s M=%zu K=%zu: ws beats=%zu cycles=%d b_rows=%zu acc_row_writes=%zu %s | "
+                "os beats=%zu cycles=%d b_rows=%zu acc_row_writes=%zu %s shift%u %s\n",
+                tl ? "tl  " : "full",
+                kM,
+                kK,
+                ws_beats.size(),
+                ws.cycles,
+                kK,
+                ws_acc_writes,
+                ws_ok ? "ok" : "BAD",
+                os_beats.size(),
+                os.cycles,
+                kTiles * kK,
+                os_acc_writes,
+                os_ok ? "ok" : "BAD",
+                static_cast<unsigned>(kOsShift),
+                shift_ok ? "ok" : "BAD");
+  }
+  std::printf("[MESH_HULL_DATAFLOW] %s ws_os_same_result\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
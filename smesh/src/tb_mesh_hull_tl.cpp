@@ -0,0 +1,97 @@
+// **********************************************************************
+// smesh/src/tb_mesh_hull_tl.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Aug 04 2026
+// MeshHull transaction-level mode against the full systolic model: both hulls see
+// the same randomized beats (pauses, prop flips, WS/OS switches and OS shifts,
+// transposer picks, id/last changes) and must agree on valid/last/id every cycle and on data whenever valid is set.
+
+#include "MeshHull.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+int main() {
+  constexpr int kSteps = 20000;
+
+  smesh::MeshHull full;
+  smesh::MeshHull tl;
+  full.reset();
+  tl.setTransactionLevel(true);
+
+  std::mt19937 rng(3);
+  bool prop = false;
+  bool os = false;
+  std::uint8_t matmul_id = 0;
+  int valid_rows = 0;
+  int mismatches = 0;
+  double full_sec = 0.0;
+  double tl_sec = 0.0;
+
+  for (int cycle = 0; cycle < kSteps; ++cycle) {
+    smesh::MeshHullIn in{};
+    in.a_fire = bit(rng() % 4 != 0);
+    in.b_fire = bit(rng() % 3 == 0);
+    in.d_fire = bit(rng() % 2 != 0);
+    for (std::size_t i = 0; i < smesh::kDim; ++i) {
+      in.a_bits[i] = static_cast<smesh::Elem>(rng());
+      in.b_bits[i] = static_cast<smesh::Elem>(rng());
+      in.d_bits[i] = static_cast<smesh::Elem>(rng());
+      in.transposer_out_col_bits[i] = static_cast<smesh::Elem>(rng());
+    }
+    in.a_is_from_transposer = bit(rng() % 8 == 0);
+    in.d_is_from_transposer = bit(rng() % 8 == 0);
+    if (rng() % 23 == 0) {
+      prop = !prop;
+    }
+    if (rng() % 17 == 0) {
+      matmul_id = static_cast<std::uint8_t>((matmul_id + 1) & 7u);
+    }
+    if (rng() % 97 == 0) {
+      os = !os;
+    }
+    in.pe_control.dataflow  = u8(os ? smesh::kExDataflowOS : smesh::kExDataflowWS);
+    in.pe_control.propagate = bit(prop);
+    in.pe_control.shift     = u8(static_cast<std::uint8_t>(rng() % 4));
+    in.matmul_id  = matmul_id;
+    in.last_fire  = bit(rng() % 5 == 0);
+    in.not_paused = bit(rng() % 6 != 0);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    full.step(in);
+    const auto t1 = std::chrono::steady_clock::now();
+    tl.step(in);
+    const auto t2 = std::chrono::steady_clock::now();
+    full_sec += std::chrono::duration<double>(t1 - t0).count();
+    tl_sec   += std::chrono::duration<double>(t2 - t1).count();
+
+    const auto& want = full.out();
+    const auto& got  = tl.out();
+    bool ok = want.resp_valid == got.resp_valid &&
+              want.resp_last == got.resp_last &&
+              want.out_matmul_id == got.out_matmul_id;
+    if (want.resp_valid != 0) {
+      ++valid_rows;
+      ok = ok && want.resp_data == got.resp_data;
+    }
+    if (!ok && mismatches++ == 0) {
+      std::printf("  first mismatch at cycle=%d valid=%u/%u id=%u/%u\n",
+                  cycle,
+                  static_cast<unsigned>(want.resp_valid),
+                  static_cast<unsigned>(got.resp_valid),
+                  static_cast<unsigned>(want.out_matmul_id),
+                  static_cast<unsigned>(got.out_matmul_id));
+    }
+  }
+
+  const bool ok = mismatches == 0 && valid_rows > 0;
+  std::printf("  steps=%d valid_rows=%d mismatches=%d full=%.0fns/step tl=%.0fns/step\n",
+              kSteps,
+              valid_rows,
+              mismatches,
+              full_sec / kSteps * 1e9,
+              tl_sec / kSteps * 1e9);
+  std::printf("[MESH_HULL_TL] %s matches_full_model\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
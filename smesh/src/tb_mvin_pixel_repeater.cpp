@@ -0,0 +1,234 @@
+// **********************************************************************
+// smesh/src/tb_mvin_pixel_repeater.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Aug 29 2026
+// Focused pixel-repeat test. Three DRAM rows go through MvinPixelRepeater and
+// MvinLocalRouter into a scratchpad-side sink that is only ready every other
+// cycle: a one-channel pixel repeated 3x, a two-channel pixel repeated 3x whose
+// third copy would start past the last lane (dropped), a plain row, and a
+// one-channel pixel at row 1 repeated 3x whose third copy would land below row 0
+// (dropped). Every copy must arrive once, in order, at row laddr - k with lanes
+// and mask shifted by k * len, and only each DRAM row's own copy may carry last.
+
+#include <cascade/Cascade.hpp>
+#include <descore/Parameter.hpp>
+
+#include "MvinLocalRouter.hpp"
+#include "MvinPixelRepeater.hpp"
+#include "SmeshPorts.hpp"
+
+#include <array>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+struct Expected {
+  std::uint32_t row;
+  std::uint8_t  mask;
+  std::array<std::uint8_t, smesh::kDim> lanes;
+  bool          last;
+};
+
+smesh::DmaReadResp inputRow(std::size_t i) {
+  smesh::DmaReadResp resp{};
+  resp.cmd_id = static_cast<std::uint16_t>(i + 1);
+  resp.last = true;
+  switch (i) {
+    case 0:
+      resp.laddr = smesh::makeSpAddr(5);
+      resp.len = 1;
+      resp.data[0] = 0xa1;
+      resp.pixel_repeats = 3;
+      break;
+    case 1:
+      resp.laddr = smesh::makeSpAddr(1);
+      resp.len = 2;
+      resp.data[0] = 0xb1;
+      resp.data[1] = 0xb2;
+      resp.pixel_repeats = 3;
+      break;
+    case 2:
+      resp.laddr = smesh::makeSpAddr(8);
+      resp.len = smesh::kDim;
+      for (std::size_t lane = 0; lane < smesh::kDim; ++lane) {
+        resp.data[lane] = static_cast<std::uint8_t>(0xc0 + lane);
+      }
+      break;
+    default:
+      resp.laddr = smesh::makeSpAddr(1);
+      resp.len = 1;
+      resp.data[0] = 0xd1;
+      resp.pixel_repeats = 3;
+      break;
+  }
+  resp.mask = static_cast<std::uint8_t>((1u << static_cast<std::uint16_t>(resp.len)) - 1u);
+  resp.bytes_read = resp.len;
+  return resp;
+}
+
+const std::vector<Expected> kExpected{
+    {3, 0x4, {{0, 0, 0xa1, 0}}, false},
+    {4, 0x2, {{0, 0xa1, 0, 0}}, false},
+    {5, 0x1, {{0xa1, 0, 0, 0}}, true},
+    {0, 0xc, {{0, 0, 0xb1, 0xb2}}, false},
+    {1, 0x3, {{0xb1, 0xb2, 0, 0}}, true},
+    {8, 0xf, {{0xc0, 0xc1, 0xc2, 0xc3}}, true},
+    {0, 0x2, {{0, 0xd1, 0, 0}}, false},
+    {1, 0x1, {{0xd1, 0, 0, 0}}, true},
+};
+
+constexpr std::size_t kInputs = 4;
+
+} // namespace
+
+class RepeatSource : public Component {
+  DECLARE_COMPONENT(RepeatSource);
+
+ public:
+  RepeatSource(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+  FifoOutput(smesh::DmaReadResp, data_out);
+
+  void update();
+  void reset();
+
+ private:
+  std::size_t sent_ = 0;
+};
+
+RepeatSource::RepeatSource(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(update).writes(data_out);
+}
+
+void RepeatSource::update() {
+  if (Sim::state == Sim::SimResetting || sent_ == kInputs || data_out.full()) {
+    return;
+  }
+  data_out.push(inputRow(sent_));
+  ++sent_;
+}
+
+void RepeatSource::reset() {
+  sent_ = 0;
+}
+
+// Stands in for WriteCtrl's scratchpad port: ready every other cycle, records what it takes.
+class RepeatSink : public Component {
+  DECLARE_COMPONENT(RepeatSink);
+
+ public:
+  RepeatSink(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+  Output(bit, spad_rdy);
+  Output(bit, accum_rdy);
+  Input(bit, spad_val);
+  Input(smesh::DmaReadResp, spad_bits);
+  Input(bit, accum_val);
+
+  void updateReady();
+  void update();
+  void reset();
+
+  const std::vector<smesh::DmaReadResp>& taken() const { return taken_; }
+  bool sawAccum() const { return saw_accum_; }
+  int stalls() const { return stalls_; }
+
+ private:
+  int  cycle_     = 0;
+  int  stalls_    = 0; // cycles a row was offered while not ready
+  bool saw_accum_ = false;
+  std::vector<smesh::DmaReadResp> taken_;
+};
+
+RepeatSink::RepeatSink(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(updateReady).writes(spad_rdy, accum_rdy);
+  UPDATE(update).reads(spad_rdy, spad_val, spad_bits, accum_val);
+}
+
+void RepeatSink::updateReady() {
+  spad_rdy = bit(Sim::state != Sim::SimResetting && cycle_ % 2 == 1);
+  accum_rdy = 0;
+}
+
+void RepeatSink::update() {
+  if (Sim::state == Sim::SimResetting) {
+    return;
+  }
+  ++cycle_;
+  saw_accum_ = saw_accum_ || accum_val != 0;
+  if (spad_val == 0) {
+    return;
+  }
+  if (spad_rdy != 0) {
+    taken_.push_back(*spad_bits);
+  } else {
+    ++stalls_;
+  }
+}
+
+void RepeatSink::reset() {
+  cycle_ = 0;
+  stalls_ = 0;
+  saw_accum_ = false;
+  taken_.clear();
+  spad_rdy.reset(0);
+  accum_rdy.reset(0);
+}
+
+int main(int argc, char* argv[]) {
+  descore::parseTraces(argc, argv);
+  Parameter::parseCommandLine(argc, argv);
+  Sim::parseDumps(argc, argv);
+
+  RepeatSource source("Source");
+  smesh::MvinPixelRepeater repeater("MvinPixelRepeater");
+  smesh::MvinLocalRouter router("MvinLocalRouter");
+  RepeatSink sink("Sink");
+
+  repeater.data_in << source.data_out;
+  router.data_in << repeater.data_out;
+  router.dmaread_spad_rdy << sink.spad_rdy;
+  router.dmaread_accum_rdy << sink.accum_rdy;
+  sink.spad_val << router.dmaread_spad_val;
+  sink.spad_bits << router.dmaread_spad_bits;
+  sink.accum_val << router.dmaread_accum_val;
+
+  Clock clk;
+  source.clk << clk;
+  repeater.clk << clk;
+  router.clk << clk;
+  sink.clk << clk;
+  clk.generateClock();
+
+  Cascade::params.MaxResetIterations = 1;
+  Sim::init();
+  Sim::reset();
+  for (int i = 0; i < 48; ++i) {
+    Sim::run();
+  }
+
+  const auto& taken = sink.taken();
+  bool ok = taken.size() == kExpected.size() && !sink.sawAccum() && sink.stalls() > 0 &&
+            repeater.copies() == kExpected.size() && repeater.dropped() == 2;
+  for (std::size_t i = 0; ok && i < taken.size(); ++i) {
+    const auto& got = taken[i];
+    const auto& want = kExpected[i];
+    ok = got.laddr.full_sp_addr() == want.row &&
+         static_cast<std::uint8_t>(got.mask) == want.mask &&
+         static_cast<bool>(got.last) == want.last &&
+         (static_cast<std::uint16_t>(got.bytes_read) != 0) == want.last;
+    for (std::size_t lane = 0; ok && lane < smesh::kDim; ++lane) {
+      ok = got.data[lane] == want.lanes[lane];
+    }
+  }
+
+  std::printf("[MVIN_PIXEL_REPEATER] copies=%zu dropped=%llu sink_stalls=%d\n",
+              taken.size(),
+              static_cast<unsigned long long>(repeater.dropped()),
+              sink.stalls());
+  std::printf("[MVIN_PIXEL_REPEATER] %s pixel_repeats\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,256 @@
+// **********************************************************************
+// smesh/src/tb_normalizer.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Aug 28 2026
+// Focused Normalizer test. Two rigs, one and four reduction stages deep, get
+// the same stream back to back: a LayerNorm row reduced over two tiles (SUM
+// then INV_STDDEV) and written out, then a softmax row (MAX, INV_SUM_EXP) in
+// stats entry 255 and written out. Both must ack the four stats-only rows,
+// hand on only the two output rows, and leave them as x - mean with
+// acc_scale * 1/stddev and I-EXP(x - max) with acc_scale * 1/sum_exp;
+// requantized, the softmax row must track a float softmax. Neither rig ever holds off StNormCtrl, since a row
+// leaving the last stage frees it the same cycle; the deep rig's outputs just
+// appear exactly three cycles later.
+
+#include <cascade/Cascade.hpp>
+#include <descore/Parameter.hpp>
+
+#include "Activation.hpp"
+#include "Normalizer.hpp"
+#include "Requantize.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr double kScale = 1.0 / 64.0; // softmax input quantization step S
+constexpr std::size_t kRows = 6;
+constexpr std::uint16_t kSoftmaxStats = 0xff; // the top 8-bit CONFIG_NORM stats id names an entry
+const smesh::MeshAccumRow kSoftmaxRow{{-200, 0, 64, 10}};
+
+// I-BERT I-EXP constants for S, as tb_activation derives them
+smesh::AccumReadResp withIExp(smesh::AccumReadResp acc) {
+  constexpr double a = 0.3585, b = 1.353, c = 0.344;
+  const auto qln2 = static_cast<std::int32_t>(std::floor(std::log(2.0) / kScale));
+  acc.igelu_qb = static_cast<std::uint32_t>(static_cast<std::int32_t>(std::floor(b / kScale)));
+  acc.igelu_qc = static_cast<std::uint32_t>(static_cast<std::int32_t>(std::floor(c / (a * kScale * kScale))));
+  acc.iexp_qln2 = static_cast<std::uint32_t>(qln2);
+  acc.iexp_qln2_inv = static_cast<std::uint32_t>(std::lround(65536.0 / qln2));
+  return acc;
+}
+
+smesh::AccNormReq normRow(std::size_t r) {
+  smesh::AccNormReq req{};
+  auto& acc = req.acc_read_resp;
+  acc.laddr = smesh::makeAccAddr(static_cast<std::uint32_t>(r));
+  acc.len = smesh::kDim;
+  acc.cmd_id = static_cast<std::uint16_t>(r);
+  acc.from_dma = true;
+  req.cmd.len = smesh::kDim;
+  switch (r) {
+    case 0:
+      acc.data = smesh::MeshAccumRow{{1, 2, 3, 4}};
+      req.cmd.cmd = static_cast<std::uint8_t>(smesh::NormCmd::Sum);
+      break;
+    case 1:
+      acc.data = smesh::MeshAccumRow{{5, 6, 7, 8}};
+      req.cmd.cmd = static_cast<std::uint8_t>(smesh::NormCmd::InvStddev);
+      break;
+    case 2:
+      acc.data = smesh::MeshAccumRow{{1, 5, 8, 4}};
+      acc.act = static_cast<std::uint8_t>(smesh::Activation::LayerNorm);
+      acc.scale = smesh::accScaleFromFloat(2.0f);
+      req.cmd.cmd = static_cast<std::uint8_t>(smesh::NormCmd::Reset);
+      break;
+    default:
+      acc = withIExp(acc);
+      acc.data = kSoftmaxRow;
+      acc.act = static_cast<std::uint8_t>(smesh::Activation::Softmax);
+      acc.scale = smesh::accScaleFromFloat(127.0f);
+      req.cmd.stats_id = kSoftmaxStats;
+      req.cmd.cmd = static_cast<std::uint8_t>(r == 3 ? smesh::NormCmd::Max
+                                            : r == 4 ? smesh::NormCmd::InvSumExp
+                                                     : smesh::NormCmd::Reset);
+      break;
+  }
+  return req;
+}
+// rows 1..8 have mean 4.5 (rounds to 4) and variance 204/8 - 4.5^2 = 5.25
+bool layerNormOk(const smesh::AccNormReq& out) {
+  const auto& acc = out.acc_read_resp;
+  const float scale = smesh::accScaleToFloat(acc.scale, smesh::AccScaleFormat::Float32);
+  return acc.data == smesh::MeshAccumRow{{-3, 1, 4, 0}} &&
+         std::fabs(scale - 2.0f / std::sqrt(5.25f)) < 1e-5f &&
+         acc.act == static_cast<std::uint8_t>(smesh::Activation::None);
+}
+// requantized with the folded scale, the row is 127 * softmax(x * S) to within a few counts
+bool softmaxOk(const smesh::AccNormReq& out) {
+  const auto& acc = out.acc_read_resp;
+  const auto q = smesh::requantizeRow(acc.data, acc.scale, smesh::AccScaleRow{}, smesh::AccScaleFormat::Float32);
+  double denom = 0.0;
+  for (const auto x : kSoftmaxRow) {
+    denom += std::exp(x * kScale);
+  }
+  bool ok = true;
+  for (std::size_t lane = 0; lane < smesh::kDim; ++lane) {
+    const double ref = 127.0 * std::exp(kSoftmaxRow[lane] * kScale) / denom;
+    ok = ok && std::fabs(q[lane] - ref) <= 3.0;
+  }
+  return ok;
+}
+
+} // namespace
+
+// Offers kRows rows back to back, holds resp_rdy high and collects outputs and acks.
+class NormalizerDriver : public Component {
+  DECLARE_COMPONENT(NormalizerDriver);
+
+ public:
+  NormalizerDriver(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+  Output(bit, req_val);
+  Output(smesh::AccNormReq, req_bits);
+  Output(bit, resp_rdy);
+  Input(bit, req_rdy);
+  Input(bit, resp_val);
+  Input(smesh::AccNormReq, resp_bits);
+  FifoInput(smesh::DmaWriteResp, stats_done);
+
+  void updateOffer();
+  void update();
+  void reset();
+
+  bool done() const { return outputs_.size() == 2 && acks_.size() == 4; }
+  const std::vector<smesh::AccNormReq>& outputs() const { return outputs_; }
+  const std::vector<std::uint16_t>& acks() const { return acks_; }
+  const std::vector<int>& outCycles() const { return out_cycles_; }
+
+ private:
+  std::size_t sent_  = 0;
+  int         cycle_ = 0;
+  std::vector<smesh::AccNormReq> outputs_;
+  std::vector<std::uint16_t> acks_;
+  std::vector<int> out_cycles_;
+};
+
+NormalizerDriver::NormalizerDriver(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(updateOffer).writes(req_val, req_bits, resp_rdy);
+  UPDATE(update).reads(req_val, req_rdy, resp_val, resp_bits, stats_done);
+}
+
+void NormalizerDriver::updateOffer() {
+  const bool offering = Sim::state != Sim::SimResetting && sent_ < kRows;
+  req_val = bit(offering);
+  req_bits = offering ? normRow(sent_) : smesh::AccNormReq{};
+  resp_rdy = 1;
+}
+
+void NormalizerDriver::update() {
+  if (Sim::state == Sim::SimResetting) {
+    return;
+  }
+  ++cycle_;
+  if (req_val != 0 && req_rdy != 0) {
+    ++sent_;
+  }
+  if (!stats_done.empty()) {
+    acks_.push_back(static_cast<std::uint16_t>(stats_done.pop().cmd_id));
+  }
+  if (resp_val != 0) {
+    outputs_.push_back(*resp_bits);
+    out_cycles_.push_back(cycle_);
+  }
+}
+
+void NormalizerDriver::reset() {
+  sent_ = 0;
+  cycle_ = 0;
+  outputs_.clear();
+  acks_.clear();
+  out_cycles_.clear();
+  req_val.reset(0);
+  req_bits.reset(smesh::AccNormReq{});
+  resp_rdy.reset(0);
+}
+
+namespace {
+
+struct Rig {
+  Rig(const std::string& name, std::size_t latency)
+      : driver(name + "Driver"), norm(name + "Normalizer") {
+    norm.setLatency(latency);
+  }
+
+  NormalizerDriver  driver;
+  smesh::Normalizer norm;
+
+  void connect(Clock& clk) {
+    norm.req_val << driver.req_val;
+    norm.req_bits << driver.req_bits;
+    driver.req_rdy << norm.req_rdy;
+    driver.resp_val << norm.resp_val;
+    driver.resp_bits << norm.resp_bits;
+    norm.resp_rdy << driver.resp_rdy;
+    driver.stats_done << norm.stats_done;
+    driver.clk << clk;
+    norm.clk << clk;
+  }
+
+  bool passed() const {
+    const auto& out = driver.outputs();
+    const auto& acks = driver.acks();
+    return driver.done() &&
+           acks == std::vector<std::uint16_t>{0, 1, 3, 4} &&
+           out[0].acc_read_resp.cmd_id == 2 && layerNormOk(out[0]) &&
+           out[1].acc_read_resp.cmd_id == 5 && softmaxOk(out[1]) &&
+           norm.stats(0).count == 8 && norm.stats(0).mean == 4 &&
+           norm.stats(kSoftmaxStats).max == 64 && norm.statsRows() == 4 && norm.rows() == 2;
+  }
+
+  void report() const {
+    const auto& cycles = driver.outCycles();
+    std::printf("  latency=%zu first_out=%d last_out=%d avg_occupancy=%.2f full_stalls=%llu\n",
+                norm.latency(),
+                cycles.empty() ? -1 : cycles.front(),
+                cycles.empty() ? -1 : cycles.back(),
+                norm.averageOccupancy(),
+                static_cast<unsigned long long>(norm.fullStallCycles()));
+  }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  descore::parseTraces(argc, argv);
+  Parameter::parseCommandLine(argc, argv);
+  Sim::parseDumps(argc, argv);
+
+  Rig shallow("Shallow", 1);
+  Rig deep("Deep", 4);
+  Clock clk;
+  shallow.connect(clk);
+  deep.connect(clk);
+  clk.generateClock();
+
+  Cascade::params.MaxResetIterations = 1;
+  Sim::init();
+  Sim::reset();
+  for (std::size_t i = 0; i < 8 * kRows && !(shallow.driver.done() && deep.driver.done()); ++i) {
+    Sim::run();
+  }
+
+  shallow.report();
+  deep.report();
+  const bool data_ok = shallow.passed() && deep.passed();
+  // both depths take the stream back to back; depth only adds latency
+  const bool timing_ok = shallow.norm.fullStallCycles() == 0 &&
+                         deep.norm.fullStallCycles() == 0 &&
+                         deep.driver.outCycles().front() == shallow.driver.outCycles().front() + 3;
+  const bool ok = data_ok && timing_ok;
+  std::printf("[NORMALIZER] %s layernorm_softmax\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -132,8 +132,6 @@ int main(int argc, char* argv[]) {
   local_router.data_in << pixel_repeater.data_out;
   local_router.dmaread_spad_rdy << write_ctrl.dmaread_spad_rdy;
   local_router.dmaread_accum_rdy << zero_spad_read.zero_bit;
-  local_router.dmaread_spad.sendToBitBucket();
-  local_router.dmaread_accum.sendToBitBucket();
   write_ctrl.dmaread_spad_val << local_router.dmaread_spad_val;
   write_ctrl.dmaread_spad_bits << local_router.dmaread_spad_bits;
   write_ctrl.dmaread_accum_val << zero_spad_read.zero_bit;
@@ -148,6 +146,8 @@ int main(int argc, char* argv[]) {
     write_ctrl.arb_spad_dmaread_rdy[bank] << arb_spad[bank]->dmaread_rdy;
     arb_spad[bank]->zerowrite_val << zero_spad_read.zero_bit;
     arb_spad[bank]->zerowrite_bits << zero_spad_read.dma_read_resp;
+    arb_spad[bank]->spadwrite_val << zero_spad_read.zero_bit;
+    arb_spad[bank]->spadwrite_bits << zero_spad_read.dma_read_resp;
     arb_spad[bank]->write_rdy << spad.write_rdy_bnk[bank];
     spad.write_val_bnk[bank] << arb_spad[bank]->write_val;
     spad.write_bits_bnk[bank] << arb_spad[bank]->write_bits;
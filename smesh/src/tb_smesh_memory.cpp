@@ -0,0 +1,109 @@
+// **********************************************************************
+// smesh/src/tb_smesh_memory.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Oct 17 2026
+/*
+Testbench for the paged fake host memory. Covers a row that straddles a page
+boundary, reads of pages that were never written (zero, and still not
+resident), and an Acc row round trip including negative values and its
+little-endian byte layout.
+*/
+
+#include "SmeshMemory.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+
+namespace {
+
+constexpr std::uint64_t kPage = smesh::SmeshMemory::kPageBytes;
+
+// a kDim-element row whose middle crosses into the next page
+bool runPageStraddle() {
+  smesh::SmeshMemory mem;
+  const std::uint64_t addr = 3 * kPage - smesh::kDim / 2;
+  std::array<smesh::Elem, smesh::kDim> row{};
+  for (std::size_t i = 0; i < row.size(); ++i) {
+    row[i] = static_cast<smesh::Elem>(0x31 + i);
+  }
+  mem.writeRow(addr, row.data(), row.size());
+
+  std::array<smesh::Elem, smesh::kDim> back{};
+  mem.readRow(addr, back.data(), back.size());
+  bool ok = back == row && mem.residentPages() == 2;
+  for (std::size_t i = 0; i < row.size(); ++i) {
+    ok = ok && mem.readElem(addr + i) == row[i]; // byte by byte, from either page
+  }
+  ok = ok && mem.readElem(addr - 1) == 0 && mem.readElem(addr + row.size()) == 0;
+  std::printf("[SMESH_MEMORY] %s page_straddle\n", ok ? "PASS" : "FAIL");
+  return ok;
+}
+
+// untouched pages read as zero, including a span that runs from a written page into an unwritten one
+bool runZeroFill() {
+  smesh::SmeshMemory mem;
+  std::array<std::uint8_t, 16> buf{};
+  buf.fill(0xee);
+  mem.read(7 * kPage + 40, buf.data(), buf.size());
+  bool ok = mem.residentPages() == 0;
+  for (const auto b : buf) {
+    ok = ok && b == 0;
+  }
+
+  const std::uint8_t mark = 0x5a;
+  mem.write(kPage - 1, &mark, 1);
+  buf.fill(0xee);
+  mem.read(kPage - 8, buf.data(), buf.size());
+  for (std::size_t i = 0; i < buf.size(); ++i) {
+    ok = ok && buf[i] == (i == 7 ? mark : 0);
+  }
+  ok = ok && mem.residentPages() == 1 && mem.readAcc(100 * kPage) == 0 && mem.residentPages() == 1;
+
+  mem.reset();
+  ok = ok && mem.residentPages() == 0 && mem.readElem(kPage - 1) == 0;
+  std::printf("[SMESH_MEMORY] %s zero_fill\n", ok ? "PASS" : "FAIL");
+  return ok;
+}
+
+// Acc rows longer than the kDim staging buffer, across a page, come back intact and little-endian
+bool runAccRoundTrip() {
+  smesh::SmeshMemory mem;
+  constexpr std::size_t kCount = 2 * smesh::kDim + 1;
+  const std::uint64_t addr = 5 * kPage - 2 * sizeof(smesh::Acc) - 1; // unaligned too
+  std::array<smesh::Acc, kCount> row{};
+  for (std::size_t i = 0; i < row.size(); ++i) {
+    row[i] = static_cast<smesh::Acc>((i % 2 == 0 ? -1 : 1) * static_cast<std::int64_t>(0x01020304 * (i + 1)));
+  }
+  row[0] = static_cast<smesh::Acc>(0x80000000u); // most negative Acc
+  mem.writeRow(addr, row.data(), row.size());
+
+  std::array<smesh::Acc, kCount> back{};
+  mem.readRow(addr, back.data(), back.size());
+  bool ok = back == row;
+  for (std::size_t i = 0; i < row.size(); ++i) {
+    ok = ok && mem.readAcc(addr + i * sizeof(smesh::Acc)) == row[i];
+  }
+
+  mem.writeAcc(addr, static_cast<smesh::Acc>(0x11223344));
+  std::array<std::uint8_t, sizeof(smesh::Acc)> bytes{};
+  mem.read(addr, bytes.data(), bytes.size());
+  ok = ok && bytes == std::array<std::uint8_t, sizeof(smesh::Acc)>{{0x44, 0x33, 0x22, 0x11}};
+  std::printf("[SMESH_MEMORY] %s acc_round_trip\n", ok ? "PASS" : "FAIL");
+  return ok;
+}
+
+} // namespace
+
+int main() {
+  try {
+    const bool ok_straddle = runPageStraddle();
+    const bool ok_zero = runZeroFill();
+    const bool ok_acc = runAccRoundTrip();
+    return (ok_straddle && ok_zero && ok_acc) ? 0 : 1;
+  } catch (const std::exception& e) {
+    std::printf("[SMESH_MEMORY] FAIL exception: %s\n", e.what());
+    return 1;
+  }
+}
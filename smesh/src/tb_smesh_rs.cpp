@@ -8,6 +8,7 @@ Focused reservation-station range tests.
 
 #include "SmeshRS.hpp"
 
+#include <array>
 #include <cstdint>
 #include <cstdio>
 
@@ -191,6 +192,88 @@ bool testDependencies() {
          st_ld_rs.issueLoad() != nullptr;
 }
 
+// A deep load queue fills all kRsMaxEntries rows, rejects the next command,
+// and reuses exactly the row a completion frees.
+bool testDeepCapacity() {
+  constexpr smesh::MatrixShape shape{smesh::kDim, smesh::kDim};
+  const auto load = command(
+      smesh::SmeshFunct::Mvin,
+      0,
+      smesh::packLocal(smesh::makeSpAddr(0), shape));
+
+  smesh::SmeshRS rs("DeepCapacityRS");
+  rs.setEntries(smesh::kRsMaxEntries, 8, 8);
+  for (std::size_t i = 0; i < smesh::kRsMaxEntries; ++i) {
+    if (!rs.allocate(load)) {
+      return false;
+    }
+  }
+  if (rs.canAccept(load) || rs.allocate(load) ||
+      rs.entries(smesh::SmeshQueueClass::Load) != smesh::kRsMaxEntries ||
+      rs.occupancy(smesh::SmeshQueueClass::Load) != smesh::kRsMaxEntries ||
+      rs.peakOccupancy(smesh::SmeshQueueClass::Load) != smesh::kRsMaxEntries) {
+    return false;
+  }
+
+  constexpr std::size_t kFreedRow = 37;
+  const auto freed_rs_tag = rs.loadEntry(kFreedRow).rs_tag;
+  return rs.complete(freed_rs_tag) &&
+         rs.occupancy(smesh::SmeshQueueClass::Load) == smesh::kRsMaxEntries - 1 &&
+         rs.allocate(load) &&
+         rs.loadEntry(kFreedRow).valid &&
+         rs.loadEntry(kFreedRow).allocated_at == smesh::kRsMaxEntries &&
+         !rs.canAccept(load);
+}
+
+// One STORE waits on four LOADs. Each completion clears only its own bit in
+// the STORE's deps_ld; the STORE becomes issuable on the last one.
+bool testWakeup() {
+  constexpr smesh::MatrixShape shape{smesh::kDim, smesh::kDim};
+  smesh::SmeshRS rs("WakeupRS");
+  rs.setEntries(8, 8, 8);
+  const auto config_load = command(
+      smesh::SmeshFunct::Config,
+      smesh::packConfig(smesh::ConfigKind::Load, 0, smesh::kDim),
+      0);
+  if (!rs.allocate(config_load) || !rs.complete(rs.entry().rs_tag)) {
+    return false;
+  }
+
+  constexpr std::size_t kLoads = 4;
+  std::array<smesh::SmeshRsTag, kLoads> load_tags{};
+  for (std::size_t i = 0; i < kLoads; ++i) {
+    const auto load = command(
+        smesh::SmeshFunct::Mvin,
+        0,
+        smesh::packLocal(smesh::makeSpAddr(static_cast<std::uint32_t>(i * smesh::kDim)), shape));
+    if (!rs.allocate(load, &load_tags[i])) {
+      return false;
+    }
+  }
+  const auto store = command(
+      smesh::SmeshFunct::Mvout,
+      0,
+      smesh::packLocal(smesh::makeSpAddr(0),
+                       smesh::MatrixShape{static_cast<std::uint32_t>(kLoads * smesh::kDim), smesh::kDim}));
+  if (!rs.allocate(store) ||
+      rs.storeEntry().deps_ld != 0xfu ||
+      rs.loadEntry(0).waiters_st != 1u ||
+      rs.loadEntry(0).waiters_ld != 0xeu ||
+      rs.issueStore() != nullptr) {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < kLoads; ++i) {
+    if (rs.issueStore() != nullptr || !rs.complete(load_tags[i]) ||
+        rs.storeEntry().deps_ld != (0xfu & ~((2u << i) - 1u))) {
+      return false;
+    }
+  }
+  return rs.issueStore() != nullptr &&
+         rs.occupancy(smesh::SmeshQueueClass::Load) == 0 &&
+         rs.occupancy(smesh::SmeshQueueClass::Store) == 1;
+}
+
 bool testLoadRange() {
   smesh::SmeshRS rs("LoadRangeRS");
 
@@ -385,6 +468,8 @@ int main() {
   const bool overlap_ok = testOverlap();
   const bool capacity_ok = testCapacity();
   const bool dependencies_ok = testDependencies();
+  const bool deep_capacity_ok = testDeepCapacity();
+  const bool wakeup_ok = testWakeup();
   const bool load_ok = testLoadRange();
   const bool store_ok = testStoreRange();
   const bool store_spad_ok = testStoreSpadRange();
@@ -396,6 +481,9 @@ int main() {
   std::printf("[SMESH_RS] %s capacity\n", capacity_ok ? "PASS" : "FAIL");
   std::printf("[SMESH_RS] %s dependencies\n",
               dependencies_ok ? "PASS" : "FAIL");
+  std::printf("[SMESH_RS] %s deep_capacity\n",
+              deep_capacity_ok ? "PASS" : "FAIL");
+  std::printf("[SMESH_RS] %s wakeup\n", wakeup_ok ? "PASS" : "FAIL");
   std::printf("[SMESH_RS] %s load_range\n", load_ok ? "PASS" : "FAIL");
   std::printf("[SMESH_RS] %s store_range\n", store_ok ? "PASS" : "FAIL");
   std::printf("[SMESH_RS] %s store_spad_range\n",
@@ -404,7 +492,8 @@ int main() {
               preload_ok ? "PASS" : "FAIL");
   std::printf("[SMESH_RS] %s compute_range\n",
               compute_ok ? "PASS" : "FAIL");
-  return (local_addr_ok && overlap_ok && capacity_ok && dependencies_ok && load_ok &&
+  return (local_addr_ok && overlap_ok && capacity_ok && dependencies_ok &&
+          deep_capacity_ok && wakeup_ok && load_ok &&
           store_ok && store_spad_ok && preload_ok && compute_ok)
              ? 0
              : 1;
@@ -0,0 +1,252 @@
+// **********************************************************************
+// smesh/src/tb_smesh_rs_depth.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Aug 24 2026
+// RS depth sweep. One SmeshTop rig per RS depth, each on its own MemCtrl/Dram,
+// runs the same stream of mvin/mvout pairs side by side at a given memory
+// latency. Each rig reports the cycles to drain, the cycles the front end
+// stalled on a full load/store queue, and the average/peak RS occupancy, so the
+// knee (the smallest depth that stops throttling the front end) can be read off.
+// Run e.g. with -mem_latency=2, 8 and 32 to see the knee move with DMA latency.
+
+#include <cascade/Cascade.hpp>
+#include <descore/Parameter.hpp>
+
+#include "SmeshCommand.hpp"
+#include "SmeshTop.hpp"
+#include "smem/Dram.hpp"
+#include "smem/MemCtrl.hpp"
+
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+IntParameter(mem_latency, 8, "MemCtrl latency for tb_smesh_rs_depth");
+IntParameter(pairs, 16, "mvin/mvout pairs per rig for tb_smesh_rs_depth");
+
+namespace {
+
+constexpr std::uint64_t kLoadDramBase  = 0x80008000;
+constexpr std::uint64_t kStoreDramBase = 0x80009000;
+constexpr std::uint32_t kDramRowStride = 9;
+constexpr std::uint32_t kStoreStride   = 0x40; // DRAM bytes between mvout destinations
+constexpr std::size_t   kBlocks        = smesh::kSpRows / smesh::kDim; // mvins rotate through these Spad blocks
+constexpr std::array<std::size_t, 6> kDepths{{2, 4, 8, 16, 32, 64}};
+
+static_assert(kDepths.back() <= smesh::kRsMaxEntries, "sweep depth exceeds kRsMaxEntries");
+
+} // namespace
+
+// Streams CONFIG(load) then `pairs` mvin/mvout pairs: mvin k fills Spad block k % kBlocks
+// from the same DRAM tile, mvout k writes that block back to its own DRAM slot.
+class DepthDriver : public Component {
+  DECLARE_COMPONENT(DepthDriver);
+
+ public:
+  DepthDriver(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+  Output(bit, cmd_valid);
+  Output(smesh::SmeshCmd, cmd_bits);
+  Input(bit, cmd_ready);
+
+  void update();
+  void reset();
+
+  bool done() const { return next_command_ >= commands(); }
+
+ private:
+  static std::uint32_t commands() { return 1 + 2 * static_cast<std::uint32_t>(static_cast<int>(pairs)); }
+  smesh::SmeshCmd command(std::uint32_t index) const;
+
+  std::uint32_t next_command_ = 0;
+};
+
+DepthDriver::DepthDriver(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(update).reads(cmd_ready).writes(cmd_valid, cmd_bits);
+}
+
+smesh::SmeshCmd DepthDriver::command(std::uint32_t index) const {
+  constexpr smesh::MatrixShape shape{smesh::kDim, smesh::kDim};
+  smesh::SmeshCmd cmd{};
+  if (index == 0) {
+    cmd.funct = u32(static_cast<std::uint32_t>(smesh::SmeshFunct::Config));
+    cmd.rs1 = u64(smesh::packConfig(smesh::ConfigKind::Load, 0, smesh::kDim));
+    cmd.rs2 = u64(kDramRowStride);
+    return cmd;
+  }
+  const auto pair = (index - 1) / 2;
+  const auto block = smesh::makeSpAddr(static_cast<std::uint32_t>((pair % kBlocks) * smesh::kDim));
+  if ((index - 1) % 2 == 0) {
+    cmd.funct = u32(static_cast<std::uint32_t>(smesh::SmeshFunct::Mvin));
+    cmd.rs1 = u64(kLoadDramBase);
+  } else {
+    cmd.funct = u32(static_cast<std::uint32_t>(smesh::SmeshFunct::Mvout));
+    cmd.rs1 = u64(kStoreDramBase + pair * kStoreStride);
+  }
+  cmd.rs2 = u64(smesh::packLocal(block, shape));
+  return cmd;
+}
+
+void DepthDriver::update() {
+  cmd_valid = 0;
+  cmd_bits = smesh::SmeshCmd{};
+  if (Sim::state == Sim::SimResetting || done()) {
+    return;
+  }
+
+  cmd_bits = command(next_command_);
+  cmd_valid = 1;
+  if (cmd_ready != 0) {
+    ++next_command_;
+  }
+}
+
+void DepthDriver::reset() {
+  next_command_ = 0;
+}
+
+namespace {
+
+struct Rig {
+  Rig(const std::string& name, std::size_t rs_depth)
+      : depth(rs_depth),
+        driver(name + "Driver"),
+        top(name + "Top"),
+        mem(name + "MemCtrl"),
+        dram(name + "Dram", 0) {
+    top.setRsEntries(depth, depth, depth);
+  }
+
+  std::size_t         depth;
+  DepthDriver         driver;
+  smesh::SmeshTop     top;
+  smem::MemCtrl       mem;
+  smem::Dram          dram;
+  int                 done_cycle = -1;
+
+  void connect(Clock& clk) {
+    top.cmd_valid << driver.cmd_valid;
+    top.cmd_bits << driver.cmd_bits;
+    driver.cmd_ready << top.cmd_ready;
+    mem.in_core_req << top.memReq();
+    top.memResp() << mem.out_core_resp;
+    mem.in_core_req.setDelay(1);
+    dram.s_req << mem.s_req;
+    mem.s_resp << dram.s_resp;
+
+    driver.clk << clk;
+    top.clk << clk;
+    mem.clk << clk;
+    dram.clk << clk;
+  }
+
+  bool drained() const {
+    return driver.done() && top.rs().empty() && top.dmaMemArb().writesIdle();
+  }
+
+  // first row of every mvout destination must match the loaded tile
+  bool stored(const std::array<std::uint8_t, smesh::kDim * smesh::kDim>& rows) {
+    for (int p = 0; p < static_cast<int>(pairs); ++p) {
+      std::array<std::uint8_t, smesh::kDim> got{};
+      dram.read(kStoreDramBase + static_cast<std::uint64_t>(p) * kStoreStride, got.data(), got.size());
+      for (std::size_t c = 0; c < smesh::kDim; ++c) {
+        if (got[c] != rows[c]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  void report() const {
+    const auto& rs = top.rs();
+    std::printf("  depth=%2zu cycles=%5d ld_full_stalls=%5llu st_full_stalls=%5llu "
+                "ld_occ=%5.2f/%2zu st_occ=%5.2f/%2zu\n",
+                depth,
+                done_cycle,
+                static_cast<unsigned long long>(rs.fullStallCycles(smesh::SmeshQueueClass::Load)),
+                static_cast<unsigned long long>(rs.fullStallCycles(smesh::SmeshQueueClass::Store)),
+                rs.averageOccupancy(smesh::SmeshQueueClass::Load),
+                rs.peakOccupancy(smesh::SmeshQueueClass::Load),
+                rs.averageOccupancy(smesh::SmeshQueueClass::Store),
+                rs.peakOccupancy(smesh::SmeshQueueClass::Store));
+  }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  descore::parseTraces(argc, argv);
+  Parameter::parseCommandLine(argc, argv);
+  Sim::parseDumps(argc, argv);
+
+  std::vector<std::unique_ptr<Rig>> rigs;
+  for (const auto depth : kDepths) {
+    rigs.push_back(std::make_unique<Rig>("Depth" + std::to_string(depth), depth));
+  }
+
+  Clock clk;
+  for (auto& rig : rigs) {
+    rig->connect(clk);
+  }
+  clk.generateClock();
+
+  Cascade::params.MaxResetIterations = 1;
+  Sim::init();
+  Sim::reset();
+
+  const std::array<std::uint8_t, smesh::kDim * smesh::kDim> rows{{
+      0x01, 0x02, 0x03, 0x04,
+      0x11, 0x12, 0x13, 0x14,
+      0x21, 0x22, 0x23, 0x24,
+      0x31, 0x32, 0x33, 0x34,
+  }};
+  for (auto& rig : rigs) {
+    rig->mem.set_latency(static_cast<int>(mem_latency));
+    for (std::size_t r = 0; r < smesh::kDim; ++r) {
+      rig->dram.write(kLoadDramBase + r * kDramRowStride, rows.data() + r * smesh::kDim, smesh::kDim);
+    }
+  }
+
+  const int max_cycles = 64 * static_cast<int>(pairs) * (static_cast<int>(mem_latency) + 8);
+  std::size_t running = rigs.size();
+  for (int cycle = 1; cycle <= max_cycles && running > 0; ++cycle) {
+    Sim::run();
+    for (auto& rig : rigs) {
+      if (rig->done_cycle < 0 && rig->drained()) {
+        rig->done_cycle = cycle;
+        --running;
+      }
+    }
+  }
+
+  std::printf("[SMESH_RS_DEPTH] %d mvin/mvout pairs, mem_latency=%d\n",
+              static_cast<int>(pairs), static_cast<int>(mem_latency));
+  bool ok = running == 0;
+  for (auto& rig : rigs) {
+    rig->report();
+    const auto& rs = rig->top.rs();
+    ok = ok && rig->stored(rows) &&
+         rs.peakOccupancy(smesh::SmeshQueueClass::Load) <= rig->depth &&
+         rs.peakOccupancy(smesh::SmeshQueueClass::Store) <= rig->depth;
+  }
+
+  // knee: shallowest depth within 5% of the deepest rig's drain time
+  if (running == 0) {
+    const int best = rigs.back()->done_cycle;
+    for (const auto& rig : rigs) {
+      if (rig->done_cycle * 100 <= best * 105) {
+        std::printf("  knee=%zu (deepest=%d cycles, depth %zu=%d cycles)\n",
+                    rig->depth, best, rigs.front()->depth, rigs.front()->done_cycle);
+        break;
+      }
+    }
+    ok = ok && rigs.back()->done_cycle <= rigs.front()->done_cycle;
+  }
+
+  std::printf("[SMESH_RS_DEPTH] %s rs_depth_sweep\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -2,7 +2,10 @@
 // smesh/src/tb_smesh_top_acc_full_load.cpp
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 24 2026
-// Focused full-width accumulator load-return path test.
+// Focused full-width accumulator load-return path test. An unscaled row and a
+// bias row with a 0.5 mvin scale (ties to even, saturation at the Acc range)
+// go through MvinScaleAcc into Accum; the input-width mvin kernel is checked
+// directly.
 
 #include <cascade/Cascade.hpp>
 #include <descore/Parameter.hpp>
@@ -10,11 +13,13 @@
 #include "Accum.hpp"
 #include "ArbWriteLocal.hpp"
 #include "MvinScale.hpp"
+#include "Requantize.hpp"
 #include "SmeshPorts.hpp"
 #include "WriteCtrl.hpp"
 
 #include <array>
 #include <cstdio>
+#include <limits>
 
 class FullAccumLoadSource : public Component {
   DECLARE_COMPONENT(FullAccumLoadSource);
@@ -29,7 +34,7 @@ class FullAccumLoadSource : public Component {
   void reset();
 
  private:
-  bool sent_ = false;
+  int sent_ = 0;
 };
 
 class FullAccumLoadTieOff : public Component {
@@ -50,6 +55,9 @@ class FullAccumLoadTieOff : public Component {
 namespace {
 
 constexpr std::array<smesh::Acc, smesh::kDim> kExpected{{0x01020304, 0x11121314, 0x21222324, 0x31323334}};
+constexpr std::array<smesh::Acc, smesh::kDim> kBias{{-7, 5, 1000, std::numeric_limits<smesh::Acc>::min()}};
+// kBias x 0.5: -3.5 -> -4, 2.5 -> 2, 500, and INT32_MIN / 2 stays exact
+constexpr std::array<smesh::Acc, smesh::kDim> kBiasScaled{{-4, 2, 500, std::numeric_limits<smesh::Acc>::min() / 2}};
 
 smesh::DmaReadData packAccRow(const std::array<smesh::Acc, smesh::kDim>& row) {
   smesh::DmaReadData data{};
@@ -63,6 +71,20 @@ smesh::DmaReadData packAccRow(const std::array<smesh::Acc, smesh::kDim>& row) {
   return data;
 }
 
+bool testInputKernel() {
+  const auto half = smesh::accScaleFromFloat(0.5f);
+  const auto four = smesh::accScaleFromFloat(4.0f);
+  const smesh::MeshInputRow row{{3, -3, 100, -100}};
+  const auto halved = smesh::scaleInputRow(row, half);
+  const auto grown = smesh::scaleInputRow(row, four);
+  const auto big = smesh::scaleAccumRow(smesh::MeshAccumRow{{1 << 30, -(1 << 30), 3, 0}}, four);
+  return halved == smesh::MeshInputRow{{2, -2, 50, -50}} &&
+         grown == smesh::MeshInputRow{{12, -12, 127, -128}} &&
+         smesh::scaleInputRow(row, smesh::kAccScaleIdentity) == row &&
+         big[0] == std::numeric_limits<smesh::Acc>::max() &&
+         big[1] == std::numeric_limits<smesh::Acc>::min() && big[2] == 12;
+}
+
 } // namespace
 
 FullAccumLoadSource::FullAccumLoadSource(std::string /*name*/, IMPL_CTOR) {
@@ -70,25 +92,26 @@ FullAccumLoadSource::FullAccumLoadSource(std::string /*name*/, IMPL_CTOR) {
 }
 
 void FullAccumLoadSource::update() {
-  if (sent_ || data_out.full()) {
+  if (sent_ == 2 || data_out.full()) {
     return;
   }
 
   smesh::DmaReadResp resp{};
-  resp.data = packAccRow(kExpected);
-  resp.laddr = smesh::makeAccAddr(0);
+  resp.data = packAccRow(sent_ == 0 ? kExpected : kBias);
+  resp.laddr = smesh::makeAccAddr(static_cast<std::uint32_t>(sent_));
+  resp.scale = sent_ == 0 ? smesh::kAccScaleIdentity : smesh::accScaleFromFloat(0.5f);
   resp.mask = static_cast<u8>((1u << smesh::kDim) - 1u);
   resp.has_acc_bitwidth = true;
   resp.len = smesh::kDim;
   resp.bytes_read = smesh::kDim * sizeof(smesh::Acc);
   resp.cmd_id = 7;
-  resp.last = true;
+  resp.last = sent_ == 1;
   data_out.push(resp);
-  sent_ = true;
+  ++sent_;
 }
 
 void FullAccumLoadSource::reset() {
-  sent_ = false;
+  sent_ = 0;
 }
 
 FullAccumLoadTieOff::FullAccumLoadTieOff(std::string /*name*/, IMPL_CTOR) {
@@ -122,7 +145,6 @@ int main(int argc, char* argv[]) {
   split.normal_out.sendToBitBucket();
   scale_acc.data_in << split.acc_out;
   scale_acc.data_rdy << write_ctrl.dmaread_accum_full_rdy;
-  scale_acc.data_out.sendToBitBucket();
 
   write_ctrl.dmaread_spad_val << tie_off.zero_bit;
   write_ctrl.dmaread_spad_bits << tie_off.dma_read_resp;
@@ -172,20 +194,23 @@ int main(int argc, char* argv[]) {
   Sim::init();
   Sim::reset();
 
-  for (int i = 0; i < 16 && !accum.hasAcceptedWrite(); ++i) {
+  for (int i = 0; i < 16; ++i) {
     Sim::run();
   }
 
   bool row_ok = accum.hasAcceptedWrite();
   const auto& row = accum.row(smesh::makeAccAddr(0));
+  const auto& bias = accum.row(smesh::makeAccAddr(1));
   for (std::size_t lane = 0; lane < smesh::kDim; ++lane) {
-    row_ok = row_ok && row[lane] == kExpected[lane];
+    row_ok = row_ok && row[lane] == kExpected[lane] && bias[lane] == kBiasScaled[lane];
   }
+  const bool kernel_ok = testInputKernel();
 
   for (auto* arb : arb_accum) {
     delete arb;
   }
 
   std::printf("[SMESH_TOP_ACC_FULL_LOAD] %s mvin_scale_acc_to_accum\n", row_ok ? "PASS" : "FAIL");
-  return row_ok ? 0 : 1;
+  std::printf("[SMESH_TOP_ACC_FULL_LOAD] %s mvin_scale_kernel\n", kernel_ok ? "PASS" : "FAIL");
+  return row_ok && kernel_ok ? 0 : 1;
 }
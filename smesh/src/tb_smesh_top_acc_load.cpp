@@ -141,13 +141,13 @@ int main(int argc, char* argv[]) {
     std::printf("  accum_ok=%u accepted_write=%u\n",
                 accum_ok ? 1u : 0u,
                 top.accum().hasAcceptedWrite() ? 1u : 0u);
-    std::printf("  load0 valid=%u issued=%u ready=%u funct=%u tag=%u deps_ld=0x%x\n",
+    std::printf("  load0 valid=%u issued=%u ready=%u funct=%u tag=%u deps_ld=0x%llx\n",
                 load0.valid ? 1u : 0u,
                 load0.issued ? 1u : 0u,
                 load0.ready() ? 1u : 0u,
                 static_cast<unsigned>(load0.cmd.funct),
                 static_cast<unsigned>(load0.rs_tag),
-                load0.deps_ld);
+                static_cast<unsigned long long>(load0.deps_ld));
     std::printf("  completion_ok=%u has_dma_resp=%u expected=%u returned=%u tag=%u rs_empty=%u\n",
                 completion_ok ? 1u : 0u,
                 top.ldCtrl().hasDmaResponse() ? 1u : 0u,
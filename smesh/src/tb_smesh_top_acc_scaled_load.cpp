@@ -0,0 +1,175 @@
+// **********************************************************************
+// smesh/src/tb_smesh_top_acc_scaled_load.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Oct 17 2026
+// Focused SmeshTop full-width accumulator load with an mvin scale. CONFIG_LD
+// sets a 0.5 scale and a padded DRAM stride, then one MVIN with
+// read_full_acc_row moves kDim rows of 32-bit bias words from Dram into Accum.
+// Every lane must arrive scaled (ties to even, negative extremes exact), LdCtrl
+// must count four bytes per element and the MVIN's RS tag must retire.
+
+#include <cascade/Cascade.hpp>
+#include <descore/Parameter.hpp>
+
+#include "Requantize.hpp"
+#include "SmeshCommand.hpp"
+#include "SmeshTop.hpp"
+#include "smem/Dram.hpp"
+#include "smem/MemCtrl.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+constexpr std::uint64_t kDramBase = 0x80005000;
+constexpr std::uint32_t kDramRowStride = smesh::kDim * sizeof(smesh::Acc) + 4;
+
+namespace {
+
+using BiasRows = std::array<std::array<smesh::Acc, smesh::kDim>, smesh::kDim>;
+
+// odd lanes land on ties, and the last row holds the Acc extremes
+BiasRows biasRows() {
+  BiasRows rows{};
+  for (std::size_t r = 0; r < smesh::kDim; ++r) {
+    for (std::size_t c = 0; c < smesh::kDim; ++c) {
+      const auto v = static_cast<smesh::Acc>(1000 * r + 2 * c + 1);
+      rows[r][c] = (r + c) % 2 == 0 ? v : -v;
+    }
+  }
+  rows[smesh::kDim - 1][0] = std::numeric_limits<smesh::Acc>::min();
+  rows[smesh::kDim - 1][1] = std::numeric_limits<smesh::Acc>::max();
+  return rows;
+}
+
+} // namespace
+
+class TopAccScaledLoadDriver : public Component {
+  DECLARE_COMPONENT(TopAccScaledLoadDriver);
+
+ public:
+  TopAccScaledLoadDriver(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+  Output(bit, cmd_valid);
+  Output(smesh::SmeshCmd, cmd_bits);
+  Input(bit, cmd_ready);
+
+  void update();
+  void reset();
+
+ private:
+  std::uint32_t next_command_ = 0;
+};
+
+TopAccScaledLoadDriver::TopAccScaledLoadDriver(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(update).reads(cmd_ready).writes(cmd_valid, cmd_bits);
+}
+
+void TopAccScaledLoadDriver::update() {
+  cmd_valid = 0;
+  cmd_bits = smesh::SmeshCmd{};
+  if (Sim::state == Sim::SimResetting) {
+    return;
+  }
+  if (next_command_ >= 2) {
+    return;
+  }
+
+  constexpr smesh::MatrixShape shape{smesh::kDim, smesh::kDim};
+  smesh::SmeshCmd cmd{};
+  if (next_command_ == 0) {
+    cmd.funct = u32(static_cast<std::uint32_t>(smesh::SmeshFunct::Config));
+    cmd.rs1 = u64(smesh::packConfig(smesh::ConfigKind::Load, 0, smesh::kDim, smesh::accScaleFromFloat(0.5f)));
+    cmd.rs2 = u64(kDramRowStride);
+  } else {
+    cmd.funct = u32(static_cast<std::uint32_t>(smesh::SmeshFunct::Mvin));
+    cmd.rs1 = u64(kDramBase);
+    cmd.rs2 = u64(smesh::packLocal(smesh::makeAccAddr(0, false, true), shape)); // 32-bit rows
+  }
+
+  cmd_bits = cmd;
+  cmd_valid = 1;
+  if (cmd_ready != 0) {
+    trace("top_acc_scaled_load_driver: pushed funct=%u", static_cast<unsigned>(cmd.funct));
+    ++next_command_;
+  }
+}
+
+void TopAccScaledLoadDriver::reset() {
+  next_command_ = 0;
+}
+
+int main(int argc, char* argv[]) {
+  descore::parseTraces(argc, argv);
+  Parameter::parseCommandLine(argc, argv);
+  Sim::parseDumps(argc, argv);
+
+  TopAccScaledLoadDriver driver("Driver");
+  smesh::SmeshTop top("SmeshTop");
+  smem::MemCtrl mem("MemCtrl");
+  smem::Dram dram("Dram", 0);
+
+  top.cmd_valid << driver.cmd_valid;
+  top.cmd_bits << driver.cmd_bits;
+  driver.cmd_ready << top.cmd_ready;
+  mem.in_core_req << top.memReq();
+  top.memResp() << mem.out_core_resp;
+  mem.in_core_req.setDelay(1);
+  dram.s_req << mem.s_req;
+  mem.s_resp << dram.s_resp;
+
+  Clock clk;
+  driver.clk << clk;
+  top.clk << clk;
+  mem.clk << clk;
+  dram.clk << clk;
+  clk.generateClock();
+
+  Cascade::params.MaxResetIterations = 1;
+  Sim::init();
+  Sim::reset();
+
+  const auto rows = biasRows();
+  for (std::size_t r = 0; r < smesh::kDim; ++r) {
+    dram.write(kDramBase + r * kDramRowStride, rows[r].data(), smesh::kDim * sizeof(smesh::Acc));
+  }
+
+  for (int i = 0; i < 256 && !(top.ldCtrl().hasDmaResponse() && top.rs().empty()); ++i) {
+    Sim::run();
+  }
+
+  bool accum_ok = top.accum().hasAcceptedWrite();
+  for (std::size_t r = 0; r < smesh::kDim; ++r) {
+    const auto& acc_row = top.accum().row(smesh::makeAccAddr(static_cast<std::uint32_t>(r)));
+    for (std::size_t c = 0; c < smesh::kDim; ++c) {
+      const auto want = static_cast<smesh::Acc>(std::nearbyint(0.5 * rows[r][c])); // exact in double, ties to even
+      if (acc_row[c] != want) {
+        std::printf("  MISMATCH r=%zu c=%zu got=%d expected=%d\n", r, c, acc_row[c], want);
+      }
+      accum_ok = accum_ok && acc_row[c] == want;
+    }
+  }
+
+  constexpr std::uint32_t kBytes = smesh::kDim * smesh::kDim * sizeof(smesh::Acc);
+  const bool completion_ok = top.ldCtrl().hasDmaResponse() &&
+                             !top.ldCtrl().hasActiveCommand() &&
+                             top.ldCtrl().expectedBytes() == kBytes &&
+                             top.ldCtrl().returnedBytes() == kBytes &&
+                             top.ldCtrl().responseRsTag() == 1 &&
+                             top.rs().empty();
+  const bool ok = accum_ok && completion_ok;
+  if (!ok) {
+    std::printf("  accum_ok=%u completion_ok=%u has_dma_resp=%u expected=%u returned=%u tag=%u rs_empty=%u\n",
+                accum_ok ? 1u : 0u,
+                completion_ok ? 1u : 0u,
+                top.ldCtrl().hasDmaResponse() ? 1u : 0u,
+                top.ldCtrl().expectedBytes(),
+                top.ldCtrl().returnedBytes(),
+                static_cast<unsigned>(top.ldCtrl().responseRsTag()),
+                top.rs().empty() ? 1u : 0u);
+  }
+  std::printf("[SMESH_TOP_ACC_SCALED_LOAD] %s scaled_mvin_to_accum_full_width\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
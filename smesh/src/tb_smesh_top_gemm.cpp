@@ -0,0 +1,231 @@
+// **********************************************************************
+// smesh/src/tb_smesh_top_gemm.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Oct 17 2026
+// End-to-end SmeshTop GEMM: C = A * B with K = 2 * kDim, through external
+// MemCtrl/Dram. MVIN the two A column blocks and two B row blocks, PRELOAD B0
+// over C and COMPUTE A0, PRELOAD B1 accumulating into C and COMPUTE A1, then a
+// full-width MVOUT. C in Dram must match a reference matmul and every RS tag
+// must retire.
+
+#include <cascade/Cascade.hpp>
+#include <descore/Parameter.hpp>
+
+#include "SmeshCommand.hpp"
+#include "SmeshTop.hpp"
+#include "smem/Dram.hpp"
+#include "smem/MemCtrl.hpp"
+
+#include <array>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kK = 2 * smesh::kDim;
+constexpr std::uint64_t kADramBase = 0x80010000; // kDim x kK, packed rows
+constexpr std::uint64_t kBDramBase = 0x80011000; // kK x kDim, rows padded to kBDramStride
+constexpr std::uint64_t kCDramBase = 0x80012000; // kDim x kDim Acc
+constexpr std::uint32_t kADramStride = kK * sizeof(smesh::Elem);
+constexpr std::uint32_t kBDramStride = smesh::kDim * sizeof(smesh::Elem) + 3;
+constexpr std::uint32_t kCDramStride = smesh::kDim * sizeof(smesh::Acc) + 4;
+
+using MatrixA = std::array<std::array<smesh::Elem, kK>, smesh::kDim>;
+using MatrixB = std::array<std::array<smesh::Elem, smesh::kDim>, kK>;
+using MatrixC = std::array<std::array<smesh::Acc, smesh::kDim>, smesh::kDim>;
+
+smesh::SmeshCmd command(smesh::SmeshFunct funct, std::uint64_t rs1 = 0, std::uint64_t rs2 = 0) {
+  return smesh::SmeshCmd{u32(static_cast<std::uint32_t>(funct)), u64(rs1), u64(rs2)};
+}
+
+// A block k in Spad bank 0 rows k*kDim.., B block k in bank 1, C at Accum row 0
+std::vector<smesh::SmeshCmd> gemmProgram() {
+  const auto dim = static_cast<std::uint32_t>(smesh::kDim);
+  const smesh::MatrixShape block{smesh::kDim, smesh::kDim};
+  std::vector<smesh::SmeshCmd> program{
+      command(smesh::SmeshFunct::Config, smesh::packConfig(smesh::ConfigKind::Load, 0, dim), kADramStride),
+      command(smesh::SmeshFunct::Config, smesh::packConfig(smesh::ConfigKind::Load, 1, dim), kBDramStride),
+      command(smesh::SmeshFunct::Config, smesh::packConfig(smesh::ConfigKind::Store), kCDramStride),
+      command(smesh::SmeshFunct::Config, smesh::packConfigExecuteRs1(1), smesh::packConfigExecuteRs2(1)),
+  };
+  for (std::uint32_t k = 0; k < kK / smesh::kDim; ++k) {
+    const auto a = smesh::makeSpAddr(k * dim);
+    const auto b = smesh::makeSpAddr(static_cast<std::uint32_t>(smesh::kSpBankRows) + k * dim);
+    program.push_back(command(smesh::SmeshFunct::Mvin, kADramBase + k * dim * sizeof(smesh::Elem), smesh::packLocal(a, block)));
+    program.push_back(command(smesh::SmeshFunct::Mvin2, kBDramBase + k * dim * kBDramStride, smesh::packLocal(b, block)));
+  }
+  for (std::uint32_t k = 0; k < kK / smesh::kDim; ++k) {
+    const auto a = smesh::makeSpAddr(k * dim);
+    const auto b = smesh::makeSpAddr(static_cast<std::uint32_t>(smesh::kSpBankRows) + k * dim);
+    program.push_back(command(smesh::SmeshFunct::Preload,
+                              smesh::packLocal(b, block),
+                              smesh::packLocal(smesh::makeAccAddr(0, k != 0), block))); // later k-steps accumulate
+    program.push_back(command(smesh::SmeshFunct::ComputeFlip,
+                              smesh::packLocal(a, block),
+                              smesh::packLocal(smesh::makeGarbageAddr(), block)));
+  }
+  program.push_back(command(smesh::SmeshFunct::Mvout, kCDramBase,
+                            smesh::packLocal(smesh::makeAccAddr(0, false, true), block))); // full-width Acc rows
+  return program;
+}
+
+MatrixC referenceMatmul(const MatrixA& a, const MatrixB& b) {
+  MatrixC c{};
+  for (std::size_t r = 0; r < smesh::kDim; ++r) {
+    for (std::size_t col = 0; col < smesh::kDim; ++col) {
+      for (std::size_t k = 0; k < kK; ++k) {
+        c[r][col] += static_cast<smesh::Acc>(a[r][k]) * static_cast<smesh::Acc>(b[k][col]);
+      }
+    }
+  }
+  return c;
+}
+
+} // namespace
+
+class TopGemmDriver : public Component {
+  DECLARE_COMPONENT(TopGemmDriver);
+
+ public:
+  TopGemmDriver(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+  Output(bit, cmd_valid);
+  Output(smesh::SmeshCmd, cmd_bits);
+  Input(bit, cmd_ready);
+
+  void update();
+  void reset();
+
+  bool done() const { return next_command_ >= program_.size(); }
+  std::size_t commands() const { return program_.size(); }
+
+ private:
+  const std::vector<smesh::SmeshCmd> program_ = gemmProgram();
+  std::size_t next_command_ = 0;
+};
+
+TopGemmDriver::TopGemmDriver(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(update).reads(cmd_ready).writes(cmd_valid, cmd_bits);
+}
+
+void TopGemmDriver::update() {
+  cmd_valid = 0;
+  cmd_bits = smesh::SmeshCmd{};
+  if (Sim::state == Sim::SimResetting || done()) {
+    return;
+  }
+
+  cmd_bits = program_[next_command_];
+  cmd_valid = 1;
+  if (cmd_ready != 0) {
+    trace("top_gemm_driver: pushed funct=%u", static_cast<unsigned>(program_[next_command_].funct));
+    ++next_command_;
+  }
+}
+
+void TopGemmDriver::reset() {
+  next_command_ = 0;
+}
+
+int main(int argc, char* argv[]) {
+  descore::parseTraces(argc, argv);
+  Parameter::parseCommandLine(argc, argv);
+  Sim::parseDumps(argc, argv);
+
+  TopGemmDriver driver("Driver");
+  smesh::SmeshTop top("SmeshTop");
+  smem::MemCtrl mem("MemCtrl");
+  smem::Dram dram("Dram", 0);
+
+  top.cmd_valid << driver.cmd_valid;
+  top.cmd_bits << driver.cmd_bits;
+  driver.cmd_ready << top.cmd_ready;
+  mem.in_core_req << top.memReq();
+  top.memResp() << mem.out_core_resp;
+  mem.in_core_req.setDelay(1);
+  dram.s_req << mem.s_req;
+  mem.s_resp << dram.s_resp;
+
+  Clock clk;
+  driver.clk << clk;
+  top.clk << clk;
+  mem.clk << clk;
+  dram.clk << clk;
+  clk.generateClock();
+
+  Cascade::params.MaxResetIterations = 1;
+  Sim::init();
+  Sim::reset();
+
+  std::mt19937 rng(18);
+  MatrixA a{};
+  MatrixB b{};
+  for (std::size_t r = 0; r < smesh::kDim; ++r) {
+    for (std::size_t k = 0; k < kK; ++k) {
+      a[r][k] = static_cast<smesh::Elem>(static_cast<int>(rng() % 255) - 127);
+    }
+    dram.write(kADramBase + r * kADramStride, a[r].data(), kK);
+  }
+  for (std::size_t k = 0; k < kK; ++k) {
+    for (std::size_t c = 0; c < smesh::kDim; ++c) {
+      b[k][c] = static_cast<smesh::Elem>(static_cast<int>(rng() % 255) - 127);
+    }
+    dram.write(kBDramBase + k * kBDramStride, b[k].data(), smesh::kDim);
+  }
+  // poison C so rows the mvout skips cannot pass by accident
+  const std::array<std::uint8_t, kCDramStride> poison = [] {
+    std::array<std::uint8_t, kCDramStride> p{};
+    p.fill(0xa5);
+    return p;
+  }();
+  for (std::size_t r = 0; r < smesh::kDim; ++r) {
+    dram.write(kCDramBase + r * kCDramStride, poison.data(), poison.size());
+  }
+
+  int cycles = 0;
+  for (; cycles < 4096 && !(driver.done() && top.rs().empty() && top.dmaMemArb().writesIdle()); ++cycles) {
+    Sim::run();
+  }
+
+  const auto want = referenceMatmul(a, b);
+  bool dram_ok = true;
+  for (std::size_t r = 0; r < smesh::kDim; ++r) {
+    for (std::size_t c = 0; c < smesh::kDim; ++c) {
+      smesh::Acc got = 0;
+      dram.read(kCDramBase + r * kCDramStride + c * sizeof(got), &got, sizeof(got));
+      if (got != want[r][c]) {
+        std::printf("  MISMATCH r=%zu c=%zu got=%d expected=%d\n", r, c, got, want[r][c]);
+        dram_ok = false;
+      }
+    }
+  }
+  bool accum_ok = true;
+  for (std::size_t r = 0; r < smesh::kDim; ++r) {
+    const auto& row = top.accum().row(smesh::makeAccAddr(static_cast<std::uint32_t>(r)));
+    for (std::size_t c = 0; c < smesh::kDim; ++c) {
+      accum_ok = accum_ok && row[c] == want[r][c];
+    }
+  }
+  const bool complete_ok = driver.done() &&
+                           top.rs().empty() &&
+                           top.dmaMemArb().writesIdle() &&
+                           top.dmaMemArb().writes() == smesh::kDim &&
+                           top.stCtrl().writesAcked() == smesh::kDim &&
+                           top.stCtrl().outstanding() == 0;
+  const bool ok = dram_ok && accum_ok && complete_ok;
+
+  std::printf("  cycles=%d commands=%zu\n", cycles, driver.commands());
+  if (!ok) {
+    std::printf("  dram_ok=%u accum_ok=%u complete_ok=%u rs_empty=%u writes=%llu writes_acked=%llu\n",
+                dram_ok ? 1u : 0u,
+                accum_ok ? 1u : 0u,
+                complete_ok ? 1u : 0u,
+                top.rs().empty() ? 1u : 0u,
+                static_cast<unsigned long long>(top.dmaMemArb().writes()),
+                static_cast<unsigned long long>(top.stCtrl().writesAcked()));
+  }
+  std::printf("[SMESH_TOP_GEMM] %s mvin_preload_compute_mvout\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,297 @@
+// **********************************************************************
+// smesh/src/tb_smesh_top_gemm_transpose.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Oct 17 2026
+// End-to-end transposed WS GEMMs: C = A * B with K = 2 * kDim through SmeshTop
+// and external MemCtrl/Dram, the same program as tb_smesh_top_gemm but with
+// one operand stored transposed. Two rigs run side by side:
+//   ATranspose   CONFIG_EX a_transpose=1: Dram holds A^T (K x kDim), so each
+//                Spad A block is A_k^T and goes through the Transposer
+//   BdTranspose  CONFIG_EX bd_transpose=1: Dram holds B^T (kDim x K), so each
+//                preloaded block is B_k^T and goes through the Transposer
+// C in Dram and Accum must match a reference matmul of the untransposed
+// operands, and every RS tag must retire. OS is not run: ExCtrl's Flush
+// states are still a TODO, so the last OS tile never leaves the mesh.
+
+#include <cascade/Cascade.hpp>
+#include <descore/Parameter.hpp>
+
+#include "SmeshCommand.hpp"
+#include "SmeshTop.hpp"
+#include "smem/Dram.hpp"
+#include "smem/MemCtrl.hpp"
+
+#include <array>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kK = 2 * smesh::kDim;
+constexpr std::uint64_t kADramBase = 0x80010000; // A (kDim x kK) or A^T (kK x kDim)
+constexpr std::uint64_t kBDramBase = 0x80011000; // B (kK x kDim) or B^T (kDim x kK)
+constexpr std::uint64_t kCDramBase = 0x80012000; // kDim x kDim Acc
+constexpr std::uint32_t kWideStride = kK * sizeof(smesh::Elem) + 5;          // kDim rows of kK
+constexpr std::uint32_t kTallStride = smesh::kDim * sizeof(smesh::Elem) + 3; // kK rows of kDim
+constexpr std::uint32_t kCDramStride = smesh::kDim * sizeof(smesh::Acc) + 4;
+
+using MatrixA = std::array<std::array<smesh::Elem, kK>, smesh::kDim>;
+using MatrixB = std::array<std::array<smesh::Elem, smesh::kDim>, kK>;
+using MatrixC = std::array<std::array<smesh::Acc, smesh::kDim>, smesh::kDim>;
+
+smesh::SmeshCmd command(smesh::SmeshFunct funct, std::uint64_t rs1 = 0, std::uint64_t rs2 = 0) {
+  return smesh::SmeshCmd{u32(static_cast<std::uint32_t>(funct)), u64(rs1), u64(rs2)};
+}
+// Dram address of K-block k of A (or A^T) and of B (or B^T)
+std::uint64_t aBlock(bool a_transpose, std::uint32_t k) {
+  const auto dim = static_cast<std::uint32_t>(smesh::kDim);
+  return a_transpose ? kADramBase + k * dim * kTallStride : kADramBase + k * dim * sizeof(smesh::Elem);
+}
+std::uint64_t bBlock(bool bd_transpose, std::uint32_t k) {
+  const auto dim = static_cast<std::uint32_t>(smesh::kDim);
+  return bd_transpose ? kBDramBase + k * dim * sizeof(smesh::Elem) : kBDramBase + k * dim * kTallStride;
+}
+
+// A block k in Spad bank 0 rows k*kDim.., B block k in bank 1, C at Accum row 0
+std::vector<smesh::SmeshCmd> gemmProgram(bool a_transpose, bool bd_transpose) {
+  const auto dim = static_cast<std::uint32_t>(smesh::kDim);
+  const smesh::MatrixShape block{smesh::kDim, smesh::kDim};
+  std::vector<smesh::SmeshCmd> program{
+      command(smesh::SmeshFunct::Config, smesh::packConfig(smesh::ConfigKind::Load, 0, dim),
+              a_transpose ? kTallStride : kWideStride),
+      command(smesh::SmeshFunct::Config, smesh::packConfig(smesh::ConfigKind::Load, 1, dim),
+              bd_transpose ? kWideStride : kTallStride),
+      command(smesh::SmeshFunct::Config, smesh::packConfig(smesh::ConfigKind::Store), kCDramStride),
+      command(smesh::SmeshFunct::Config,
+              smesh::packConfigExecuteRs1(1, a_transpose, bd_transpose),
+              smesh::packConfigExecuteRs2(1)),
+  };
+  for (std::uint32_t k = 0; k < kK / smesh::kDim; ++k) {
+    const auto a = smesh::makeSpAddr(k * dim);
+    const auto b = smesh::makeSpAddr(static_cast<std::uint32_t>(smesh::kSpBankRows) + k * dim);
+    program.push_back(command(smesh::SmeshFunct::Mvin, aBlock(a_transpose, k), smesh::packLocal(a, block)));
+    program.push_back(command(smesh::SmeshFunct::Mvin2, bBlock(bd_transpose, k), smesh::packLocal(b, block)));
+  }
+  for (std::uint32_t k = 0; k < kK / smesh::kDim; ++k) {
+    const auto a = smesh::makeSpAddr(k * dim);
+    const auto b = smesh::makeSpAddr(static_cast<std::uint32_t>(smesh::kSpBankRows) + k * dim);
+    program.push_back(command(smesh::SmeshFunct::Preload,
+                              smesh::packLocal(b, block),
+                              smesh::packLocal(smesh::makeAccAddr(0, k != 0), block))); // later k-steps accumulate
+    program.push_back(command(smesh::SmeshFunct::ComputeFlip,
+                              smesh::packLocal(a, block),
+                              smesh::packLocal(smesh::makeGarbageAddr(), block)));
+  }
+  program.push_back(command(smesh::SmeshFunct::Mvout, kCDramBase,
+                            smesh::packLocal(smesh::makeAccAddr(0, false, true), block))); // full-width Acc rows
+  return program;
+}
+
+MatrixC referenceMatmul(const MatrixA& a, const MatrixB& b) {
+  MatrixC c{};
+  for (std::size_t r = 0; r < smesh::kDim; ++r) {
+    for (std::size_t col = 0; col < smesh::kDim; ++col) {
+      for (std::size_t k = 0; k < kK; ++k) {
+        c[r][col] += static_cast<smesh::Acc>(a[r][k]) * static_cast<smesh::Acc>(b[k][col]);
+      }
+    }
+  }
+  return c;
+}
+
+} // namespace
+
+class TopGemmDriver : public Component {
+  DECLARE_COMPONENT(TopGemmDriver);
+
+ public:
+  TopGemmDriver(std::string name, std::vector<smesh::SmeshCmd> program, COMPONENT_CTOR);
+
+  Clock(clk);
+  Output(bit, cmd_valid);
+  Output(smesh::SmeshCmd, cmd_bits);
+  Input(bit, cmd_ready);
+
+  void update();
+  void reset();
+
+  bool done() const { return next_command_ >= program_.size(); }
+  std::size_t commands() const { return program_.size(); }
+
+ private:
+  const std::vector<smesh::SmeshCmd> program_;
+  std::size_t next_command_ = 0;
+};
+
+TopGemmDriver::TopGemmDriver(std::string /*name*/, std::vector<smesh::SmeshCmd> program, IMPL_CTOR)
+    : program_(std::move(program)) {
+  UPDATE(update).reads(cmd_ready).writes(cmd_valid, cmd_bits);
+}
+
+void TopGemmDriver::update() {
+  cmd_valid = 0;
+  cmd_bits = smesh::SmeshCmd{};
+  if (Sim::state == Sim::SimResetting || done()) {
+    return;
+  }
+
+  cmd_bits = program_[next_command_];
+  cmd_valid = 1;
+  if (cmd_ready != 0) {
+    trace("top_gemm_driver: pushed funct=%u", static_cast<unsigned>(program_[next_command_].funct));
+    ++next_command_;
+  }
+}
+
+void TopGemmDriver::reset() {
+  next_command_ = 0;
+}
+
+namespace {
+
+struct Rig {
+  Rig(const std::string& rig, bool transpose_a, bool transpose_bd)
+      : name(rig),
+        a_transpose(transpose_a),
+        bd_transpose(transpose_bd),
+        driver(rig + "Driver", gemmProgram(transpose_a, transpose_bd)),
+        top(rig + "SmeshTop"),
+        mem(rig + "MemCtrl"),
+        dram(rig + "Dram", 0) {}
+
+  std::string     name;
+  bool            a_transpose;
+  bool            bd_transpose;
+  TopGemmDriver   driver;
+  smesh::SmeshTop top;
+  smem::MemCtrl   mem;
+  smem::Dram      dram;
+
+  void connect(Clock& clk) {
+    top.cmd_valid << driver.cmd_valid;
+    top.cmd_bits << driver.cmd_bits;
+    driver.cmd_ready << top.cmd_ready;
+    mem.in_core_req << top.memReq();
+    top.memResp() << mem.out_core_resp;
+    mem.in_core_req.setDelay(1);
+    dram.s_req << mem.s_req;
+    mem.s_resp << dram.s_resp;
+    driver.clk << clk;
+    top.clk << clk;
+    mem.clk << clk;
+    dram.clk << clk;
+  }
+  // A and B land in Dram as the CONFIG_EX bits expect them: transposed where set
+  void seed(const MatrixA& a, const MatrixB& b) {
+    for (std::size_t r = 0; r < smesh::kDim; ++r) {
+      for (std::size_t k = 0; k < kK; ++k) {
+        const auto addr = a_transpose ? kADramBase + k * kTallStride + r : kADramBase + r * kWideStride + k;
+        dram.write(addr, &a[r][k], 1);
+      }
+    }
+    for (std::size_t k = 0; k < kK; ++k) {
+      for (std::size_t c = 0; c < smesh::kDim; ++c) {
+        const auto addr = bd_transpose ? kBDramBase + c * kWideStride + k : kBDramBase + k * kTallStride + c;
+        dram.write(addr, &b[k][c], 1);
+      }
+    }
+    // poison C so rows the mvout skips cannot pass by accident
+    std::array<std::uint8_t, kCDramStride> poison{};
+    poison.fill(0xa5);
+    for (std::size_t r = 0; r < smesh::kDim; ++r) {
+      dram.write(kCDramBase + r * kCDramStride, poison.data(), poison.size());
+    }
+  }
+
+  bool finished() const { return driver.done() && top.rs().empty() && top.dmaMemArb().writesIdle(); }
+
+  bool check(const MatrixC& want) {
+    bool dram_ok = true;
+    for (std::size_t r = 0; r < smesh::kDim; ++r) {
+      for (std::size_t c = 0; c < smesh::kDim; ++c) {
+        smesh::Acc got = 0;
+        dram.read(kCDramBase + r * kCDramStride + c * sizeof(got), &got, sizeof(got));
+        if (got != want[r][c]) {
+          std::printf("  %s MISMATCH r=%zu c=%zu got=%d expected=%d\n", name.c_str(), r, c, got, want[r][c]);
+          dram_ok = false;
+        }
+      }
+    }
+    bool accum_ok = true;
+    for (std::size_t r = 0; r < smesh::kDim; ++r) {
+      const auto& row = top.accum().row(smesh::makeAccAddr(static_cast<std::uint32_t>(r)));
+      for (std::size_t c = 0; c < smesh::kDim; ++c) {
+        accum_ok = accum_ok && row[c] == want[r][c];
+      }
+    }
+    const bool complete_ok = finished() &&
+                             top.dmaMemArb().writes() == smesh::kDim &&
+                             top.stCtrl().writesAcked() == smesh::kDim &&
+                             top.stCtrl().outstanding() == 0;
+    const bool ok = dram_ok && accum_ok && complete_ok;
+    if (!ok) {
+      std::printf("  %s dram_ok=%u accum_ok=%u complete_ok=%u rs_empty=%u writes=%llu writes_acked=%llu\n",
+                  name.c_str(),
+                  dram_ok ? 1u : 0u,
+                  accum_ok ? 1u : 0u,
+                  complete_ok ? 1u : 0u,
+                  top.rs().empty() ? 1u : 0u,
+                  static_cast<unsigned long long>(top.dmaMemArb().writes()),
+                  static_cast<unsigned long long>(top.stCtrl().writesAcked()));
+    }
+    return ok;
+  }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  descore::parseTraces(argc, argv);
+  Parameter::parseCommandLine(argc, argv);
+  Sim::parseDumps(argc, argv);
+
+  Rig a_rig("ATranspose", true, false);
+  Rig bd_rig("BdTranspose", false, true);
+
+  Clock clk;
+  a_rig.connect(clk);
+  bd_rig.connect(clk);
+  clk.generateClock();
+
+  Cascade::params.MaxResetIterations = 1;
+  Sim::init();
+  Sim::reset();
+
+  std::mt19937 rng(14);
+  MatrixA a{};
+  MatrixB b{};
+  for (auto& row : a) {
+    for (auto& v : row) {
+      v = static_cast<smesh::Elem>(static_cast<int>(rng() % 255) - 127);
+    }
+  }
+  for (auto& row : b) {
+    for (auto& v : row) {
+      v = static_cast<smesh::Elem>(static_cast<int>(rng() % 255) - 127);
+    }
+  }
+  a_rig.seed(a, b);
+  bd_rig.seed(a, b);
+
+  int cycles = 0;
+  for (; cycles < 4096 && !(a_rig.finished() && bd_rig.finished()); ++cycles) {
+    Sim::run();
+  }
+
+  const auto want = referenceMatmul(a, b);
+  const bool a_ok = a_rig.check(want);
+  const bool bd_ok = bd_rig.check(want);
+
+  std::printf("  cycles=%d commands=%zu\n", cycles, a_rig.driver.commands());
+  std::printf("[SMESH_TOP_GEMM_TRANSPOSE] %s ws_a_transpose\n", a_ok ? "PASS" : "FAIL");
+  std::printf("[SMESH_TOP_GEMM_TRANSPOSE] %s ws_bd_transpose\n", bd_ok ? "PASS" : "FAIL");
+  return a_ok && bd_ok ? 0 : 1;
+}
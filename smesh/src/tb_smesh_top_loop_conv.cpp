@@ -0,0 +1,272 @@
+// **********************************************************************
+// smesh/src/tb_smesh_top_loop_conv.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Oct 17 2026
+// End-to-end LOOP_CONV_WS through SmeshTop and external MemCtrl/Dram. A padded
+// 3x3 layer with an Acc bias over two images and odd channel counts, then a
+// strided, dilated layer without bias. The store phase issues multi-row MVOUTs
+// at the output-channel stride; the NHWC output in Dram must match a reference
+// convolution, the row past it must stay untouched, and every unrolled command
+// must retire.
+
+#include <cascade/Cascade.hpp>
+#include <descore/Parameter.hpp>
+
+#include "SmeshCommand.hpp"
+#include "SmeshTop.hpp"
+#include "smem/Dram.hpp"
+#include "smem/MemCtrl.hpp"
+
+#include <array>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::uint8_t kPoison = 0xa5;
+
+struct ConvLayer {
+  smesh::LoopConvDims   dims{};
+  smesh::LoopConvKernel kernel{};
+  std::uint64_t input   = 0;
+  std::uint64_t weights = 0;
+  std::uint64_t bias    = 0; // 0: none
+  std::uint64_t output  = 0;
+
+  std::uint32_t outDim() const {
+    const std::uint32_t span = kernel.dilation * (kernel.kernel_dim - 1) + 1;
+    return (dims.in_dim + 2 * kernel.padding - span) / kernel.stride + 1;
+  }
+};
+
+smesh::SmeshCmd command(smesh::SmeshFunct funct, std::uint64_t rs1 = 0, std::uint64_t rs2 = 0) {
+  return smesh::SmeshCmd{u32(static_cast<std::uint32_t>(funct)), u64(rs1), u64(rs2)};
+}
+
+std::vector<smesh::SmeshCmd> convCmds(const ConvLayer& l) {
+  return {
+      command(smesh::SmeshFunct::LoopConvWsConfigDims, smesh::packLoopConvDims(l.dims), l.outDim()),
+      command(smesh::SmeshFunct::LoopConvWsConfigKernel, smesh::packLoopConvKernel(l.kernel)),
+      command(smesh::SmeshFunct::LoopConvWsConfigAddrsWO, l.weights, l.output),
+      command(smesh::SmeshFunct::LoopConvWsConfigAddrsBI, l.bias, l.input),
+      command(smesh::SmeshFunct::LoopConvWs, smesh::packLoopWsRs1()),
+  };
+}
+
+// out[b][orow][ocol][och] = bias[och] + sum over taps and ich of in * w
+std::vector<smesh::Acc> referenceConv(const ConvLayer& l,
+                                      const std::vector<int>& in,
+                                      const std::vector<int>& w,
+                                      const std::vector<int>& bias) {
+  const auto& d = l.dims;
+  const auto& k = l.kernel;
+  const std::int64_t out_dim = l.outDim();
+  std::vector<smesh::Acc> out(static_cast<std::size_t>(d.batch * out_dim * out_dim * d.out_channels));
+  for (std::int64_t b = 0; b < d.batch; ++b) {
+    for (std::int64_t orow = 0; orow < out_dim; ++orow) {
+      for (std::int64_t ocol = 0; ocol < out_dim; ++ocol) {
+        for (std::int64_t och = 0; och < d.out_channels; ++och) {
+          smesh::Acc sum = bias.empty() ? 0 : bias[och];
+          for (std::int64_t kr = 0; kr < k.kernel_dim; ++kr) {
+            for (std::int64_t kc = 0; kc < k.kernel_dim; ++kc) {
+              const std::int64_t irow = orow * k.stride + kr * k.dilation - k.padding;
+              const std::int64_t icol = ocol * k.stride + kc * k.dilation - k.padding;
+              if (irow < 0 || icol < 0 || irow >= d.in_dim || icol >= d.in_dim) {
+                continue;
+              }
+              for (std::int64_t ich = 0; ich < d.in_channels; ++ich) {
+                sum += in[((b * d.in_dim + irow) * d.in_dim + icol) * d.in_channels + ich] *
+                       w[((kr * k.kernel_dim + kc) * d.in_channels + ich) * d.out_channels + och];
+              }
+            }
+          }
+          out[((b * out_dim + orow) * out_dim + ocol) * d.out_channels + och] = sum;
+        }
+      }
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+class TopLoopConvDriver : public Component {
+  DECLARE_COMPONENT(TopLoopConvDriver);
+
+ public:
+  TopLoopConvDriver(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+  Output(bit, cmd_valid);
+  Output(smesh::SmeshCmd, cmd_bits);
+  Input(bit, cmd_ready);
+
+  void update();
+  void reset();
+
+  std::vector<smesh::SmeshCmd> cmds;
+  bool done() const { return next_ >= cmds.size(); }
+
+ private:
+  std::size_t next_ = 0;
+};
+
+TopLoopConvDriver::TopLoopConvDriver(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(update).reads(cmd_ready).writes(cmd_valid, cmd_bits);
+}
+
+void TopLoopConvDriver::update() {
+  cmd_valid = 0;
+  cmd_bits = smesh::SmeshCmd{};
+  if (Sim::state == Sim::SimResetting || done()) {
+    return;
+  }
+
+  cmd_bits = cmds[next_];
+  cmd_valid = 1;
+  if (cmd_ready != 0) {
+    trace("top_loop_conv_driver: pushed funct=%u", static_cast<unsigned>(cmds[next_].funct));
+    ++next_;
+  }
+}
+
+void TopLoopConvDriver::reset() {
+  next_ = 0;
+}
+
+int main(int argc, char* argv[]) {
+  descore::parseTraces(argc, argv);
+  Parameter::parseCommandLine(argc, argv);
+  Sim::parseDumps(argc, argv);
+
+  const std::uint32_t dim = static_cast<std::uint32_t>(smesh::kDim);
+  std::array<ConvLayer, 2> layers{};
+  layers[0].dims    = smesh::LoopConvDims{2, 5, dim + 2, dim + 1};
+  layers[0].kernel  = smesh::LoopConvKernel{3, 1, 1, 1};
+  layers[0].input   = 0x80030000;
+  layers[0].weights = 0x80031000;
+  layers[0].bias    = 0x80032000;
+  layers[0].output  = 0x80033000;
+  layers[1].dims    = smesh::LoopConvDims{1, 7, dim - 1, dim};
+  layers[1].kernel  = smesh::LoopConvKernel{3, 2, 2, 2};
+  layers[1].input   = 0x80036000;
+  layers[1].weights = 0x80037000;
+  layers[1].output  = 0x80038000;
+
+  TopLoopConvDriver driver("Driver");
+  smesh::SmeshTop top("SmeshTop");
+  smem::MemCtrl mem("MemCtrl");
+  smem::Dram dram("Dram", 0);
+  for (const auto& l : layers) {
+    const auto cmds = convCmds(l);
+    driver.cmds.insert(driver.cmds.end(), cmds.begin(), cmds.end());
+  }
+
+  top.cmd_valid << driver.cmd_valid;
+  top.cmd_bits << driver.cmd_bits;
+  driver.cmd_ready << top.cmd_ready;
+  mem.in_core_req << top.memReq();
+  top.memResp() << mem.out_core_resp;
+  mem.in_core_req.setDelay(1);
+  dram.s_req << mem.s_req;
+  mem.s_resp << dram.s_resp;
+
+  Clock clk;
+  driver.clk << clk;
+  top.clk << clk;
+  mem.clk << clk;
+  dram.clk << clk;
+  clk.generateClock();
+
+  Cascade::params.MaxResetIterations = 1;
+  Sim::init();
+  Sim::reset();
+
+  std::mt19937 rng(16);
+  std::array<std::vector<smesh::Acc>, 2> want{};
+  std::uint64_t out_rows = 0; // one MVOUT row per output pixel per channel block
+  for (std::size_t n = 0; n < layers.size(); ++n) {
+    const auto& l = layers[n];
+    const auto& d = l.dims;
+    const auto& k = l.kernel;
+    std::vector<int> in(static_cast<std::size_t>(d.batch * d.in_dim * d.in_dim * d.in_channels));
+    std::vector<int> w(static_cast<std::size_t>(k.kernel_dim * k.kernel_dim * d.in_channels * d.out_channels));
+    std::vector<int> bias(l.bias != 0 ? d.out_channels : 0);
+    for (std::size_t i = 0; i < in.size(); ++i) {
+      in[i] = static_cast<int>(rng() % 255) - 127;
+      const auto v = static_cast<smesh::Elem>(in[i]);
+      dram.write(l.input + i, &v, sizeof(v));
+    }
+    for (std::size_t i = 0; i < w.size(); ++i) {
+      w[i] = static_cast<int>(rng() % 255) - 127;
+      const auto v = static_cast<smesh::Elem>(w[i]);
+      dram.write(l.weights + i, &v, sizeof(v));
+    }
+    for (std::size_t i = 0; i < bias.size(); ++i) {
+      bias[i] = static_cast<int>(rng() % 200001) - 100000;
+      const auto v = static_cast<smesh::Acc>(bias[i]);
+      dram.write(l.bias + i * sizeof(v), &v, sizeof(v));
+    }
+    want[n] = referenceConv(l, in, w, bias);
+    // poison the output and one output row past it
+    const std::vector<std::uint8_t> poison((want[n].size() + l.outDim() * d.out_channels) * sizeof(smesh::Acc), kPoison);
+    dram.write(l.output, poison.data(), poison.size());
+    out_rows += static_cast<std::uint64_t>(d.batch) * l.outDim() * l.outDim() * ((d.out_channels + dim - 1) / dim);
+  }
+
+  int cycles = 0;
+  for (; cycles < 262144 &&
+         !(driver.done() && !top.unrolledCmdQueue().loopActive() && top.rs().empty() &&
+           top.dmaMemArb().writes() == out_rows && top.dmaMemArb().writesIdle());
+       ++cycles) {
+    Sim::run();
+  }
+
+  bool math_ok = true;
+  bool bounds_ok = true;
+  for (std::size_t n = 0; n < layers.size(); ++n) {
+    const auto& l = layers[n];
+    for (std::size_t i = 0; i < want[n].size(); ++i) {
+      smesh::Acc got = 0;
+      dram.read(l.output + i * sizeof(got), &got, sizeof(got));
+      if (got != want[n][i] && math_ok) {
+        std::printf("  MISMATCH layer=%zu i=%zu got=%d expected=%d\n", n, i, got, want[n][i]);
+      }
+      math_ok = math_ok && got == want[n][i];
+    }
+    // the trailing channel block's padded lanes and pixels must not spill past the output
+    std::vector<std::uint8_t> after(l.outDim() * l.dims.out_channels * sizeof(smesh::Acc));
+    dram.read(l.output + want[n].size() * sizeof(smesh::Acc), after.data(), after.size());
+    for (const auto byte : after) {
+      bounds_ok = bounds_ok && byte == kPoison;
+    }
+  }
+
+  const bool complete_ok = driver.done() &&
+                           !top.unrolledCmdQueue().loopActive() &&
+                           top.unrolledCmdQueue().loops() == layers.size() &&
+                           top.rs().empty() &&
+                           top.dmaMemArb().writes() == out_rows &&
+                           top.dmaMemArb().writesIdle() &&
+                           top.stCtrl().writesAcked() == out_rows &&
+                           top.stCtrl().outstanding() == 0;
+  const bool ok = math_ok && bounds_ok && complete_ok;
+
+  std::printf("  cycles=%d host_cmds=%zu generated=%llu out_rows=%llu\n",
+              cycles,
+              driver.cmds.size(),
+              static_cast<unsigned long long>(top.unrolledCmdQueue().loopCmdsOut()),
+              static_cast<unsigned long long>(out_rows));
+  if (!ok) {
+    std::printf("  math_ok=%u bounds_ok=%u complete_ok=%u rs_empty=%u writes=%llu writes_acked=%llu\n",
+                math_ok ? 1u : 0u,
+                bounds_ok ? 1u : 0u,
+                complete_ok ? 1u : 0u,
+                top.rs().empty() ? 1u : 0u,
+                static_cast<unsigned long long>(top.dmaMemArb().writes()),
+                static_cast<unsigned long long>(top.stCtrl().writesAcked()));
+  }
+  std::printf("[SMESH_TOP_LOOP_CONV] %s loop_conv_out_in_dram\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
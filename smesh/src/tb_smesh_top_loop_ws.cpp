@@ -0,0 +1,244 @@
+// **********************************************************************
+// smesh/src/tb_smesh_top_loop_ws.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Oct 17 2026
+// End-to-end LOOP_WS through SmeshTop and external MemCtrl/Dram. Two matmul
+// loops, C = A * B + D: odd sizes with an Acc-wide bias (trailing-tile padding,
+// multi-row MVOUTs at the C stride), then an Elem-wide bias. C in Dram must
+// match a reference matmul, every row outside C must stay untouched, and every
+// unrolled command must retire.
+
+#include <cascade/Cascade.hpp>
+#include <descore/Parameter.hpp>
+
+#include "SmeshCommand.hpp"
+#include "SmeshTop.hpp"
+#include "smem/Dram.hpp"
+#include "smem/MemCtrl.hpp"
+
+#include <array>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct LoopShape {
+  std::uint32_t m = 0; // C rows
+  std::uint32_t n = 0; // C cols
+  std::uint32_t k = 0;
+  bool          low_d = false;
+  std::uint64_t a = 0; // DRAM addrs; rows are packed back to back
+  std::uint64_t b = 0;
+  std::uint64_t d = 0;
+  std::uint64_t c = 0;
+};
+
+constexpr std::uint8_t kPoison = 0xa5;
+
+std::uint32_t tiles(std::uint32_t extent) {
+  return static_cast<std::uint32_t>((extent + smesh::kDim - 1) / smesh::kDim);
+}
+
+std::uint32_t pad(std::uint32_t extent) {
+  return tiles(extent) * static_cast<std::uint32_t>(smesh::kDim) - extent;
+}
+
+smesh::SmeshCmd command(smesh::SmeshFunct funct, std::uint64_t rs1 = 0, std::uint64_t rs2 = 0) {
+  return smesh::SmeshCmd{u32(static_cast<std::uint32_t>(funct)), u64(rs1), u64(rs2)};
+}
+
+void appendLoop(std::vector<smesh::SmeshCmd>& program, const LoopShape& s) {
+  const std::uint64_t d_bytes = s.low_d ? sizeof(smesh::Elem) : sizeof(smesh::Acc);
+  program.push_back(command(smesh::SmeshFunct::LoopWsConfigBounds,
+                            smesh::packLoopWsBounds(pad(s.m), pad(s.n), pad(s.k)),
+                            smesh::packLoopWsBounds(tiles(s.m), tiles(s.n), tiles(s.k))));
+  program.push_back(command(smesh::SmeshFunct::LoopWsConfigAddrsAB, s.a, s.b));
+  program.push_back(command(smesh::SmeshFunct::LoopWsConfigAddrsDC, s.d, s.c));
+  program.push_back(command(smesh::SmeshFunct::LoopWsConfigStridesAB, s.k * sizeof(smesh::Elem), s.n * sizeof(smesh::Elem)));
+  program.push_back(command(smesh::SmeshFunct::LoopWsConfigStridesDC, s.n * d_bytes, s.n * sizeof(smesh::Acc)));
+  program.push_back(command(smesh::SmeshFunct::LoopWs, smesh::packLoopWsRs1(0, true, s.low_d)));
+}
+
+} // namespace
+
+class TopLoopWsDriver : public Component {
+  DECLARE_COMPONENT(TopLoopWsDriver);
+
+ public:
+  TopLoopWsDriver(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+  Output(bit, cmd_valid);
+  Output(smesh::SmeshCmd, cmd_bits);
+  Input(bit, cmd_ready);
+
+  void update();
+  void reset();
+
+  std::vector<smesh::SmeshCmd> cmds;
+  bool done() const { return next_ >= cmds.size(); }
+
+ private:
+  std::size_t next_ = 0;
+};
+
+TopLoopWsDriver::TopLoopWsDriver(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(update).reads(cmd_ready).writes(cmd_valid, cmd_bits);
+}
+
+void TopLoopWsDriver::update() {
+  cmd_valid = 0;
+  cmd_bits = smesh::SmeshCmd{};
+  if (Sim::state == Sim::SimResetting || done()) {
+    return;
+  }
+
+  cmd_bits = cmds[next_];
+  cmd_valid = 1;
+  if (cmd_ready != 0) {
+    trace("top_loop_ws_driver: pushed funct=%u", static_cast<unsigned>(cmds[next_].funct));
+    ++next_;
+  }
+}
+
+void TopLoopWsDriver::reset() {
+  next_ = 0;
+}
+
+int main(int argc, char* argv[]) {
+  descore::parseTraces(argc, argv);
+  Parameter::parseCommandLine(argc, argv);
+  Sim::parseDumps(argc, argv);
+
+  const std::uint32_t dim = static_cast<std::uint32_t>(smesh::kDim);
+  std::array<LoopShape, 2> loops{};
+  loops[0] = LoopShape{2 * dim - 1, 2 * dim - 2, 3 * dim - 3, false, 0x80020000, 0x80021000, 0x80022000, 0x80023000};
+  loops[1] = LoopShape{dim, dim + 1, 2 * dim, true, 0x80024000, 0x80025000, 0x80026000, 0x80027000};
+
+  TopLoopWsDriver driver("Driver");
+  smesh::SmeshTop top("SmeshTop");
+  smem::MemCtrl mem("MemCtrl");
+  smem::Dram dram("Dram", 0);
+  for (const auto& s : loops) {
+    appendLoop(driver.cmds, s);
+  }
+
+  top.cmd_valid << driver.cmd_valid;
+  top.cmd_bits << driver.cmd_bits;
+  driver.cmd_ready << top.cmd_ready;
+  mem.in_core_req << top.memReq();
+  top.memResp() << mem.out_core_resp;
+  mem.in_core_req.setDelay(1);
+  dram.s_req << mem.s_req;
+  mem.s_resp << dram.s_resp;
+
+  Clock clk;
+  driver.clk << clk;
+  top.clk << clk;
+  mem.clk << clk;
+  dram.clk << clk;
+  clk.generateClock();
+
+  Cascade::params.MaxResetIterations = 1;
+  Sim::init();
+  Sim::reset();
+
+  std::mt19937 rng(15);
+  std::array<std::vector<int>, 2> a{};
+  std::array<std::vector<int>, 2> b{};
+  std::array<std::vector<int>, 2> d{};
+  std::uint64_t c_rows = 0; // one MVOUT row per C row per column tile
+  for (std::size_t l = 0; l < loops.size(); ++l) {
+    const auto& s = loops[l];
+    a[l].resize(s.m * s.k);
+    b[l].resize(s.k * s.n);
+    d[l].resize(s.m * s.n);
+    for (std::size_t i = 0; i < a[l].size(); ++i) {
+      a[l][i] = static_cast<int>(rng() % 255) - 127;
+      const auto v = static_cast<smesh::Elem>(a[l][i]);
+      dram.write(s.a + i, &v, sizeof(v));
+    }
+    for (std::size_t i = 0; i < b[l].size(); ++i) {
+      b[l][i] = static_cast<int>(rng() % 255) - 127;
+      const auto v = static_cast<smesh::Elem>(b[l][i]);
+      dram.write(s.b + i, &v, sizeof(v));
+    }
+    for (std::size_t i = 0; i < d[l].size(); ++i) {
+      if (s.low_d) {
+        d[l][i] = static_cast<int>(rng() % 255) - 127;
+        const auto v = static_cast<smesh::Elem>(d[l][i]);
+        dram.write(s.d + i, &v, sizeof(v));
+      } else {
+        d[l][i] = static_cast<int>(rng() % 200001) - 100000;
+        const auto v = static_cast<smesh::Acc>(d[l][i]);
+        dram.write(s.d + i * sizeof(v), &v, sizeof(v));
+      }
+    }
+    // poison C and one row past it
+    const std::vector<std::uint8_t> poison((s.m + 1) * s.n * sizeof(smesh::Acc), kPoison);
+    dram.write(s.c, poison.data(), poison.size());
+    c_rows += static_cast<std::uint64_t>(s.m) * tiles(s.n);
+  }
+
+  int cycles = 0;
+  for (; cycles < 65536 &&
+         !(driver.done() && !top.unrolledCmdQueue().loopActive() && top.rs().empty() &&
+           top.dmaMemArb().writes() == c_rows && top.dmaMemArb().writesIdle());
+       ++cycles) {
+    Sim::run();
+  }
+
+  bool math_ok = true;
+  bool bounds_ok = true;
+  for (std::size_t l = 0; l < loops.size(); ++l) {
+    const auto& s = loops[l];
+    for (std::size_t i = 0; i < s.m; ++i) {
+      for (std::size_t j = 0; j < s.n; ++j) {
+        smesh::Acc want = d[l][i * s.n + j];
+        for (std::size_t k = 0; k < s.k; ++k) {
+          want += a[l][i * s.k + k] * b[l][k * s.n + j];
+        }
+        smesh::Acc got = 0;
+        dram.read(s.c + (i * s.n + j) * sizeof(got), &got, sizeof(got));
+        if (got != want && math_ok) {
+          std::printf("  MISMATCH loop=%zu i=%zu j=%zu got=%d expected=%d\n", l, i, j, got, want);
+        }
+        math_ok = math_ok && got == want;
+      }
+    }
+    // the padded tile's extra rows and columns must not spill past C
+    std::vector<std::uint8_t> after(s.n * sizeof(smesh::Acc));
+    dram.read(s.c + s.m * s.n * sizeof(smesh::Acc), after.data(), after.size());
+    for (const auto byte : after) {
+      bounds_ok = bounds_ok && byte == kPoison;
+    }
+  }
+
+  const bool complete_ok = driver.done() &&
+                           !top.unrolledCmdQueue().loopActive() &&
+                           top.unrolledCmdQueue().loops() == loops.size() &&
+                           top.rs().empty() &&
+                           top.dmaMemArb().writes() == c_rows &&
+                           top.dmaMemArb().writesIdle() &&
+                           top.stCtrl().writesAcked() == c_rows &&
+                           top.stCtrl().outstanding() == 0;
+  const bool ok = math_ok && bounds_ok && complete_ok;
+
+  std::printf("  cycles=%d host_cmds=%zu generated=%llu c_rows=%llu\n",
+              cycles,
+              driver.cmds.size(),
+              static_cast<unsigned long long>(top.unrolledCmdQueue().loopCmdsOut()),
+              static_cast<unsigned long long>(c_rows));
+  if (!ok) {
+    std::printf("  math_ok=%u bounds_ok=%u complete_ok=%u rs_empty=%u writes=%llu writes_acked=%llu\n",
+                math_ok ? 1u : 0u,
+                bounds_ok ? 1u : 0u,
+                complete_ok ? 1u : 0u,
+                top.rs().empty() ? 1u : 0u,
+                static_cast<unsigned long long>(top.dmaMemArb().writes()),
+                static_cast<unsigned long long>(top.stCtrl().writesAcked()));
+  }
+  std::printf("[SMESH_TOP_LOOP_WS] %s loop_ws_c_in_dram\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
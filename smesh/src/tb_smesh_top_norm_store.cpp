@@ -0,0 +1,245 @@
+// **********************************************************************
+// smesh/src/tb_smesh_top_norm_store.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Oct 17 2026
+// End-to-end LayerNorm on mvout through SmeshTop and external MemCtrl/Dram.
+// A logical row two tiles wide is loaded into Accum rows 0 and 1 as 32-bit
+// words. Phase one reduces it with stats-only MVOUTs (SUM on tile 0,
+// INV_STDDEV on tile 1) into stats id 255, the top of CONFIG_NORM's field:
+// their RS tags must retire through the Normalizer's stats_done ack without
+// writing Dram. Phase two stores both tiles with RESET,
+// and Dram must hold (x - mean) * acc_scale / stddev requantized to Elem.
+
+#include <cascade/Cascade.hpp>
+#include <descore/Parameter.hpp>
+
+#include "Activation.hpp"
+#include "Normalizer.hpp"
+#include "Requantize.hpp"
+#include "SmeshCommand.hpp"
+#include "SmeshTop.hpp"
+#include "smem/Dram.hpp"
+#include "smem/MemCtrl.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t kAccDramBase   = 0x80006000; // kTiles rows of kDim Acc words
+constexpr std::uint64_t kStatsDramBase = 0x80006100; // stats-only MVOUT targets, must stay poisoned
+constexpr std::uint64_t kOutDramBase   = 0x80006200; // normalized Elem tiles, back to back
+constexpr std::uint32_t kStatsId       = 0xff; // top of CONFIG_NORM's 8-bit field
+constexpr std::size_t   kTiles         = 2;
+constexpr float         kOutScale      = 16.0f; // acc_scale: one stddev is 16
+constexpr std::uint8_t  kPoison        = 0xa5;
+
+smesh::SmeshCmd command(smesh::SmeshFunct funct, std::uint64_t rs1 = 0, std::uint64_t rs2 = 0) {
+  return smesh::SmeshCmd{u32(static_cast<std::uint32_t>(funct)), u64(rs1), u64(rs2)};
+}
+
+smesh::SmeshCmd mvoutTile(std::size_t tile, smesh::NormCmd norm_cmd, std::uint64_t dram) {
+  const smesh::MatrixShape row{1, smesh::kDim};
+  const auto laddr = smesh::makeAccAddr(static_cast<std::uint32_t>(tile), false, false, static_cast<std::uint32_t>(norm_cmd));
+  return command(smesh::SmeshFunct::Mvout, dram, smesh::packLocal(laddr, row));
+}
+
+// phase one: load, configure and reduce; phase two: the two output rows
+std::vector<smesh::SmeshCmd> normProgram() {
+  return {
+      command(smesh::SmeshFunct::Config,
+              smesh::packConfig(smesh::ConfigKind::Load, 0, smesh::kDim),
+              smesh::kDim * sizeof(smesh::Acc)),
+      command(smesh::SmeshFunct::Mvin, kAccDramBase,
+              smesh::packLocal(smesh::makeAccAddr(0, false, true), smesh::MatrixShape{kTiles, smesh::kDim})),
+      command(smesh::SmeshFunct::Config,
+              smesh::packConfigStoreRs1(static_cast<std::uint32_t>(smesh::Activation::LayerNorm), 0,
+                                        smesh::accScaleFromFloat(kOutScale)),
+              smesh::kDim * sizeof(smesh::Elem)),
+      command(smesh::SmeshFunct::Config, smesh::packConfigNormRs1(0, false, kStatsId, true)),
+      mvoutTile(0, smesh::NormCmd::Sum, kStatsDramBase),
+      mvoutTile(1, smesh::NormCmd::InvStddev, kStatsDramBase + smesh::kDim),
+      mvoutTile(0, smesh::NormCmd::Reset, kOutDramBase),
+      mvoutTile(1, smesh::NormCmd::Reset, kOutDramBase + smesh::kDim),
+  };
+}
+
+constexpr std::size_t kPhaseOneCmds = 6;
+
+} // namespace
+
+class TopNormDriver : public Component {
+  DECLARE_COMPONENT(TopNormDriver);
+
+ public:
+  TopNormDriver(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+  Output(bit, cmd_valid);
+  Output(smesh::SmeshCmd, cmd_bits);
+  Input(bit, cmd_ready);
+
+  void update();
+  void reset();
+
+  std::size_t limit = kPhaseOneCmds; // commands released so far
+  bool done() const { return next_command_ >= limit; }
+  std::size_t commands() const { return program_.size(); }
+
+ private:
+  const std::vector<smesh::SmeshCmd> program_ = normProgram();
+  std::size_t next_command_ = 0;
+};
+
+TopNormDriver::TopNormDriver(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(update).reads(cmd_ready).writes(cmd_valid, cmd_bits);
+}
+
+void TopNormDriver::update() {
+  cmd_valid = 0;
+  cmd_bits = smesh::SmeshCmd{};
+  if (Sim::state == Sim::SimResetting || done()) {
+    return;
+  }
+
+  cmd_bits = program_[next_command_];
+  cmd_valid = 1;
+  if (cmd_ready != 0) {
+    trace("top_norm_driver: pushed funct=%u", static_cast<unsigned>(program_[next_command_].funct));
+    ++next_command_;
+  }
+}
+
+void TopNormDriver::reset() {
+  next_command_ = 0;
+}
+
+int main(int argc, char* argv[]) {
+  descore::parseTraces(argc, argv);
+  Parameter::parseCommandLine(argc, argv);
+  Sim::parseDumps(argc, argv);
+
+  TopNormDriver driver("Driver");
+  smesh::SmeshTop top("SmeshTop");
+  smem::MemCtrl mem("MemCtrl");
+  smem::Dram dram("Dram", 0);
+
+  top.cmd_valid << driver.cmd_valid;
+  top.cmd_bits << driver.cmd_bits;
+  driver.cmd_ready << top.cmd_ready;
+  mem.in_core_req << top.memReq();
+  top.memResp() << mem.out_core_resp;
+  mem.in_core_req.setDelay(1);
+  dram.s_req << mem.s_req;
+  mem.s_resp << dram.s_resp;
+
+  Clock clk;
+  driver.clk << clk;
+  top.clk << clk;
+  mem.clk << clk;
+  dram.clk << clk;
+  clk.generateClock();
+
+  Cascade::params.MaxResetIterations = 1;
+  Sim::init();
+  Sim::reset();
+
+  // one logical row of kTiles * kDim lanes, spread around a nonzero mean
+  std::array<smesh::Acc, kTiles * smesh::kDim> x{};
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<smesh::Acc>((i * 37) % 301) - 120;
+  }
+  dram.write(kAccDramBase, x.data(), x.size() * sizeof(smesh::Acc));
+  const std::array<std::uint8_t, 2 * kTiles * smesh::kDim> poison = [] {
+    std::array<std::uint8_t, 2 * kTiles * smesh::kDim> p{};
+    p.fill(kPoison);
+    return p;
+  }();
+  dram.write(kStatsDramBase, poison.data(), poison.size());
+  dram.write(kOutDramBase, poison.data(), poison.size());
+
+  // phase one: the stats-only MVOUTs retire on the Normalizer's ack alone
+  int cycles = 0;
+  for (; cycles < 1024 && !(driver.done() && top.rs().empty()); ++cycles) {
+    Sim::run();
+  }
+  const auto& stats = top.normalizer().stats(kStatsId);
+  const bool stats_ok = driver.done() &&
+                        top.rs().empty() &&
+                        top.stCtrl().statsAcked() == kTiles &&
+                        top.stCtrl().outstanding() == 0 &&
+                        top.normalizer().statsRows() == kTiles &&
+                        top.normalizer().rows() == 0 &&
+                        top.dmaMemArb().writes() == 0 &&
+                        stats.moments_final &&
+                        stats.count == x.size();
+  const int stats_cycles = cycles;
+
+  // phase two: RESET rows leave normalized with the finalized statistics
+  driver.limit = driver.commands();
+  for (; cycles < 2048 &&
+         !(driver.done() && top.rs().empty() && top.dmaMemArb().writes() == kTiles && top.dmaMemArb().writesIdle());
+       ++cycles) {
+    Sim::run();
+  }
+
+  double sum = 0.0;
+  double sum_sq = 0.0;
+  for (const auto v : x) {
+    sum += v;
+    sum_sq += static_cast<double>(v) * v;
+  }
+  const double n = static_cast<double>(x.size());
+  const double mean = sum / n;
+  const auto mean_q = static_cast<smesh::Acc>(std::llrint(mean));
+  const auto inv_stddev = static_cast<float>(1.0 / std::sqrt(std::max(sum_sq / n - mean * mean, 0.0)));
+  const float scale = kOutScale * inv_stddev;
+
+  bool dram_ok = true;
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    const double scaled = std::nearbyint(static_cast<double>(x[i] - mean_q) * static_cast<double>(scale));
+    const auto want = static_cast<smesh::Elem>(std::min(std::max(scaled, -128.0), 127.0));
+    smesh::Elem got = 0;
+    dram.read(kOutDramBase + i, &got, sizeof(got));
+    if (got != want) {
+      std::printf("  MISMATCH i=%zu got=%d expected=%d\n", i, got, want);
+    }
+    dram_ok = dram_ok && got == want;
+  }
+  std::array<std::uint8_t, 2 * kTiles * smesh::kDim> stats_region{};
+  dram.read(kStatsDramBase, stats_region.data(), stats_region.size());
+  bool untouched_ok = stats_region == poison;
+  std::array<std::uint8_t, kTiles * smesh::kDim> after{};
+  dram.read(kOutDramBase + x.size(), after.data(), after.size());
+  for (const auto byte : after) {
+    untouched_ok = untouched_ok && byte == kPoison;
+  }
+
+  const bool complete_ok = driver.done() &&
+                           top.rs().empty() &&
+                           top.dmaMemArb().writesIdle() &&
+                           top.dmaMemArb().writes() == kTiles &&
+                           top.stCtrl().writesAcked() == kTiles &&
+                           top.stCtrl().statsAcked() == kTiles &&
+                           top.stCtrl().outstanding() == 0 &&
+                           top.normalizer().rows() == kTiles;
+  const bool ok = stats_ok && dram_ok && untouched_ok && complete_ok;
+
+  std::printf("  cycles=%d stats_phase_cycles=%d mean=%d inv_stddev=%.6f\n", cycles, stats_cycles, mean_q, inv_stddev);
+  if (!ok) {
+    std::printf("  stats_ok=%u dram_ok=%u untouched_ok=%u complete_ok=%u rs_empty=%u writes=%llu writes_acked=%llu stats_acked=%llu\n",
+                stats_ok ? 1u : 0u,
+                dram_ok ? 1u : 0u,
+                untouched_ok ? 1u : 0u,
+                complete_ok ? 1u : 0u,
+                top.rs().empty() ? 1u : 0u,
+                static_cast<unsigned long long>(top.dmaMemArb().writes()),
+                static_cast<unsigned long long>(top.stCtrl().writesAcked()),
+                static_cast<unsigned long long>(top.stCtrl().statsAcked()));
+  }
+  std::printf("[SMESH_TOP_NORM_STORE] %s stats_then_reset_mvout\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,207 @@
+// **********************************************************************
+// smesh/src/tb_smesh_top_pixel_repeat_load.cpp
+// **********************************************************************
+// Sebastian Claudiusz Magierowski Oct 17 2026
+// Focused SmeshTop pixel-repeat load. An MVIN2 first fills the scratchpad rows
+// around the target with a full-width pattern. Then CONFIG_LD with
+// ld_pixel_repeats = 2 and an MVIN of kDim pixels, kDim / 2 channels each,
+// writes pixel r to row base + r lanes [0, kDim / 2) and its repeat to row
+// base + r - 1 lanes [kDim / 2, kDim). Lanes outside each copy's mask must keep
+// the pattern, the row below the first repeat must stay untouched, and both
+// MVINs must retire.
+
+#include <cascade/Cascade.hpp>
+#include <descore/Parameter.hpp>
+
+#include "SmeshCommand.hpp"
+#include "SmeshTop.hpp"
+#include "smem/Dram.hpp"
+#include "smem/MemCtrl.hpp"
+
+#include <array>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t kPatternDramBase = 0x80007000; // kPatternRows full rows, packed
+constexpr std::uint64_t kPixelDramBase   = 0x80007100; // kDim pixels at kPixelStride
+constexpr std::uint32_t kBaseRow         = 3;
+constexpr std::uint32_t kChannels        = smesh::kDim / 2;
+constexpr std::uint32_t kPixelStride     = kChannels + 1;
+constexpr std::uint32_t kRepeats         = 2;
+constexpr std::uint32_t kPatternRows     = smesh::kDim + 1; // rows kBaseRow - 1 .. kBaseRow + kDim - 1
+
+smesh::SmeshCmd command(smesh::SmeshFunct funct, std::uint64_t rs1 = 0, std::uint64_t rs2 = 0) {
+  return smesh::SmeshCmd{u32(static_cast<std::uint32_t>(funct)), u64(rs1), u64(rs2)};
+}
+
+std::vector<smesh::SmeshCmd> repeatProgram() {
+  return {
+      command(smesh::SmeshFunct::Config, smesh::packConfig(smesh::ConfigKind::Load, 1, smesh::kDim), smesh::kDim),
+      command(smesh::SmeshFunct::Mvin2, kPatternDramBase,
+              smesh::packLocal(smesh::makeSpAddr(kBaseRow - 1), smesh::MatrixShape{kPatternRows, smesh::kDim})),
+      command(smesh::SmeshFunct::Config,
+              smesh::packConfig(smesh::ConfigKind::Load, 0, smesh::kDim, 0, kRepeats),
+              kPixelStride),
+      command(smesh::SmeshFunct::Mvin, kPixelDramBase,
+              smesh::packLocal(smesh::makeSpAddr(kBaseRow), smesh::MatrixShape{smesh::kDim, kChannels})),
+  };
+}
+
+std::uint8_t patternByte(std::size_t row, std::size_t lane) {
+  return static_cast<std::uint8_t>(0x80 + 0x10 * row + lane);
+}
+
+std::uint8_t pixelByte(std::size_t pixel, std::size_t channel) {
+  return static_cast<std::uint8_t>(0x11 + 0x10 * pixel + channel);
+}
+
+} // namespace
+
+class TopPixelRepeatDriver : public Component {
+  DECLARE_COMPONENT(TopPixelRepeatDriver);
+
+ public:
+  TopPixelRepeatDriver(std::string name, COMPONENT_CTOR);
+
+  Clock(clk);
+  Output(bit, cmd_valid);
+  Output(smesh::SmeshCmd, cmd_bits);
+  Input(bit, cmd_ready);
+
+  void update();
+  void reset();
+
+  bool done() const { return next_command_ >= program_.size(); }
+
+ private:
+  const std::vector<smesh::SmeshCmd> program_ = repeatProgram();
+  std::size_t next_command_ = 0;
+};
+
+TopPixelRepeatDriver::TopPixelRepeatDriver(std::string /*name*/, IMPL_CTOR) {
+  UPDATE(update).reads(cmd_ready).writes(cmd_valid, cmd_bits);
+}
+
+void TopPixelRepeatDriver::update() {
+  cmd_valid = 0;
+  cmd_bits = smesh::SmeshCmd{};
+  if (Sim::state == Sim::SimResetting || done()) {
+    return;
+  }
+
+  cmd_bits = program_[next_command_];
+  cmd_valid = 1;
+  if (cmd_ready != 0) {
+    trace("top_pixel_repeat_driver: pushed funct=%u", static_cast<unsigned>(program_[next_command_].funct));
+    ++next_command_;
+  }
+}
+
+void TopPixelRepeatDriver::reset() {
+  next_command_ = 0;
+}
+
+int main(int argc, char* argv[]) {
+  descore::parseTraces(argc, argv);
+  Parameter::parseCommandLine(argc, argv);
+  Sim::parseDumps(argc, argv);
+
+  TopPixelRepeatDriver driver("Driver");
+  smesh::SmeshTop top("SmeshTop");
+  smem::MemCtrl mem("MemCtrl");
+  smem::Dram dram("Dram", 0);
+
+  top.cmd_valid << driver.cmd_valid;
+  top.cmd_bits << driver.cmd_bits;
+  driver.cmd_ready << top.cmd_ready;
+  mem.in_core_req << top.memReq();
+  top.memResp() << mem.out_core_resp;
+  mem.in_core_req.setDelay(1);
+  dram.s_req << mem.s_req;
+  mem.s_resp << dram.s_resp;
+
+  Clock clk;
+  driver.clk << clk;
+  top.clk << clk;
+  mem.clk << clk;
+  dram.clk << clk;
+  clk.generateClock();
+
+  Cascade::params.MaxResetIterations = 1;
+  Sim::init();
+  Sim::reset();
+
+  for (std::size_t r = 0; r < kPatternRows; ++r) {
+    std::array<std::uint8_t, smesh::kDim> row{};
+    for (std::size_t lane = 0; lane < smesh::kDim; ++lane) {
+      row[lane] = patternByte(r, lane);
+    }
+    dram.write(kPatternDramBase + r * smesh::kDim, row.data(), row.size());
+  }
+  for (std::size_t p = 0; p < smesh::kDim; ++p) {
+    std::array<std::uint8_t, kChannels> pixel{};
+    for (std::size_t c = 0; c < kChannels; ++c) {
+      pixel[c] = pixelByte(p, c);
+    }
+    dram.write(kPixelDramBase + p * kPixelStride, pixel.data(), pixel.size());
+  }
+
+  int cycles = 0;
+  for (; cycles < 512 && !(driver.done() && top.rs().empty() && !top.ldCtrl().hasActiveCommand()); ++cycles) {
+    Sim::run();
+  }
+
+  // row kBaseRow - 1 + i starts as pattern row i; pixel r lands in row kBaseRow + r and
+  // its repeat one row up, kChannels lanes in
+  bool spad_ok = top.spad().hasAcceptedWrite();
+  for (std::size_t i = 0; i < kPatternRows; ++i) {
+    const auto row = kBaseRow - 1 + i;
+    std::array<std::uint8_t, smesh::kDim> want{};
+    for (std::size_t lane = 0; lane < smesh::kDim; ++lane) {
+      want[lane] = patternByte(i, lane);
+    }
+    if (row >= kBaseRow) {
+      for (std::size_t c = 0; c < kChannels; ++c) {
+        want[c] = pixelByte(row - kBaseRow, c);
+      }
+    }
+    if (row + 1 - kBaseRow < smesh::kDim) {
+      for (std::size_t c = 0; c < kChannels; ++c) {
+        want[kChannels + c] = pixelByte(row + 1 - kBaseRow, c);
+      }
+    }
+    const auto& got = top.spad().row(smesh::makeSpAddr(static_cast<std::uint32_t>(row)));
+    for (std::size_t lane = 0; lane < smesh::kDim; ++lane) {
+      if (static_cast<std::uint8_t>(got[lane]) != want[lane]) {
+        std::printf("  MISMATCH row=%zu lane=%zu got=0x%02x expected=0x%02x\n",
+                    row, lane, static_cast<unsigned>(static_cast<std::uint8_t>(got[lane])), static_cast<unsigned>(want[lane]));
+      }
+      spad_ok = spad_ok && static_cast<std::uint8_t>(got[lane]) == want[lane];
+    }
+  }
+  const auto& below = top.spad().row(smesh::makeSpAddr(kBaseRow - 2));
+  for (std::size_t lane = 0; lane < smesh::kDim; ++lane) {
+    spad_ok = spad_ok && below[lane] == 0;
+  }
+
+  const bool completion_ok = driver.done() &&
+                             top.rs().empty() &&
+                             !top.ldCtrl().hasActiveCommand() &&
+                             top.ldCtrl().expectedBytes() == smesh::kDim * kChannels &&
+                             top.ldCtrl().returnedBytes() == smesh::kDim * kChannels;
+  const bool ok = spad_ok && completion_ok;
+
+  std::printf("  cycles=%d\n", cycles);
+  if (!ok) {
+    std::printf("  spad_ok=%u completion_ok=%u rs_empty=%u expected=%u returned=%u\n",
+                spad_ok ? 1u : 0u,
+                completion_ok ? 1u : 0u,
+                top.rs().empty() ? 1u : 0u,
+                top.ldCtrl().expectedBytes(),
+                top.ldCtrl().returnedBytes());
+  }
+  std::printf("[SMESH_TOP_PIXEL_REPEAT_LOAD] %s mvin_pixel_repeats_to_spad\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -2,7 +2,9 @@
 // smesh/src/tb_smesh_top_spad_store.cpp
 // **********************************************************************
 // Sebastian Claudiusz Magierowski Jul 13 2026
-// Focused SmeshTop store-path test from scratchpad into the store data path.
+// Focused SmeshTop store-path test from scratchpad into the store data path,
+// through the shared DmaMemArb port into Dram: a kDim-row MVOUT under a CONFIG_ST
+// stride writes every row, and the RS retires it on the last row's write ack.
 
 #include <cascade/Cascade.hpp>
 #include <descore/Parameter.hpp>
@@ -19,6 +21,7 @@ constexpr std::uint64_t kLoadDramBase = 0x80006000;
 constexpr std::uint64_t kStoreDramBase = 0x80007000;
 constexpr std::uint32_t kDramRowStride = 9;
 constexpr std::uint32_t kLoadBlockStride = 5;
+constexpr std::uint32_t kStoreRowStride = 6;
 
 class TopSpadStoreDriver : public Component {
   DECLARE_COMPONENT(TopSpadStoreDriver);
@@ -64,11 +67,13 @@ class StorePathMonitor : public Component {
   bool sawAlignedTransfer() const { return saw_aligned_transfer_; }
   bool sawDmaWriterTransfer() const { return saw_dma_writer_transfer_; }
   std::uint32_t alignedTransferCount() const { return aligned_transfer_count_; }
+  std::uint32_t writerTransferCount() const { return writer_transfer_count_; }
 
  private:
   bool saw_aligned_transfer_ = false;
   bool saw_dma_writer_transfer_ = false;
   std::uint32_t aligned_transfer_count_ = 0;
+  std::uint32_t writer_transfer_count_ = 0;
 };
 
 TopSpadStoreDriver::TopSpadStoreDriver(std::string /*name*/, IMPL_CTOR) {
@@ -81,7 +86,7 @@ void TopSpadStoreDriver::update() {
   if (Sim::state == Sim::SimResetting) {
     return;
   }
-  if (next_command_ >= 3) {
+  if (next_command_ >= 4) {
     return;
   }
 
@@ -95,6 +100,10 @@ void TopSpadStoreDriver::update() {
     cmd.funct = u32(static_cast<std::uint32_t>(smesh::SmeshFunct::Mvin));
     cmd.rs1 = u64(kLoadDramBase);
     cmd.rs2 = u64(smesh::packLocal(smesh::makeSpAddr(0), shape));
+  } else if (next_command_ == 2) {
+    cmd.funct = u32(static_cast<std::uint32_t>(smesh::SmeshFunct::Config));
+    cmd.rs1 = u64(smesh::packConfig(smesh::ConfigKind::Store));
+    cmd.rs2 = u64(kStoreRowStride);
   } else {
     cmd.funct = u32(static_cast<std::uint32_t>(smesh::SmeshFunct::Mvout));
     cmd.rs1 = u64(kStoreDramBase);
@@ -161,24 +170,29 @@ void StorePathMonitor::updateWriter() {
     return;
   }
   const auto writer_req = *dma_writer_req_bits;
-  assert_always(writer_req.issue.vaddr == kStoreDramBase,
+  // each row leaves in order at its own strided DRAM address
+  const std::uint64_t row = writer_transfer_count_;
+  assert_always(row < smesh::kDim, "store monitor saw more DMA writer rows than the mvout has");
+  assert_always(writer_req.issue.vaddr == kStoreDramBase + row * kStoreRowStride,
                 "store monitor saw wrong DMA writer address");
   assert_always(writer_req.issue.dest == 0,
                 "store monitor expected normal DMA writer destination");
   assert_always(writer_req.len_bytes == smesh::kDim * sizeof(smesh::Elem),
                 "store monitor saw wrong DMA writer byte count");
   for (std::size_t i = 0; i < smesh::kDim; ++i) {
-    assert_always(writer_req.data[i] == static_cast<std::uint8_t>(0x01 + i),
+    assert_always(writer_req.data[i] == static_cast<std::uint8_t>(0x01 + 0x10 * row + i),
                   "store monitor saw wrong DMA writer data byte");
   }
 
   saw_dma_writer_transfer_ = true;
+  ++writer_transfer_count_;
 }
 
 void StorePathMonitor::reset() {
   saw_aligned_transfer_ = false;
   saw_dma_writer_transfer_ = false;
   aligned_transfer_count_ = 0;
+  writer_transfer_count_ = 0;
 }
 
 int main(int argc, char* argv[]) {
@@ -234,35 +248,61 @@ int main(int argc, char* argv[]) {
                smesh::kDim);
   }
 
-  for (int i = 0; i < 192 && !monitor.sawDmaWriterTransfer(); ++i) {
+  int cycles = 0;
+  for (; cycles < 192 && !monitor.sawDmaWriterTransfer(); ++cycles) {
+    Sim::run();
+  }
+  const int writer_cycle = cycles;
+  for (; cycles < 384 && !(top.rs().empty() && top.dmaMemArb().writesIdle()); ++cycles) {
     Sim::run();
   }
 
   bool spad_ok = top.spad().hasAcceptedWrite();
-  for (std::size_t c = 0; c < smesh::kDim; ++c) {
-    const auto& row0 = top.spad().row(smesh::makeSpAddr(0));
-    spad_ok = spad_ok && row0[c] == static_cast<smesh::Elem>(rows[c]);
+  for (std::size_t r = 0; r < smesh::kDim; ++r) {
+    const auto& row = top.spad().row(smesh::makeSpAddr(static_cast<std::uint32_t>(r)));
+    for (std::size_t c = 0; c < smesh::kDim; ++c) {
+      spad_ok = spad_ok && row[c] == static_cast<smesh::Elem>(rows[r * smesh::kDim + c]);
+    }
   }
 
   const bool monitor_ok = monitor.sawAlignedTransfer() &&
                           monitor.sawDmaWriterTransfer() &&
-                          monitor.alignedTransferCount() == 1;
-  const bool ok = spad_ok && monitor_ok;
+                          monitor.alignedTransferCount() == smesh::kDim &&
+                          monitor.writerTransferCount() == smesh::kDim;
+  // every mvout row must have reached Dram and only the last row's write ack may retire the store
+  bool dram_ok = true;
+  for (std::size_t r = 0; r < smesh::kDim; ++r) {
+    std::array<std::uint8_t, smesh::kDim> stored{};
+    dram.read(kStoreDramBase + r * kStoreRowStride, stored.data(), stored.size());
+    for (std::size_t c = 0; dram_ok && c < smesh::kDim; ++c) {
+      dram_ok = stored[c] == rows[r * smesh::kDim + c];
+    }
+  }
+  const bool complete_ok = top.rs().empty() &&
+                           top.dmaMemArb().writes() == smesh::kDim &&
+                           top.dmaMemArb().writesIdle() &&
+                           top.stCtrl().dispatched() == smesh::kDim &&
+                           top.stCtrl().writesAcked() == smesh::kDim &&
+                           top.stCtrl().outstanding() == 0;
+  const bool ok = spad_ok && monitor_ok && dram_ok && complete_ok;
+  std::printf("  writer_cycle=%d done_cycle=%d\n", writer_cycle, cycles);
   if (!ok) {
     const auto& store0 = top.rs().storeEntry(0);
-    std::printf("  spad_ok=%u monitor_ok=%u writer_seen=%u aligned_count=%u\n",
+    std::printf("  spad_ok=%u monitor_ok=%u dram_ok=%u complete_ok=%u writer_count=%u aligned_count=%u\n",
                 spad_ok ? 1u : 0u,
                 monitor_ok ? 1u : 0u,
-                monitor.sawDmaWriterTransfer() ? 1u : 0u,
+                dram_ok ? 1u : 0u,
+                complete_ok ? 1u : 0u,
+                monitor.writerTransferCount(),
                 monitor.alignedTransferCount());
-    std::printf("  store0 valid=%u issued=%u ready=%u funct=%u tag=%u deps_ld=0x%x deps_st=0x%x\n",
+    std::printf("  store0 valid=%u issued=%u ready=%u funct=%u tag=%u deps_ld=0x%llx deps_st=0x%llx\n",
                 store0.valid ? 1u : 0u,
                 store0.issued ? 1u : 0u,
                 store0.ready() ? 1u : 0u,
                 static_cast<unsigned>(store0.cmd.funct),
                 static_cast<unsigned>(store0.rs_tag),
-                store0.deps_ld,
-                store0.deps_st);
+                static_cast<unsigned long long>(store0.deps_ld),
+                static_cast<unsigned long long>(store0.deps_st));
   }
 
   std::printf("[SMESH_TOP_SPAD_STORE] %s spad_store_read_path\n", ok ? "PASS" : "FAIL");
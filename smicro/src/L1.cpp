@@ -1,9 +1,351 @@
+// **********************************************************************
 // smicro/src/L1.cpp
+// **********************************************************************
+// S Magierowski Aug 16 2025
+/*
+Each cycle:
+update_issue()
+  1) send at most one matured response up (hits and filled targets, in order of readiness)
+  2) take at most one request from up_req: hit -> queue response after hit_latency;
+     miss -> merge into the line's MSHR or allocate one and queue its fill beats;
+     write-through stores are also queued downstream
+  3) send at most one queued beat down (fills, writebacks, write-through stores)
+update_retire()
+  4) drain down_resp: copy fill beats into their MSHR; on the last beat pick a
+     victim (write it back if dirty), install the line and serve the MSHR targets
+*/
 #include "L1.hpp"
+#include <algorithm>
+#include <cstring>
 
 L1::L1(std::string /*name*/, IMPL_CTOR) {
-  UPDATE(update);
+  UPDATE(update_issue).reads(up_req).writes(up_resp, down_req);
+  UPDATE(update_retire).reads(down_resp);
+  set_config(Config{});
 }
 
-void L1::update() {}
-void L1::reset() {}
+static int log2_exact(int v) {
+  int b = 0;
+  while ((1 << b) < v) ++b;
+  return b;
+}
+
+void L1::set_config(const Config& c) {
+  auto pow2 = [](int v) { return v > 0 && (v & (v - 1)) == 0; };
+  assert_always(pow2(c.sets), "L1: sets must be a power of two");
+  assert_always(c.ways >= 1 && c.ways <= 64, "L1: ways must be 1..64");
+  assert_always(c.repl != Repl::PLRU || pow2(c.ways), "L1: PLRU needs a power-of-two way count");
+  assert_always(pow2(c.line_bytes) && c.line_bytes >= 8 && c.line_bytes <= 512, "L1: line_bytes must be a power of two in 8..512");
+  assert_always(c.mshrs >= 1 && c.mshrs <= 256, "L1: mshrs must be 1..256");
+  assert_always(c.mshr_targets >= 1, "L1: mshr_targets must be >= 1");
+  assert_always(c.hit_latency >= 1, "L1: hit_latency must be >= 1");
+  cfg_ = c;
+  set_bits_  = log2_exact(cfg_.sets);
+  line_bits_ = log2_exact(cfg_.line_bytes);
+  reset();
+  trace("l1: sets=%d ways=%d line=%d repl=%s %s mshrs=%d\n", cfg_.sets, cfg_.ways, cfg_.line_bytes,
+        cfg_.repl == Repl::LRU ? "lru" : "plru", cfg_.write_back ? "wb" : "wt", cfg_.mshrs);
+}
+
+bool L1::idle() const {
+  if (!down_q_.empty() || !resp_q_.empty()) return false;
+  for (const auto &m : mshrs_) if (m.valid) return false;
+  return true;
+}
+
+// ----- first update: respond, accept one request, feed downstream -----
+void L1::update_issue() {
+  cyc_++;
+  // 1) Matured response -> up_resp
+  if (!resp_q_.empty() && resp_q_.front().ready <= cyc_ && !up_resp.full()) {
+    up_resp.push(resp_q_.front().r);
+    resp_q_.pop_front();
+  }
+  // 2) Accept one request (left in the FIFO on an MSHR stall)
+  if (!up_req.empty()) {
+    if (accept(up_req.peek())) up_req.pop();
+    else stats_.mshr_full_stalls++;
+  }
+  // 3) One beat downstream
+  if (!down_q_.empty() && !down_req.full()) {
+    down_req.push(down_q_.front());
+    down_q_.pop_front();
+  }
+}
+
+// ----- second update: line fills from downstream -----
+void L1::update_retire() {
+  while (!down_resp.empty()) {
+    auto rr = down_resp.pop();
+    const uint16_t id = (uint16_t)rr.id;
+    if (id & 0x8000u) continue;                // store ack (writeback / write-through): nothing to do
+    const int m = id >> 6, beat = id & 63;
+    assert_always(m < (int)mshrs_.size() && mshrs_[(size_t)m].valid, "L1: fill beat for an idle MSHR");
+    Mshr &ms = mshrs_[(size_t)m];
+    const uint64_t v = (uint64_t)rr.rdata;
+    std::memcpy(&ms.data[(size_t)beat * 8], &v, 8);
+    if (--ms.beats_left == 0) finish_fill(m);
+  }
+}
+
+void L1::reset() {
+  const size_t n = (size_t)cfg_.sets * (size_t)cfg_.ways;
+  lines_.assign(n, Line{});
+  for (auto &ln : lines_) ln.data.assign((size_t)cfg_.line_bytes, 0);
+  plru_.assign((size_t)cfg_.sets, 0);
+  mshrs_.assign((size_t)cfg_.mshrs, Mshr{});
+  down_q_.clear();
+  resp_q_.clear();
+  stats_ = Stats{};
+  cyc_ = 0;
+  stamp_ = 0;
+  wr_seq_ = 0;
+}
+
+// Snoop from below: [addr, addr+bytes) was written by another agent. Every line it touches is dropped;
+// a dirty one is written back first without those bytes, since our copy of them is older and would
+// land on top. A fill in flight serves its targets but is not kept.
+void L1::invalidate(uint64_t addr, uint64_t bytes) {
+  if (bytes == 0) return;
+  const uint64_t end = addr + bytes;
+  const uint64_t lb  = (uint64_t)cfg_.line_bytes;
+  scrub_writes(addr, end);
+  for (uint64_t la = line_addr(addr); la < end; la += lb) {
+    const size_t lo = (size_t)(std::max(addr, la) - la);
+    const size_t hi = (size_t)(std::min(end, la + lb) - la);
+    for (auto &m : mshrs_) {
+      if (!m.valid || m.line_addr != la) continue;
+      m.snooped = true;
+      std::fill(m.snooped_bytes.begin() + (std::ptrdiff_t)lo, m.snooped_bytes.begin() + (std::ptrdiff_t)hi, 1);
+    }
+    const int way = find_way(la);
+    if (way < 0) continue;
+    Line &ln = line(set_of(la), way);
+    if (ln.dirty) {
+      stats_.writebacks++;
+      std::vector<uint8_t> skip((size_t)lb, 0);
+      std::fill(skip.begin() + (std::ptrdiff_t)lo, skip.begin() + (std::ptrdiff_t)hi, 1);
+      write_back(la, ln.data, skip);
+    }
+    ln.valid = false;
+    ln.dirty = false;
+    stats_.invalidations++;
+    trace("l1: snoop inval line=0x%llx bytes=[%zu,%zu)\n", (unsigned long long)la, lo, hi);
+  }
+}
+
+// ----- helpers -----
+int L1::find_way(uint64_t addr) {
+  const int set = set_of(addr);
+  const uint64_t tag = tag_of(addr);
+  for (int w = 0; w < cfg_.ways; ++w) {
+    const Line &ln = line(set, w);
+    if (ln.valid && ln.tag == tag) return w;
+  }
+  return -1;
+}
+
+// Invalid way first; else LRU (oldest stamp) or follow the PLRU tree
+int L1::pick_victim(int set) {
+  for (int w = 0; w < cfg_.ways; ++w) if (!line(set, w).valid) return w;
+  if (cfg_.repl == Repl::PLRU) {
+    const uint64_t bits = plru_[(size_t)set];
+    int node = 1, way = 0;
+    for (int lvl = 0; (1 << lvl) < cfg_.ways; ++lvl) {
+      const int b = (int)((bits >> node) & 1ull);
+      way  = (way << 1) | b;
+      node = node * 2 + b;
+    }
+    return way;
+  }
+  int victim = 0;
+  for (int w = 1; w < cfg_.ways; ++w) if (line(set, w).stamp < line(set, victim).stamp) victim = w;
+  return victim;
+}
+
+void L1::touch(int set, int way) {
+  line(set, way).stamp = ++stamp_;
+  if (cfg_.repl != Repl::PLRU) return;
+  uint64_t &bits = plru_[(size_t)set];
+  const int levels = log2_exact(cfg_.ways);
+  int node = 1;
+  for (int lvl = levels - 1; lvl >= 0; --lvl) {  // point every node on the path away from way
+    const int b = (way >> lvl) & 1;
+    if (b) bits &= ~(1ull << node); else bits |= (1ull << node);
+    node = node * 2 + b;
+  }
+}
+
+void L1::push_write(uint64_t addr, uint64_t data, int size) {
+  smem::MemReq w{};
+  w.addr  = addr;
+  w.wdata = data;
+  w.size  = (uint16_t)size;
+  w.write = true;
+  w.id    = (uint16_t)(0x8000u | (wr_seq_++ & 0x7fffu));
+  down_q_.push_back(w);
+}
+
+// One store per run of bytes not marked in skip (n <= 8, one beat)
+void L1::push_runs(uint64_t addr, const uint8_t* data, const uint8_t* skip, size_t n) {
+  size_t i = 0;
+  while (i < n) {
+    if (skip[i]) { ++i; continue; }
+    size_t j = i;
+    while (j < n && !skip[j]) ++j;
+    uint64_t v = 0;
+    std::memcpy(&v, data + i, j - i);
+    push_write(addr + i, v, (int)(j - i));
+    i = j;
+  }
+}
+
+void L1::write_back(uint64_t la, const std::vector<uint8_t>& data, const std::vector<uint8_t>& skip) {
+  for (size_t b = 0; b < data.size(); b += 8) push_runs(la + b, &data[b], &skip[b], 8);
+}
+
+// Queued stores keep their order but lose the bytes in [lo, hi)
+void L1::scrub_writes(uint64_t lo, uint64_t hi) {
+  std::deque<smem::MemReq> queued;
+  queued.swap(down_q_);
+  for (const auto &r : queued) {
+    const uint64_t a = (uint64_t)r.addr;
+    const size_t   n = (size_t)(uint16_t)r.size;
+    if (!r.write || a >= hi || a + n <= lo) { down_q_.push_back(r); continue; }
+    uint8_t data[8], skip[8];
+    const uint64_t wd = (uint64_t)r.wdata;
+    std::memcpy(data, &wd, 8);
+    for (size_t i = 0; i < n; ++i) skip[i] = (a + i >= lo && a + i < hi) ? 1 : 0;
+    push_runs(a, data, skip, n);
+  }
+}
+
+void L1::access(Line& ln, const smem::MemReq& r, uint64_t ready) {
+  const uint64_t off = (uint64_t)r.addr & (uint64_t)(cfg_.line_bytes - 1);
+  const size_t sz = (size_t)(uint16_t)r.size;
+  smem::MemResp o{};
+  o.id = r.id;
+  if (r.write) {
+    const uint64_t wd = (uint64_t)r.wdata;
+    std::memcpy(&ln.data[off], &wd, sz);
+    if (cfg_.write_back) {
+      ln.dirty = true;
+    } else {                                     // write-through the whole aligned word
+      const uint64_t w0 = off & ~7ull;
+      uint64_t word = 0;
+      std::memcpy(&word, &ln.data[w0], 8);
+      push_write(line_addr((uint64_t)r.addr) + w0, word);
+    }
+  } else {
+    uint64_t v = 0;
+    std::memcpy(&v, &ln.data[off], sz);
+    o.rdata = v;
+  }
+  resp_q_.push_back(PendingResp{ready, o});
+}
+
+bool L1::accept(const smem::MemReq& r) {
+  const uint64_t addr = (uint64_t)r.addr;
+  const uint64_t sz   = (uint64_t)(uint16_t)r.size;
+  assert_always(sz >= 1 && sz <= 8, "L1: access size must be 1..8 bytes");
+  assert_always((addr & (uint64_t)(cfg_.line_bytes - 1)) + sz <= (uint64_t)cfg_.line_bytes, "L1: access crosses a cache line");
+  const uint64_t la = line_addr(addr);
+
+  // Hit
+  const int way = find_way(addr);
+  if (way >= 0) {
+    if (r.write) stats_.stores++; else stats_.loads++;
+    stats_.hits++;
+    touch(set_of(addr), way);
+    access(line(set_of(addr), way), r, cyc_ + (uint64_t)cfg_.hit_latency);
+    trace("l1: hit  id=%u addr=0x%llx %s\n", (unsigned)(uint16_t)r.id, (unsigned long long)addr, r.write ? "st" : "ld");
+    return true;
+  }
+
+  // Secondary miss: line already in flight
+  for (auto &m : mshrs_) {
+    if (!m.valid || m.line_addr != la) continue;
+    if ((int)m.targets.size() >= cfg_.mshr_targets) return false;
+    if (r.write) stats_.stores++; else stats_.loads++;
+    stats_.mshr_merges++;
+    m.targets.push_back(r);
+    return true;
+  }
+
+  // Write-through store miss: no allocate, forward and ack
+  if (r.write && !cfg_.write_back) {
+    if (down_q_.size() >= (size_t)cfg_.mshrs * 8) return false; // bound the store buffer
+    stats_.stores++;
+    stats_.misses++;
+    smem::MemReq w = r;
+    w.id = (uint16_t)(0x8000u | (wr_seq_++ & 0x7fffu));
+    down_q_.push_back(w);
+    smem::MemResp ack{}; ack.id = r.id;
+    resp_q_.push_back(PendingResp{cyc_ + (uint64_t)cfg_.hit_latency, ack});
+    return true;
+  }
+
+  // Primary miss: allocate an MSHR and queue the line fill
+  int m = -1;
+  for (int i = 0; i < (int)mshrs_.size(); ++i) if (!mshrs_[(size_t)i].valid) { m = i; break; }
+  if (m < 0) return false;
+  if (r.write) stats_.stores++; else stats_.loads++;
+  stats_.misses++;
+  Mshr &ms = mshrs_[(size_t)m];
+  const int beats = cfg_.line_bytes / 8;
+  ms.valid      = true;
+  ms.snooped    = false;
+  ms.line_addr  = la;
+  ms.beats_left = beats;
+  ms.data.assign((size_t)cfg_.line_bytes, 0);
+  ms.snooped_bytes.assign((size_t)cfg_.line_bytes, 0);
+  ms.targets.clear();
+  ms.targets.push_back(r);
+  for (int b = 0; b < beats; ++b) {
+    smem::MemReq f{};
+    f.addr  = la + (uint64_t)b * 8;
+    f.size  = 8;
+    f.write = false;
+    f.id    = (uint16_t)((m << 6) | b);
+    down_q_.push_back(f);
+  }
+  trace("l1: miss id=%u addr=0x%llx mshr=%d\n", (unsigned)(uint16_t)r.id, (unsigned long long)addr, m);
+  return true;
+}
+
+void L1::finish_fill(int m) {
+  Mshr &ms = mshrs_[(size_t)m];
+  const int set = set_of(ms.line_addr);
+  const int way = pick_victim(set);
+  Line &ln = line(set, way);
+  if (ln.valid) {
+    stats_.evictions++;
+    if (ln.dirty) {                              // write the victim back ahead of any later refill
+      stats_.writebacks++;
+      const uint64_t va = ((ln.tag << set_bits_) | (uint64_t)set) << line_bits_;
+      for (int b = 0; b < cfg_.line_bytes / 8; ++b) {
+        uint64_t v = 0;
+        std::memcpy(&v, &ln.data[(size_t)b * 8], 8);
+        push_write(va + (uint64_t)b * 8, v);
+      }
+    }
+  }
+  ln.valid = true;
+  ln.dirty = false;
+  ln.tag   = tag_of(ms.line_addr);
+  ln.data.swap(ms.data);
+  touch(set, way);
+  for (const auto &t : ms.targets) access(ln, t, cyc_ + 1);
+  trace("l1: fill line=0x%llx set=%d way=%d targets=%zu\n", (unsigned long long)ms.line_addr, set, way, ms.targets.size());
+  if (ms.snooped) {                            // written below us while in flight: don't keep it
+    if (ln.dirty) {
+      stats_.writebacks++;
+      write_back(ms.line_addr, ln.data, ms.snooped_bytes);
+    }
+    ln.valid = false;
+    ln.dirty = false;
+    stats_.invalidations++;
+  }
+  ms.valid = false;
+  ms.targets.clear();
+}
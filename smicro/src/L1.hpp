@@ -2,9 +2,33 @@
 // smicro/src/L1.hpp
 // **********************************************************************
 // S Magierowski Aug 16 2025
+/*
+Set-associative, non-blocking L1 data cache on the smem::MemReq/smem::MemResp protocol.
+
+  --> up_req   -> update_issue()  -> down_req  -->
+  <-- up_resp  <- update_retire() <- down_resp <--
+
+- sets x ways x line_bytes, LRU or tree-PLRU replacement.
+- write-back + write-allocate, or write-through + no-write-allocate.
+- MSHRs: a miss allocates one per line and fetches it; later misses to the same
+  line merge as targets (up to mshr_targets). No free MSHR/target slot stalls up_req.
+- Downstream traffic is 8-byte beats (the shared L2 is also beat-based):
+  a line fill is line_bytes/8 loads, a dirty eviction line_bytes/8 stores.
+  Fill beats are tagged id = mshr<<6 | beat; store ids have bit 15 set and their acks are dropped.
+- Upstream ops are 1..8 bytes and must not cross a line.
+- snooper() is the hook a shared L2 uses to drop lines another agent wrote.
+  A dirty line is written back first, minus the bytes that agent wrote: they are
+  newer below us, and the write-back lands after them. Store beats still queued
+  here lose those bytes too, and an in-flight fill is served but not kept (nor
+  are its snooped bytes written back).
+*/
 #pragma once
 #include <cascade/Cascade.hpp>
 #include "smem/MemTypes.hpp"
+#include "smem/MemoryPort.hpp"
+#include <cstdint>
+#include <deque>
+#include <vector>
 
 class L1 : public Component {
   DECLARE_COMPONENT(L1);
@@ -18,6 +42,85 @@ public:
   // Downstream (L2-facing)
   FifoOutput(smem::MemReq,  down_req);
   FifoInput (smem::MemResp, down_resp);
-  void update();
+
+  enum class Repl : uint8_t { LRU, PLRU };
+  struct Config {
+    int  sets         = 64;
+    int  ways         = 4;
+    int  line_bytes   = 64;        // power of two, 8..512
+    Repl repl         = Repl::LRU;
+    bool write_back   = true;      // false: write-through, no-write-allocate
+    int  mshrs        = 4;         // outstanding line fills
+    int  mshr_targets = 8;         // requests merged per MSHR
+    int  hit_latency  = 1;         // cycles from accept to response on a hit
+  };
+  struct Stats {
+    uint64_t loads            = 0;
+    uint64_t stores           = 0;
+    uint64_t hits             = 0;
+    uint64_t misses           = 0; // primary misses (allocated an MSHR)
+    uint64_t mshr_merges      = 0; // secondary misses folded into an MSHR
+    uint64_t evictions        = 0; // valid lines replaced
+    uint64_t writebacks       = 0; // dirty lines written back
+    uint64_t mshr_full_stalls = 0; // cycles up_req stalled: no free MSHR / target slot
+    uint64_t invalidations    = 0; // lines dropped by a snoop
+  };
+
+  void set_config(const Config& c);
+  const Config& config() const { return cfg_; }
+  const Stats&  stats() const { return stats_; }
+  double hit_rate() const { const uint64_t n = stats_.loads + stats_.stores; return n ? double(stats_.hits) / double(n) : 0.0; }
+  bool idle() const;    // no MSHR, queued response or downstream request pending
+  void invalidate(uint64_t addr, uint64_t bytes = 4);    // another agent wrote [addr, addr+bytes)
+  smem::MemoryWriteObserver* snooper() { return &snooper_; } // register with the L2 as a sharer
+
+  void update_issue();  // reads up_req, writes up_resp/down_req
+  void update_retire(); // reads down_resp (line fills)
   void reset();
+
+private:
+  struct Line { bool valid = false; bool dirty = false; uint64_t tag = 0; uint64_t stamp = 0; std::vector<uint8_t> data; };
+  struct Mshr {
+    bool valid = false; bool snooped = false; uint64_t line_addr = 0; int beats_left = 0;
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> snooped_bytes; // 1 = written below us while in flight
+    std::vector<smem::MemReq> targets;
+  };
+  class Snooper : public smem::MemoryWriteObserver {
+  public:
+    explicit Snooper(L1& l1) : l1_(l1) {}
+    void on_write32(uint32_t addr) override { l1_.invalidate(addr, 4); }
+    void on_write(uint64_t addr, uint64_t bytes) override { l1_.invalidate(addr, bytes); }
+  private:
+    L1& l1_;
+  };
+  struct PendingResp { uint64_t ready; smem::MemResp r; };
+
+  Config cfg_{};
+  Stats  stats_{};
+  std::vector<Line>     lines_;   // sets*ways, set-major
+  std::vector<uint64_t> plru_;    // one tree per set (bit n = node n, root = 1)
+  std::vector<Mshr>     mshrs_;
+  std::deque<smem::MemReq> down_q_; // beats waiting for down_req
+  std::deque<PendingResp>  resp_q_; // responses waiting for up_resp
+  uint64_t cyc_   = 0;
+  uint64_t stamp_ = 0;            // LRU timestamp source
+  uint16_t wr_seq_ = 0;
+  int      set_bits_ = 0, line_bits_ = 0;
+  Snooper  snooper_{*this};
+
+  uint64_t line_addr(uint64_t addr) const { return addr & ~(uint64_t)(cfg_.line_bytes - 1); }
+  int      set_of(uint64_t addr) const { return (int)((addr >> line_bits_) & (uint64_t)(cfg_.sets - 1)); }
+  uint64_t tag_of(uint64_t addr) const { return addr >> (line_bits_ + set_bits_); }
+  Line&    line(int set, int way) { return lines_[(size_t)set * (size_t)cfg_.ways + (size_t)way]; }
+  int      find_way(uint64_t addr);
+  int      pick_victim(int set);
+  void     touch(int set, int way);
+  void     access(Line& ln, const smem::MemReq& r, uint64_t ready); // serve a hit (or a filled target)
+  bool     accept(const smem::MemReq& r);                           // false: stall (MSHRs full)
+  void     finish_fill(int m);
+  void     push_write(uint64_t addr, uint64_t data, int size = 8);
+  void     push_runs(uint64_t addr, const uint8_t* data, const uint8_t* skip, size_t n); // stores for the unskipped bytes
+  void     write_back(uint64_t la, const std::vector<uint8_t>& data, const std::vector<uint8_t>& skip);
+  void     scrub_writes(uint64_t lo, uint64_t hi);                  // drop [lo, hi) from queued stores
 };
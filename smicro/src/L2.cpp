@@ -1,9 +1,308 @@
+// **********************************************************************
 // smicro/src/L2.cpp
+// **********************************************************************
+// S Magierowski Aug 16 2025
+/*
+Each cycle:
+update_issue()
+  1) per port, return up to port_width matured responses
+  2) per port, move up to port_width requests from its FIFO into its queue (stall if full)
+  3) per bank (unless blocked on a fill), grant the oldest queued request for that bank,
+     round-robin between core and accel when both have one, and serve it
+  4) send at most one queued beat to memory (fills, writebacks, write-throughs)
+update_retire()
+  5) drain mem_resp: fill beats complete a bank's miss; accel write acks go back up
+*/
 #include "L2.hpp"
+#include <algorithm>
+#include <cstring>
 
 L2::L2(std::string /*name*/, IMPL_CTOR) {
-  UPDATE(update);
+  UPDATE(update_issue).reads(core_req, accel_req).writes(core_resp, accel_resp, mem_req);
+  UPDATE(update_retire).reads(mem_resp);
+  set_config(Config{});
 }
 
-void L2::update() {}
-void L2::reset() {}
+static int log2_exact(int v) {
+  int b = 0;
+  while ((1 << b) < v) ++b;
+  return b;
+}
+
+void L2::set_config(const Config& c) {
+  auto pow2 = [](int v) { return v > 0 && (v & (v - 1)) == 0; };
+  assert_always(pow2(c.banks) && c.banks <= 64, "L2: banks must be a power of two <= 64");
+  assert_always(pow2(c.sets), "L2: sets must be a power of two");
+  assert_always(c.ways >= 1, "L2: ways must be >= 1");
+  assert_always(pow2(c.line_bytes) && c.line_bytes >= 8 && c.line_bytes <= 512, "L2: line_bytes must be a power of two in 8..512");
+  assert_always(c.hit_latency >= 1, "L2: hit_latency must be >= 1");
+  assert_always(c.port_width >= 1 && c.queue_depth >= 1, "L2: port_width and queue_depth must be >= 1");
+  cfg_ = c;
+  bank_bits_ = log2_exact(cfg_.banks);
+  set_bits_  = log2_exact(cfg_.sets);
+  line_bits_ = log2_exact(cfg_.line_bytes);
+  reset();
+  trace("l2: banks=%d sets=%d ways=%d line=%d hit=%d port_width=%d\n", cfg_.banks, cfg_.sets, cfg_.ways,
+        cfg_.line_bytes, cfg_.hit_latency, cfg_.port_width);
+}
+
+bool L2::idle() const {
+  if (!down_q_.empty() || !accel_wr_.empty()) return false;
+  for (int p = 0; p < NUM_PORTS; ++p) if (!q_[p].empty() || !resp_q_[p].empty()) return false;
+  for (const auto &b : banks_) if (b.missing) return false;
+  return true;
+}
+
+void L2::add_sharer(smem::MemoryWriteObserver* s) {
+  if (s && std::find(sharers_.begin(), sharers_.end(), s) == sharers_.end()) sharers_.push_back(s);
+}
+
+void L2::remove_sharer(smem::MemoryWriteObserver* s) {
+  sharers_.erase(std::remove(sharers_.begin(), sharers_.end(), s), sharers_.end());
+}
+
+// Out-of-band writer (DMA straight to DRAM): clean+invalidate overlapping lines, tell the sharers
+void L2::invalidate_range(uint64_t addr, uint64_t bytes) {
+  if (bytes == 0) return;
+  for (uint64_t la = line_addr(addr); la < addr + bytes; la += (uint64_t)cfg_.line_bytes) {
+    const int b = bank_of(la);
+    const int way = find_way(banks_[(size_t)b], la);
+    if (way < 0) continue;
+    Line &ln = line(banks_[(size_t)b], set_of(la), way);
+    if (ln.dirty) write_back(b, set_of(la), ln);
+    ln.valid = false;
+    invalidations_++;
+  }
+  notify_sharers(addr, bytes);
+}
+
+// ----- first update: respond, accept, arbitrate banks, feed memory -----
+void L2::update_issue() {
+  cyc_++;
+  // 1) Responses
+  for (int p = 0; p < NUM_PORTS; ++p) {
+    auto &out = (p == CORE) ? core_resp : accel_resp;
+    for (int n = 0; n < cfg_.port_width && !resp_q_[p].empty() && resp_q_[p].front().ready <= cyc_ && !out.full(); ++n) {
+      out.push(resp_q_[p].front().r);
+      resp_q_[p].pop_front();
+    }
+  }
+  // 2) Requests into the port queues
+  for (int p = 0; p < NUM_PORTS; ++p) {
+    auto &in = (p == CORE) ? core_req : accel_req;
+    for (int n = 0; n < cfg_.port_width && !in.empty(); ++n) {
+      if ((int)q_[p].size() >= cfg_.queue_depth) { port_stats_[p].port_stalls++; break; }
+      Entry e;
+      e.r      = in.pop();
+      e.arrive = cyc_;
+      e.bank   = bank_of((uint64_t)e.r.addr);
+      e.port   = p;
+      q_[p].push_back(e);
+    }
+  }
+  // 3) Bank arbitration: oldest request per port for each idle bank
+  for (int b = 0; b < cfg_.banks; ++b) {
+    Bank &bk = banks_[(size_t)b];
+    if (bk.missing) continue;
+    int pick[NUM_PORTS] = {-1, -1};
+    for (int p = 0; p < NUM_PORTS; ++p) {
+      for (size_t i = 0; i < q_[p].size(); ++i) if (q_[p][i].bank == b) { pick[p] = (int)i; break; }
+    }
+    int port = -1;
+    if (pick[CORE] >= 0 && pick[ACCEL] >= 0) {
+      bank_conflicts_++;
+      port = (bk.last_port == CORE) ? ACCEL : CORE;
+    } else if (pick[CORE] >= 0) {
+      port = CORE;
+    } else if (pick[ACCEL] >= 0) {
+      port = ACCEL;
+    }
+    if (port < 0) continue;
+    const Entry e = q_[port][(size_t)pick[port]];
+    q_[port].erase(q_[port].begin() + pick[port]);
+    bk.last_port = port;
+    serve(b, e);
+  }
+  // 4) One beat to memory
+  if (!down_q_.empty() && !mem_req.full()) {
+    mem_req.push(down_q_.front());
+    down_q_.pop_front();
+  }
+}
+
+// ----- second update: fills and accel write acks -----
+void L2::update_retire() {
+  while (!mem_resp.empty()) {
+    auto rr = mem_resp.pop();
+    const uint16_t id = (uint16_t)rr.id;
+    if (id & 0x8000u) continue;                    // writeback / core store ack
+    if (id & 0x4000u) {                            // accel write-through landed: ack the accel
+      auto it = accel_wr_.find((uint16_t)(id & 0x3fffu));
+      assert_always(it != accel_wr_.end(), "L2: unexpected accel write ack");
+      smem::MemResp ack{}; ack.id = it->second;
+      resp_q_[ACCEL].push_back(PendingResp{cyc_, ack});
+      accel_wr_.erase(it);
+      continue;
+    }
+    const int b = id >> 6, beat = id & 63;
+    assert_always(b < cfg_.banks && banks_[(size_t)b].missing, "L2: fill beat for an idle bank");
+    Bank &bk = banks_[(size_t)b];
+    const uint64_t v = (uint64_t)rr.rdata;
+    std::memcpy(&bk.fill[(size_t)beat * 8], &v, 8);
+    if (--bk.beats_left == 0) finish_fill(b);
+  }
+}
+
+void L2::reset() {
+  banks_.assign((size_t)cfg_.banks, Bank{});
+  for (auto &b : banks_) {
+    b.lines.assign((size_t)cfg_.sets * (size_t)cfg_.ways, Line{});
+    for (auto &ln : b.lines) ln.data.assign((size_t)cfg_.line_bytes, 0);
+  }
+  for (int p = 0; p < NUM_PORTS; ++p) { q_[p].clear(); resp_q_[p].clear(); port_stats_[p] = PortStats{}; }
+  down_q_.clear();
+  accel_wr_.clear();
+  invalidations_ = bank_conflicts_ = writebacks_ = 0;
+  cyc_ = stamp_ = 0;
+  wr_seq_ = acc_seq_ = 0;
+}
+
+// ----- helpers -----
+int L2::find_way(Bank& b, uint64_t a) {
+  const int set = set_of(a);
+  const uint64_t tag = tag_of(a);
+  for (int w = 0; w < cfg_.ways; ++w) {
+    const Line &ln = line(b, set, w);
+    if (ln.valid && ln.tag == tag) return w;
+  }
+  return -1;
+}
+
+void L2::push_write(uint64_t addr, uint64_t data, uint16_t id) {
+  smem::MemReq w{};
+  w.addr  = addr;
+  w.wdata = data;
+  w.size  = 8;
+  w.write = true;
+  w.id    = id;
+  down_q_.push_back(w);
+}
+
+void L2::write_back(int bank, int set, Line& ln) {
+  const uint64_t la = ((((ln.tag << set_bits_) | (uint64_t)set) << bank_bits_) | (uint64_t)bank) << line_bits_;
+  for (int i = 0; i < cfg_.line_bytes / 8; ++i) {
+    uint64_t v = 0;
+    std::memcpy(&v, &ln.data[(size_t)i * 8], 8);
+    push_write(la + (uint64_t)i * 8, v, (uint16_t)(0x8000u | (wr_seq_++ & 0x7fffu)));
+  }
+  ln.dirty = false;
+  writebacks_++;
+}
+
+void L2::notify_sharers(uint64_t addr, uint64_t bytes) {
+  for (auto *s : sharers_) s->on_write(addr, bytes);
+}
+
+void L2::access(Line& ln, const Entry& e, uint64_t ready) {
+  const uint64_t off = (uint64_t)e.r.addr & (uint64_t)(cfg_.line_bytes - 1);
+  const size_t sz = (size_t)(uint16_t)e.r.size;
+  smem::MemResp o{};
+  o.id = e.r.id;
+  if (e.r.write) {
+    const uint64_t wd = (uint64_t)e.r.wdata;
+    std::memcpy(&ln.data[off], &wd, sz);
+    ln.dirty = true;
+  } else {
+    uint64_t v = 0;
+    std::memcpy(&v, &ln.data[off], sz);
+    o.rdata = v;
+  }
+  ln.stamp = ++stamp_;
+  resp_q_[e.port].push_back(PendingResp{ready, o});
+}
+
+void L2::serve(int bank, const Entry& e) {
+  Bank &bk = banks_[(size_t)bank];
+  PortStats &ps = port_stats_[e.port];
+  const uint64_t addr = (uint64_t)e.r.addr;
+  const uint64_t sz   = (uint64_t)(uint16_t)e.r.size;
+  assert_always(sz >= 1 && sz <= 8, "L2: access size must be 1..8 bytes");
+  assert_always((addr & (uint64_t)(cfg_.line_bytes - 1)) + sz <= (uint64_t)cfg_.line_bytes, "L2: access crosses a cache line");
+  if (e.r.write) ps.writes++; else ps.reads++;
+  const uint64_t wait = cyc_ - e.arrive;
+  ps.queue_cycles += wait;
+  if (wait > ps.max_queue) ps.max_queue = wait;
+
+  const int set = set_of(addr);
+  const int way = find_way(bk, addr);
+
+  // Accelerator write: write through, drop our copy (merge + write back if dirty), tell the sharers
+  if (e.port == ACCEL && e.r.write) {
+    if (way >= 0) {
+      ps.hits++;
+      Line &ln = line(bk, set, way);
+      if (ln.dirty) {
+        const uint64_t wd = (uint64_t)e.r.wdata;
+        std::memcpy(&ln.data[addr & (uint64_t)(cfg_.line_bytes - 1)], &wd, (size_t)sz);
+        write_back(bank, set, ln);
+      }
+      ln.valid = false;
+      invalidations_++;
+    } else {
+      ps.misses++;
+    }
+    const uint16_t seq = (uint16_t)(acc_seq_++ & 0x3fffu);
+    assert_always(accel_wr_.find(seq) == accel_wr_.end(), "L2: too many accel writes in flight");
+    accel_wr_[seq] = (uint16_t)e.r.id;
+    smem::MemReq w = e.r;
+    w.id = (uint16_t)(0x4000u | seq);
+    down_q_.push_back(w);
+    notify_sharers(addr, sz);
+    trace("l2: accel wr addr=0x%llx inval=%d\n", (unsigned long long)addr, way >= 0 ? 1 : 0);
+    return;
+  }
+
+  if (way >= 0) {
+    ps.hits++;
+    access(line(bk, set, way), e, cyc_ + (uint64_t)cfg_.hit_latency);
+    return;
+  }
+
+  // Miss: this bank blocks until the line arrives
+  ps.misses++;
+  const uint64_t la = line_addr(addr);
+  const int beats = cfg_.line_bytes / 8;
+  bk.missing    = true;
+  bk.miss       = e;
+  bk.beats_left = beats;
+  bk.fill.assign((size_t)cfg_.line_bytes, 0);
+  for (int i = 0; i < beats; ++i) {
+    smem::MemReq f{};
+    f.addr  = la + (uint64_t)i * 8;
+    f.size  = 8;
+    f.write = false;
+    f.id    = (uint16_t)((bank << 6) | i);
+    down_q_.push_back(f);
+  }
+  trace("l2: miss port=%d bank=%d addr=0x%llx\n", e.port, bank, (unsigned long long)addr);
+}
+
+void L2::finish_fill(int bank) {
+  Bank &bk = banks_[(size_t)bank];
+  const uint64_t addr = (uint64_t)bk.miss.r.addr;
+  const int set = set_of(addr);
+  int way = -1;
+  for (int w = 0; w < cfg_.ways; ++w) if (!line(bk, set, w).valid) { way = w; break; }
+  if (way < 0) {                                   // LRU victim
+    way = 0;
+    for (int w = 1; w < cfg_.ways; ++w) if (line(bk, set, w).stamp < line(bk, set, way).stamp) way = w;
+    if (line(bk, set, way).dirty) write_back(bank, set, line(bk, set, way));
+  }
+  Line &ln = line(bk, set, way);
+  ln.valid = true;
+  ln.dirty = false;
+  ln.tag   = tag_of(addr);
+  ln.data.swap(bk.fill);
+  access(ln, bk.miss, cyc_ + 1);
+  bk.missing = false;
+}
@@ -1,7 +1,37 @@
+// **********************************************************************
 // smicro/src/L2.hpp
+// **********************************************************************
+// S Magierowski Aug 16 2025
+/*
+Banked, shared L2 on the smem::MemReq/smem::MemResp protocol.
+
+  core  --> core_req  -+                      +-> mem_req  --> MemCtrl
+                       |-> port queues -> banks
+  accel --> accel_req -+                      +<- mem_resp <-- MemCtrl
+  core  <-- core_resp  / accel_resp <-- per-port response queues
+
+- banks x sets x ways x line_bytes, lines interleaved across banks, LRU, write-back/write-allocate.
+- Each port takes and returns up to port_width requests per cycle into a queue_depth
+  queue; each bank serves one request per cycle, round-robin between the two ports.
+  A bank blocks on its own miss while the other banks keep serving (hit-under-miss).
+- Coherence-lite: an accelerator write is written through to memory and invalidates the
+  L2 line (merging into it and writing it back first if dirty). Registered sharers
+  (L1, Tile1's decode cache) are told the bytes it touches so upper levels drop their
+  copies; a dirty L1 line is written back without those bytes, so its older data
+  cannot land on top of the accel's. The accel write is acked once memory acks it.
+  invalidate_range() does the same for writers that bypass the L2 (e.g. a DMA engine);
+  call it, wait for idle(), then write.
+- Downstream ids: fill beats bank<<6 | beat; writebacks and core stores 0x8000 | seq
+  (acks dropped); accel write-throughs 0x4000 | seq (ack returned on accel_resp).
+*/
 #pragma once
 #include <cascade/Cascade.hpp>
 #include "smem/MemTypes.hpp"
+#include "smem/MemoryPort.hpp"
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
 
 class L2 : public Component {
   DECLARE_COMPONENT(L2);
@@ -18,6 +48,82 @@ public:
   // Accelerator-facing
   FifoInput (smem::MemReq,  accel_req);
   FifoOutput(smem::MemResp, accel_resp);
-  void update();
+
+  struct Config {
+    int banks       = 4;   // power of two
+    int sets        = 128; // per bank, power of two
+    int ways        = 8;
+    int line_bytes  = 64;  // power of two, 8..512
+    int hit_latency = 4;   // cycles from bank access to response
+    int port_width  = 1;   // requests accepted / responses returned per port per cycle
+    int queue_depth = 8;   // per-port request queue
+  };
+  enum Port : int { CORE = 0, ACCEL = 1, NUM_PORTS = 2 };
+  struct PortStats {
+    uint64_t reads        = 0;
+    uint64_t writes       = 0;
+    uint64_t hits         = 0;
+    uint64_t misses       = 0;
+    uint64_t queue_cycles = 0; // sum over requests of cycles waiting for a bank
+    uint64_t max_queue    = 0;
+    uint64_t port_stalls  = 0; // cycles the request FIFO was left waiting (queue full)
+    double hit_rate() const { const uint64_t n = reads + writes; return n ? double(hits) / double(n) : 0.0; }
+    double avg_queue() const { const uint64_t n = reads + writes; return n ? double(queue_cycles) / double(n) : 0.0; }
+  };
+
+  void set_config(const Config& c);
+  const Config& config() const { return cfg_; }
+  const PortStats& port_stats(Port p) const { return port_stats_[p]; }
+  uint64_t invalidations() const { return invalidations_; }  // L2 lines dropped by accel/DMA writes
+  uint64_t bank_conflicts() const { return bank_conflicts_; } // cycles both ports wanted the same bank
+  uint64_t writebacks() const { return writebacks_; }
+  bool idle() const;   // no queued request, fill, response or downstream beat
+
+  // Coherence-lite hooks
+  void add_sharer(smem::MemoryWriteObserver* s);
+  void remove_sharer(smem::MemoryWriteObserver* s);
+  void invalidate_range(uint64_t addr, uint64_t bytes);
+
+  void update_issue();   // reads core_req/accel_req, writes core_resp/accel_resp/mem_req
+  void update_retire();  // reads mem_resp (fills, write acks)
   void reset();
+
+private:
+  struct Line { bool valid = false; bool dirty = false; uint64_t tag = 0; uint64_t stamp = 0; std::vector<uint8_t> data; };
+  struct Entry { smem::MemReq r; uint64_t arrive = 0; int bank = 0; int port = CORE; };
+  struct Bank {
+    std::vector<Line> lines;          // sets*ways
+    bool     missing = false;         // blocking: one fill in flight
+    Entry    miss{};                  // request waiting on the fill
+    int      beats_left = 0;
+    std::vector<uint8_t> fill;
+    int      last_port = ACCEL;       // round-robin: port granted last
+  };
+  struct PendingResp { uint64_t ready; smem::MemResp r; };
+
+  Config cfg_{};
+  std::vector<Bank> banks_;
+  std::deque<Entry> q_[NUM_PORTS];
+  std::deque<PendingResp> resp_q_[NUM_PORTS];
+  std::deque<smem::MemReq> down_q_;
+  std::unordered_map<uint16_t, uint16_t> accel_wr_; // downstream seq -> accel request id
+  std::vector<smem::MemoryWriteObserver*> sharers_;
+  PortStats port_stats_[NUM_PORTS];
+  uint64_t invalidations_ = 0, bank_conflicts_ = 0, writebacks_ = 0;
+  uint64_t cyc_ = 0, stamp_ = 0;
+  uint16_t wr_seq_ = 0, acc_seq_ = 0;
+  int bank_bits_ = 0, set_bits_ = 0, line_bits_ = 0;
+
+  int      bank_of(uint64_t a) const { return (int)((a >> line_bits_) & (uint64_t)(cfg_.banks - 1)); }
+  int      set_of(uint64_t a) const { return (int)((a >> (line_bits_ + bank_bits_)) & (uint64_t)(cfg_.sets - 1)); }
+  uint64_t tag_of(uint64_t a) const { return a >> (line_bits_ + bank_bits_ + set_bits_); }
+  uint64_t line_addr(uint64_t a) const { return a & ~(uint64_t)(cfg_.line_bytes - 1); }
+  Line&    line(Bank& b, int set, int way) { return b.lines[(size_t)set * (size_t)cfg_.ways + (size_t)way]; }
+  int      find_way(Bank& b, uint64_t a);
+  void     serve(int bank, const Entry& e); // one bank access (hit, miss or accel write)
+  void     finish_fill(int bank);
+  void     access(Line& ln, const Entry& e, uint64_t ready);
+  void     write_back(int bank, int set, Line& ln);
+  void     notify_sharers(uint64_t addr, uint64_t bytes);
+  void     push_write(uint64_t addr, uint64_t data, uint16_t id);
 };
@@ -45,6 +45,21 @@ Smoke-test topologies (no caches; accel off)
     - Tile1Core may still have a private MemoryPort → Dram connection for core experiments,
       but all protocol / latency tests are driven by MemTester through MemCtrl.
 
+
+(3) Suites: proto_l1 / proto_l2 (or any tester suite with topo=via_l1)   (Driver: tester)
+
+    MemTester ==> L1 ==> L2.core_req  \
+                                       L2 (banked, shared) ==> MemCtrl ==> Dram
+    AccelMemBridge ==> L2.accel_req   /
+
+    - L1 is a set-associative non-blocking cache (see L1.hpp); L2 is banked and
+      arbitrates its core and accel ports (see L2.hpp). Fills and writebacks move
+      as 8-byte beats.
+    - Accel writes invalidate the L2 line and snoop the L1 (coherence-lite).
+
+(4) Core-driven suites with topo=via_l2 (the default): AccelMemBridge ==> L2.accel_req ==> MemCtrl.
+    L2.core_req is parked; Tile1Core is an L2 sharer so accel writes drop its decoded instructions.
+
 Planned evolution:
     Later, Tile1Core will grow a small LSU that drives m_req/m_resp directly, replacing
     MemTester as the MemCtrl client so the real core exercises the same smem::MemReq/smem::MemResp path.
@@ -100,18 +115,30 @@ SoC::SoC(AttachMode mode, bool use_test_driver, IMPL_CTOR)
   core_->attach_dram(dram_); // let Tile1Core know which DRAM to talk to
   attach_accelerator(array_sum_); // connect accel to Tile1
 
-  // ---- Smoke-test wiring: bypass caches/accel; wire core & tester ----
+  // ---- Smoke-test wiring: wire core & tester (caches only in the via_l1 / via_l2 paths below) ----
   // Core/TestMaster <-> MemCtrl
   if (use_test_driver_) {
     // Disable core ports when tester is driving MemCtrl
     core_->m_req.sendToBitBucket();
     core_->m_resp.wireToZero();
-    // Disable bridge ports when tester is driving MemCtrl
-    ab_->m_req.sendToBitBucket();
-    ab_->m_resp.wireToZero();
-    // Tester -> MemCtrl
-    mem_->in_core_req   << tester_->m_req;
-    tester_->m_resp     << mem_->out_core_resp;
+    if (mode_ == ViaL1) {
+      // Tester -> L1 -> L2 (core port) -> MemCtrl; bridge -> L2 (accel port)
+      l1_->up_req         << tester_->m_req;
+      tester_->m_resp     << l1_->up_resp;
+      l2_->core_req       << l1_->down_req;
+      l1_->down_resp      << l2_->core_resp;
+      l2_->accel_req      << ab_->m_req;
+      ab_->m_resp         << l2_->accel_resp;
+      mem_->in_core_req   << l2_->mem_req;
+      l2_->mem_resp       << mem_->out_core_resp;
+    } else {
+      // Disable bridge ports when tester is driving MemCtrl
+      ab_->m_req.sendToBitBucket();
+      ab_->m_resp.wireToZero();
+      // Tester -> MemCtrl
+      mem_->in_core_req   << tester_->m_req;
+      tester_->m_resp     << mem_->out_core_resp;
+    }
   } else {
     // No tester: neutralize its ports
     tester_->m_req.sendToBitBucket();
@@ -120,16 +147,27 @@ SoC::SoC(AttachMode mode, bool use_test_driver, IMPL_CTOR)
     // so we do not connect it to MemCtrl's core-side ports.
     core_->m_req.sendToBitBucket();        //   core -> bucket
     core_->m_resp.wireToZero();            //   core <- 0
-    // Bridge -> MemCtrl (accelerator memory bridge is the active MemCtrl client)
-    mem_->in_core_req << ab_->m_req;
-    ab_->m_resp       << mem_->out_core_resp;
+    if (mode_ == ViaL2) {
+      // Bridge -> L2 (accel port) -> MemCtrl; L2 core port idle until the core has an LSU
+      l2_->accel_req    << ab_->m_req;
+      ab_->m_resp       << l2_->accel_resp;
+      mem_->in_core_req << l2_->mem_req;
+      l2_->mem_resp     << mem_->out_core_resp;
+      l2_->core_req.sendToBitBucket();   l2_->core_req.wireToZero();
+      l2_->core_resp.sendToBitBucket();  l2_->core_resp.wireToZero();
+    } else {
+      // Bridge -> MemCtrl (accelerator memory bridge is the active MemCtrl client)
+      mem_->in_core_req << ab_->m_req;
+      ab_->m_resp       << mem_->out_core_resp;
+    }
   }
 
   // MemCtrl <-> DRAM (DRAM is zero-latency storage) 
   dram_->s_req        << mem_->s_req;      //           mem ctrl -> dram
   mem_->s_resp        << dram_->s_resp;    //           mem ctrl <- dram
-  // Break req/resp combinational feedback when bridge drives MemCtrl directly.
-  if (use_test_driver_) {
+  // Break req/resp combinational feedback wherever the bridge (one update that both
+  // pops responses and pushes requests) drives MemCtrl or the L2 directly.
+  if (use_test_driver_ || l2_active()) {
     mem_->in_core_req.setDelay(0);
     mem_->out_core_resp.setDelay(0);
   } else {
@@ -139,17 +177,30 @@ SoC::SoC(AttachMode mode, bool use_test_driver, IMPL_CTOR)
   mem_->s_req.setDelay(0);
   mem_->s_resp.setDelay(0);
 
-  // Neutralize unused L1/L2/accel internal ports so construction checks pass
-  l1_->up_req.sendToBitBucket();     l1_->up_req.wireToZero();
-  l1_->up_resp.sendToBitBucket();    l1_->up_resp.wireToZero();
-  l1_->down_req.sendToBitBucket();   l1_->down_req.wireToZero();
-  l1_->down_resp.sendToBitBucket();  l1_->down_resp.wireToZero();
-  l2_->core_req.sendToBitBucket();   l2_->core_req.wireToZero();
-  l2_->core_resp.sendToBitBucket();  l2_->core_resp.wireToZero();
-  l2_->mem_req.sendToBitBucket();    l2_->mem_req.wireToZero();
-  l2_->mem_resp.sendToBitBucket();   l2_->mem_resp.wireToZero();
-  l2_->accel_req.sendToBitBucket();  l2_->accel_req.wireToZero();
-  l2_->accel_resp.sendToBitBucket(); l2_->accel_resp.wireToZero();
+  if (l1_active()) {
+    l1_->up_req.setDelay(0);
+    l1_->up_resp.setDelay(0);
+    l2_->add_sharer(l1_->snooper());   // accel writes drop stale L1 lines
+  } else {
+    // Neutralize unused L1 ports so construction checks pass
+    l1_->up_req.sendToBitBucket();     l1_->up_req.wireToZero();
+    l1_->up_resp.sendToBitBucket();    l1_->up_resp.wireToZero();
+    l1_->down_req.sendToBitBucket();   l1_->down_req.wireToZero();
+    l1_->down_resp.sendToBitBucket();  l1_->down_resp.wireToZero();
+  }
+  if (l2_active()) {
+    l2_->accel_req.setDelay(1);
+    l2_->accel_resp.setDelay(1);
+    l2_->add_sharer(core_->snooper()); // accel writes drop Tile1's decoded copies
+  } else {
+    // Neutralize unused L2 ports so construction checks pass
+    l2_->core_req.sendToBitBucket();   l2_->core_req.wireToZero();
+    l2_->core_resp.sendToBitBucket();  l2_->core_resp.wireToZero();
+    l2_->mem_req.sendToBitBucket();    l2_->mem_req.wireToZero();
+    l2_->mem_resp.sendToBitBucket();   l2_->mem_resp.wireToZero();
+    l2_->accel_req.sendToBitBucket();  l2_->accel_req.wireToZero();
+    l2_->accel_resp.sendToBitBucket(); l2_->accel_resp.wireToZero();
+  }
 
   // Accel attach (ViaL2 by default)
   // Make top-level accel control ports inert unless TB connects them
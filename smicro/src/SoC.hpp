@@ -56,6 +56,11 @@ public:
   void set_mem_latency(int v) { if (mem_) mem_->set_latency(v); }            // set MemCtrl latency in cycles
   void set_dram_latency(int v) { set_mem_latency(v); }                       // back-compat alias
   void set_posted_writes(bool en) { if (mem_) mem_->set_posted_writes(en); } // enable/disable posted write acks
+  void set_dram_timing(const smem::MemCtrl::DramTiming& t) { if (mem_) mem_->set_timing(t); } // banked DRAM model (banks=0: flat)
+  void set_l1_config(const L1::Config& c) { if (l1_) l1_->set_config(c); }      // L1 geometry/policy (only in path for tester + ViaL1)
+  void set_l2_config(const L2::Config& c) { if (l2_) l2_->set_config(c); }      // L2 banks/ports/geometry
+  bool l1_active() const { return use_test_driver_ && mode_ == ViaL1; }
+  bool l2_active() const { return use_test_driver_ ? (mode_ == ViaL1) : (mode_ == ViaL2); }
 
   void attach_accelerator(AccelPort* accel);
 
@@ -23,6 +23,7 @@ void Tile1Core::attach_dram(smem::Dram* dram) { // to tell Tile1Core which DRAM
 
   // Clean up any existing adapter
   if (dram_port_) {
+    tile_.attach_memory(nullptr); // Tile1 stops observing the adapter before it is freed
     delete dram_port_;
     dram_port_ = nullptr;
   }
@@ -42,6 +43,12 @@ void Tile1Core::set_pc(uint32_t pc) {
   tile_.set_pc(pc);
 }
 
+// physical -> CPU address (DramMemoryPort maps CPU addr to dram base + addr)
+void Tile1Core::Snooper::on_write32(uint32_t phys) {
+  if (!core_.dram_ || phys < core_.dram_->get_base()) return;
+  core_.tile_.invalidate_decoded(static_cast<uint32_t>(phys - core_.dram_->get_base()));
+}
+
 void Tile1Core::update() {
   tile_.tick();   // for now: just tick Tile1. Memory is handled synchronously via DramMemoryPort.
 }
@@ -20,6 +20,7 @@ Tile1Core: minimal wrapper to host Tile1 inside smicro ecosystem.
 #include "smem/MemTypes.hpp"
 #include "Tile1.hpp"        // tile from smile
 #include "smem/Dram.hpp"         // if you want to connect DRAM
+#include "smem/MemoryPort.hpp"
 
 class AccelPort;
 namespace smem { class DramMemoryPort; }
@@ -45,10 +46,22 @@ public:
   void attach_dram(smem::Dram* dram); // let SoC give Tile1Core a DRAM to talk to
   void attach_accelerator(AccelPort* accel);
   void set_pc(uint32_t pc);
+  // Register with a shared L2 as a sharer: writes by other agents (physical addrs)
+  // drop Tile1's decoded instructions/blocks for those words.
+  smem::MemoryWriteObserver* snooper() { return &snooper_; }
 
 private:
+  class Snooper : public smem::MemoryWriteObserver {
+  public:
+    explicit Snooper(Tile1Core& core) : core_(core) {}
+    void on_write32(uint32_t phys) override;
+  private:
+    Tile1Core& core_;
+  };
+
   Tile1 tile_;                  // the actual RISC-V core (in smile)
   smem::Dram* dram_ = nullptr;  // the DRAM to connect to
   // Shared adapter from smem, allocated once DRAM is attached.
   smem::DramMemoryPort* dram_port_ = nullptr;
+  Snooper snooper_{*this};
 };
@@ -36,10 +36,12 @@ cedar/build/smicro % ./smicro <options>
 #endif
 #include <descore/Parameter.hpp>
 #include <cstddef> // proto_accel_sum needs size_t for vector params
+#include <algorithm> // proto_l2 picks the first-scripted response by id
 #include <cstdint> // for uint32_t, etc. in proto_accel_sum
 #include <iostream>
 #include <vector>  // for vector parameters in proto_accel_sum
 #include "SoC.hpp"
+#include "AccelMemBridge.hpp" // proto_l2 drives the bridge host API directly
 #include "AccelCmd.hpp" 
 
 using namespace std;
@@ -50,12 +52,101 @@ using namespace std;
 StringParameter(topo,       "via_l2", "Topology: via_l1|via_l2|dram|priv"); // defaults topo is via_l2
 IntParameter(steps,          0,      "Batch steps; 0=interactive");
 // New single-switch suite
-StringParameter(suite,      "proto_core", "Suite: hal_none|hal_multi|hal_bounds|proto_core|proto_accel_sum|proto_accel_sum_altaddr|proto_accel_sum_badarg|proto_accel_sum_unsupported|proto_accel_sum_twice|proto_raw|proto_no_raw|proto_rar|proto_lat");
+StringParameter(suite,      "proto_core", "Suite: hal_none|hal_multi|hal_bounds|hal_sparse|proto_core|proto_accel_sum|proto_accel_sum_altaddr|proto_accel_sum_badarg|proto_accel_sum_unsupported|proto_accel_sum_twice|proto_raw|proto_no_raw|proto_rar|proto_lat|proto_banked|proto_l1|proto_l2");
 IntParameter(mem_latency,     3, "MemCtrl latency (cycles)");
 IntParameter(dram_latency,   -1, "[deprecated] use -mem_latency; if >=0 overrides mem_latency");
 BoolParameter(drain,         false, "After run, fence: keep stepping until posted stores drain");
 BoolParameter(showcontexts,  false, "List component instance names (contexts) and exit");
 BoolParameter(posted_writes, true, "Enable posted write ACKs (1=posted, 0=ack on drain)");
+IntParameter(dram_mb,       256, "DRAM window size in MB (sparse: only touched pages are allocated)");
+IntParameter(dram_banks,      0, "MemCtrl DRAM banks (0=flat fixed latency; >0 banked FR-FCFS model)");
+IntParameter(dram_row_bytes, 2048, "Banked model: bytes per DRAM row");
+IntParameter(t_cl,            2, "Banked model: column access cycles (row hit)");
+IntParameter(t_rcd,           3, "Banked model: activate cycles (closed bank)");
+IntParameter(t_rp,            3, "Banked model: precharge cycles (row conflict)");
+IntParameter(l1_sets,        64, "L1 (topo=via_l1): sets (power of two)");
+IntParameter(l1_ways,         4, "L1: ways");
+IntParameter(l1_line,        64, "L1: line bytes (power of two, 8..512)");
+StringParameter(l1_repl,  "lru", "L1: replacement lru|plru");
+BoolParameter(l1_wb,        true, "L1: 1=write-back/write-allocate, 0=write-through/no-write-allocate");
+IntParameter(l1_mshrs,        4, "L1: MSHRs (outstanding line fills)");
+IntParameter(l1_hit_lat,      1, "L1: hit latency (cycles)");
+IntParameter(l2_banks,        4, "L2 (topo=via_l2, or via_l1 with tester): banks (power of two)");
+IntParameter(l2_sets,       128, "L2: sets per bank (power of two)");
+IntParameter(l2_ways,         8, "L2: ways");
+IntParameter(l2_line,        64, "L2: line bytes (power of two, 8..512)");
+IntParameter(l2_hit_lat,      4, "L2: hit latency (cycles)");
+IntParameter(l2_port_width,   1, "L2: requests accepted/returned per port per cycle");
+IntParameter(l2_queue,        8, "L2: per-port request queue depth");
+
+static smem::MemCtrl::DramTiming timing_from_params(int banks) {
+  smem::MemCtrl::DramTiming t;
+  t.banks     = banks;
+  t.row_bytes = (int)dram_row_bytes;
+  t.t_cl      = (int)t_cl;
+  t.t_rcd     = (int)t_rcd;
+  t.t_rp      = (int)t_rp;
+  return t;
+}
+
+static void print_bank_stats(const smem::MemCtrl& mc) {
+  const auto& bs = mc.bank_stats();
+  if (bs.empty()) return;
+  printf("[DRAM] row_hit_rate=%.3f hits=%llu accesses=%llu reordered=%llu qfull=%llu\n",
+         mc.row_hit_rate(), (unsigned long long)mc.row_hits(), (unsigned long long)mc.row_accesses(),
+         (unsigned long long)mc.reordered(), (unsigned long long)mc.queue_full_stalls());
+  for (size_t b = 0; b < bs.size(); ++b) {
+    printf("[DRAM] bank%zu hits=%llu misses=%llu conflicts=%llu rd=%llu wr=%llu busy=%llu\n", b,
+           (unsigned long long)bs[b].row_hits, (unsigned long long)bs[b].row_misses,
+           (unsigned long long)bs[b].row_conflicts, (unsigned long long)bs[b].reads,
+           (unsigned long long)bs[b].writes, (unsigned long long)bs[b].busy_cycles);
+  }
+}
+
+static L1::Config l1_config_from_params() {
+  L1::Config c;
+  c.sets        = (int)l1_sets;
+  c.ways        = (int)l1_ways;
+  c.line_bytes  = (int)l1_line;
+  c.repl        = (std::string(l1_repl) == "plru") ? L1::Repl::PLRU : L1::Repl::LRU;
+  c.write_back  = (bool)l1_wb;
+  c.mshrs       = (int)l1_mshrs;
+  c.hit_latency = (int)l1_hit_lat;
+  return c;
+}
+
+static void print_l1_stats(const L1& l1) {
+  const auto& st = l1.stats();
+  printf("[L1] hit_rate=%.3f loads=%llu stores=%llu hits=%llu misses=%llu merges=%llu evictions=%llu writebacks=%llu mshr_full=%llu\n",
+         l1.hit_rate(), (unsigned long long)st.loads, (unsigned long long)st.stores, (unsigned long long)st.hits,
+         (unsigned long long)st.misses, (unsigned long long)st.mshr_merges, (unsigned long long)st.evictions,
+         (unsigned long long)st.writebacks, (unsigned long long)st.mshr_full_stalls);
+}
+
+static L2::Config l2_config_from_params() {
+  L2::Config c;
+  c.banks       = (int)l2_banks;
+  c.sets        = (int)l2_sets;
+  c.ways        = (int)l2_ways;
+  c.line_bytes  = (int)l2_line;
+  c.hit_latency = (int)l2_hit_lat;
+  c.port_width  = (int)l2_port_width;
+  c.queue_depth = (int)l2_queue;
+  return c;
+}
+
+static void print_l2_stats(const L2& l2) {
+  const char* names[L2::NUM_PORTS] = {"core", "accel"};
+  for (int p = 0; p < L2::NUM_PORTS; ++p) {
+    const auto& ps = l2.port_stats((L2::Port)p);
+    printf("[L2] %-5s hit_rate=%.3f rd=%llu wr=%llu hits=%llu misses=%llu avg_queue=%.2f max_queue=%llu stalls=%llu\n",
+           names[p], ps.hit_rate(), (unsigned long long)ps.reads, (unsigned long long)ps.writes,
+           (unsigned long long)ps.hits, (unsigned long long)ps.misses, ps.avg_queue(),
+           (unsigned long long)ps.max_queue, (unsigned long long)ps.port_stalls);
+  }
+  printf("[L2] invalidations=%llu bank_conflicts=%llu writebacks=%llu\n", (unsigned long long)l2.invalidations(),
+         (unsigned long long)l2.bank_conflicts(), (unsigned long long)l2.writebacks());
+}
 
 static AttachMode parse_mode(const std::string& topo) {
   if (topo == "via_l1") return ViaL1;
@@ -92,7 +183,8 @@ int main (int argc, char *argv[]) {
                     (S != "proto_accel_sum_badarg") && 
                     (S != "proto_accel_sum_unsupported") && 
                     (S != "proto_accel_sum_twice"); // tester for proto_* except core-driven suites
-  SoC soc(parse_mode(topo), use_tester);     // invoke SoC object in desired config
+  AttachMode mode = (S == "proto_l1" || S == "proto_l2") ? ViaL1 : parse_mode(topo); // cache suites run tester -> L1 -> L2
+  SoC soc(mode, use_tester);                 // invoke SoC object in desired config
   
   // **************
   // Step 3: Optional: list component instance names and exit
@@ -106,6 +198,10 @@ int main (int argc, char *argv[]) {
   int eff_lat = (dram_latency >= 0) ? (int)dram_latency : (int)mem_latency;
   soc.set_mem_latency(eff_lat);
   soc.set_posted_writes(posted_writes);
+  if (soc.dram_ && dram_mb > 0) soc.dram_->set_capacity(static_cast<uint64_t>((int)dram_mb) << 20);
+  if (dram_banks > 0) soc.set_dram_timing(timing_from_params((int)dram_banks));
+  if (soc.l1_active()) soc.set_l1_config(l1_config_from_params());
+  if (soc.l2_active()) soc.set_l2_config(l2_config_from_params());
   
   // **************
   // Step 5: Hook clock and initialize simulator
@@ -157,6 +253,22 @@ int main (int argc, char *argv[]) {
       log("\n");
       return true;
     }
+    if (S == "hal_sparse") {
+      // Far-apart touches only commit the pages they land on; untouched pages read as zero
+      uint64_t base=d->get_base(), sz=d->get_size(), pg=d->get_page_bytes(), r=1, x=0x5A5A5A5A5A5A5A5AULL;
+      const uint64_t before = d->resident_pages();
+      d->read(base+sz/2,&r,8);     assert_always(r==0, "untouched page not zero");
+      assert_always(d->resident_pages()==before, "read allocated a page");
+      d->write(base+pg-4,&x,8);    // straddles a page boundary
+      d->write(base+sz-8,&x,8);    // last word of the window
+      d->read(base+pg-4,&r,8);     assert_always(r==x, "straddle mismatch");
+      d->read(base+sz-8,&r,8);     assert_always(r==x, "top-of-window mismatch");
+      assert_always(d->resident_pages() <= before + 3, "sparse DRAM committed too many pages");
+      cout << "DRAM resident pages: " << d->resident_pages() << "/" << d->page_count()
+           << " (" << d->resident_bytes() << " of " << sz << " bytes)" << endl;
+      log("\n");
+      return true;
+    }
     return false;
   };
   if (is_hal) {
@@ -361,6 +473,154 @@ int main (int argc, char *argv[]) {
       assert_always((uint64_t)e1.rdata == (uint64_t)e2.rdata, "rar: load values mismatch");
       return true;
     }
+    if (s == "proto_banked") {
+      // Banked model: miss, hit, then FR-FCFS lets a row hit (Z) jump an older row conflict (Y)
+      if (soc.mem_->timing().banks == 0) soc.set_dram_timing(timing_from_params(4));
+      const uint64_t row_span = (uint64_t)soc.mem_->timing().row_bytes * (uint64_t)soc.mem_->timing().banks;
+      const uint64_t X = base, Y = base + row_span, Z = base + 8;   // same bank; Y is a different row
+      t->clear_script(); t->clear_results();
+      t->enqueue_load(X);
+      t->enqueue_load(Y);
+      t->enqueue_load(Z);
+      for (int i=0;i<mem_lat+40;i++) { Sim::run(); log("\n"); }
+      const auto& rs = t->results();
+      assert_always(rs.size() == 3, "banked: expected three load responses");
+      assert_always(rs[1].id == 2 && rs[2].id == 1, "banked: FR-FCFS should serve row hit Z before conflict Y");
+      assert_always(soc.mem_->row_hits() >= 1 && soc.mem_->reordered() >= 1, "banked: expected a reordered row hit");
+      const auto& b0 = soc.mem_->bank_stats()[0];
+      assert_always(b0.row_misses == 1 && b0.row_conflicts == 1, "banked: expected one miss and one conflict on bank0");
+      print_bank_stats(*soc.mem_);
+      return true;
+    }
+    auto run_until = [&](size_t n) { // step until the tester has n responses (bounded)
+      for (int i=0;i<4000 && t->results().size()<n;i++) { Sim::run(); log("\n"); }
+    };
+    if (s == "proto_l1") {
+      // Tester -> L1 -> L2 -> MemCtrl: miss then hit latency, MSHR merge, and a dirty eviction round trip
+      auto* l1 = soc.l1_;
+      const auto& cfg = l1->config();
+      const uint64_t stride = (uint64_t)cfg.sets * (uint64_t)cfg.line_bytes; // same set, next tag
+      const uint64_t D = 0x0123456789ABCDEFULL;
+      auto by_seq = [](const std::vector<MemTester::Ev>& rs, int k) -> const MemTester::Ev& { // k-th op of the script
+        uint16_t id0 = rs.front().id;
+        for (const auto& e : rs) if (e.id < id0) id0 = e.id;
+        for (const auto& e : rs) if (e.id == id0 + k) return e;
+        assert_always(false, "l1: missing response");
+        return rs.front();
+      };
+      // (1) cold store + load of the same line: one fill, the load merges or hits
+      t->clear_script(); t->clear_results();
+      t->enqueue_store(A, D);
+      t->enqueue_load(A);
+      t->enqueue_load(B);
+      run_until(3);
+      {
+        const auto& rs = t->results();
+        assert_always(rs.size() == 3, "l1: expected three responses");
+        const auto& ld = by_seq(rs, 1);
+        assert_always((uint64_t)ld.rdata == D, "l1: load after store returned wrong data");
+        assert_always((int64_t)(ld.resp_cyc - ld.sent_cyc) > cfg.hit_latency, "l1: cold load should pay the miss");
+      }
+      // (2) warm load: hit latency only
+      t->clear_script(); t->clear_results();
+      t->enqueue_load(A);
+      for (int i=0;i<cfg.hit_latency+4;i++) { Sim::run(); log("\n"); }
+      {
+        const auto& rs = t->results();
+        assert_always(rs.size() == 1, "l1: expected one hit response");
+        assert_always((uint64_t)rs[0].rdata == D, "l1: hit returned wrong data");
+        assert_always((int64_t)(rs[0].resp_cyc - rs[0].sent_cyc) == cfg.hit_latency, "l1: expected hit latency");
+      }
+      // (3) sweep ways+1 conflicting lines through A's set, then reload A from memory
+      t->clear_script(); t->clear_results();
+      for (int w = 1; w <= cfg.ways; ++w) t->enqueue_load(A + (uint64_t)w * stride);
+      run_until((size_t)cfg.ways);
+      t->clear_script(); t->clear_results();
+      t->enqueue_load(A);
+      run_until(1);
+      {
+        const auto& rs = t->results();
+        assert_always(rs.size() == 1, "l1: expected reload response");
+        assert_always((uint64_t)rs[0].rdata == D, "l1: evicted line lost its data");
+        assert_always((int64_t)(rs[0].resp_cyc - rs[0].sent_cyc) > cfg.hit_latency, "l1: reload should miss");
+      }
+      const auto& st = l1->stats();
+      assert_always(st.evictions >= 1, "l1: expected an eviction");
+      assert_always(!cfg.write_back || st.writebacks >= 1, "l1: expected a dirty writeback");
+      print_l1_stats(*l1);
+      print_l2_stats(*soc.l2_);
+      return true;
+    }
+    if (s == "proto_l2") {
+      // Coherence-lite: the tester caches A in L1+L2, the accel bridge writes A through the
+      // L2 accel port, and the tester's next load must miss both levels and see the new value.
+      auto* l1 = soc.l1_;
+      auto* l2 = soc.l2_;
+      auto* ab = soc.ab_;
+      const uint64_t V0 = 0x1111222233334444ULL;
+      soc.dram_->write(A, &V0, sizeof(V0));
+      t->clear_script(); t->clear_results();
+      t->enqueue_load(A);
+      t->enqueue_load(A);
+      run_until(2);
+      assert_always(t->results().size() == 2, "l2: expected two responses");
+      assert_always((uint64_t)t->results()[1].rdata == V0, "l2: initial load returned wrong data");
+      // accel store32 to the low lane of A (bridge: RMW load64 hits L2, store64 writes through)
+      const uint32_t V1 = 0xA5A5A5A5u;
+      ab->start_store32(static_cast<uint32_t>(A - base), V1);
+      for (int i=0;i<4000 && !ab->resp_valid();i++) { Sim::run(); log("\n"); }
+      assert_always(ab->resp_valid(), "l2: accel store never acked");
+      ab->resp_consume();
+      assert_always(l2->invalidations() >= 1, "l2: accel write should invalidate the L2 line");
+      assert_always(l1->stats().invalidations >= 1, "l2: accel write should snoop the L1 line");
+      // core-side reload must see the accel's data
+      t->clear_script(); t->clear_results();
+      t->enqueue_load(A);
+      run_until(1);
+      assert_always(t->results().size() == 1, "l2: expected reload response");
+      const uint64_t want = (V0 & 0xffffffff00000000ULL) | V1;
+      assert_always((uint64_t)t->results()[0].rdata == want, "l2: core read stale data after accel write");
+      const auto& cs = l2->port_stats(L2::CORE);
+      const auto& as = l2->port_stats(L2::ACCEL);
+      assert_always(cs.misses >= 2 && as.hits >= 1, "l2: expected core misses and an accel hit");
+      // Dirty case: the core stores to A+8 (L1 line dirty, L2 copy clean), then the accel stores
+      // to A. The snoop's write-back lands after the accel write-through and must carry A+8
+      // without overwriting A; memory ends up with both writers' words.
+      const uint64_t V2 = 0x0DDBA11C0FFEE000ULL;
+      t->clear_script(); t->clear_results();
+      t->enqueue_store(A + 8, V2);
+      run_until(1);
+      const uint64_t wb0 = l1->stats().writebacks;
+      const uint32_t V3 = 0x5A5A0F0Fu;
+      ab->start_store32(static_cast<uint32_t>(A - base), V3);
+      for (int i=0;i<4000 && !ab->resp_valid();i++) { Sim::run(); log("\n"); }
+      assert_always(ab->resp_valid(), "l2: dirty-line accel store never acked");
+      ab->resp_consume();
+      for (int i=0;i<4000 && !(l1->idle() && l2->idle() && soc.mem_->writes_empty());i++) { Sim::run(); log("\n"); }
+      assert_always(l1->stats().writebacks == wb0 + 1, "l2: snooping the dirty L1 line should write it back");
+      const uint64_t want_a = (want & 0xffffffff00000000ULL) | V3;
+      t->clear_script(); t->clear_results();
+      t->enqueue_load(A);
+      t->enqueue_load(A + 8);
+      run_until(2);
+      assert_always(t->results().size() == 2, "l2: expected two dirty-case reloads");
+      const uint16_t id_a = std::min(t->results()[0].id, t->results()[1].id); // load A was scripted first
+      for (const auto& e : t->results()) {
+        const uint64_t exp = (e.id == id_a) ? want_a : V2;
+        assert_always((uint64_t)e.rdata == exp, "l2: core read stale data after a dirty snoop");
+      }
+      // push everything out of L2 and check DRAM itself
+      l2->invalidate_range(A, (uint64_t)l2->config().line_bytes);
+      for (int i=0;i<4000 && !(l2->idle() && soc.mem_->writes_empty());i++) { Sim::run(); log("\n"); }
+      uint64_t mem_a = 0, mem_a8 = 0;
+      soc.dram_->read(A, &mem_a, 8);
+      soc.dram_->read(A + 8, &mem_a8, 8);
+      assert_always(mem_a == want_a, "l2: L1 write-back overwrote the accel's word in memory");
+      assert_always(mem_a8 == V2, "l2: L1 write-back lost the core's dirty word");
+      print_l1_stats(*l1);
+      print_l2_stats(*l2);
+      return true;
+    }
     if (s == "proto_lat") {
       for (int L : {0,1,3,7}) {
         soc.set_mem_latency(L); Sim::run(); log("\n");
@@ -400,6 +660,9 @@ int main (int argc, char *argv[]) {
       // Advance until all posted stores drain from MemCtrl (useful for fences)
       while (!soc.mem_->writes_empty()) { Sim::run(); log("\n"); }
     }
+    if (S != "proto_banked") print_bank_stats(*soc.mem_);
+    if (S != "proto_l1" && S != "proto_l2" && soc.l1_active()) print_l1_stats(*soc.l1_);
+    if (S != "proto_l1" && S != "proto_l2" && soc.l2_active()) print_l2_stats(*soc.l2_);
     return 0;
   }
 
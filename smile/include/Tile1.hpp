@@ -10,7 +10,9 @@ Define tile processing sequence upon ticks as well as support methods and it's m
 #include <cascade/Cascade.hpp>
 #include <array>
 #include <cstdint>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 #include "Instruction.hpp"
 #include "smem/MemoryPort.hpp"
 struct ThreadContext {       // structure to hold thread context
@@ -28,6 +30,7 @@ class Tile1 : public Component { // inherit from Component,
 public:
   // Construction and lifecycle
   Tile1(std::string name, COMPONENT_CTOR); // constructor medthod declaration
+  ~Tile1();                                // detaches the decode cache from the memory port
   Clock(clk);
   void tick();
   void reset();
@@ -50,6 +53,7 @@ public:
     Machine     = 3u,
   };
   enum class MemModel : uint8_t { Timed = 0, Ideal = 1 }; // for switching between ideal/timed mem models
+  enum class ExecMode : uint8_t { Step = 0, Block = 1 };  // one instr per tick vs. translated basic blocks per tick
   // public CSR addres constants
   static constexpr uint32_t CSR_MSTATUS = 0x300u;
   static constexpr uint32_t CSR_MTVEC   = 0x305u;
@@ -112,6 +116,24 @@ public:
   void     set_mem_model(MemModel m) { mem_model_ = m; }  // a way to set ideal or timed mem model…
   MemModel mem_model() const { return mem_model_; }       // …(currently used by testbench cmdline args)
 
+  // Decoded-instruction cache (PC-indexed, skips decode + dispatch tree on a hit)
+  void     set_decode_cache(bool on);                     // enable/disable (flushes either way)
+  bool     decode_cache_enabled()  const { return decode_cache_on_; }
+  void     flush_decode_cache();
+  void     invalidate_decoded(uint32_t addr);             // drop any entry caching the word at addr
+  uint64_t decode_cache_hits()     const { return decode_cache_hits_; }
+  uint64_t decode_cache_misses()   const { return decode_cache_misses_; }
+  uint64_t decode_cache_invalidations() const { return decode_cache_invals_; }
+
+  // Basic-block translation (fast functional mode, needs MemModel::Ideal)
+  void     set_exec_mode(ExecMode m);                     // switching flushes translated blocks
+  ExecMode exec_mode()             const { return exec_mode_; }
+  void     set_block_budget(uint32_t n) { block_budget_ = n ? n : 1u; } // instrs a Block-mode tick may retire
+  uint32_t block_budget()          const { return block_budget_; }
+  uint64_t blocks_translated()     const { return blocks_translated_; }
+  uint64_t block_chain_hits()      const { return block_chain_hits_; }
+  uint64_t block_flushes()         const { return block_flushes_; }
+
   // CSR accessors
   uint32_t read_csr(uint32_t addr) const;
   void     write_csr(uint32_t addr, uint32_t value);
@@ -137,6 +159,69 @@ public:
 private:
   friend void exec_custom0(Tile1& tile, const Instruction& instr);
 
+  // Pre-resolved dispatch for one instruction: what the decode tree in tick() selects,
+  // captured once so a decoded-cache hit can go straight to the exec_* helper.
+  enum class OpKind : uint8_t {
+    None = 0, // recognized category but no handler (still counted)
+    Exec,     // exec(tile, instr), PC advances
+    ExecPc,   // exec_pc(tile, instr, curr_pc), PC advances (AUIPC)
+    System,   // exec(tile, instr) if any, PC held (ECALL/EBREAK/xRET)
+    Load,
+    Store,
+    Jump,     // next_pc = jump(tile, instr, curr_pc)
+    Branch    // taken = branch(tile, instr) if any
+  };
+  using ExecFn   = void (*)(Tile1&, const Instruction&);
+  using ExecPcFn = void (*)(Tile1&, const Instruction&, uint32_t);
+  using JumpFn   = uint32_t (*)(Tile1&, const Instruction&, uint32_t);
+  using BranchFn = bool (*)(Tile1&, const Instruction&);
+  struct DecodedOp {
+    Instruction instr{0u};
+    OpKind   kind    = OpKind::None;
+    ExecFn   exec    = nullptr;
+    ExecPcFn exec_pc = nullptr;
+    JumpFn   jump    = nullptr;
+    BranchFn branch  = nullptr;
+    bool     count_arith = false; // ALU category
+    bool     count_add   = false; // ADD/SUB
+    bool     count_mul   = false; // MUL
+  };
+  struct DecodeCacheEntry {
+    bool      valid = false;
+    uint32_t  pc    = 0;
+    DecodedOp op{};
+  };
+  // Forwards MemoryPort write notifications into the decoded cache (self-modifying code)
+  class DecodeCacheInvalidator : public smem::MemoryWriteObserver {
+  public:
+    explicit DecodeCacheInvalidator(Tile1& tile) : tile_(tile) {}
+    void on_write32(uint32_t addr) override { tile_.invalidate_decoded(addr); }
+  private:
+    Tile1& tile_;
+  };
+  static constexpr size_t kDecodeCacheEntries = 4096; // direct-mapped on pc[13:2]
+
+  // A translated basic block: straight-line pre-decoded ops, optionally ending in a
+  // branch/JAL/JALR.  Ops that must go through tick() (SYSTEM, CSR, CUSTOM-0, FENCE.I)
+  // are never translated; a block stops just before them.
+  struct TranslatedBlock {
+    uint32_t start_pc = 0;
+    uint32_t end_pc   = 0;                          // pc right after the last op
+    std::vector<DecodedOp> ops;
+    TranslatedBlock* next[2] = {nullptr, nullptr};  // chained successors: [0] fall-through, [1] taken/jump target
+  };
+  static constexpr size_t kMaxBlockOps = 64;
+
+  bool run_blocks();                            // Block mode body of tick(); false => step the instr at pc_
+  TranslatedBlock* find_block(uint32_t pc);     // lookup, translating on a miss
+  static bool needs_step(const DecodedOp& op);  // must this op run through the per-instruction path?
+  void flush_blocks();
+  void load_ideal(const Instruction& instr, uint32_t addr);                 // ideal-mem data path shared
+  void store_ideal(const Instruction& instr, uint32_t addr, uint32_t data); // by tick() and block mode
+  static DecodedOp resolve_op(uint32_t instr);        // walk the decode tree once
+  const DecodedOp* cached_op(uint32_t pc) const;      // valid cache entry for pc, else nullptr
+  const DecodedOp& fill_op(uint32_t pc, uint32_t instr); // decode instr and (if enabled) cache it
+
   enum class DmemOp : uint8_t {
     None = 0,
     LW,
@@ -210,6 +295,26 @@ private:
   bool exited_ = false;              // has core's program intentionally finished
   uint32_t exit_code_ = 0;
 
+  // Decoded-instruction cache state
+  bool decode_cache_on_ = true;
+  std::vector<DecodeCacheEntry> decode_cache_;
+  DecodedOp decode_scratch_{};          // holds the op when the cache is disabled
+  DecodeCacheInvalidator decode_invalidator_{*this};
+  uint64_t decode_cache_hits_   = 0;
+  uint64_t decode_cache_misses_ = 0;
+  uint64_t decode_cache_invals_ = 0;
+
+  // Basic-block translation state
+  ExecMode exec_mode_   = ExecMode::Step;
+  uint32_t block_budget_ = 1024;
+  std::unordered_map<uint32_t, std::unique_ptr<TranslatedBlock>> blocks_;
+  uint32_t block_code_lo_ = UINT32_MAX; // [lo, hi) covers every translated op (cheap write filter)
+  uint32_t block_code_hi_ = 0;
+  bool     blocks_stale_  = false;      // a write hit translated code; flush before next lookup
+  uint64_t blocks_translated_ = 0;
+  uint64_t block_chain_hits_  = 0;
+  uint64_t block_flushes_     = 0;
+
   // Simple micro-architectural counters
   uint64_t inst_count_         = 0;
   uint64_t arith_count_        = 0;
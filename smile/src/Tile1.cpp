@@ -8,17 +8,26 @@ How the tile processes instructions and talks to memory.
 #include "Tile1.hpp"
 #include "Tile1_exec.hpp"
 #include "AccelPort.hpp"
+#include <algorithm>
 #include <cstdint>
 
-Tile1::Tile1(std::string /*name*/, IMPL_CTOR) {
+Tile1::Tile1(std::string /*name*/, IMPL_CTOR) : decode_cache_(kDecodeCacheEntries) {
   regs_.fill(0);
   priv_mode_ = PrivMode::Machine;
   reset_trap_csrs();
 }
+
+Tile1::~Tile1() {
+  if (mem_port_) mem_port_->remove_write_observer(&decode_invalidator_); // port must not call back into a dead tile
+}
 // Connects external memory to tile
 void Tile1::attach_memory(smem::MemoryPort* mem) {
+  if (mem_port_) mem_port_->remove_write_observer(&decode_invalidator_); // re-attaching: stop watching the old port
   mem_port_ = mem; // tile stores pointer (mem_port_) to memory port to fetch instr and read/write data
-}                  // will allow us to access a memory port class's methods for mem read/write
+                   // will allow us to access a memory port class's methods for mem read/write
+  if (mem_port_) mem_port_->add_write_observer(&decode_invalidator_); // writes through the port invalidate decoded entries
+  flush_decode_cache();
+}
 
 // Tile's execution sequence, fetch/decode/etc.
 void Tile1::tick() {
@@ -78,17 +87,23 @@ void Tile1::tick() {
     regs_[0] = 0;
     return;
   }
+  if (exec_mode_ == ExecMode::Block) { // fast functional mode: run translated blocks…
+    assert_always(mem_model_ == MemModel::Ideal, "Block exec mode requires the ideal memory model");
+    if (run_blocks()) return;          // …then step anything they can't hold (SYSTEM/CSR/CUSTOM-0)
+  }
 
   // ******************
   // 1. FETCH
   // ******************
   const uint32_t curr_pc = pc_;
   uint32_t instr = 0;
+  const DecodedOp* cached = nullptr; // decoded-cache entry for curr_pc (if any)
   if (mem_model_ == MemModel::Ideal) { // ideal mem…
     // Ideal mem is a functional sanity mode: synchronous read32/write32, no stalls.
     ifetch_wait_ = false;
     ifetch_valid_ = false;
-    instr = mem_port_->read32(curr_pc);
+    cached = cached_op(curr_pc);       // a valid entry already holds the word (writes invalidate it)
+    instr = cached ? cached->instr.raw : mem_port_->read32(curr_pc);
   } else {                             // …or timed mem (default), sims realistic mem latency with req/resp and stalling
     // Timed mem is the cycle-accurate mode using request/resp.
     // If no buffered instruction is available, request one from memory.
@@ -102,6 +117,8 @@ void Tile1::tick() {
     }
     instr = ifetch_word_;
     ifetch_valid_ = false;
+    cached = cached_op(curr_pc);       // fetch timing is unchanged, only decode is skipped on a hit
+    if (cached && cached->instr.raw != instr) cached = nullptr;
   }
   last_pc_    = curr_pc;
   last_instr_ = instr;
@@ -111,215 +128,43 @@ void Tile1::tick() {
 
   // ******************
   // 2. DECODE
-  // ******************  
-  Instruction decoded(instr); // construct a new Instruction object called decoded by passing in instr
+  // ******************
+  if (cached) {
+    decode_cache_hits_++;
+  } else if (decode_cache_on_) {
+    decode_cache_misses_++;
+  }
+  const DecodedOp& dispatch = cached ? *cached : fill_op(curr_pc, instr); // decode once per PC, then reuse
+  const Instruction& decoded = dispatch.instr;
 
   // ******************
   // 3. EXECUTE
   // ******************
   inst_count_++;
-  switch (decoded.category) { // determine what kind of instruction you're dealing with
-    // ALU
-    case Instruction::Category::ALU:
-      arith_count_++; // increment arithmetic (ALU category) count
-      if (decoded.type == Instruction::Type::I) {
-        if (decoded.opcode == 0x13) {
-          if (decoded.funct3 == 0x1) {
-            exec_slli(*this, decoded);
-          } else if (decoded.funct3 == 0x2) {
-            exec_slti(*this, decoded);
-          } else if (decoded.funct3 == 0x3) {
-            exec_sltiu(*this, decoded);
-          } else if (decoded.funct3 == 0x4) {
-            exec_xori(*this, decoded);
-          } else if (decoded.funct3 == 0x6) {
-            exec_ori(*this, decoded);
-          } else if (decoded.funct3 == 0x7) {
-            exec_andi(*this, decoded);
-          } else if (decoded.funct3 == 0x5) {
-            if (decoded.funct7 == 0x00) {
-              exec_srli(*this, decoded);
-            } else if (decoded.funct7 == 0x20) {
-              exec_srai(*this, decoded);
-            } else {
-              exec_addi(*this, decoded);
-            }
-          } else {
-            exec_addi(*this, decoded);
-          }
-        } else {
-          exec_addi(*this, decoded);
-        }
-      } else if (decoded.type == Instruction::Type::R) {
-        if (decoded.opcode == 0x33) {
-          switch (decoded.funct3) {
-            case 0x0:
-              if (decoded.funct7 == 0x00) {
-                add_count_++;
-                exec_add(*this, decoded);
-              } else if (decoded.funct7 == 0x20) {
-                add_count_++; // count subs as adds
-                exec_sub(*this, decoded);
-              } else if (decoded.funct7 == 0x01) {
-                mul_count_++;
-                exec_mul(*this, decoded);
-              } else {
-                exec_add(*this, decoded);
-              }
-              break;
-            case 0x1:
-              if (decoded.funct7 == 0x00) {
-                exec_sll(*this, decoded);
-              } else if (decoded.funct7 == 0x01) {
-                exec_mulh(*this, decoded);
-              } else {
-                exec_add(*this, decoded);
-              }
-              break;
-            case 0x2:
-              if (decoded.funct7 == 0x00) {
-                exec_slt(*this, decoded);
-              } else if (decoded.funct7 == 0x01) {
-                exec_mulhsu(*this, decoded);
-              } else {
-                exec_add(*this, decoded);
-              }
-              break;
-            case 0x3:
-              if (decoded.funct7 == 0x00) {
-                exec_sltu(*this, decoded);
-              } else if (decoded.funct7 == 0x01) {
-                exec_mulhu(*this, decoded);
-              } else {
-                exec_add(*this, decoded);
-              }
-              break;
-            case 0x4:
-              if (decoded.funct7 == 0x00) {
-                exec_xor(*this, decoded);
-              } else if (decoded.funct7 == 0x01) {
-                exec_div(*this, decoded);
-              } else {
-                exec_add(*this, decoded);
-              }
-              break;
-            case 0x5:
-              if (decoded.funct7 == 0x00) {
-                exec_srl(*this, decoded);
-              } else if (decoded.funct7 == 0x20) {
-                exec_sra(*this, decoded);
-              } else if (decoded.funct7 == 0x01) {
-                exec_divu(*this, decoded);
-              } else {
-                exec_add(*this, decoded);
-              }
-              break;
-            case 0x6:
-              if (decoded.funct7 == 0x00) {
-                exec_or(*this, decoded);
-              } else if (decoded.funct7 == 0x01) {
-                exec_rem(*this, decoded);
-              } else {
-                exec_add(*this, decoded);
-              }
-              break;
-            case 0x7:
-              if (decoded.funct7 == 0x00) {
-                exec_and(*this, decoded);
-              } else if (decoded.funct7 == 0x01) {
-                exec_remu(*this, decoded);
-              } else {
-                exec_add(*this, decoded);
-              }
-              break;
-            default:
-              exec_add(*this, decoded);
-              break;
-          }
-        } else if (decoded.opcode == 0x3b) {
-          if (decoded.funct3 == 0x0 && decoded.funct7 == 0x01) {
-            exec_mulw(*this, decoded);
-          } else {
-            exec_add(*this, decoded);
-          }
-        } else {
-          exec_add(*this, decoded);
-        }
-      } else if (decoded.type == Instruction::Type::U) {
-        if (decoded.opcode == 0x37) {
-          exec_lui(*this, decoded);
-        } else if (decoded.opcode == 0x17) {
-          exec_auipc(*this, decoded, curr_pc);
-        }
-      }
+  if (dispatch.count_arith) arith_count_++; // increment arithmetic (ALU category) count
+  if (dispatch.count_add)   add_count_++;   // count subs as adds
+  if (dispatch.count_mul)   mul_count_++;
+  switch (dispatch.kind) { // handler was resolved at decode time (see resolve_op)
+    case OpKind::Exec:
+      dispatch.exec(*this, decoded);
       break;
-    // SYSTEM
-    case Instruction::Category::SYSTEM:
-      if (decoded.type == Instruction::Type::I) {
-        if (decoded.opcode == 0x73) {
-          switch (decoded.i.imm) {
-            case 0x000: exec_ecall(*this, decoded); break;
-            case 0x001: exec_ebreak(*this, decoded); break;
-            case 0x002: exec_uret(*this, decoded); break;
-            case 0x102: exec_sret(*this, decoded); break;
-            case 0x302: exec_mret(*this, decoded); break;
-            default: break;
-          }
-          advance_pc = false;
-        } else if (decoded.opcode == 0x0f) {
-          if (decoded.funct3 == 0x0) {
-            exec_fence(*this, decoded);
-          } else if (decoded.funct3 == 0x1) {
-            exec_fence_i(*this, decoded);
-          }
-        }
-      }
+    case OpKind::ExecPc:
+      dispatch.exec_pc(*this, decoded, curr_pc);
+      break;
+    case OpKind::System:
+      if (dispatch.exec) dispatch.exec(*this, decoded);
+      advance_pc = false;
       break;
     // MEMORY
-    case Instruction::Category::LOAD:
-      if (decoded.type == Instruction::Type::I) {
+    case OpKind::Load:
+      {
         load_count_++;
         const auto& op = decoded.i;
         const int32_t base = static_cast<int32_t>(read_reg(op.rs1));
         const uint32_t addr = static_cast<uint32_t>(base + op.imm);
         // Ideal mem is a functional sanity mode: synchronous read32/write32, no stalls.
         if (mem_model_ == MemModel::Ideal) { // if ideal mem…
-          const uint32_t word = mem_port_->read32(addr & ~0x3u);
-          uint32_t value = 0;
-          switch (decoded.funct3) {
-            case 0x0: {
-              const uint32_t shift = (addr & 0x3u) * 8u;
-              const int8_t byte = static_cast<int8_t>((word >> shift) & 0xffu);
-              value = static_cast<uint32_t>(byte);
-              break;
-            }
-            case 0x1: {
-              assert_always((addr & 0x1u) == 0u, "LH requires 2-byte alignment");
-              const uint32_t shift = (addr & 0x2u) * 8u;
-              const int16_t half = static_cast<int16_t>((word >> shift) & 0xffffu);
-              value = static_cast<uint32_t>(half);
-              break;
-            }
-            case 0x2:
-              assert_always((addr & 0x3u) == 0u, "LW requires 4-byte alignment");
-              value = word;
-              break;
-            case 0x4: {
-              const uint32_t shift = (addr & 0x3u) * 8u;
-              value = (word >> shift) & 0xffu;
-              break;
-            }
-            case 0x5: {
-              assert_always((addr & 0x1u) == 0u, "LHU requires 2-byte alignment");
-              const uint32_t shift = (addr & 0x2u) * 8u;
-              value = (word >> shift) & 0xffffu;
-              break;
-            }
-            default:
-              assert_always(false, "Unsupported load funct3 in ideal data path");
-              break;
-          }
-          if (op.rd != 0) write_reg(op.rd, value);
+          load_ideal(decoded, addr);
         } else {                             // …or timed mem (default), sims realistic mem latency with req/resp and stalling
           // Timed mem is the cycle-accurate mode using request/resp.
           DmemOp dmem_op = DmemOp::None;
@@ -357,8 +202,8 @@ void Tile1::tick() {
         }
       }
       break;
-    case Instruction::Category::STORE:
-      if (decoded.type == Instruction::Type::S) {
+    case OpKind::Store:
+      {
         store_count_++;
         const auto& op = decoded.s;
         const int32_t base = static_cast<int32_t>(read_reg(op.rs1));
@@ -367,32 +212,7 @@ void Tile1::tick() {
         const uint32_t aligned = addr & ~0x3u;
         // Ideal mem is a functional sanity mode: synchronous read32/write32, no stalls.
         if (mem_model_ == MemModel::Ideal) { // if ideal mem…
-          switch (decoded.funct3) {
-            case 0x0: {
-              const uint32_t shift = (addr & 0x3u) * 8u;
-              const uint32_t mask = 0xffu << shift;
-              const uint32_t prior = mem_port_->read32(aligned);
-              const uint32_t merged = (prior & ~mask) | ((data << shift) & mask);
-              mem_port_->write32(aligned, merged);
-              break;
-            }
-            case 0x1: {
-              assert_always((addr & 0x1u) == 0u, "SH requires 2-byte alignment");
-              const uint32_t shift = (addr & 0x2u) * 8u;
-              const uint32_t mask = 0xffffu << shift;
-              const uint32_t prior = mem_port_->read32(aligned);
-              const uint32_t merged = (prior & ~mask) | ((data << shift) & mask);
-              mem_port_->write32(aligned, merged);
-              break;
-            }
-            case 0x2:
-              assert_always((addr & 0x3u) == 0u, "SW requires 4-byte alignment");
-              mem_port_->write32(aligned, data);
-              break;
-            default:
-              assert_always(false, "Unsupported store funct3 in ideal data path");
-              break;
-          }
+          store_ideal(decoded, addr, data);
         } else {                             // …or timed mem (default), sims realistic mem latency with req/resp and stalling
           // Timed mem is the cycle-accurate mode using request/resp.
           if (!mem_port_->can_request()) return;
@@ -440,59 +260,21 @@ void Tile1::tick() {
       }
       break;
     // JUMP
-    case Instruction::Category::JUMP:
-      if (decoded.type == Instruction::Type::J) {
-        next_pc = exec_jal(*this, decoded, curr_pc);
-      } else if (decoded.type == Instruction::Type::I) {
-        next_pc = exec_jalr(*this, decoded, curr_pc);
-      }
-      break;
-    // CSR
-    case Instruction::Category::CSR:
-      if (decoded.type == Instruction::Type::CSR) {
-        switch (decoded.funct3) {
-          case 0x1: exec_csrrw(*this, decoded); break;
-          case 0x2: exec_csrrs(*this, decoded); break;
-          case 0x3: exec_csrrc(*this, decoded); break;
-          default: break;
-        }
-      }
-      break;
-    case Instruction::Category::CSR_IMM:
-      if (decoded.type == Instruction::Type::CSR) {
-        switch (decoded.funct3) {
-          case 0x5: exec_csrrwi(*this, decoded); break;
-          case 0x6: exec_csrrsi(*this, decoded); break;
-          case 0x7: exec_csrrci(*this, decoded); break;
-          default: break;
-        }
-      }
+    case OpKind::Jump:
+      next_pc = dispatch.jump(*this, decoded, curr_pc);
       break;
     // BRANCH
-    case Instruction::Category::BRANCH:
-      if (decoded.type == Instruction::Type::B) {
-        branch_count_++;
-        bool taken = false;
-        switch (decoded.funct3) {
-          case 0x0: taken = exec_beq(*this, decoded); break; // BEQ
-          case 0x1: taken = exec_bne(*this, decoded); break; // BNE
-          case 0x4: taken = exec_blt(*this, decoded); break; // BLT
-          case 0x5: taken = exec_bge(*this, decoded); break; // BGE
-          case 0x6: taken = exec_bltu(*this, decoded); break; // BLTU
-          case 0x7: taken = exec_bgeu(*this, decoded); break; // BGEU
-          default: break;
-        }
-        if (taken) {
-          branch_taken_count_++;
-          const int32_t offset = decoded.b.imm;
-          next_pc = static_cast<uint32_t>(static_cast<int32_t>(curr_pc) + offset);
-        }
+    case OpKind::Branch: {
+      branch_count_++;
+      const bool taken = dispatch.branch ? dispatch.branch(*this, decoded) : false;
+      if (taken) {
+        branch_taken_count_++;
+        const int32_t offset = decoded.b.imm;
+        next_pc = static_cast<uint32_t>(static_cast<int32_t>(curr_pc) + offset);
       }
       break;
-    // CUSTOM
-    case Instruction::Category::CUSTOM:
-      exec_custom0(*this, decoded); // execute custom instr (Tile1_exec.cpp)
-      break;
+    }
+    case OpKind::None:
     default:
       break;
   }
@@ -551,6 +333,14 @@ void Tile1::reset() {
   store_count_         = 0;
   branch_count_        = 0;
   branch_taken_count_  = 0;
+  decode_cache_hits_   = 0;
+  decode_cache_misses_ = 0;
+  decode_cache_invals_ = 0;
+  flush_decode_cache();
+  flush_blocks();
+  blocks_translated_   = 0;
+  block_chain_hits_    = 0;
+  block_flushes_       = 0;
   trap_pending_        = false;
   pc_override_pending_ = false;
   priv_mode_           = PrivMode::Machine; // init priv_mode_ to M
@@ -558,6 +348,402 @@ void Tile1::reset() {
   csrs_.clear();
 }
 
+// Ideal-memory data path (synchronous read32/write32, no stalls), shared by tick() and block mode.
+void Tile1::load_ideal(const Instruction& instr, uint32_t addr) {
+  const uint32_t word = mem_port_->read32(addr & ~0x3u);
+  uint32_t value = 0;
+  switch (instr.funct3) {
+    case 0x0: {
+      const uint32_t shift = (addr & 0x3u) * 8u;
+      const int8_t byte = static_cast<int8_t>((word >> shift) & 0xffu);
+      value = static_cast<uint32_t>(byte);
+      break;
+    }
+    case 0x1: {
+      assert_always((addr & 0x1u) == 0u, "LH requires 2-byte alignment");
+      const uint32_t shift = (addr & 0x2u) * 8u;
+      const int16_t half = static_cast<int16_t>((word >> shift) & 0xffffu);
+      value = static_cast<uint32_t>(half);
+      break;
+    }
+    case 0x2:
+      assert_always((addr & 0x3u) == 0u, "LW requires 4-byte alignment");
+      value = word;
+      break;
+    case 0x4: {
+      const uint32_t shift = (addr & 0x3u) * 8u;
+      value = (word >> shift) & 0xffu;
+      break;
+    }
+    case 0x5: {
+      assert_always((addr & 0x1u) == 0u, "LHU requires 2-byte alignment");
+      const uint32_t shift = (addr & 0x2u) * 8u;
+      value = (word >> shift) & 0xffffu;
+      break;
+    }
+    default:
+      assert_always(false, "Unsupported load funct3 in ideal data path");
+      break;
+  }
+  if (instr.i.rd != 0) write_reg(instr.i.rd, value);
+}
+
+void Tile1::store_ideal(const Instruction& instr, uint32_t addr, uint32_t data) {
+  const uint32_t aligned = addr & ~0x3u;
+  switch (instr.funct3) {
+    case 0x0: {
+      const uint32_t shift = (addr & 0x3u) * 8u;
+      const uint32_t mask = 0xffu << shift;
+      const uint32_t prior = mem_port_->read32(aligned);
+      const uint32_t merged = (prior & ~mask) | ((data << shift) & mask);
+      mem_port_->write32(aligned, merged);
+      break;
+    }
+    case 0x1: {
+      assert_always((addr & 0x1u) == 0u, "SH requires 2-byte alignment");
+      const uint32_t shift = (addr & 0x2u) * 8u;
+      const uint32_t mask = 0xffffu << shift;
+      const uint32_t prior = mem_port_->read32(aligned);
+      const uint32_t merged = (prior & ~mask) | ((data << shift) & mask);
+      mem_port_->write32(aligned, merged);
+      break;
+    }
+    case 0x2:
+      assert_always((addr & 0x3u) == 0u, "SW requires 4-byte alignment");
+      mem_port_->write32(aligned, data);
+      break;
+    default:
+      assert_always(false, "Unsupported store funct3 in ideal data path");
+      break;
+  }
+}
+
+// Walks the decode tree once for a raw instruction word and records which exec_* helper
+// (and which counters) tick() should use.  Mirrors the RV32IM + CUSTOM-0 dispatch.
+Tile1::DecodedOp Tile1::resolve_op(uint32_t instr) {
+  DecodedOp op;
+  op.instr = Instruction(instr);
+  const Instruction& d = op.instr;
+  auto use = [&op](ExecFn fn) { op.kind = OpKind::Exec; op.exec = fn; };
+  switch (d.category) {
+    // ALU
+    case Instruction::Category::ALU:
+      op.count_arith = true;
+      if (d.type == Instruction::Type::I) {
+        if (d.opcode == 0x13) {
+          switch (d.funct3) {
+            case 0x1: use(exec_slli); break;
+            case 0x2: use(exec_slti); break;
+            case 0x3: use(exec_sltiu); break;
+            case 0x4: use(exec_xori); break;
+            case 0x6: use(exec_ori); break;
+            case 0x7: use(exec_andi); break;
+            case 0x5:
+              if (d.funct7 == 0x00)      use(exec_srli);
+              else if (d.funct7 == 0x20) use(exec_srai);
+              else                       use(exec_addi);
+              break;
+            default: use(exec_addi); break;
+          }
+        } else {
+          use(exec_addi);
+        }
+      } else if (d.type == Instruction::Type::R) {
+        use(exec_add); // fallback for unrecognized funct3/funct7 combos
+        if (d.opcode == 0x33) {
+          const bool base = (d.funct7 == 0x00);
+          const bool mext = (d.funct7 == 0x01);
+          switch (d.funct3) {
+            case 0x0:
+              if (base)                  { use(exec_add); op.count_add = true; }
+              else if (d.funct7 == 0x20) { use(exec_sub); op.count_add = true; } // count subs as adds
+              else if (mext)             { use(exec_mul); op.count_mul = true; }
+              break;
+            case 0x1: if (base) use(exec_sll);  else if (mext) use(exec_mulh);   break;
+            case 0x2: if (base) use(exec_slt);  else if (mext) use(exec_mulhsu); break;
+            case 0x3: if (base) use(exec_sltu); else if (mext) use(exec_mulhu);  break;
+            case 0x4: if (base) use(exec_xor);  else if (mext) use(exec_div);    break;
+            case 0x5:
+              if (base)                  use(exec_srl);
+              else if (d.funct7 == 0x20) use(exec_sra);
+              else if (mext)             use(exec_divu);
+              break;
+            case 0x6: if (base) use(exec_or);   else if (mext) use(exec_rem);    break;
+            case 0x7: if (base) use(exec_and);  else if (mext) use(exec_remu);   break;
+            default: break;
+          }
+        } else if (d.opcode == 0x3b) {
+          if (d.funct3 == 0x0 && d.funct7 == 0x01) use(exec_mulw);
+        }
+      } else if (d.type == Instruction::Type::U) {
+        if (d.opcode == 0x37) {
+          use(exec_lui);
+        } else if (d.opcode == 0x17) {
+          op.kind = OpKind::ExecPc;
+          op.exec_pc = exec_auipc;
+        }
+      }
+      break;
+    // SYSTEM
+    case Instruction::Category::SYSTEM:
+      if (d.type == Instruction::Type::I) {
+        if (d.opcode == 0x73) {
+          op.kind = OpKind::System; // PC held, trap/exit logic decides where to go
+          switch (d.i.imm) {
+            case 0x000: op.exec = exec_ecall; break;
+            case 0x001: op.exec = exec_ebreak; break;
+            case 0x002: op.exec = exec_uret; break;
+            case 0x102: op.exec = exec_sret; break;
+            case 0x302: op.exec = exec_mret; break;
+            default: break;
+          }
+        } else if (d.opcode == 0x0f) {
+          if (d.funct3 == 0x0) {
+            use(exec_fence);
+          } else if (d.funct3 == 0x1) {
+            use(exec_fence_i);
+          }
+        }
+      }
+      break;
+    // MEMORY
+    case Instruction::Category::LOAD:
+      if (d.type == Instruction::Type::I) op.kind = OpKind::Load;
+      break;
+    case Instruction::Category::STORE:
+      if (d.type == Instruction::Type::S) op.kind = OpKind::Store;
+      break;
+    // JUMP
+    case Instruction::Category::JUMP:
+      if (d.type == Instruction::Type::J) {
+        op.kind = OpKind::Jump;
+        op.jump = exec_jal;
+      } else if (d.type == Instruction::Type::I) {
+        op.kind = OpKind::Jump;
+        op.jump = exec_jalr;
+      }
+      break;
+    // CSR
+    case Instruction::Category::CSR:
+      if (d.type == Instruction::Type::CSR) {
+        switch (d.funct3) {
+          case 0x1: use(exec_csrrw); break;
+          case 0x2: use(exec_csrrs); break;
+          case 0x3: use(exec_csrrc); break;
+          default: break;
+        }
+      }
+      break;
+    case Instruction::Category::CSR_IMM:
+      if (d.type == Instruction::Type::CSR) {
+        switch (d.funct3) {
+          case 0x5: use(exec_csrrwi); break;
+          case 0x6: use(exec_csrrsi); break;
+          case 0x7: use(exec_csrrci); break;
+          default: break;
+        }
+      }
+      break;
+    // BRANCH
+    case Instruction::Category::BRANCH:
+      if (d.type == Instruction::Type::B) {
+        op.kind = OpKind::Branch; // counted even when funct3 is not a real branch
+        switch (d.funct3) {
+          case 0x0: op.branch = exec_beq; break;  // BEQ
+          case 0x1: op.branch = exec_bne; break;  // BNE
+          case 0x4: op.branch = exec_blt; break;  // BLT
+          case 0x5: op.branch = exec_bge; break;  // BGE
+          case 0x6: op.branch = exec_bltu; break; // BLTU
+          case 0x7: op.branch = exec_bgeu; break; // BGEU
+          default: break;
+        }
+      }
+      break;
+    // CUSTOM
+    case Instruction::Category::CUSTOM:
+      use(exec_custom0); // execute custom instr (Tile1_exec.cpp)
+      break;
+    default:
+      break;
+  }
+  return op;
+}
+
+// Decoded-instruction cache: direct-mapped on the word index of the PC.
+const Tile1::DecodedOp* Tile1::cached_op(uint32_t pc) const {
+  if (!decode_cache_on_) return nullptr;
+  const DecodeCacheEntry& e = decode_cache_[(pc >> 2) & (kDecodeCacheEntries - 1)];
+  return (e.valid && e.pc == pc) ? &e.op : nullptr;
+}
+
+const Tile1::DecodedOp& Tile1::fill_op(uint32_t pc, uint32_t instr) {
+  if (!decode_cache_on_) {
+    decode_scratch_ = resolve_op(instr);
+    return decode_scratch_;
+  }
+  DecodeCacheEntry& e = decode_cache_[(pc >> 2) & (kDecodeCacheEntries - 1)];
+  e.op    = resolve_op(instr);
+  e.pc    = pc;
+  e.valid = true;
+  return e.op;
+}
+
+// Called (via DecodeCacheInvalidator) whenever the attached MemoryPort commits a write32.
+void Tile1::invalidate_decoded(uint32_t addr) {
+  const uint32_t word = addr & ~0x3u;
+  DecodeCacheEntry& e = decode_cache_[(word >> 2) & (kDecodeCacheEntries - 1)];
+  if (e.valid && e.pc == word) {
+    e.valid = false;
+    decode_cache_invals_++;
+  }
+  if (!blocks_stale_ && word >= block_code_lo_ && word < block_code_hi_) {
+    for (const auto& kv : blocks_) {
+      if (word >= kv.second->start_pc && word < kv.second->end_pc) {
+        blocks_stale_ = true; // drop all blocks (chain links included) before the next lookup
+        break;
+      }
+    }
+  }
+}
+
+void Tile1::flush_decode_cache() {
+  for (auto& e : decode_cache_) e.valid = false;
+  if (!blocks_.empty()) blocks_stale_ = true;
+}
+
+void Tile1::set_decode_cache(bool on) {
+  decode_cache_on_ = on;
+  flush_decode_cache();
+}
+
+// ******************
+// Basic-block translation (ExecMode::Block)
+// ******************
+void Tile1::set_exec_mode(ExecMode m) {
+  exec_mode_ = m;
+  flush_blocks();
+}
+
+bool Tile1::needs_step(const DecodedOp& op) {
+  const Instruction::Category cat = op.instr.category;
+  return op.kind == OpKind::System ||                   // ECALL/EBREAK/xRET: traps, exits, PC overrides
+         cat == Instruction::Category::CSR ||
+         cat == Instruction::Category::CSR_IMM ||
+         cat == Instruction::Category::CUSTOM ||        // accelerator issue/wait
+         op.exec == exec_fence_i;                       // flushes translated code
+}
+
+void Tile1::flush_blocks() {
+  if (!blocks_.empty()) block_flushes_++;
+  blocks_.clear();
+  block_code_lo_ = UINT32_MAX;
+  block_code_hi_ = 0;
+  blocks_stale_  = false;
+}
+
+// Translate a straight-line run starting at pc (through the ideal read32 path).
+Tile1::TranslatedBlock* Tile1::find_block(uint32_t pc) {
+  if (blocks_stale_) flush_blocks();
+  auto it = blocks_.find(pc);
+  if (it != blocks_.end()) return it->second.get();
+
+  auto blk = std::make_unique<TranslatedBlock>();
+  blk->start_pc = pc;
+  uint32_t at = pc;
+  while (blk->ops.size() < kMaxBlockOps) {
+    DecodedOp op = resolve_op(mem_port_->read32(at));
+    if (needs_step(op)) break;           // leave it for tick()'s per-instruction path
+    const bool terminator = (op.kind == OpKind::Branch || op.kind == OpKind::Jump);
+    blk->ops.push_back(op);
+    at += 4u;
+    if (terminator) break;
+  }
+  blk->end_pc = at;
+  if (!blk->ops.empty()) {
+    block_code_lo_ = std::min(block_code_lo_, blk->start_pc);
+    block_code_hi_ = std::max(block_code_hi_, blk->end_pc);
+  }
+  blocks_translated_++;
+  TranslatedBlock* raw = blk.get();
+  blocks_.emplace(pc, std::move(blk));
+  return raw;
+}
+
+// Retire translated blocks back to back (following chain links) until the budget is used up
+// or the next pc starts with an op that needs the step path.  Counters are bumped per op
+// exactly as tick() would.  Returns false when the caller should step the instr at pc_.
+bool Tile1::run_blocks() {
+  uint32_t retired = 0;
+  TranslatedBlock* blk = find_block(pc_);
+  while (!blk->ops.empty()) {
+    uint32_t pc      = blk->start_pc;
+    uint32_t next_pc = blk->end_pc;
+    int      succ    = 0;                // which chain slot leads to next_pc
+    for (const DecodedOp& op : blk->ops) {
+      const Instruction& d = op.instr;
+      last_pc_    = pc;
+      last_instr_ = d.raw;
+      trace("pc=0x%08x instr=0x%08x\n", pc, d.raw);
+      inst_count_++;
+      if (op.count_arith) arith_count_++;
+      if (op.count_add)   add_count_++;
+      if (op.count_mul)   mul_count_++;
+      switch (op.kind) {
+        case OpKind::Exec:
+          op.exec(*this, d);
+          break;
+        case OpKind::ExecPc:
+          op.exec_pc(*this, d, pc);
+          break;
+        case OpKind::Load:
+          load_count_++;
+          load_ideal(d, static_cast<uint32_t>(static_cast<int32_t>(read_reg(d.i.rs1)) + d.i.imm));
+          break;
+        case OpKind::Store:
+          store_count_++;
+          store_ideal(d, static_cast<uint32_t>(static_cast<int32_t>(read_reg(d.s.rs1)) + d.s.imm), read_reg(d.s.rs2));
+          break;
+        case OpKind::Jump:
+          next_pc = op.jump(*this, d, pc);
+          succ = 1;
+          break;
+        case OpKind::Branch:
+          branch_count_++;
+          if (op.branch && op.branch(*this, d)) {
+            branch_taken_count_++;
+            next_pc = static_cast<uint32_t>(static_cast<int32_t>(pc) + d.b.imm);
+            succ = 1;
+          }
+          break;
+        default:
+          break;
+      }
+      pc += 4u;
+      retired++;
+      if (blocks_stale_) {               // a store rewrote translated code: leave right after it
+        next_pc = pc;
+        break;
+      }
+    }
+    regs_[0] = 0;
+    pc_ = next_pc;
+    if (halted_ || retired >= block_budget_) return true;
+    if (blocks_stale_) {
+      blk = find_block(pc_);             // flushes, then retranslates from the new code
+      continue;
+    }
+    TranslatedBlock* chained = blk->next[succ];
+    if (chained && chained->start_pc == next_pc) {
+      block_chain_hits_++;
+    } else {
+      chained = find_block(next_pc);
+      blk->next[succ] = chained;         // JALR slots just remember the last target
+    }
+    blk = chained;
+  }
+  return false;                          // head of blk needs the step path
+}
+
 // Helper for completing a data memory access after a stall: 
 // updates RF for loads, clears dmem-related fields, and applies next PC
 void Tile1::complete_dmem(uint32_t resp_data) {
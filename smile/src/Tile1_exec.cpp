@@ -325,8 +325,9 @@ void exec_fence(Tile1& /*tile*/, const Instruction& /*instr*/) {
   // No-op in this single-core, in-order Tile1 model.
 }
 
-void exec_fence_i(Tile1& /*tile*/, const Instruction& /*instr*/) {
-  // No-op in this single-core, in-order Tile1 model.
+void exec_fence_i(Tile1& tile, const Instruction& /*instr*/) {
+  // Writes already invalidate decoded entries; FENCE.I just drops the whole decoded cache.
+  tile.flush_decode_cache();
 }
 
 // M extension
@@ -41,8 +41,11 @@ IntParameter(start_pc, 0x0, "Initial PC (set core's PC before run)");
 IntParameter(mem_latency, 0, "Fixed memory latency (cycles) for MemCtrlTimedPort");
 BoolParameter(ideal_mem, false, "Use ideal memory model in Tile1 (sync read32/write32, no stalls)");
 StringParameter(mem_model, "timed", "Tile1 memory model: timed|ideal");
+BoolParameter(decode_cache, true, "Use Tile1's PC-indexed decoded-instruction cache");
+StringParameter(exec_mode, "step", "Tile1 execution engine: step|block (block = translated basic blocks, implies ideal mem)");
+IntParameter(block_budget, 1024, "Max instructions one cycle may retire in -exec_mode=block");
 StringParameter(accel, "array_sum", "Accelerator: none|demo_add|array_sum|array_sum_mc");
-StringParameter(suite, "proto_accel_sum", "Built-in suite when -prog is empty: proto_accel_sum|proto_accel_sum_altaddr|proto_accel_sum_badarg|proto_accel_sum_unsupported|proto_accel_sum_twice");
+StringParameter(suite, "proto_accel_sum", "Built-in suite when -prog is empty: proto_accel_sum|proto_accel_sum_altaddr|proto_accel_sum_badarg|proto_accel_sum_unsupported|proto_accel_sum_twice|smc");
 BoolParameter(selfcheck, false, "Run regression matrix (accel/suite/mem_latency) and exit");
 IntParameter(steps, 0, "Cycles to auto-run; <=0 enters interactive debugger");
 IntParameter(sw_threads, 1, "Software thread contexts to schedule (1 or 2). Default: 1");
@@ -64,6 +67,34 @@ static std::string to_lower_copy(const std::string& s) {
   return out;
 }
 
+static void print_decode_cache_stats(const Tile1& tile) {
+  if (!tile.decode_cache_enabled()) return;
+  printf("[DCACHE] hits=%llu misses=%llu invals=%llu\n",
+         (unsigned long long)tile.decode_cache_hits(),
+         (unsigned long long)tile.decode_cache_misses(),
+         (unsigned long long)tile.decode_cache_invalidations());
+}
+
+static void print_block_stats(const Tile1& tile) {
+  if (tile.exec_mode() != Tile1::ExecMode::Block) return;
+  printf("[BLOCKS] translated=%llu chained=%llu flushes=%llu\n",
+         (unsigned long long)tile.blocks_translated(),
+         (unsigned long long)tile.block_chain_hits(),
+         (unsigned long long)tile.block_flushes());
+}
+
+// Block mode is a functional engine on top of the ideal data path.
+static bool apply_exec_mode_flag(Tile1& tile, const std::string& exec_mode_flag) {
+  if (exec_mode_flag == "block") {
+    tile.set_mem_model(Tile1::MemModel::Ideal);
+    tile.set_exec_mode(Tile1::ExecMode::Block);
+    tile.set_block_budget(static_cast<uint32_t>(static_cast<int>(block_budget) > 0 ? static_cast<int>(block_budget) : 1));
+    return true;
+  }
+  tile.set_exec_mode(Tile1::ExecMode::Step);
+  return exec_mode_flag == "step";
+}
+
 static std::unique_ptr<AccelPort> make_accel_for_flag(const std::string& accel_flag_in,
                                                        smem::MemoryPort& mem,
                                                        std::string& err) {
@@ -96,6 +127,16 @@ static bool inject_suite_program(smem::DramMemoryPort& dram_port,
     const uint32_t imm_hi = ((imm >> 5) & 0x7fu) << 25;
     return imm_hi | ((rs2 & 0x1fu) << 20) | ((rs1 & 0x1fu) << 15) | (0x2u << 12) | imm_lo | 0x23u;
   };
+  auto encode_lw = [](uint32_t rd, uint32_t rs1, int32_t imm12) -> uint32_t {
+    const uint32_t imm = static_cast<uint32_t>(imm12) & 0xfffu;
+    return (imm << 20) | ((rs1 & 0x1fu) << 15) | (0x2u << 12) | ((rd & 0x1fu) << 7) | 0x03u;
+  };
+  auto encode_bne = [](uint32_t rs1, uint32_t rs2, int32_t imm13) -> uint32_t {
+    const uint32_t imm = static_cast<uint32_t>(imm13) & 0x1fffu;
+    return (((imm >> 12) & 0x1u) << 31) | (((imm >> 5) & 0x3fu) << 25) |
+           ((rs2 & 0x1fu) << 20) | ((rs1 & 0x1fu) << 15) | (0x1u << 12) |
+           (((imm >> 1) & 0xfu) << 8) | (((imm >> 11) & 0x1u) << 7) | 0x63u;
+  };
   auto encode_ecall = []() -> uint32_t {
     return 0x00000073u;
   };
@@ -123,6 +164,7 @@ static bool inject_suite_program(smem::DramMemoryPort& dram_port,
   uint32_t init_base = array_addr;
   uint32_t len_words = 4u;
   uint32_t funct3 = 0u;
+  bool smc = false;
 
   if (suite_meta.name == "proto_accel_sum") {
     // preserved default behavior: base=0x100, len=4, expect sum=10
@@ -144,13 +186,15 @@ static bool inject_suite_program(smem::DramMemoryPort& dram_port,
     init_base = array_addr;
     len_words = 16u;
     suite_meta.twice = true;
+  } else if (suite_meta.name == "smc") {
+    smc = true;
   } else {
     err = "unknown suite for injected program path";
     return false;
   }
 
   uint32_t expected_sum = 0;
-  for (uint32_t i = 0; i < len_words; ++i) {
+  for (uint32_t i = 0; !smc && i < len_words; ++i) {
     const uint32_t value = i + 1u;
     expected_sum += value;
     dram_port.write32(init_base + 4u * i, value);
@@ -165,8 +209,28 @@ static bool inject_suite_program(smem::DramMemoryPort& dram_port,
   }
 
   std::vector<uint32_t> program;
-  program.reserve(suite_meta.twice ? 24u : 16u);
-  if (suite_meta.twice) {
+  program.reserve(suite_meta.twice ? 24u : 17u);
+  if (smc) {
+    // Self-modifying code: stores rewrite one instruction that has already run
+    // (the loop head, from inside the loop's own block) and one further down
+    // the block that is running. Replacement words sit past the program.
+    const uint32_t patch_addr = load_addr_value + 0x80u;
+    dram_port.write32(patch_addr,      encode_addi(10u, 10u, 100));
+    dram_port.write32(patch_addr + 4u, encode_addi(10u, 10u, 7));
+    if (!emit_li(program, 1u, load_addr_value)) return false;
+    if (!emit_li(program, 2u, patch_addr)) return false;
+    program.push_back(encode_addi(10u, 0u, 0));
+    program.push_back(encode_addi(5u, 0u, 2));
+    program.push_back(encode_addi(10u, 10u, 1));     // [6] loop: becomes +100 after its first pass
+    program.push_back(encode_lw(6u, 2u, 0));
+    program.push_back(encode_sw(6u, 1u, 6 * 4));
+    program.push_back(encode_addi(5u, 5u, -1));
+    program.push_back(encode_bne(5u, 0u, -16));      // back to [6]
+    program.push_back(encode_lw(7u, 2u, 4));
+    program.push_back(encode_sw(7u, 1u, 14 * 4));
+    program.push_back(encode_addi(0u, 0u, 0));
+    program.push_back(encode_addi(10u, 10u, 1000));  // [14] rewritten to +7 before it runs
+  } else if (suite_meta.twice) {
     if (!emit_li(program, 1u, mailbox0)) return false;
     if (!emit_li(program, 2u, array_addr)) return false;
     if (!emit_li(program, 4u, len_words)) return false;
@@ -195,7 +259,9 @@ static bool inject_suite_program(smem::DramMemoryPort& dram_port,
     tile.set_pc(load_addr_value);
   }
 
-  if (suite_meta.twice) {
+  if (smc) {
+    suite_meta.expected_exit = 1u + 100u + 7u;
+  } else if (suite_meta.twice) {
     suite_meta.expected_exit = 0u;
   } else if (suite_meta.name == "proto_accel_sum_badarg") {
     suite_meta.expected_exit = AccelPort::ACCEL_E_BADARG;
@@ -207,15 +273,28 @@ static bool inject_suite_program(smem::DramMemoryPort& dram_port,
   return true;
 }
 
+// Retired-instruction counters of one selfcheck run, compared across engines.
+struct RunCounters {
+  uint64_t insts = 0;
+  uint64_t loads = 0;
+  uint64_t taken = 0;
+  uint64_t invals = 0;
+  uint64_t flushes = 0;
+};
+
 static int run_one_case(const std::string& accel_flag,
                         const std::string& suite_flag,
                         int mem_lat,
-                        int steps_override) {
-  Tile1 tile("tile1");
+                        int steps_override,
+                        const std::string& exec_flag,
+                        bool dcache,
+                        RunCounters* counters = nullptr) {
   smem::Dram dram("dram", 0);
   smem::DramMemoryPort dram_port(dram);
   smem::MemCtrlTimedPort memctrl(&dram_port, mem_lat);
+  Tile1 tile("tile1"); // after its memory, so it detaches before the port goes away
   tile.attach_memory(&memctrl);
+  tile.set_decode_cache(dcache);
 
   std::string err;
   std::unique_ptr<AccelPort> accel_ptr = make_accel_for_flag(accel_flag, memctrl, err);
@@ -236,6 +315,11 @@ static int run_one_case(const std::string& accel_flag,
       accel_flag.c_str(), suite_flag.c_str(), mem_lat, steps_override);
     return 1;
   }
+  if (!apply_exec_mode_flag(tile, to_lower_copy(exec_flag))) {
+    printf("[SELF] FAIL accel=%s suite=%s lat=%d steps=%d err=bad exec_mode\n",
+      accel_flag.c_str(), suite_flag.c_str(), mem_lat, steps_override);
+    return 1;
+  }
 
   dram.s_req.wireToZero();
   dram.s_resp.sendToBitBucket();
@@ -285,6 +369,13 @@ static int run_one_case(const std::string& accel_flag,
       return 1;
     }
   }
+  if (counters) {
+    counters->insts   = tile.inst_count();
+    counters->loads   = tile.load_count();
+    counters->taken   = tile.branch_taken_count();
+    counters->invals  = tile.decode_cache_invalidations();
+    counters->flushes = tile.block_flushes();
+  }
   printf("[SELF] PASS accel=%s suite=%s lat=%d steps=%d\n",
     accel_flag.c_str(), suite_flag.c_str(), mem_lat, steps_override);
   return 0;
@@ -315,9 +406,43 @@ int main(int argc, char* argv[]) {
     };
     int failures = 0;
     for (const auto& c : cases) {
-      failures += run_one_case(c.accel, c.suite, c.latency, c.steps);
+      failures += run_one_case(c.accel, c.suite, c.latency, c.steps,
+                               std::string(exec_mode), decode_cache);
+    }
+    // The self-modifying suite must retire the same instructions on every engine,
+    // and the cached engines must have actually dropped the stale code.
+    struct SmcMode {
+      const char* exec;
+      bool dcache;
+      int latency;
+    };
+    const std::vector<SmcMode> smc_modes = {
+      {"step",  false, 0},
+      {"step",  true,  0},
+      {"step",  true,  5},
+      {"block", true,  0},
+    };
+    RunCounters smc_ref;
+    for (size_t i = 0; i < smc_modes.size(); ++i) {
+      const SmcMode& m = smc_modes[i];
+      RunCounters got;
+      int fail = run_one_case("none", "smc", m.latency, 600, m.exec, m.dcache, &got);
+      if (fail == 0) {
+        if (i == 0) smc_ref = got;
+        const bool step_cached = m.dcache && std::string(m.exec) == "step";
+        const bool block = std::string(m.exec) == "block";
+        if (got.insts != smc_ref.insts || got.loads != smc_ref.loads || got.taken != smc_ref.taken ||
+            (step_cached && got.invals == 0) || (block && got.flushes == 0)) {
+          fail = 1;
+        }
+        printf("[SELF] %s smc exec=%s dcache=%d lat=%d insts=%llu loads=%llu taken=%llu invals=%llu flushes=%llu\n",
+          fail ? "FAIL" : "PASS", m.exec, m.dcache ? 1 : 0, m.latency,
+          (unsigned long long)got.insts, (unsigned long long)got.loads, (unsigned long long)got.taken,
+          (unsigned long long)got.invals, (unsigned long long)got.flushes);
+      }
+      failures += fail;
     }
-    const int total = static_cast<int>(cases.size());
+    const int total = static_cast<int>(cases.size() + smc_modes.size());
     if (failures == 0) {
       printf("[SELF] PASS %d/%d\n", total, total);
       return 0;
@@ -329,11 +454,12 @@ int main(int argc, char* argv[]) {
   // **************
   // Step 2: Create components
   // **************
-  Tile1 tile("tile1");
   smem::Dram dram("dram", 0);
   smem::DramMemoryPort dram_port(dram);
   smem::MemCtrlTimedPort memctrl(&dram_port, (int)mem_latency);
+  Tile1 tile("tile1"); // after its memory, so it detaches before the port goes away
   tile.attach_memory(&memctrl);
+  tile.set_decode_cache(decode_cache);
   // Configure accelerator based on accel parameter (none/demo_add/array_sum/array_sum_mc)
   std::unique_ptr<AccelPort> accel_ptr;
   std::string accel_flag = std::string(accel);
@@ -361,6 +487,7 @@ int main(int argc, char* argv[]) {
     assert_always(mem_model_flag == "timed", "mem_model must be 'timed' or 'ideal'");
     tile.set_mem_model(Tile1::MemModel::Timed);
   }
+  assert_always(apply_exec_mode_flag(tile, to_lower_copy(std::string(exec_mode))), "exec_mode must be 'step' or 'block'");
   dram.s_req.wireToZero();
   dram.s_resp.sendToBitBucket();
 
@@ -464,6 +591,8 @@ int main(int argc, char* argv[]) {
            (unsigned long long)tile.store_count(),
            (unsigned long long)tile.branch_count(),
            (unsigned long long)tile.branch_taken_count());
+    print_decode_cache_stats(tile);
+    print_block_stats(tile);
     return 0;
   }
 
@@ -485,6 +614,8 @@ int main(int argc, char* argv[]) {
          (unsigned long long)tile.store_count(),
          (unsigned long long)tile.branch_count(),
          (unsigned long long)tile.branch_taken_count());
+  print_decode_cache_stats(tile);
+  print_block_stats(tile);
 
   // **************
   // Step 7C: Sim stop NOT on exit(): post-mortem sanity check